@@ -33,511 +33,877 @@
 #include "core/config/engine.h"
 #include "core/object/script_language.h"
 #include "core/variant/container_type_validate.h"
+#include "core/variant/variant_internal.h"
+
+// SIMD is used to skip over the plain runs inside strings, which make up most of typical JSON documents.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SSE2_ENABLED
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define JSON_NEON_ENABLED
+#include <arm_neon.h>
+#endif
+
+// Returns the first character in a string that ends a plain run: a quote, a backslash, a newline or NUL.
+static _FORCE_INLINE_ const uint8_t *_find_string_special(const uint8_t *p_from, const uint8_t *p_end) {
+	const uint8_t *p = p_from;
+#if defined(JSON_SSE2_ENABLED)
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i zero = _mm_setzero_si128();
+	while (p_end - p >= 16) {
+		const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+		const __m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, zero)));
+		if (_mm_movemask_epi8(special)) {
+			break;
+		}
+		p += 16;
+	}
+#elif defined(JSON_NEON_ENABLED)
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t backslash = vdupq_n_u8('\\');
+	const uint8x16_t newline = vdupq_n_u8('\n');
+	while (p_end - p >= 16) {
+		const uint8x16_t chunk = vld1q_u8(p);
+		const uint8x16_t special = vorrq_u8(
+				vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+				vorrq_u8(vceqq_u8(chunk, newline), vceqzq_u8(chunk)));
+		if (vmaxvq_u8(special)) {
+			break;
+		}
+		p += 16;
+	}
+#endif
+	while (p < p_end && *p != '"' && *p != '\\' && *p != '\n' && *p != 0) {
+		p++;
+	}
+	return p;
+}
 
-const char *JSON::tk_name[TK_MAX] = {
-	"'{'",
-	"'}'",
-	"'['",
-	"']'",
-	"identifier",
-	"string",
-	"number",
-	"':'",
-	"','",
-	"EOF",
-};
+static _FORCE_INLINE_ const char32_t *_find_string_special(const char32_t *p_from, const char32_t *p_end) {
+	const char32_t *p = p_from;
+	while (p < p_end && *p != '"' && *p != '\\' && *p != '\n' && *p != 0) {
+		p++;
+	}
+	return p;
+}
+
+static _FORCE_INLINE_ void _append_run(String &r_str, const uint8_t *p_from, const uint8_t *p_to) {
+	r_str.append_utf8((const char *)p_from, p_to - p_from);
+}
+
+static _FORCE_INLINE_ void _append_run(String &r_str, const char32_t *p_from, const char32_t *p_to) {
+	r_str.append_utf32(Span(p_from, p_to - p_from));
+}
 
-void JSON::_add_indent(String &r_result, const String &p_indent, int p_size) {
-	for (int i = 0; i < p_size; i++) {
-		r_result += p_indent;
+// The number was already scanned, so the range only holds ASCII digits, signs, '.' and exponent markers.
+template <typename C>
+static double _parse_float_fallback(const C *p_from, const C *p_to) {
+	char buf[64];
+	const int64_t len = p_to - p_from;
+	char *dst = buf;
+	CharString cs;
+	if (len >= int64_t(sizeof(buf))) {
+		cs.resize(len + 1);
+		dst = cs.ptrw();
 	}
+	for (int64_t i = 0; i < len; i++) {
+		dst[i] = char(p_from[i]);
+	}
+	dst[len] = 0;
+	return String::to_float(dst);
 }
 
-void JSON::_stringify(String &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision) {
-	if (p_cur_indent > Variant::MAX_RECURSION_DEPTH) {
-		r_result += "...";
-		ERR_FAIL_MSG("JSON structure is too deep. Bailing.");
+// Recursive descent parser shared by the String and UTF-8 entry points. It reports values to `H`, which is either
+// the Variant builder below or a JSON::Handler, so that the Variant path does not pay for virtual calls.
+template <typename C, typename H>
+class JSONParser {
+	enum TokenType {
+		TK_CURLY_BRACKET_OPEN,
+		TK_CURLY_BRACKET_CLOSE,
+		TK_BRACKET_OPEN,
+		TK_BRACKET_CLOSE,
+		TK_IDENTIFIER,
+		TK_STRING,
+		TK_NUMBER,
+		TK_COLON,
+		TK_COMMA,
+		TK_EOF,
+		TK_MAX
+	};
+
+	struct Token {
+		TokenType type = TK_EOF;
+		double number = 0.0;
+		String string;
+	};
+
+	static constexpr const char *tk_name[TK_MAX] = {
+		"'{'",
+		"'}'",
+		"'['",
+		"']'",
+		"identifier",
+		"string",
+		"number",
+		"':'",
+		"','",
+		"EOF",
+	};
+
+	const C *ptr = nullptr;
+	const C *end = nullptr;
+	H &handler;
+
+	_FORCE_INLINE_ char32_t _peek(int p_ofs) const {
+		return ptr + p_ofs < end ? char32_t(ptr[p_ofs]) : 0;
 	}
 
-	const char *colon = p_indent.is_empty() ? ":" : ": ";
-	const char *end_statement = p_indent.is_empty() ? "" : "\n";
+	Error _parse_hex(int p_ofs, char32_t &r_value) {
+		r_value = 0;
+		for (int j = 0; j < 4; j++) {
+			char32_t c = _peek(p_ofs + j);
+			if (c == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
+			}
+			if (!is_hex_digit(c)) {
+				err_str = "Malformed hex constant in string";
+				return ERR_PARSE_ERROR;
+			}
+			char32_t v;
+			if (is_digit(c)) {
+				v = c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				v = c - 'a' + 10;
+			} else {
+				v = c - 'A' + 10;
+			}
+			r_value = (r_value << 4) | v;
+		}
+		return OK;
+	}
 
-	switch (p_var.get_type()) {
-		case Variant::NIL:
-			r_result += "null";
-			return;
-		case Variant::BOOL:
-			r_result += p_var.operator bool() ? "true" : "false";
-			return;
-		case Variant::INT:
-			r_result += itos(p_var);
-			return;
-		case Variant::FLOAT: {
-			double num = p_var;
+	Error _parse_string(String &r_str) {
+		ptr++; // Opening quote.
+		const C *run = ptr;
+		while (true) {
+			ptr = _find_string_special(ptr, end);
+			if (ptr == end || *ptr == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
+			}
+			if (*ptr == '\n') {
+				line++;
+				ptr++;
+				continue;
+			}
+			if (ptr > run) {
+				_append_run(r_str, run, ptr);
+			}
+			if (*ptr == '"') {
+				ptr++;
+				return OK;
+			}
 
-			// Only for exactly 0. If we have approximately 0 let the user decide how much
-			// precision they want.
-			if (num == double(0)) {
-				r_result += "0.0";
-				return;
+			// Escaped characters.
+			ptr++;
+			char32_t next = _peek(0);
+			if (next == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
 			}
+			char32_t res = 0;
 
-			double magnitude = std::log10(Math::abs(num));
-			int total_digits = p_full_precision ? 17 : 14;
-			int precision = MAX(1, total_digits - (int)Math::floor(magnitude));
+			switch (next) {
+				case 'b':
+					res = 8;
+					break;
+				case 't':
+					res = 9;
+					break;
+				case 'n':
+					res = 10;
+					break;
+				case 'f':
+					res = 12;
+					break;
+				case 'r':
+					res = 13;
+					break;
+				case 'u': {
+					Error err = _parse_hex(1, res);
+					if (err) {
+						return err;
+					}
+					ptr += 4; // Will add at the end anyway.
 
-			r_result += String::num(num, precision);
-			return;
-		}
-		case Variant::PACKED_INT32_ARRAY:
-		case Variant::PACKED_INT64_ARRAY:
-		case Variant::PACKED_FLOAT32_ARRAY:
-		case Variant::PACKED_FLOAT64_ARRAY:
-		case Variant::PACKED_STRING_ARRAY:
-		case Variant::ARRAY: {
-			Array a = p_var;
-			if (p_markers.has(a.id())) {
-				r_result += "\"[...]\"";
-				ERR_FAIL_MSG("Converting circular structure to JSON.");
-			}
+					if ((res & 0xfffffc00) == 0xd800) {
+						if (_peek(1) != '\\' || _peek(2) != 'u') {
+							err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+						ptr += 2;
+						char32_t trail = 0;
+						err = _parse_hex(1, trail);
+						if (err) {
+							return err;
+						}
+						if ((trail & 0xfffffc00) == 0xdc00) {
+							res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+							ptr += 4; // Will add at the end anyway.
+						} else {
+							err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+					} else if ((res & 0xfffffc00) == 0xdc00) {
+						err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
+						return ERR_PARSE_ERROR;
+					}
 
-			if (a.is_empty()) {
-				r_result += "[]";
-				return;
+				} break;
+				case '"':
+				case '\\':
+				case '/': {
+					res = next;
+				} break;
+				default: {
+					err_str = "Invalid escape sequence";
+					return ERR_PARSE_ERROR;
+				}
 			}
 
-			r_result += '[';
-			r_result += end_statement;
+			r_str += res;
+			ptr++;
+			run = ptr;
+		}
+	}
 
-			p_markers.insert(a.id());
+	// Numbers with at most 19 significant digits, a mantissa exactly representable as a double and a small decimal
+	// exponent are converted with a single correctly rounded operation. Anything else goes through String::to_float().
+	Error _parse_number(double &r_number) {
+		static constexpr double powers_of_ten[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		const C *start = ptr;
+		const bool negative = *ptr == '-';
+		if (negative) {
+			ptr++;
+		}
+		if (ptr == end || !is_digit(*ptr)) {
+			err_str = "Malformed number";
+			return ERR_PARSE_ERROR;
+		}
 
-			bool first = true;
-			for (const Variant &var : a) {
-				if (first) {
-					first = false;
+		uint64_t mantissa = 0;
+		int significant = 0;
+		int exponent = 0;
+		bool truncated = false;
+
+		while (ptr < end && is_digit(*ptr)) {
+			const int digit = *ptr - '0';
+			if (mantissa != 0 || digit != 0) {
+				if (significant < 19) {
+					mantissa = mantissa * 10 + digit;
+					significant++;
 				} else {
-					r_result += ',';
-					r_result += end_statement;
+					exponent++;
+					truncated = true;
 				}
-				_add_indent(r_result, p_indent, p_cur_indent + 1);
-				_stringify(r_result, var, p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
 			}
-			r_result += end_statement;
-			_add_indent(r_result, p_indent, p_cur_indent);
-			r_result += ']';
-			p_markers.erase(a.id());
-			return;
+			ptr++;
 		}
-		case Variant::DICTIONARY: {
-			Dictionary d = p_var;
-			if (p_markers.has(d.id())) {
-				r_result += "\"{...}\"";
-				ERR_FAIL_MSG("Converting circular structure to JSON.");
+		if (ptr < end && *ptr == '.') {
+			ptr++;
+			while (ptr < end && is_digit(*ptr)) {
+				const int digit = *ptr - '0';
+				if (mantissa == 0 && digit == 0) {
+					exponent--;
+				} else if (significant < 19) {
+					mantissa = mantissa * 10 + digit;
+					significant++;
+					exponent--;
+				} else {
+					truncated = true;
+				}
+				ptr++;
 			}
+		}
+		if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+			const C *exponent_start = ptr;
+			ptr++;
+			bool exponent_negative = false;
+			if (ptr < end && (*ptr == '+' || *ptr == '-')) {
+				exponent_negative = *ptr == '-';
+				ptr++;
+			}
+			if (ptr < end && is_digit(*ptr)) {
+				int value = 0;
+				while (ptr < end && is_digit(*ptr)) {
+					value = MIN(value * 10 + (*ptr - '0'), 100000);
+					ptr++;
+				}
+				exponent += exponent_negative ? -value : value;
+			} else {
+				ptr = exponent_start; // Not an exponent, let the next token deal with it.
+			}
+		}
 
-			r_result += '{';
-			r_result += end_statement;
-			p_markers.insert(d.id());
-
-			LocalVector<Variant> keys = d.get_key_list();
+		if (mantissa == 0) {
+			r_number = negative ? -0.0 : 0.0;
+		} else if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+			double value = double(mantissa);
+			value = exponent < 0 ? value / powers_of_ten[-exponent] : value * powers_of_ten[exponent];
+			r_number = negative ? -value : value;
+		} else {
+			r_number = _parse_float_fallback(start, ptr);
+		}
+		return OK;
+	}
 
-			if (p_sort_keys) {
-				keys.sort_custom<StringLikeVariantOrder>();
+	Error _get_token(Token &r_token) {
+		while (true) {
+			if (ptr == end) {
+				r_token.type = TK_EOF;
+				return OK;
 			}
+			switch (*ptr) {
+				case '\n': {
+					line++;
+					ptr++;
+					break;
+				}
+				case 0: {
+					r_token.type = TK_EOF;
+					return OK;
+				} break;
+				case '{': {
+					r_token.type = TK_CURLY_BRACKET_OPEN;
+					ptr++;
+					return OK;
+				}
+				case '}': {
+					r_token.type = TK_CURLY_BRACKET_CLOSE;
+					ptr++;
+					return OK;
+				}
+				case '[': {
+					r_token.type = TK_BRACKET_OPEN;
+					ptr++;
+					return OK;
+				}
+				case ']': {
+					r_token.type = TK_BRACKET_CLOSE;
+					ptr++;
+					return OK;
+				}
+				case ':': {
+					r_token.type = TK_COLON;
+					ptr++;
+					return OK;
+				}
+				case ',': {
+					r_token.type = TK_COMMA;
+					ptr++;
+					return OK;
+				}
+				case '"': {
+					r_token.type = TK_STRING;
+					r_token.string = String();
+					return _parse_string(r_token.string);
+				} break;
+				default: {
+					if (*ptr <= 32) {
+						ptr++;
+						break;
+					}
 
-			bool first_key = true;
-			for (const Variant &key : keys) {
-				if (first_key) {
-					first_key = false;
-				} else {
-					r_result += ',';
-					r_result += end_statement;
+					if (*ptr == '-' || is_digit(*ptr)) {
+						r_token.type = TK_NUMBER;
+						return _parse_number(r_token.number);
+
+					} else if (is_ascii_alphabet_char(*ptr)) {
+						const C *start = ptr;
+						while (ptr < end && is_ascii_alphabet_char(*ptr)) {
+							ptr++;
+						}
+
+						r_token.type = TK_IDENTIFIER;
+						r_token.string = String();
+						_append_run(r_token.string, start, ptr);
+						return OK;
+					} else {
+						err_str = "Unexpected character";
+						return ERR_PARSE_ERROR;
+					}
 				}
-				_add_indent(r_result, p_indent, p_cur_indent + 1);
-				_stringify(r_result, String(key), p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
-				r_result += colon;
-				_stringify(r_result, d[key], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
 			}
-
-			r_result += end_statement;
-			_add_indent(r_result, p_indent, p_cur_indent);
-			r_result += '}';
-			p_markers.erase(d.id());
-			return;
 		}
-		default:
-			r_result += '"';
-			r_result += String(p_var).json_escape();
-			r_result += '"';
-			return;
 	}
-}
 
-Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
-	while (p_len > 0) {
-		switch (p_str[index]) {
-			case '\n': {
-				line++;
-				index++;
-				break;
+	Error _parse_value(Token &p_token, int p_depth) {
+		if (p_depth > Variant::MAX_RECURSION_DEPTH) {
+			err_str = "JSON structure is too deep";
+			return ERR_OUT_OF_MEMORY;
+		}
+
+		switch (p_token.type) {
+			case TK_CURLY_BRACKET_OPEN: {
+				Error err = handler.begin_object();
+				if (err) {
+					return err;
+				}
+				return _parse_object(p_depth + 1);
 			}
-			case 0: {
-				r_token.type = TK_EOF;
-				return OK;
-			} break;
-			case '{': {
-				r_token.type = TK_CURLY_BRACKET_OPEN;
-				index++;
-				return OK;
+			case TK_BRACKET_OPEN: {
+				Error err = handler.begin_array();
+				if (err) {
+					return err;
+				}
+				return _parse_array(p_depth + 1);
 			}
-			case '}': {
-				r_token.type = TK_CURLY_BRACKET_CLOSE;
-				index++;
-				return OK;
+			case TK_IDENTIFIER: {
+				const String &id = p_token.string;
+				if (id == "true") {
+					return handler.bool_value(true);
+				} else if (id == "false") {
+					return handler.bool_value(false);
+				} else if (id == "null") {
+					return handler.null_value();
+				}
+				err_str = vformat("Expected 'true', 'false', or 'null', got '%s'", id);
+				return ERR_PARSE_ERROR;
 			}
-			case '[': {
-				r_token.type = TK_BRACKET_OPEN;
-				index++;
-				return OK;
+			case TK_NUMBER: {
+				return handler.number_value(p_token.number);
 			}
-			case ']': {
-				r_token.type = TK_BRACKET_CLOSE;
-				index++;
-				return OK;
+			case TK_STRING: {
+				return handler.string_value(p_token.string);
 			}
-			case ':': {
-				r_token.type = TK_COLON;
-				index++;
-				return OK;
+			default: {
+				err_str = vformat("Expected value, got '%s'", String(tk_name[p_token.type]));
+				return ERR_PARSE_ERROR;
 			}
-			case ',': {
-				r_token.type = TK_COMMA;
-				index++;
-				return OK;
+		}
+	}
+
+	Error _parse_array(int p_depth) {
+		Token token;
+		bool need_comma = false;
+
+		while (ptr < end) {
+			Error err = _get_token(token);
+			if (err != OK) {
+				return err;
 			}
-			case '"': {
-				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated string";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
-						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						char32_t next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated string";
-							return ERR_PARSE_ERROR;
-						}
-						char32_t res = 0;
-
-						switch (next) {
-							case 'b':
-								res = 8;
-								break;
-							case 't':
-								res = 9;
-								break;
-							case 'n':
-								res = 10;
-								break;
-							case 'f':
-								res = 12;
-								break;
-							case 'r':
-								res = 13;
-								break;
-							case 'u': {
-								// hex number
-								for (int j = 0; j < 4; j++) {
-									char32_t c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated string";
-										return ERR_PARSE_ERROR;
-									}
-									if (!is_hex_digit(c)) {
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									char32_t v;
-									if (is_digit(c)) {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("Bug parsing hex constant.");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-								if ((res & 0xfffffc00) == 0xd800) {
-									if (p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-									index += 2;
-									char32_t trail = 0;
-									for (int j = 0; j < 4; j++) {
-										char32_t c = p_str[index + j + 1];
-										if (c == 0) {
-											r_err_str = "Unterminated string";
-											return ERR_PARSE_ERROR;
-										}
-										if (!is_hex_digit(c)) {
-											r_err_str = "Malformed hex constant in string";
-											return ERR_PARSE_ERROR;
-										}
-										char32_t v;
-										if (is_digit(c)) {
-											v = c - '0';
-										} else if (c >= 'a' && c <= 'f') {
-											v = c - 'a';
-											v += 10;
-										} else if (c >= 'A' && c <= 'F') {
-											v = c - 'A';
-											v += 10;
-										} else {
-											ERR_PRINT("Bug parsing hex constant.");
-											v = 0;
-										}
-
-										trail <<= 4;
-										trail |= v;
-									}
-									if ((trail & 0xfffffc00) == 0xdc00) {
-										res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
-										index += 4; //will add at the end anyway
-									} else {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-								} else if ((res & 0xfffffc00) == 0xdc00) {
-									r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
-									return ERR_PARSE_ERROR;
-								}
-
-							} break;
-							case '"':
-							case '\\':
-							case '/': {
-								res = next;
-							} break;
-							default: {
-								r_err_str = "Invalid escape sequence";
-								return ERR_PARSE_ERROR;
-							}
-						}
 
-						str += res;
+			if (token.type == TK_BRACKET_CLOSE) {
+				return handler.end_array();
+			}
 
-					} else {
-						if (p_str[index] == '\n') {
-							line++;
-						}
-						str += p_str[index];
-					}
-					index++;
+			if (need_comma) {
+				if (token.type != TK_COMMA) {
+					err_str = "Expected ','";
+					return ERR_PARSE_ERROR;
+				} else {
+					need_comma = false;
+					continue;
 				}
+			}
 
-				r_token.type = TK_STRING;
-				r_token.value = str;
-				return OK;
+			err = _parse_value(token, p_depth);
+			if (err) {
+				return err;
+			}
+			need_comma = true;
+		}
 
-			} break;
-			default: {
-				if (p_str[index] <= 32) {
-					index++;
-					break;
-				}
+		err_str = "Expected ']'";
+		return ERR_PARSE_ERROR;
+	}
 
-				if (p_str[index] == '-' || is_digit(p_str[index])) {
-					//a number
-					const char32_t *rptr;
-					double number = String::to_float(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
-					r_token.type = TK_NUMBER;
-					r_token.value = number;
-					return OK;
+	Error _parse_object(int p_depth) {
+		bool at_key = true;
+		Token token;
+		bool need_comma = false;
+
+		while (ptr < end) {
+			if (at_key) {
+				Error err = _get_token(token);
+				if (err != OK) {
+					return err;
+				}
 
-				} else if (is_ascii_alphabet_char(p_str[index])) {
-					String id;
+				if (token.type == TK_CURLY_BRACKET_CLOSE) {
+					return handler.end_object();
+				}
 
-					while (is_ascii_alphabet_char(p_str[index])) {
-						id += p_str[index];
-						index++;
+				if (need_comma) {
+					if (token.type != TK_COMMA) {
+						err_str = "Expected '}' or ','";
+						return ERR_PARSE_ERROR;
+					} else {
+						need_comma = false;
+						continue;
 					}
+				}
 
-					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
-					return OK;
-				} else {
-					r_err_str = "Unexpected character";
+				if (token.type != TK_STRING) {
+					err_str = "Expected key";
+					return ERR_PARSE_ERROR;
+				}
+
+				err = handler.object_key(token.string);
+				if (err != OK) {
+					return err;
+				}
+				err = _get_token(token);
+				if (err != OK) {
+					return err;
+				}
+				if (token.type != TK_COLON) {
+					err_str = "Expected ':'";
 					return ERR_PARSE_ERROR;
 				}
+				at_key = false;
+			} else {
+				Error err = _get_token(token);
+				if (err != OK) {
+					return err;
+				}
+
+				err = _parse_value(token, p_depth);
+				if (err) {
+					return err;
+				}
+				need_comma = true;
+				at_key = true;
 			}
 		}
-	}
 
-	r_err_str = "Unknown error getting token";
-	return ERR_PARSE_ERROR;
-}
-
-Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	if (p_depth > Variant::MAX_RECURSION_DEPTH) {
-		r_err_str = "JSON structure is too deep";
-		return ERR_OUT_OF_MEMORY;
+		err_str = "Expected '}'";
+		return ERR_PARSE_ERROR;
 	}
 
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, p_depth + 1, r_err_str);
+public:
+	String err_str;
+	int line = 0;
+
+	Error parse() {
+		Token token;
+		Error err = _get_token(token);
 		if (err) {
 			return err;
 		}
-		value = d;
-	} else if (token.type == TK_BRACKET_OPEN) {
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, p_depth + 1, r_err_str);
-		if (err) {
-			return err;
+
+		err = _parse_value(token, 0);
+
+		// Check if EOF is reached
+		// or it's a type of the next token.
+		if (err == OK && ptr < end) {
+			err = _get_token(token);
+
+			if (err || token.type != TK_EOF) {
+				err_str = "Expected 'EOF'";
+				return ERR_PARSE_ERROR;
+			}
+		}
+
+		return err;
+	}
+
+	JSONParser(const C *p_from, const C *p_end, H &p_handler) :
+			ptr(p_from), end(p_end), handler(p_handler) {}
+};
+
+// Builds the Variant tree for JSON::parse() and friends. Containers are attached to their parent once complete.
+class JSONVariantBuilder {
+	LocalVector<Variant> containers;
+	LocalVector<String> keys;
+
+	Error _add(const Variant &p_value) {
+		if (containers.is_empty()) {
+			result = p_value;
+			return OK;
 		}
-		value = a;
-	} else if (token.type == TK_IDENTIFIER) {
-		String id = token.value;
-		if (id == "true") {
-			value = true;
-		} else if (id == "false") {
-			value = false;
-		} else if (id == "null") {
-			value = Variant();
+		Variant &top = containers[containers.size() - 1];
+		if (top.get_type() == Variant::ARRAY) {
+			VariantInternal::get_array(&top)->push_back(p_value);
 		} else {
-			r_err_str = vformat("Expected 'true', 'false', or 'null', got '%s'", id);
-			return ERR_PARSE_ERROR;
+			(*VariantInternal::get_dictionary(&top))[keys[keys.size() - 1]] = p_value;
 		}
-	} else if (token.type == TK_NUMBER) {
-		value = token.value;
-	} else if (token.type == TK_STRING) {
-		value = token.value;
-	} else {
-		r_err_str = vformat("Expected value, got '%s'", String(tk_name[token.type]));
-		return ERR_PARSE_ERROR;
+		return OK;
 	}
 
-	return OK;
-}
+	Error _end_container() {
+		const uint32_t last = containers.size() - 1;
+		Variant container = containers[last];
+		containers.resize(last);
+		keys.resize(last);
+		return _add(container);
+	}
 
-Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	Token token;
-	bool need_comma = false;
+public:
+	Variant result;
 
-	while (index < p_len) {
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-		if (err != OK) {
-			return err;
-		}
+	_FORCE_INLINE_ Error null_value() { return _add(Variant()); }
+	_FORCE_INLINE_ Error bool_value(bool p_value) { return _add(p_value); }
+	_FORCE_INLINE_ Error number_value(double p_value) { return _add(p_value); }
+	_FORCE_INLINE_ Error string_value(const String &p_value) { return _add(p_value); }
 
-		if (token.type == TK_BRACKET_CLOSE) {
-			return OK;
-		}
+	Error begin_array() {
+		containers.push_back(Array());
+		keys.push_back(String());
+		return OK;
+	}
+	Error end_array() { return _end_container(); }
 
-		if (need_comma) {
-			if (token.type != TK_COMMA) {
-				r_err_str = "Expected ','";
-				return ERR_PARSE_ERROR;
+	Error begin_object() {
+		containers.push_back(Dictionary());
+		keys.push_back(String());
+		return OK;
+	}
+	_FORCE_INLINE_ Error object_key(const String &p_key) {
+		keys[keys.size() - 1] = p_key;
+		return OK;
+	}
+	Error end_object() { return _end_container(); }
+};
+
+// Writes JSON text as UTF-32 (for String) or UTF-8 into a growable buffer, instead of concatenating Strings.
+template <typename C>
+class JSONWriter {
+	LocalVector<C> &buffer;
+	const String &indent;
+	const bool sort_keys;
+	HashSet<const void *> markers;
+
+	_FORCE_INLINE_ void _put(char32_t p_char) {
+		if constexpr (std::is_same_v<C, char32_t>) {
+			buffer.push_back(p_char);
+		} else {
+			if (p_char < 0x80) {
+				buffer.push_back(p_char);
+			} else if (p_char < 0x800) {
+				buffer.push_back(0xC0 | (p_char >> 6));
+				buffer.push_back(0x80 | (p_char & 0x3F));
+			} else if (p_char < 0x10000) {
+				buffer.push_back(0xE0 | (p_char >> 12));
+				buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+				buffer.push_back(0x80 | (p_char & 0x3F));
 			} else {
-				need_comma = false;
-				continue;
+				buffer.push_back(0xF0 | ((p_char >> 18) & 0x07));
+				buffer.push_back(0x80 | ((p_char >> 12) & 0x3F));
+				buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+				buffer.push_back(0x80 | (p_char & 0x3F));
 			}
 		}
+	}
 
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, p_depth, r_err_str);
-		if (err) {
-			return err;
+	void _put(const char *p_ascii) {
+		while (*p_ascii) {
+			buffer.push_back(C(*(p_ascii++)));
 		}
-
-		array.push_back(v);
-		need_comma = true;
 	}
 
-	r_err_str = "Expected ']'";
-	return ERR_PARSE_ERROR;
-}
+	void _put(const String &p_string) {
+		const char32_t *chars = p_string.ptr();
+		const int len = p_string.length();
+		for (int i = 0; i < len; i++) {
+			_put(chars[i]);
+		}
+	}
 
-Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	bool at_key = true;
-	String key;
-	Token token;
-	bool need_comma = false;
+	void _put_indent(int p_size) {
+		for (int i = 0; i < p_size; i++) {
+			_put(indent);
+		}
+	}
 
-	while (index < p_len) {
-		if (at_key) {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
+	// Same escaping as String::json_escape(), in one pass.
+	void _put_quoted(const String &p_string) {
+		buffer.push_back(C('"'));
+		const char32_t *chars = p_string.ptr();
+		const int len = p_string.length();
+		for (int i = 0; i < len; i++) {
+			const char32_t c = chars[i];
+			switch (c) {
+				case '\\':
+					_put("\\\\");
+					break;
+				case '\b':
+					_put("\\b");
+					break;
+				case '\f':
+					_put("\\f");
+					break;
+				case '\n':
+					_put("\\n");
+					break;
+				case '\r':
+					_put("\\r");
+					break;
+				case '\t':
+					_put("\\t");
+					break;
+				case '\v':
+					_put("\\v");
+					break;
+				case '"':
+					_put("\\\"");
+					break;
+				default:
+					_put(c);
 			}
+		}
+		buffer.push_back(C('"'));
+	}
 
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
-				return OK;
-			}
+public:
+	void write(const Variant &p_var, int p_cur_indent, bool p_full_precision = false) {
+		if (p_cur_indent > Variant::MAX_RECURSION_DEPTH) {
+			_put("...");
+			ERR_FAIL_MSG("JSON structure is too deep. Bailing.");
+		}
 
-			if (need_comma) {
-				if (token.type != TK_COMMA) {
-					r_err_str = "Expected '}' or ','";
-					return ERR_PARSE_ERROR;
-				} else {
-					need_comma = false;
-					continue;
+		const char *colon = indent.is_empty() ? ":" : ": ";
+		const char *end_statement = indent.is_empty() ? "" : "\n";
+
+		switch (p_var.get_type()) {
+			case Variant::NIL:
+				_put("null");
+				return;
+			case Variant::BOOL:
+				_put(p_var.operator bool() ? "true" : "false");
+				return;
+			case Variant::INT: {
+				const int64_t value = p_var;
+				uint64_t magnitude = value < 0 ? ~uint64_t(value) + 1 : uint64_t(value);
+				char digits[21];
+				int pos = sizeof(digits);
+				do {
+					digits[--pos] = '0' + magnitude % 10;
+					magnitude /= 10;
+				} while (magnitude);
+				if (value < 0) {
+					digits[--pos] = '-';
+				}
+				for (; pos < int(sizeof(digits)); pos++) {
+					buffer.push_back(C(digits[pos]));
 				}
+				return;
 			}
+			case Variant::FLOAT: {
+				double num = p_var;
+
+				// Only for exactly 0. If we have approximately 0 let the user decide how much
+				// precision they want.
+				if (num == double(0)) {
+					_put("0.0");
+					return;
+				}
 
-			if (token.type != TK_STRING) {
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
+				double magnitude = std::log10(Math::abs(num));
+				int total_digits = p_full_precision ? 17 : 14;
+				int precision = MAX(1, total_digits - (int)Math::floor(magnitude));
 
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
-			}
-			if (token.type != TK_COLON) {
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
+				_put(String::num(num, precision));
+				return;
 			}
-			at_key = false;
-		} else {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
+			case Variant::PACKED_INT32_ARRAY:
+			case Variant::PACKED_INT64_ARRAY:
+			case Variant::PACKED_FLOAT32_ARRAY:
+			case Variant::PACKED_FLOAT64_ARRAY:
+			case Variant::PACKED_STRING_ARRAY:
+			case Variant::ARRAY: {
+				Array a = p_var;
+				if (markers.has(a.id())) {
+					_put("\"[...]\"");
+					ERR_FAIL_MSG("Converting circular structure to JSON.");
+				}
+
+				if (a.is_empty()) {
+					_put("[]");
+					return;
+				}
+
+				_put("[");
+				_put(end_statement);
+
+				markers.insert(a.id());
+
+				bool first = true;
+				for (const Variant &var : a) {
+					if (first) {
+						first = false;
+					} else {
+						_put(",");
+						_put(end_statement);
+					}
+					_put_indent(p_cur_indent + 1);
+					write(var, p_cur_indent + 1);
+				}
+				_put(end_statement);
+				_put_indent(p_cur_indent);
+				_put("]");
+				markers.erase(a.id());
+				return;
 			}
+			case Variant::DICTIONARY: {
+				Dictionary d = p_var;
+				if (markers.has(d.id())) {
+					_put("\"{...}\"");
+					ERR_FAIL_MSG("Converting circular structure to JSON.");
+				}
 
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, p_depth, r_err_str);
-			if (err) {
-				return err;
+				_put("{");
+				_put(end_statement);
+				markers.insert(d.id());
+
+				LocalVector<Variant> keys = d.get_key_list();
+
+				if (sort_keys) {
+					keys.sort_custom<StringLikeVariantOrder>();
+				}
+
+				bool first_key = true;
+				for (const Variant &key : keys) {
+					if (first_key) {
+						first_key = false;
+					} else {
+						_put(",");
+						_put(end_statement);
+					}
+					_put_indent(p_cur_indent + 1);
+					write(String(key), p_cur_indent + 1);
+					_put(colon);
+					write(d[key], p_cur_indent + 1);
+				}
+
+				_put(end_statement);
+				_put_indent(p_cur_indent);
+				_put("}");
+				markers.erase(d.id());
+				return;
 			}
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
+			case Variant::STRING: {
+				_put_quoted(*VariantInternal::get_string(&p_var));
+				return;
+			}
+			default:
+				_put_quoted(String(p_var));
+				return;
 		}
 	}
 
-	r_err_str = "Expected '}'";
-	return ERR_PARSE_ERROR;
-}
+	JSONWriter(LocalVector<C> &r_buffer, const String &p_indent, bool p_sort_keys) :
+			buffer(r_buffer), indent(p_indent), sort_keys(p_sort_keys) {}
+};
 
 void JSON::set_data(const Variant &p_data) {
 	data = p_data;
@@ -545,33 +911,40 @@ void JSON::set_data(const Variant &p_data) {
 }
 
 Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
-	const char32_t *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	r_err_line = 0;
-	String aux_key;
-
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
-	if (err) {
-		return err;
-	}
-
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, 0, r_err_str);
-
-	// Check if EOF is reached
-	// or it's a type of the next token.
-	if (err == OK && idx < len) {
-		err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	JSONVariantBuilder builder;
+	JSONParser<char32_t, JSONVariantBuilder> parser(p_json.ptr(), p_json.ptr() + p_json.length(), builder);
+	Error err = parser.parse();
+	r_err_str = parser.err_str;
+	r_err_line = parser.line;
+	// Reset return value to empty `Variant` on failure.
+	r_ret = err == OK ? builder.result : Variant();
+	return err;
+}
 
-		if (err || token.type != TK_EOF) {
-			r_err_str = "Expected 'EOF'";
-			// Reset return value to empty `Variant`
-			r_ret = Variant();
-			return ERR_PARSE_ERROR;
-		}
+static _FORCE_INLINE_ void _skip_utf8_bom(const uint8_t *&r_utf8, int &r_len) {
+	if (r_len >= 3 && r_utf8[0] == 0xEF && r_utf8[1] == 0xBB && r_utf8[2] == 0xBF) {
+		r_utf8 += 3;
+		r_len -= 3;
 	}
+}
 
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	_skip_utf8_bom(p_utf8, p_len);
+	JSONVariantBuilder builder;
+	JSONParser<uint8_t, JSONVariantBuilder> parser(p_utf8, p_utf8 + p_len, builder);
+	Error err = parser.parse();
+	r_err_str = parser.err_str;
+	r_err_line = parser.line;
+	r_ret = err == OK ? builder.result : Variant();
+	return err;
+}
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Handler &p_handler, String &r_err_str, int &r_err_line) {
+	_skip_utf8_bom(p_utf8, p_len);
+	JSONParser<uint8_t, Handler> parser(p_utf8, p_utf8 + p_len, p_handler);
+	Error err = parser.parse();
+	r_err_str = parser.err_str;
+	r_err_line = parser.line;
 	return err;
 }
 
@@ -586,14 +959,38 @@ Error JSON::parse(const String &p_json_string, bool p_keep_text) {
 	return err;
 }
 
+Error JSON::parse_utf8_buffer(const Vector<uint8_t> &p_json_buffer) {
+	Error err = parse_utf8(p_json_buffer.ptr(), p_json_buffer.size(), data, err_str, err_line);
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	return err;
+}
+
 String JSON::get_parsed_text() const {
 	return text;
 }
 
 String JSON::stringify(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	LocalVector<char32_t> buffer;
+	JSONWriter<char32_t>(buffer, p_indent, p_sort_keys).write(p_var, 0, p_full_precision);
 	String result;
-	HashSet<const void *> markers;
-	_stringify(result, p_var, p_indent, 0, p_sort_keys, markers, p_full_precision);
+	result.append_utf32(Span(buffer.ptr(), buffer.size()));
+	return result;
+}
+
+void JSON::stringify_utf8(const Variant &p_var, LocalVector<uint8_t> &r_buffer, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	JSONWriter<uint8_t>(r_buffer, p_indent, p_sort_keys).write(p_var, 0, p_full_precision);
+}
+
+Vector<uint8_t> JSON::stringify_to_utf8_buffer(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	LocalVector<uint8_t> buffer;
+	stringify_utf8(p_var, buffer, p_indent, p_sort_keys, p_full_precision);
+	Vector<uint8_t> result;
+	result.resize(buffer.size());
+	if (buffer.size()) {
+		memcpy(result.ptrw(), buffer.ptr(), buffer.size());
+	}
 	return result;
 }
 
@@ -609,6 +1006,8 @@ void JSON::_bind_methods() {
 	ClassDB::bind_static_method("JSON", D_METHOD("stringify", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify, DEFVAL(""), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_static_method("JSON", D_METHOD("parse_string", "json_string"), &JSON::parse_string);
 	ClassDB::bind_method(D_METHOD("parse", "json_text", "keep_text"), &JSON::parse, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("parse_utf8_buffer", "json_buffer"), &JSON::parse_utf8_buffer);
+	ClassDB::bind_static_method("JSON", D_METHOD("stringify_to_utf8_buffer", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify_to_utf8_buffer, DEFVAL(""), DEFVAL(true), DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("get_data"), &JSON::get_data);
 	ClassDB::bind_method(D_METHOD("set_data", "data"), &JSON::set_data);
@@ -1533,7 +1932,13 @@ Ref<Resource> ResourceFormatLoaderJSON::load(const String &p_path, const String
 	Ref<JSON> json;
 	json.instantiate();
 
-	Error err = json->parse(FileAccess::get_file_as_string(p_path), Engine::get_singleton()->is_editor_hint());
+	Error err;
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// Keep the text so it can be edited and saved as is.
+		err = json->parse(FileAccess::get_file_as_string(p_path), true);
+	} else {
+		err = json->parse_utf8_buffer(FileAccess::get_file_as_bytes(p_path));
+	}
 	if (err != OK) {
 		String err_text = "Error parsing JSON file at '" + p_path + "', on line " + itos(json->get_error_line()) + ": " + json->get_error_message();
 
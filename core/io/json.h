@@ -33,50 +33,17 @@
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class JSON : public Resource {
 	GDCLASS(JSON, Resource);
 
-	enum TokenType {
-		TK_CURLY_BRACKET_OPEN,
-		TK_CURLY_BRACKET_CLOSE,
-		TK_BRACKET_OPEN,
-		TK_BRACKET_CLOSE,
-		TK_IDENTIFIER,
-		TK_STRING,
-		TK_NUMBER,
-		TK_COLON,
-		TK_COMMA,
-		TK_EOF,
-		TK_MAX
-	};
-
-	enum Expecting {
-		EXPECT_OBJECT,
-		EXPECT_OBJECT_KEY,
-		EXPECT_COLON,
-		EXPECT_OBJECT_VALUE,
-	};
-
-	struct Token {
-		TokenType type;
-		Variant value;
-	};
-
 	String text;
 	Variant data;
 	String err_str;
 	int err_line = 0;
 
-	static const char *tk_name[];
-
-	static void _add_indent(String &r_result, const String &p_indent, int p_size);
-	static void _stringify(String &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision = false);
-	static Error _get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
 	static Error _parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 	static Variant _from_native(const Variant &p_variant, bool p_full_objects, int p_depth);
@@ -89,7 +56,33 @@ public:
 	Error parse(const String &p_json_string, bool p_keep_text = false);
 	String get_parsed_text() const;
 
+	// Receives the contents of a JSON document while it is parsed, without building a Variant tree.
+	// Returning an error from a callback stops parsing; parse_utf8() then returns that error.
+	class Handler {
+	public:
+		virtual Error null_value() = 0;
+		virtual Error bool_value(bool p_value) = 0;
+		virtual Error number_value(double p_value) = 0;
+		virtual Error string_value(const String &p_value) = 0;
+		virtual Error begin_array() = 0;
+		virtual Error end_array() = 0;
+		virtual Error begin_object() = 0;
+		virtual Error object_key(const String &p_key) = 0;
+		virtual Error end_object() = 0;
+
+		virtual ~Handler() {}
+	};
+
+	Error parse_utf8_buffer(const Vector<uint8_t> &p_json_buffer);
+
+	// Parse UTF-8 input directly, without converting it to a String first.
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Handler &p_handler, String &r_err_str, int &r_err_line);
+
 	static String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	// Appends UTF-8 JSON text to `r_buffer`, which can be reused across calls to avoid reallocating.
+	static void stringify_utf8(const Variant &p_var, LocalVector<uint8_t> &r_buffer, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	static Vector<uint8_t> stringify_to_utf8_buffer(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
 	static Variant parse_string(const String &p_json_string);
 
 	_FORCE_INLINE_ static Variant from_native(const Variant &p_variant, bool p_full_objects = false) {
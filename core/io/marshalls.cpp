@@ -33,6 +33,8 @@
 #include "core/io/resource_loader.h"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/container_type_validate.h"
 
 #include <climits>
@@ -894,10 +896,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				(*r_len) += 4; // Size of count number.
 			}
 
+			// Every element takes at least a header.
+			ERR_FAIL_COND_V(count > len / 4, ERR_INVALID_DATA);
+
 			Array array;
 			if (type.builtin_type != Variant::NIL) {
 				array.set_typed(type);
 			}
+			array.resize(count);
 
 			for (int i = 0; i < count; i++) {
 				int used = 0;
@@ -906,7 +912,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				ERR_FAIL_COND_V_MSG(err != OK, err, "Error when trying to decode Variant.");
 				buf += used;
 				len -= used;
-				array.push_back(elem);
+				array.set(i, elem);
 				if (r_len) {
 					(*r_len) += used;
 				}
@@ -928,10 +934,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				uint8_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = buf[i];
-				}
+				memcpy(data.ptrw(), buf, count);
 			}
 
 			r_variant = data;
@@ -957,10 +960,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				//const int *rbuf = (const int *)buf;
 				data.resize(count);
+#ifdef BIG_ENDIAN_ENABLED
 				int32_t *w = data.ptrw();
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_uint32(&buf[i * 4]);
 				}
+#else
+				memcpy(data.ptrw(), buf, count * 4);
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -981,10 +988,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				//const int *rbuf = (const int *)buf;
 				data.resize(count);
+#ifdef BIG_ENDIAN_ENABLED
 				int64_t *w = data.ptrw();
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_uint64(&buf[i * 8]);
 				}
+#else
+				memcpy(data.ptrw(), buf, count * 8);
+#endif
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -1005,10 +1016,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			if (count) {
 				//const float *rbuf = (const float *)buf;
 				data.resize(count);
+#ifdef BIG_ENDIAN_ENABLED
 				float *w = data.ptrw();
 				for (int32_t i = 0; i < count; i++) {
 					w[i] = decode_float(&buf[i * 4]);
 				}
+#else
+				memcpy(data.ptrw(), buf, count * 4);
+#endif
 			}
 			r_variant = data;
 
@@ -1029,10 +1044,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
+#ifdef BIG_ENDIAN_ENABLED
 				double *w = data.ptrw();
 				for (int64_t i = 0; i < count; i++) {
 					w[i] = decode_double(&buf[i * 8]);
 				}
+#else
+				memcpy(data.ptrw(), buf, count * 8);
+#endif
 			}
 			r_variant = data;
 
@@ -1086,10 +1105,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#if defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(double) * 2 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 1);
 					}
+#endif
 
 					int adv = sizeof(double) * 2 * count;
 
@@ -1111,10 +1134,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
+#if !defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(float) * 2 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 1);
 					}
+#endif
 
 					int adv = sizeof(float) * 2 * count;
 
@@ -1146,11 +1173,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#if defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(double) * 3 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 1);
 						w[i].z = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 2);
 					}
+#endif
 
 					int adv = sizeof(double) * 3 * count;
 
@@ -1172,11 +1203,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
+#if !defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(float) * 3 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 1);
 						w[i].z = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 2);
 					}
+#endif
 
 					int adv = sizeof(float) * 3 * count;
 
@@ -1209,6 +1244,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				carray.resize(count);
 				Color *w = carray.ptrw();
 
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < count; i++) {
 					// Colors should always be in single-precision.
 					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
@@ -1216,6 +1252,9 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
 					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
 				}
+#else
+				memcpy(w, buf, 4 * 4 * count); // Colors should always be in single-precision.
+#endif
 
 				int adv = 4 * 4 * count;
 
@@ -1248,12 +1287,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector4 *w = varray.ptrw();
 
+#if defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(double) * 4 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 0);
 						w[i].y = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 1);
 						w[i].z = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 2);
 						w[i].w = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 3);
 					}
+#endif
 
 					int adv = sizeof(double) * 4 * count;
 
@@ -1275,12 +1318,16 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector4 *w = varray.ptrw();
 
+#if !defined(REAL_T_IS_DOUBLE) && !defined(BIG_ENDIAN_ENABLED)
+					memcpy(w, buf, sizeof(float) * 4 * count);
+#else
 					for (int32_t i = 0; i < count; i++) {
 						w[i].x = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 0);
 						w[i].y = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 1);
 						w[i].z = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 2);
 						w[i].w = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 3);
 					}
+#endif
 
 					int adv = sizeof(float) * 4 * count;
 
@@ -1302,22 +1349,57 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
-static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
-	CharString utf8 = p_string.utf8();
+// Destination of the encoder. Without a buffer it only measures, with `data` it writes to a buffer sized by the
+// caller, and with `growable` it appends to a Vector grown geometrically, so the Variant is only walked once.
+struct VariantWriter {
+	uint8_t *data = nullptr;
+	Vector<uint8_t> *growable = nullptr;
+	int capacity = 0;
+	int64_t length = 0;
+	// Set when `growable` can't hold the Variant, which is then only measured to the end.
+	Error error = OK;
+
+	void _fail_grow() {
+		error = ERR_OUT_OF_MEMORY;
+		growable = nullptr;
+		data = nullptr;
+	}
 
-	if (buf) {
-		encode_uint32(utf8.length(), buf);
-		buf += 4;
-		memcpy(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+	void _grow(int64_t p_size) {
+		if (unlikely(p_size > INT_MAX)) {
+			_fail_grow();
+			ERR_FAIL_MSG(vformat("Encoded Variant would need %d bytes, which exceeds the maximum buffer size.", p_size));
+		}
+		const int new_capacity = int(MIN(MAX(int64_t(next_power_of_2(uint64_t(p_size))), int64_t(64)), int64_t(INT_MAX)));
+		if (unlikely(growable->resize(new_capacity) != OK)) {
+			_fail_grow();
+			ERR_FAIL_MSG(vformat("Failed to allocate %d bytes for the encoded Variant.", new_capacity));
+		}
+		data = growable->ptrw();
+		capacity = new_capacity;
 	}
 
-	r_len += 4 + utf8.length();
-	while (r_len % 4) {
-		r_len++; // Pad.
-		if (buf) {
-			*(buf++) = 0;
+	// Reserves `p_size` bytes and returns where to write them, or `nullptr` when measuring.
+	// Sizes are 64-bit so that large packed arrays are rejected by `_grow()` instead of wrapping around.
+	_FORCE_INLINE_ uint8_t *advance(int64_t p_size) {
+		if (growable && unlikely(length + p_size > capacity)) {
+			_grow(length + p_size);
 		}
+		uint8_t *ptr = data ? data + length : nullptr;
+		length += p_size;
+		return ptr;
+	}
+};
+
+static void _encode_string(const String &p_string, VariantWriter &r_writer) {
+	CharString utf8 = p_string.utf8();
+	const int size = utf8.length();
+	const int pad = (4 - size % 4) % 4;
+
+	if (uint8_t *buf = r_writer.advance(4 + int64_t(size) + pad)) {
+		encode_uint32(size, buf);
+		memcpy(buf + 4, utf8.get_data(), size);
+		memset(buf + 4 + size, 0, pad);
 	}
 }
 
@@ -1334,35 +1416,33 @@ static void _encode_container_type_header(const ContainerType &p_type, uint32_t
 	}
 }
 
-static Error _encode_container_type(const ContainerType &p_type, uint8_t *&buf, int &r_len, bool p_full_objects) {
+static Error _encode_container_type(const ContainerType &p_type, VariantWriter &r_writer, bool p_full_objects) {
 	if (p_type.builtin_type != Variant::NIL) {
 		if (p_type.script.is_valid()) {
 			if (p_full_objects) {
 				String path = p_type.script->get_path();
 				ERR_FAIL_COND_V_MSG(path.is_empty() || !path.begins_with("res://"), ERR_UNAVAILABLE, "Failed to encode a path to a custom script for a container type.");
-				_encode_string(path, buf, r_len);
+				_encode_string(path, r_writer);
 			} else {
-				_encode_string(EncodedObjectAsID::get_class_static(), buf, r_len);
+				_encode_string(EncodedObjectAsID::get_class_static(), r_writer);
 			}
 		} else if (p_type.class_name != StringName()) {
-			_encode_string(p_full_objects ? p_type.class_name : EncodedObjectAsID::get_class_static(), buf, r_len);
+			_encode_string(p_full_objects ? p_type.class_name : EncodedObjectAsID::get_class_static(), r_writer);
 		} else {
 			// No need to check `p_full_objects` since `class_name` should be non-empty for `builtin_type == Variant::OBJECT`.
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4)) {
 				encode_uint32(p_type.builtin_type, buf);
-				buf += 4;
 			}
-			r_len += 4;
 		}
 	}
 	return OK;
 }
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, int p_depth) {
+static Error _encode_variant(const Variant &p_variant, VariantWriter &r_writer, bool p_full_objects, int p_depth) {
 	ERR_FAIL_COND_V_MSG(p_depth > Variant::MAX_RECURSION_DEPTH, ERR_OUT_OF_MEMORY, "Potential infinite recursion detected. Bailing.");
-	uint8_t *buf = r_buffer;
-
-	r_len = 0;
+	if (unlikely(r_writer.error != OK)) {
+		return r_writer.error;
+	}
 
 	uint32_t header = p_variant.get_type();
 
@@ -1385,10 +1465,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			Object *obj = p_variant.get_validated_object();
 			if (!obj) {
 				// Object is invalid, send a nullptr instead.
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(4)) {
 					encode_uint32(Variant::NIL, buf);
 				}
-				r_len += 4;
 				return OK;
 			}
 
@@ -1428,60 +1507,47 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 	}
 
-	if (buf) {
+	if (uint8_t *buf = r_writer.advance(4)) {
 		encode_uint32(header, buf);
-		buf += 4;
 	}
-	r_len += 4;
 
 	switch (p_variant.get_type()) {
 		case Variant::NIL: {
 			// Nothing to do.
 		} break;
 		case Variant::BOOL: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4)) {
 				encode_uint32(p_variant.operator bool(), buf);
 			}
 
-			r_len += 4;
-
 		} break;
 		case Variant::INT: {
 			if (header & HEADER_DATA_FLAG_64) {
 				// 64 bits.
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(8)) {
 					encode_uint64(p_variant.operator uint64_t(), buf);
 				}
-
-				r_len += 8;
 			} else {
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(4)) {
 					encode_uint32(p_variant.operator uint32_t(), buf);
 				}
-
-				r_len += 4;
 			}
 		} break;
 		case Variant::FLOAT: {
 			if (header & HEADER_DATA_FLAG_64) {
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(8)) {
 					encode_double(p_variant.operator double(), buf);
 				}
-
-				r_len += 8;
-
 			} else {
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(4)) {
 					encode_float(p_variant.operator float(), buf);
 				}
-
-				r_len += 4;
 			}
 
 		} break;
 		case Variant::NODE_PATH: {
 			NodePath np = p_variant;
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(12)) {
 				encode_uint32(uint32_t(np.get_name_count()) | 0x80000000, buf); // For compatibility with the old format.
 				encode_uint32(np.get_subname_count(), buf + 4);
 				uint32_t np_flags = 0;
@@ -1490,115 +1556,85 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 
 				encode_uint32(np_flags, buf + 8);
-
-				buf += 12;
 			}
 
-			r_len += 12;
-
 			int total = np.get_name_count() + np.get_subname_count();
 
 			for (int i = 0; i < total; i++) {
-				String str;
-
 				if (i < np.get_name_count()) {
-					str = np.get_name(i);
+					_encode_string(np.get_name(i), r_writer);
 				} else {
-					str = np.get_subname(i - np.get_name_count());
+					_encode_string(np.get_subname(i - np.get_name_count()), r_writer);
 				}
-
-				CharString utf8 = str.utf8();
-
-				int pad = 0;
-
-				if (utf8.length() % 4) {
-					pad = 4 - utf8.length() % 4;
-				}
-
-				if (buf) {
-					encode_uint32(utf8.length(), buf);
-					buf += 4;
-					memcpy(buf, utf8.get_data(), utf8.length());
-					buf += pad + utf8.length();
-				}
-
-				r_len += 4 + utf8.length() + pad;
 			}
 
 		} break;
-		case Variant::STRING:
+		case Variant::STRING: {
+			_encode_string(p_variant, r_writer);
+
+		} break;
 		case Variant::STRING_NAME: {
-			_encode_string(p_variant, buf, r_len);
+			_encode_string(p_variant, r_writer);
 
 		} break;
 
 		// Math types.
 		case Variant::VECTOR2: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(2 * sizeof(real_t))) {
 				Vector2 v2 = p_variant;
 				encode_real(v2.x, &buf[0]);
 				encode_real(v2.y, &buf[sizeof(real_t)]);
 			}
 
-			r_len += 2 * sizeof(real_t);
-
 		} break;
 		case Variant::VECTOR2I: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(2 * 4)) {
 				Vector2i v2 = p_variant;
 				encode_uint32(v2.x, &buf[0]);
 				encode_uint32(v2.y, &buf[4]);
 			}
 
-			r_len += 2 * 4;
-
 		} break;
 		case Variant::RECT2: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * sizeof(real_t))) {
 				Rect2 r2 = p_variant;
 				encode_real(r2.position.x, &buf[0]);
 				encode_real(r2.position.y, &buf[sizeof(real_t)]);
 				encode_real(r2.size.x, &buf[sizeof(real_t) * 2]);
 				encode_real(r2.size.y, &buf[sizeof(real_t) * 3]);
 			}
-			r_len += 4 * sizeof(real_t);
 
 		} break;
 		case Variant::RECT2I: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * 4)) {
 				Rect2i r2 = p_variant;
 				encode_uint32(r2.position.x, &buf[0]);
 				encode_uint32(r2.position.y, &buf[4]);
 				encode_uint32(r2.size.x, &buf[8]);
 				encode_uint32(r2.size.y, &buf[12]);
 			}
-			r_len += 4 * 4;
 
 		} break;
 		case Variant::VECTOR3: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(3 * sizeof(real_t))) {
 				Vector3 v3 = p_variant;
 				encode_real(v3.x, &buf[0]);
 				encode_real(v3.y, &buf[sizeof(real_t)]);
 				encode_real(v3.z, &buf[sizeof(real_t) * 2]);
 			}
 
-			r_len += 3 * sizeof(real_t);
-
 		} break;
 		case Variant::VECTOR3I: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(3 * 4)) {
 				Vector3i v3 = p_variant;
 				encode_uint32(v3.x, &buf[0]);
 				encode_uint32(v3.y, &buf[4]);
 				encode_uint32(v3.z, &buf[8]);
 			}
 
-			r_len += 3 * 4;
-
 		} break;
 		case Variant::TRANSFORM2D: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(6 * sizeof(real_t))) {
 				Transform2D val = p_variant;
 				for (int i = 0; i < 3; i++) {
 					for (int j = 0; j < 2; j++) {
@@ -1607,11 +1643,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 			}
 
-			r_len += 6 * sizeof(real_t);
-
 		} break;
 		case Variant::VECTOR4: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * sizeof(real_t))) {
 				Vector4 v4 = p_variant;
 				encode_real(v4.x, &buf[0]);
 				encode_real(v4.y, &buf[sizeof(real_t)]);
@@ -1619,11 +1653,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_real(v4.w, &buf[sizeof(real_t) * 3]);
 			}
 
-			r_len += 4 * sizeof(real_t);
-
 		} break;
 		case Variant::VECTOR4I: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * 4)) {
 				Vector4i v4 = p_variant;
 				encode_uint32(v4.x, &buf[0]);
 				encode_uint32(v4.y, &buf[4]);
@@ -1631,11 +1663,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_uint32(v4.w, &buf[12]);
 			}
 
-			r_len += 4 * 4;
-
 		} break;
 		case Variant::PLANE: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * sizeof(real_t))) {
 				Plane p = p_variant;
 				encode_real(p.normal.x, &buf[0]);
 				encode_real(p.normal.y, &buf[sizeof(real_t)]);
@@ -1643,11 +1673,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_real(p.d, &buf[sizeof(real_t) * 3]);
 			}
 
-			r_len += 4 * sizeof(real_t);
-
 		} break;
 		case Variant::QUATERNION: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * sizeof(real_t))) {
 				Quaternion q = p_variant;
 				encode_real(q.x, &buf[0]);
 				encode_real(q.y, &buf[sizeof(real_t)]);
@@ -1655,11 +1683,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_real(q.w, &buf[sizeof(real_t) * 3]);
 			}
 
-			r_len += 4 * sizeof(real_t);
-
 		} break;
 		case Variant::AABB: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(6 * sizeof(real_t))) {
 				AABB aabb = p_variant;
 				encode_real(aabb.position.x, &buf[0]);
 				encode_real(aabb.position.y, &buf[sizeof(real_t)]);
@@ -1669,11 +1695,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_real(aabb.size.z, &buf[sizeof(real_t) * 5]);
 			}
 
-			r_len += 6 * sizeof(real_t);
-
 		} break;
 		case Variant::BASIS: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(9 * sizeof(real_t))) {
 				Basis val = p_variant;
 				for (int i = 0; i < 3; i++) {
 					for (int j = 0; j < 3; j++) {
@@ -1682,11 +1706,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 			}
 
-			r_len += 9 * sizeof(real_t);
-
 		} break;
 		case Variant::TRANSFORM3D: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(12 * sizeof(real_t))) {
 				Transform3D val = p_variant;
 				for (int i = 0; i < 3; i++) {
 					for (int j = 0; j < 3; j++) {
@@ -1699,11 +1721,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_real(val.origin.z, &buf[sizeof(real_t) * 11]);
 			}
 
-			r_len += 12 * sizeof(real_t);
-
 		} break;
 		case Variant::PROJECTION: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(16 * sizeof(real_t))) {
 				Projection val = p_variant;
 				for (int i = 0; i < 4; i++) {
 					for (int j = 0; j < 4; j++) {
@@ -1712,13 +1732,11 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				}
 			}
 
-			r_len += 16 * sizeof(real_t);
-
 		} break;
 
 		// Misc types.
 		case Variant::COLOR: {
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 * 4)) { // Colors should always be in single-precision.
 				Color c = p_variant;
 				encode_float(c.r, &buf[0]);
 				encode_float(c.g, &buf[4]);
@@ -1726,30 +1744,26 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 				encode_float(c.a, &buf[12]);
 			}
 
-			r_len += 4 * 4; // Colors should always be in single-precision.
-
 		} break;
 		case Variant::RID: {
 			RID rid = p_variant;
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(8)) {
 				encode_uint64(rid.get_id(), buf);
 			}
-			r_len += 8;
 		} break;
 		case Variant::OBJECT: {
 			if (p_full_objects) {
 				Object *obj = p_variant;
 				if (!obj) {
-					if (buf) {
+					if (uint8_t *buf = r_writer.advance(4)) {
 						encode_uint32(0, buf);
 					}
-					r_len += 4;
 
 				} else {
 					ERR_FAIL_COND_V(!ClassDB::can_instantiate(obj->get_class()), ERR_INVALID_PARAMETER);
 
-					_encode_string(obj->get_class(), buf, r_len);
+					_encode_string(obj->get_class(), r_writer);
 
 					List<PropertyInfo> props;
 					obj->get_property_list(&props);
@@ -1762,19 +1776,16 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						pc++;
 					}
 
-					if (buf) {
+					if (uint8_t *buf = r_writer.advance(4)) {
 						encode_uint32(pc, buf);
-						buf += 4;
 					}
 
-					r_len += 4;
-
 					for (const PropertyInfo &E : props) {
 						if (!(E.usage & PROPERTY_USAGE_STORAGE)) {
 							continue;
 						}
 
-						_encode_string(E.name, buf, r_len);
+						_encode_string(E.name, r_writer);
 
 						Variant value;
 
@@ -1789,18 +1800,12 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 							value = obj->get(E.name);
 						}
 
-						int len;
-						Error err = encode_variant(value, buf, len, p_full_objects, p_depth + 1);
+						Error err = _encode_variant(value, r_writer, p_full_objects, p_depth + 1);
 						ERR_FAIL_COND_V(err, err);
-						ERR_FAIL_COND_V(len % 4, ERR_BUG);
-						r_len += len;
-						if (buf) {
-							buf += len;
-						}
 					}
 				}
 			} else {
-				if (buf) {
+				if (uint8_t *buf = r_writer.advance(8)) {
 					Object *obj = p_variant.get_validated_object();
 					ObjectID id;
 					if (obj) {
@@ -1809,8 +1814,6 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 					encode_uint64(id, buf);
 				}
-
-				r_len += 8;
 			}
 
 		} break;
@@ -1819,52 +1822,38 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		case Variant::SIGNAL: {
 			Signal signal = p_variant;
 
-			_encode_string(signal.get_name(), buf, r_len);
+			_encode_string(signal.get_name(), r_writer);
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(8)) {
 				encode_uint64(signal.get_object_id(), buf);
 			}
-			r_len += 8;
 		} break;
 		case Variant::DICTIONARY: {
 			const Dictionary dict = p_variant;
 
 			{
-				Error err = _encode_container_type(dict.get_key_type(), buf, r_len, p_full_objects);
+				Error err = _encode_container_type(dict.get_key_type(), r_writer, p_full_objects);
 				if (err) {
 					return err;
 				}
 			}
 
 			{
-				Error err = _encode_container_type(dict.get_value_type(), buf, r_len, p_full_objects);
+				Error err = _encode_container_type(dict.get_value_type(), r_writer, p_full_objects);
 				if (err) {
 					return err;
 				}
 			}
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4)) {
 				encode_uint32(uint32_t(dict.size()), buf);
-				buf += 4;
 			}
-			r_len += 4;
 
 			for (const KeyValue<Variant, Variant> &kv : dict) {
-				int len;
-				Error err = encode_variant(kv.key, buf, len, p_full_objects, p_depth + 1);
+				Error err = _encode_variant(kv.key, r_writer, p_full_objects, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf) {
-					buf += len;
-				}
-				err = encode_variant(kv.value, buf, len, p_full_objects, p_depth + 1);
+				err = _encode_variant(kv.value, r_writer, p_full_objects, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf) {
-					buf += len;
-				}
 			}
 
 		} break;
@@ -1872,53 +1861,37 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			const Array array = p_variant;
 
 			{
-				Error err = _encode_container_type(array.get_element_type(), buf, r_len, p_full_objects);
+				Error err = _encode_container_type(array.get_element_type(), r_writer, p_full_objects);
 				if (err) {
 					return err;
 				}
 			}
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4)) {
 				encode_uint32(uint32_t(array.size()), buf);
-				buf += 4;
 			}
-			r_len += 4;
 
 			for (const Variant &elem : array) {
-				int len;
-				Error err = encode_variant(elem, buf, len, p_full_objects, p_depth + 1);
+				Error err = _encode_variant(elem, r_writer, p_full_objects, p_depth + 1);
 				ERR_FAIL_COND_V(err, err);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				if (buf) {
-					buf += len;
-				}
-				r_len += len;
 			}
 
 		} break;
 
 		// Packed arrays.
+		// Their wire layout is the little-endian memory layout of the element type, so on little-endian hosts
+		// the elements are copied in bulk.
 		case Variant::PACKED_BYTE_ARRAY: {
 			Vector<uint8_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(uint8_t);
+			int pad = (4 - datalen % 4) % 4;
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(datalen) + pad)) {
 				encode_uint32(datalen, buf);
-				buf += 4;
-				const uint8_t *r = data.ptr();
-				if (r) {
-					memcpy(buf, &r[0], datalen * datasize);
-					buf += datalen * datasize;
-				}
-			}
-
-			r_len += 4 + datalen * datasize;
-			while (r_len % 4) {
-				r_len++;
-				if (buf) {
-					*(buf++) = 0;
+				if (datalen) {
+					memcpy(buf + 4, data.ptr(), datalen);
 				}
+				memset(buf + 4 + datalen, 0, pad);
 			}
 
 		} break;
@@ -1927,96 +1900,102 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			int datalen = data.size();
 			int datasize = sizeof(int32_t);
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(datalen) * datasize)) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int32_t *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int32_t i = 0; i < datalen; i++) {
 					encode_uint32(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_INT64_ARRAY: {
 			Vector<int64_t> data = p_variant;
 			int datalen = data.size();
 			int datasize = sizeof(int64_t);
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(datalen) * datasize)) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const int64_t *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int64_t i = 0; i < datalen; i++) {
 					encode_uint64(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_FLOAT32_ARRAY: {
 			Vector<float> data = p_variant;
 			int datalen = data.size();
 			int datasize = sizeof(float);
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(datalen) * datasize)) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const float *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < datalen; i++) {
 					encode_float(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_FLOAT64_ARRAY: {
 			Vector<double> data = p_variant;
 			int datalen = data.size();
 			int datasize = sizeof(double);
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(datalen) * datasize)) {
 				encode_uint32(datalen, buf);
 				buf += 4;
 				const double *r = data.ptr();
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < datalen; i++) {
 					encode_double(r[i], &buf[i * datasize]);
 				}
+#else
+				if (datalen) {
+					memcpy(buf, r, datalen * datasize);
+				}
+#endif
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::PACKED_STRING_ARRAY: {
 			Vector<String> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4)) {
 				encode_uint32(len, buf);
-				buf += 4;
 			}
 
-			r_len += 4;
-
 			for (int i = 0; i < len; i++) {
 				CharString utf8 = data.get(i).utf8();
+				const int size = utf8.length() + 1;
+				const int pad = (4 - size % 4) % 4;
 
-				if (buf) {
-					encode_uint32(utf8.length() + 1, buf);
-					buf += 4;
-					memcpy(buf, utf8.get_data(), utf8.length() + 1);
-					buf += utf8.length() + 1;
-				}
-
-				r_len += 4 + utf8.length() + 1;
-				while (r_len % 4) {
-					r_len++; // Pad.
-					if (buf) {
-						*(buf++) = 0;
-					}
+				if (uint8_t *buf = r_writer.advance(4 + int64_t(size) + pad)) {
+					encode_uint32(size, buf);
+					memcpy(buf + 4, utf8.get_data(), size);
+					memset(buf + 4 + size, 0, pad);
 				}
 			}
 
@@ -2025,14 +2004,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			Vector<Vector2> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(sizeof(real_t)) * 2 * len)) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < len; i++) {
 					Vector2 v = data.get(i);
 
@@ -2040,23 +2015,23 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_real(v.y, &buf[sizeof(real_t)]);
 					buf += sizeof(real_t) * 2;
 				}
+#else
+				static_assert(sizeof(Vector2) == sizeof(real_t) * 2);
+				if (len) {
+					memcpy(buf, data.ptr(), sizeof(real_t) * 2 * len);
+				}
+#endif
 			}
 
-			r_len += sizeof(real_t) * 2 * len;
-
 		} break;
 		case Variant::PACKED_VECTOR3_ARRAY: {
 			Vector<Vector3> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(sizeof(real_t)) * 3 * len)) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < len; i++) {
 					Vector3 v = data.get(i);
 
@@ -2065,23 +2040,23 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_real(v.z, &buf[sizeof(real_t) * 2]);
 					buf += sizeof(real_t) * 3;
 				}
+#else
+				static_assert(sizeof(Vector3) == sizeof(real_t) * 3);
+				if (len) {
+					memcpy(buf, data.ptr(), sizeof(real_t) * 3 * len);
+				}
+#endif
 			}
 
-			r_len += sizeof(real_t) * 3 * len;
-
 		} break;
 		case Variant::PACKED_COLOR_ARRAY: {
 			Vector<Color> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(4 * 4) * len)) { // Colors should always be in single-precision.
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < len; i++) {
 					Color c = data.get(i);
 
@@ -2089,25 +2064,25 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_float(c.g, &buf[4]);
 					encode_float(c.b, &buf[8]);
 					encode_float(c.a, &buf[12]);
-					buf += 4 * 4; // Colors should always be in single-precision.
+					buf += 4 * 4;
 				}
+#else
+				static_assert(sizeof(Color) == 4 * 4);
+				if (len) {
+					memcpy(buf, data.ptr(), 4 * 4 * len);
+				}
+#endif
 			}
 
-			r_len += 4 * 4 * len;
-
 		} break;
 		case Variant::PACKED_VECTOR4_ARRAY: {
 			Vector<Vector4> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
+			if (uint8_t *buf = r_writer.advance(4 + int64_t(sizeof(real_t)) * 4 * len)) {
 				encode_uint32(len, buf);
 				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
+#ifdef BIG_ENDIAN_ENABLED
 				for (int i = 0; i < len; i++) {
 					Vector4 v = data.get(i);
 
@@ -2117,17 +2092,43 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 					encode_real(v.w, &buf[sizeof(real_t) * 3]);
 					buf += sizeof(real_t) * 4;
 				}
+#else
+				static_assert(sizeof(Vector4) == sizeof(real_t) * 4);
+				if (len) {
+					memcpy(buf, data.ptr(), sizeof(real_t) * 4 * len);
+				}
+#endif
 			}
 
-			r_len += sizeof(real_t) * 4 * len;
-
 		} break;
 		default: {
 			ERR_FAIL_V(ERR_BUG);
 		}
 	}
 
-	return OK;
+	return r_writer.error;
+}
+
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects, int p_depth) {
+	VariantWriter writer;
+	writer.data = r_buffer;
+	Error err = _encode_variant(p_variant, writer, p_full_objects, p_depth);
+	ERR_FAIL_COND_V_MSG(err == OK && writer.length > INT_MAX, ERR_OUT_OF_MEMORY, "Encoded Variant exceeds the maximum buffer size.");
+	r_len = int(writer.length);
+	return err;
+}
+
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, bool p_full_objects) {
+	const int base_size = r_buffer.size();
+	VariantWriter writer;
+	writer.growable = &r_buffer;
+	writer.capacity = r_buffer.size();
+	writer.length = r_buffer.size();
+	writer.data = writer.length ? r_buffer.ptrw() : nullptr;
+	Error err = _encode_variant(p_variant, writer, p_full_objects, 0);
+	// On failure the buffer is left as it was before encoding.
+	r_buffer.resize(err == OK ? int(writer.length) : base_size);
+	return err;
 }
 
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count) {
@@ -223,5 +223,7 @@ public:
 
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = nullptr, bool p_allow_objects = false, int p_depth = 0);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false, int p_depth = 0);
+// Appends the encoded variant to `r_buffer` in a single pass.
+Error encode_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, bool p_full_objects = false);
 
 Vector<float> vector3_to_float32_array(const Vector3 *vecs, size_t count);
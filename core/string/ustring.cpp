@@ -53,8 +53,140 @@
 #define snprintf _snprintf_s
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SSE2_ENABLED
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define STRING_NEON_ENABLED
+#include <arm_neon.h>
+#endif
+
 static const int MAX_DECIMALS = 32;
 
+// The helpers below process 8 characters per iteration with SIMD where available
+// and let a scalar loop finish the remainder (or the block where the scan stopped).
+
+// Returns the index of the first `p_char` in `p_str`, or -1.
+static _FORCE_INLINE_ int _find_char32(const char32_t *p_str, int p_len, char32_t p_char) {
+	int i = 0;
+#if defined(STRING_SSE2_ENABLED)
+	const __m128i needle = _mm_set1_epi32((int32_t)p_char);
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(p_str + i));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi32(a, needle), _mm_cmpeq_epi32(b, needle)))) {
+			break;
+		}
+	}
+#elif defined(STRING_NEON_ENABLED)
+	const uint32x4_t needle = vdupq_n_u32(p_char);
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32x4_t a = vld1q_u32((const uint32_t *)(p_str + i));
+		const uint32x4_t b = vld1q_u32((const uint32_t *)(p_str + i + 4));
+		if (vmaxvq_u32(vorrq_u32(vceqq_u32(a, needle), vceqq_u32(b, needle)))) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Returns how many leading characters of `p_str` are ASCII.
+static _FORCE_INLINE_ int _ascii_prefix_length(const char32_t *p_str, int p_len) {
+	int i = 0;
+#if defined(STRING_SSE2_ENABLED)
+	const __m128i non_ascii = _mm_set1_epi32(~0x7f);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(p_str + i));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(a, b), non_ascii), zero)) != 0xffff) {
+			break;
+		}
+	}
+#elif defined(STRING_NEON_ENABLED)
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32x4_t a = vld1q_u32((const uint32_t *)(p_str + i));
+		const uint32x4_t b = vld1q_u32((const uint32_t *)(p_str + i + 4));
+		if (vmaxvq_u32(vorrq_u32(a, b)) > 0x7f) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && p_str[i] <= 0x7f) {
+		i++;
+	}
+	return i;
+}
+
+// Narrows `p_len` ASCII characters to bytes.
+static _FORCE_INLINE_ void _narrow_ascii(uint8_t *p_dst, const char32_t *p_src, int p_len) {
+	int i = 0;
+#if defined(STRING_SSE2_ENABLED)
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(p_src + i));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(p_src + i + 4));
+		const __m128i c = _mm_loadu_si128((const __m128i *)(p_src + i + 8));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(p_src + i + 12));
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+	}
+#elif defined(STRING_NEON_ENABLED)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint16x8_t ab = vcombine_u16(vmovn_u32(vld1q_u32((const uint32_t *)(p_src + i))), vmovn_u32(vld1q_u32((const uint32_t *)(p_src + i + 4))));
+		const uint16x8_t cd = vcombine_u16(vmovn_u32(vld1q_u32((const uint32_t *)(p_src + i + 8))), vmovn_u32(vld1q_u32((const uint32_t *)(p_src + i + 12))));
+		vst1q_u8(p_dst + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = (uint8_t)p_src[i];
+	}
+}
+
+// Returns how many leading characters of `p_str` are valid Unicode scalar values,
+// i.e. can be copied as they are by `append_utf32()`.
+static _FORCE_INLINE_ int _valid_utf32_prefix_length(const char32_t *p_str, int p_len) {
+	int i = 0;
+#if defined(STRING_SSE2_ENABLED)
+	const __m128i surrogate_mask = _mm_set1_epi32((int32_t)0xfffff800);
+	const __m128i surrogate = _mm_set1_epi32(0xd800);
+	const __m128i max_plane = _mm_set1_epi32(0x10);
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i a = _mm_loadu_si128((const __m128i *)(p_str + i));
+		const __m128i b = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+		// Anything above 0x10ffff has a plane above 0x10, the logical shift keeps the compare in signed range.
+		const __m128i invalid = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(a, surrogate_mask), surrogate), _mm_cmpeq_epi32(_mm_and_si128(b, surrogate_mask), surrogate)),
+				_mm_or_si128(_mm_cmpgt_epi32(_mm_srli_epi32(a, 16), max_plane), _mm_cmpgt_epi32(_mm_srli_epi32(b, 16), max_plane)));
+		if (_mm_movemask_epi8(invalid)) {
+			break;
+		}
+	}
+#elif defined(STRING_NEON_ENABLED)
+	const uint32x4_t surrogate_mask = vdupq_n_u32(0xfffff800);
+	const uint32x4_t surrogate = vdupq_n_u32(0xd800);
+	const uint32x4_t max_char = vdupq_n_u32(0x10ffff);
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32x4_t a = vld1q_u32((const uint32_t *)(p_str + i));
+		const uint32x4_t b = vld1q_u32((const uint32_t *)(p_str + i + 4));
+		const uint32x4_t invalid = vorrq_u32(
+				vorrq_u32(vceqq_u32(vandq_u32(a, surrogate_mask), surrogate), vceqq_u32(vandq_u32(b, surrogate_mask), surrogate)),
+				vorrq_u32(vcgtq_u32(a, max_char), vcgtq_u32(b, max_char)));
+		if (vmaxvq_u32(invalid)) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && (p_str[i] & 0xfffff800) != 0xd800 && p_str[i] <= 0x10ffff) {
+		i++;
+	}
+	return i;
+}
+
 static _FORCE_INLINE_ char32_t lower_case(char32_t c) {
 	return (is_ascii_upper_case(c) ? (c + ('a' - 'A')) : c);
 }
@@ -199,7 +331,13 @@ void String::append_utf32(const Span<char32_t> &p_cstr) {
 	const char32_t *end = p_cstr.ptr() + p_cstr.size();
 	char32_t *dst = ptrw() + prev_length;
 
-	// Copy the string, and check for UTF-32 problems.
+	// Copy the valid prefix at once, it is usually the whole string.
+	const int valid_length = _valid_utf32_prefix_length(src, p_cstr.size());
+	memcpy(dst, src, valid_length * sizeof(char32_t));
+	src += valid_length;
+	dst += valid_length;
+
+	// Copy the rest, and check for UTF-32 problems.
 	for (; src < end; ++src, ++dst) {
 		const char32_t chr = *src;
 		if ((chr & 0xfffff800) == 0xd800) {
@@ -1964,8 +2102,15 @@ CharString String::utf8(Vector<uint8_t> *r_ch_length_map) const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+
+	// Most strings start with (or are entirely) ASCII, which maps to UTF-8 one to one.
+	const int ascii_length = _ascii_prefix_length(d, l);
+	if (map_ptr) {
+		memset(map_ptr, 1, ascii_length);
+	}
+
+	int fl = ascii_length;
+	for (int i = ascii_length; i < l; i++) {
 		uint32_t c = d[i];
 		int ch_w = 1;
 		if (c <= 0x7f) { // 7 bits.
@@ -2000,9 +2145,12 @@ CharString String::utf8(Vector<uint8_t> *r_ch_length_map) const {
 	utf8s.resize(fl + 1);
 	uint8_t *cdst = (uint8_t *)utf8s.get_data();
 
+	_narrow_ascii(cdst, d, ascii_length);
+	cdst += ascii_length;
+
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	for (int i = ascii_length; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
@@ -3087,24 +3235,16 @@ int String::find(const String &p_str, int p_from) const {
 
 	const char32_t *src = get_data();
 	const char32_t *str = p_str.get_data();
+	const int last = len - src_len;
 
-	for (int i = p_from; i <= (len - src_len); i++) {
-		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
-				found = false;
-				break;
-			}
+	// Jump between occurrences of the first character, then compare the rest.
+	for (int i = p_from; i <= last; i++) {
+		const int skip = _find_char32(src + i, last - i + 1, str[0]);
+		if (skip < 0) {
+			return -1;
 		}
-
-		if (found) {
+		i += skip;
+		if (memcmp(src + i + 1, str + 1, (src_len - 1) * sizeof(char32_t)) == 0) {
 			return i;
 		}
 	}
@@ -3130,37 +3270,26 @@ int String::find(const char *p_str, int p_from) const {
 	}
 
 	const char32_t *src = get_data();
+	const int last = len - src_len;
+	const char32_t first = (char32_t)p_str[0];
 
-	if (src_len == 1) {
-		const char32_t needle = p_str[0];
-
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
+	// Jump between occurrences of the first character, then compare the rest.
+	for (int i = p_from; i <= last; i++) {
+		const int skip = _find_char32(src + i, last - i + 1, first);
+		if (skip < 0) {
+			return -1;
 		}
-
-	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
-			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
-
-				if (src[read_pos] != (char32_t)p_str[j]) {
-					found = false;
-					break;
-				}
-			}
-
-			if (found) {
-				return i;
+		i += skip;
+		bool found = true;
+		for (int j = 1; j < src_len; j++) {
+			if (src[i + j] != (char32_t)p_str[j]) {
+				found = false;
+				break;
 			}
 		}
+		if (found) {
+			return i;
+		}
 	}
 
 	return -1;
@@ -3173,7 +3302,8 @@ int String::find_char(char32_t p_char, int p_from) const {
 	if (p_from < 0 || p_from >= length()) {
 		return -1;
 	}
-	return span().find(p_char, p_from);
+	const int found = _find_char32(get_data() + p_from, length() - p_from, p_char);
+	return found < 0 ? -1 : p_from + found;
 }
 
 int String::findmk(const Vector<String> &p_keys, int p_from, int *r_key) const {
@@ -31,8 +31,13 @@
 #include "command_queue_mt.h"
 
 CommandQueueMT::CommandQueueMT() {
-	command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	for (Run *run : runs) {
+		memdelete(run);
+	}
+	for (Run *run : free_runs) {
+		memdelete(run);
+	}
 }
@@ -33,6 +33,7 @@
 #include "core/object/worker_thread_pool.h"
 #include "core/os/condition_variable.h"
 #include "core/os/mutex.h"
+#include "core/os/thread.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/simple_type.h"
 #include "core/templates/tuple.h"
@@ -104,103 +105,207 @@ class CommandQueueMT {
 	/***** BASE *******/
 
 	static const uint32_t DEFAULT_COMMAND_MEM_SIZE_KB = 64;
+	static const uint32_t SEGMENT_COUNT = 32;
+
+	// Every command is stored as [ticket][size][command].
+	static const uint32_t COMMAND_HEADER_SIZE = sizeof(uint64_t) * 2;
+
+	// Producers append to the segment of their thread, so pushing from several threads
+	// at once doesn't serialize on a single lock. Each command takes a ticket from a
+	// queue-wide counter while its segment is locked, which lets the consumer merge the
+	// segments back in the exact order the commands were pushed.
+	struct Segment {
+		BinaryMutex mutex;
+		LocalVector<uint8_t> command_mem;
+	};
+
+	// Commands taken out of a segment, waiting to be executed by the consumer.
+	struct Run {
+		LocalVector<uint8_t> command_mem;
+		uint64_t read_ptr = 0;
+	};
+
+	Segment segments[SEGMENT_COUNT];
+	std::atomic<uint32_t> dirty_segments{ 0 };
+	std::atomic<uint64_t> next_ticket{ 0 };
 
 	BinaryMutex mutex;
-	LocalVector<uint8_t> command_mem;
+	LocalVector<Run *> runs;
+	LocalVector<Run *> free_runs;
+	// Set while a thread is flushing. The flushing thread may release the mutex while a
+	// command runs (unlock allowance), so other threads check this to not flush in between.
+	std::atomic<bool> flushing{ false };
+
+	BinaryMutex sync_mutex;
 	ConditionVariable sync_cond_var;
-	uint32_t sync_head = 0;
-	uint32_t sync_tail = 0;
-	uint32_t sync_awaiters = 0;
-	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
-	uint64_t flush_read_ptr = 0;
+	uint64_t synced_ticket = 0;
+
+	std::atomic<WorkerThreadPool::TaskID> pump_task_id{ WorkerThreadPool::INVALID_TASK_ID };
 	std::atomic<bool> pending{ false };
 
+	std::atomic<uint64_t> executed_commands{ 0 };
+	std::atomic<uint32_t> last_flush_command_count{ 0 };
+	std::atomic<uint64_t> last_flush_bytes{ 0 };
+
 	template <typename T, typename... Args>
-	_FORCE_INLINE_ void create_command(Args &&...p_args) {
+	_FORCE_INLINE_ static void create_command(LocalVector<uint8_t> &p_command_mem, uint64_t p_ticket, Args &&...p_args) {
 		// alloc size is size+T+safeguard
 		constexpr uint64_t alloc_size = ((sizeof(T) + 8U - 1U) & ~(8U - 1U));
 		static_assert(alloc_size < UINT32_MAX, "Type too large to fit in the command queue.");
 
-		uint64_t size = command_mem.size();
-		command_mem.resize(size + alloc_size + sizeof(uint64_t));
-		*(uint64_t *)&command_mem[size] = alloc_size;
-		void *cmd = &command_mem[size + sizeof(uint64_t)];
+		uint64_t size = p_command_mem.size();
+		p_command_mem.resize(size + COMMAND_HEADER_SIZE + alloc_size);
+		*(uint64_t *)&p_command_mem[size] = p_ticket;
+		*(uint64_t *)&p_command_mem[size + sizeof(uint64_t)] = alloc_size;
+		void *cmd = &p_command_mem[size + COMMAND_HEADER_SIZE];
 		new (cmd) T(std::forward<Args>(p_args)...);
-		pending.store(true);
 	}
 
 	template <typename T, bool NeedsSync, typename... Args>
 	_FORCE_INLINE_ void _push_internal(Args &&...args) {
-		MutexLock mlock(mutex);
-		create_command<T>(std::forward<Args>(args)...);
+		uint32_t segment_index = Thread::get_caller_id() % SEGMENT_COUNT;
+		Segment &segment = segments[segment_index];
+		uint64_t ticket;
+		{
+			MutexLock lock(segment.mutex);
+			if (segment.command_mem.is_empty()) {
+				// Must be visible before the ticket is taken, see _flush().
+				dirty_segments.fetch_or(1U << segment_index);
+			}
+			ticket = next_ticket.fetch_add(1);
+			create_command<T>(segment.command_mem, ticket, std::forward<Args>(args)...);
+		}
+		pending.store(true);
 
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);
+		WorkerThreadPool::TaskID pump_task = pump_task_id.load();
+		if (pump_task != WorkerThreadPool::INVALID_TASK_ID) {
+			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task);
 		}
 
 		if constexpr (NeedsSync) {
-			sync_tail++;
-			_wait_for_sync(mlock);
+			_wait_for_sync(ticket);
 		}
 	}
 
-	_FORCE_INLINE_ void _prevent_sync_wraparound() {
-		bool safe_to_reset = !sync_awaiters;
-		bool already_sync_to_latest = sync_head == sync_tail;
-		if (safe_to_reset && already_sync_to_latest) {
-			sync_head = 0;
-			sync_tail = 0;
+	_FORCE_INLINE_ void _collect_segments(uint32_t p_dirty) {
+		for (uint32_t i = 0; i < SEGMENT_COUNT && p_dirty; i++) {
+			if (!(p_dirty & (1U << i))) {
+				continue;
+			}
+			p_dirty &= ~(1U << i);
+
+			Run *run;
+			if (free_runs.is_empty()) {
+				run = memnew(Run);
+				run->command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
+			} else {
+				run = free_runs[free_runs.size() - 1];
+				free_runs.resize(free_runs.size() - 1);
+			}
+
+			{
+				// Hand the (empty, preallocated) buffer of the run to the segment.
+				MutexLock lock(segments[i].mutex);
+				LocalVector<uint8_t> command_mem = std::move(segments[i].command_mem);
+				segments[i].command_mem = std::move(run->command_mem);
+				run->command_mem = std::move(command_mem);
+			}
+			run->read_ptr = 0;
+			runs.push_back(run);
 		}
 	}
 
 	void _flush() {
-		if (unlikely(flush_read_ptr)) {
-			// Re-entrant call.
+		if (unlikely(flushing.load())) {
+			// Re-entrant call, or another thread is flushing.
 			return;
 		}
 
 		MutexLock lock(mutex);
+		if (flushing.exchange(true)) {
+			// Another thread got the mutex first and released it while running a command.
+			return;
+		}
 
-		while (flush_read_ptr < command_mem.size()) {
-			uint64_t size = *(uint64_t *)&command_mem[flush_read_ptr];
-			flush_read_ptr += 8;
-			CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
-			uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(lock);
-			cmd->call();
-			WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
-
-			// Handle potential realloc due to the command and unlock allowance.
-			cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
-
-			if (unlikely(cmd->sync)) {
-				sync_head++;
-				lock.~MutexLock(); // Give an opportunity to awaiters right away.
-				sync_cond_var.notify_all();
-				new (&lock) MutexLock(mutex);
-				// Handle potential realloc happened during unlock.
-				cmd = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
+		uint32_t command_count = 0;
+		uint64_t bytes = 0;
+
+		do {
+			// Any command with a ticket below the cut is guaranteed to be in a segment
+			// flagged as dirty by now, so executing up to the cut never skips one.
+			// Commands past it stay in their run until the next round.
+			uint64_t cut = next_ticket.load();
+			_collect_segments(dirty_segments.exchange(0));
+
+			while (true) {
+				Run *run = nullptr;
+				uint64_t ticket = cut;
+				for (Run *candidate : runs) {
+					if (candidate->read_ptr < candidate->command_mem.size()) {
+						uint64_t candidate_ticket = *(uint64_t *)&candidate->command_mem[candidate->read_ptr];
+						if (candidate_ticket < ticket) {
+							run = candidate;
+							ticket = candidate_ticket;
+						}
+					}
+				}
+				if (!run) {
+					break;
+				}
+
+				uint64_t size = *(uint64_t *)&run->command_mem[run->read_ptr + sizeof(uint64_t)];
+				// Runs are owned by the consumer, commands pushed meanwhile go to the segments,
+				// so the command can't be moved by a realloc while it's executing.
+				CommandBase *cmd = reinterpret_cast<CommandBase *>(&run->command_mem[run->read_ptr + COMMAND_HEADER_SIZE]);
+				uint32_t allowance_id = WorkerThreadPool::thread_enter_unlock_allowance_zone(lock);
+				cmd->call();
+				WorkerThreadPool::thread_exit_unlock_allowance_zone(allowance_id);
+
+				if (unlikely(cmd->sync)) {
+					{
+						MutexLock sync_lock(sync_mutex);
+						synced_ticket = ticket + 1;
+					}
+					sync_cond_var.notify_all();
+				}
+
+				cmd->~CommandBase();
+
+				run->read_ptr += COMMAND_HEADER_SIZE + size;
+				executed_commands.fetch_add(1);
+				command_count++;
+				bytes += COMMAND_HEADER_SIZE + size;
 			}
 
-			cmd->~CommandBase();
+			for (uint32_t i = 0; i < runs.size(); i++) {
+				if (runs[i]->read_ptr == runs[i]->command_mem.size()) {
+					runs[i]->command_mem.clear();
+					free_runs.push_back(runs[i]);
+					runs.remove_at_unordered(i);
+					i--;
+				}
+			}
+		} while (!runs.is_empty() || dirty_segments.load() != 0);
 
-			flush_read_ptr += size;
+		pending.store(false);
+		if (dirty_segments.load() != 0) {
+			// A producer got in after the last round.
+			pending.store(true);
 		}
 
-		command_mem.clear();
-		pending.store(false);
-		flush_read_ptr = 0;
+		if (command_count) {
+			last_flush_command_count.store(command_count);
+			last_flush_bytes.store(bytes);
+		}
 
-		_prevent_sync_wraparound();
+		flushing.store(false);
 	}
 
-	_FORCE_INLINE_ void _wait_for_sync(MutexLock<BinaryMutex> &p_lock) {
-		sync_awaiters++;
-		uint32_t sync_head_goal = sync_tail;
-		do {
-			sync_cond_var.wait(p_lock);
-		} while (sync_head < sync_head_goal);
-		sync_awaiters--;
-		_prevent_sync_wraparound();
+	_FORCE_INLINE_ void _wait_for_sync(uint64_t p_ticket) {
+		MutexLock lock(sync_mutex);
+		while (synced_ticket <= p_ticket) {
+			sync_cond_var.wait(lock);
+		}
 	}
 
 	void _no_op() {}
@@ -242,16 +347,27 @@ public:
 	}
 
 	void wait_and_flush() {
-		ERR_FAIL_COND(pump_task_id == WorkerThreadPool::INVALID_TASK_ID);
-		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id);
+		WorkerThreadPool::TaskID pump_task = pump_task_id.load();
+		ERR_FAIL_COND(pump_task == WorkerThreadPool::INVALID_TASK_ID);
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task);
 		_flush();
 	}
 
 	void set_pump_task_id(WorkerThreadPool::TaskID p_task_id) {
-		MutexLock lock(mutex);
-		pump_task_id = p_task_id;
+		pump_task_id.store(p_task_id);
 	}
 
+	// Number of commands pushed but not executed yet.
+	uint64_t get_pending_command_count() const {
+		uint64_t executed = executed_commands.load();
+		uint64_t pushed = next_ticket.load();
+		return pushed > executed ? pushed - executed : 0;
+	}
+
+	// Size of the last flush that executed any command.
+	uint32_t get_last_flush_command_count() const { return last_flush_command_count.load(); }
+	uint64_t get_last_flush_bytes() const { return last_flush_bytes.load(); }
+
 	CommandQueueMT();
 	~CommandQueueMT();
 };
@@ -0,0 +1,642 @@
+/**************************************************************************/
+/*  compact_hash_map.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/hash_map.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * A compact, insertion-ordered hash map meant for maps that are usually small,
+ * such as the storage behind Dictionary.
+ *
+ * Pairs live in a few pages that double in size as the map grows, instead of
+ * one node per pair, and are never moved. Their cached hashes and the links
+ * keeping the insertion order are stored in flat arrays, in a separate
+ * allocation that is reallocated on growth. Up to LINEAR_SCAN_MAX slots,
+ * lookups simply compare the cached hashes linearly. Above that, an open
+ * addressing index table using linear probing is appended to the arrays and
+ * maps hashes to slots.
+ *
+ * Erasing a pair frees its slot for the next insertion, the order of the
+ * remaining pairs is kept by the links.
+ *
+ * Like HashMap, iteration follows insertion order, pairs inserted while
+ * iterating are visited, and pointers and references to pairs stay valid
+ * until the pair is erased.
+ */
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>>
+class CompactHashMap {
+public:
+	// Maps with this many slots or less do not allocate an index table.
+	static constexpr uint32_t LINEAR_SCAN_MAX = 8;
+	static constexpr uint32_t MIN_CAPACITY = 4;
+
+private:
+	typedef KeyValue<TKey, TValue> MapKeyValue;
+
+	static constexpr uint32_t MIN_CAPACITY_SHIFT = 2;
+	static_assert((1u << MIN_CAPACITY_SHIFT) == MIN_CAPACITY);
+
+	static constexpr uint32_t EMPTY_HASH = 0;
+	static constexpr uint32_t EMPTY_INDEX = UINT32_MAX;
+
+	// Page 0 and 1 hold MIN_CAPACITY slots, every following page as many as all the previous ones.
+	MapKeyValue **pages = nullptr;
+	// Single allocation starting with `pages`: `page_count` page pointers, then `capacity` hashes,
+	// next slots and previous slots, then `index_mask + 1` indices (if any).
+	uint32_t *hashes = nullptr;
+	uint32_t *next_slots = nullptr;
+	uint32_t *prev_slots = nullptr;
+	uint32_t *indices = nullptr;
+	uint32_t index_mask = 0;
+	uint32_t index_used = 0; // Index entries in use, including the ones left by erased pairs.
+
+	uint32_t page_count = 0;
+	uint32_t capacity = 0;
+	uint32_t used = 0; // Slots used since the last clear, including the erased ones.
+	uint32_t free_slot = EMPTY_INDEX; // Erased slots, chained through `prev_slots`.
+	uint32_t head = EMPTY_INDEX;
+	uint32_t tail = EMPTY_INDEX;
+	uint32_t num_elements = 0;
+	bool in_slot_order = true; // Iteration order is slot order, erased slots were never reused.
+
+	_FORCE_INLINE_ static uint32_t _hash(const TKey &p_key) {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (unlikely(hash == EMPTY_HASH)) {
+			hash = EMPTY_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ static uint32_t _highest_bit(uint32_t p_value) {
+#if defined(__GNUC__)
+		return 31 - __builtin_clz(p_value);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, p_value);
+		return index;
+#else
+		uint32_t bit = 0;
+		while (p_value >>= 1) {
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+	_FORCE_INLINE_ static uint32_t _get_page_size(uint32_t p_page) {
+		return p_page == 0 ? MIN_CAPACITY : MIN_CAPACITY << (p_page - 1);
+	}
+
+	_FORCE_INLINE_ MapKeyValue &_get_element(uint32_t p_slot) const {
+		if (p_slot < MIN_CAPACITY) {
+			return pages[0][p_slot];
+		}
+		const uint32_t shift = _highest_bit(p_slot);
+		return pages[shift - MIN_CAPACITY_SHIFT + 1][p_slot - (1u << shift)];
+	}
+
+	bool _lookup_slot(const TKey &p_key, uint32_t p_hash, uint32_t &r_slot) const {
+		if (indices == nullptr) {
+			for (uint32_t i = 0; i < used; i++) {
+				if (hashes[i] == p_hash && Comparator::compare(_get_element(i).key, p_key)) {
+					r_slot = i;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		uint32_t pos = p_hash & index_mask;
+		while (true) {
+			const uint32_t slot = indices[pos];
+			if (slot == EMPTY_INDEX) {
+				return false;
+			}
+			// Index entries left by erased pairs point to free slots, whose hash never matches,
+			// or to a reused slot, which is still the right one if the key matches.
+			if (hashes[slot] == p_hash && Comparator::compare(_get_element(slot).key, p_key)) {
+				r_slot = slot;
+				return true;
+			}
+			pos = (pos + 1) & index_mask;
+		}
+	}
+
+	_FORCE_INLINE_ void _index_insert(uint32_t p_slot) {
+		uint32_t pos = hashes[p_slot] & index_mask;
+		while (indices[pos] != EMPTY_INDEX) {
+			pos = (pos + 1) & index_mask;
+		}
+		indices[pos] = p_slot;
+		index_used++;
+	}
+
+	void _rebuild_index() {
+		if (indices == nullptr) {
+			return;
+		}
+		memset(indices, 0xFF, sizeof(uint32_t) * (index_mask + 1));
+		index_used = 0;
+		for (uint32_t slot = head; slot != EMPTY_INDEX; slot = next_slots[slot]) {
+			_index_insert(slot);
+		}
+	}
+
+	// Adds pages until there are at least `p_capacity` slots. Pairs are not moved, only the hashes,
+	// links and index are reallocated.
+	void _grow(uint32_t p_capacity) {
+		uint32_t new_page_count = page_count;
+		uint32_t new_capacity = capacity;
+		while (new_capacity < p_capacity) {
+			new_capacity += _get_page_size(new_page_count);
+			new_page_count++;
+		}
+
+		const uint32_t index_size = new_capacity > LINEAR_SCAN_MAX ? next_power_of_2(new_capacity * 2) : 0;
+		uint8_t *block = (uint8_t *)Memory::alloc_static(sizeof(MapKeyValue *) * new_page_count + sizeof(uint32_t) * (new_capacity * 3 + index_size));
+		MapKeyValue **new_pages = (MapKeyValue **)block;
+		uint32_t *new_hashes = (uint32_t *)(block + sizeof(MapKeyValue *) * new_page_count);
+		uint32_t *new_next_slots = new_hashes + new_capacity;
+		uint32_t *new_prev_slots = new_next_slots + new_capacity;
+
+		if (pages != nullptr) {
+			memcpy(new_pages, pages, sizeof(MapKeyValue *) * page_count);
+			memcpy(new_hashes, hashes, sizeof(uint32_t) * used);
+			memcpy(new_next_slots, next_slots, sizeof(uint32_t) * used);
+			memcpy(new_prev_slots, prev_slots, sizeof(uint32_t) * used);
+			Memory::free_static(pages);
+		}
+		for (uint32_t i = page_count; i < new_page_count; i++) {
+			new_pages[i] = (MapKeyValue *)Memory::alloc_static(sizeof(MapKeyValue) * _get_page_size(i));
+		}
+
+		pages = new_pages;
+		hashes = new_hashes;
+		next_slots = new_next_slots;
+		prev_slots = new_prev_slots;
+		indices = index_size ? new_prev_slots + new_capacity : nullptr;
+		index_mask = index_size ? index_size - 1 : 0;
+		page_count = new_page_count;
+		capacity = new_capacity;
+		_rebuild_index();
+	}
+
+	uint32_t _insert_new(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		uint32_t slot;
+		if (free_slot != EMPTY_INDEX) {
+			slot = free_slot;
+			free_slot = prev_slots[slot];
+			in_slot_order = false;
+		} else {
+			if (unlikely(used == capacity)) {
+				_grow(capacity + 1);
+			}
+			slot = used++;
+		}
+
+		memnew_placement(&_get_element(slot), MapKeyValue(p_key, p_value));
+		hashes[slot] = p_hash;
+		next_slots[slot] = EMPTY_INDEX;
+		prev_slots[slot] = tail;
+		if (tail != EMPTY_INDEX) {
+			next_slots[tail] = slot;
+		} else {
+			head = slot;
+		}
+		tail = slot;
+		num_elements++;
+
+		if (indices != nullptr) {
+			// Entries left by erased pairs slow down probing, drop them once the table is 3/4 full.
+			if ((index_used + 1) * 4 > (index_mask + 1) * 3) {
+				_rebuild_index();
+			} else {
+				_index_insert(slot);
+			}
+		}
+		return slot;
+	}
+
+	void _copy_from(const CompactHashMap &p_other) {
+		if (p_other.num_elements == 0) {
+			return;
+		}
+		reserve(p_other.num_elements);
+		for (uint32_t slot = p_other.head; slot != EMPTY_INDEX; slot = p_other.next_slots[slot]) {
+			// Keys are unique in the source, no need to look them up.
+			const MapKeyValue &E = p_other._get_element(slot);
+			_insert_new(E.key, E.value, p_other.hashes[slot]);
+		}
+	}
+
+	// Takes the storage of p_other, which is left empty. The current storage must have been freed.
+	void _move_from(CompactHashMap &p_other) {
+		pages = p_other.pages;
+		hashes = p_other.hashes;
+		next_slots = p_other.next_slots;
+		prev_slots = p_other.prev_slots;
+		indices = p_other.indices;
+		index_mask = p_other.index_mask;
+		index_used = p_other.index_used;
+		page_count = p_other.page_count;
+		capacity = p_other.capacity;
+		used = p_other.used;
+		free_slot = p_other.free_slot;
+		head = p_other.head;
+		tail = p_other.tail;
+		num_elements = p_other.num_elements;
+		in_slot_order = p_other.in_slot_order;
+
+		p_other.pages = nullptr;
+		p_other.hashes = nullptr;
+		p_other.next_slots = nullptr;
+		p_other.prev_slots = nullptr;
+		p_other.indices = nullptr;
+		p_other.index_mask = 0;
+		p_other.index_used = 0;
+		p_other.page_count = 0;
+		p_other.capacity = 0;
+		p_other.used = 0;
+		p_other.free_slot = EMPTY_INDEX;
+		p_other.head = EMPTY_INDEX;
+		p_other.tail = EMPTY_INDEX;
+		p_other.num_elements = 0;
+		p_other.in_slot_order = true;
+	}
+
+	void _free_storage() {
+		clear();
+		if (pages != nullptr) {
+			for (uint32_t i = 0; i < page_count; i++) {
+				Memory::free_static(pages[i]);
+			}
+			Memory::free_static(pages);
+		}
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	_FORCE_INLINE_ bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if constexpr (!(std::is_trivially_destructible_v<TKey> && std::is_trivially_destructible_v<TValue>)) {
+			for (uint32_t slot = head; slot != EMPTY_INDEX; slot = next_slots[slot]) {
+				_get_element(slot).~MapKeyValue();
+			}
+		}
+		used = 0;
+		free_slot = EMPTY_INDEX;
+		head = EMPTY_INDEX;
+		tail = EMPTY_INDEX;
+		num_elements = 0;
+		in_slot_order = true;
+		if (indices != nullptr) {
+			memset(indices, 0xFF, sizeof(uint32_t) * (index_mask + 1));
+			index_used = 0;
+		}
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t slot = 0;
+		bool exists = num_elements > 0 && _lookup_slot(p_key, _hash(p_key), slot);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _get_element(slot).value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t slot = 0;
+		bool exists = num_elements > 0 && _lookup_slot(p_key, _hash(p_key), slot);
+		CRASH_COND_MSG(!exists, "CompactHashMap key not found.");
+		return _get_element(slot).value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t slot = 0;
+		if (num_elements > 0 && _lookup_slot(p_key, _hash(p_key), slot)) {
+			return &_get_element(slot).value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (num_elements > 0 && _lookup_slot(p_key, _hash(p_key), slot)) {
+			return &_get_element(slot).value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _slot = 0;
+		return num_elements > 0 && _lookup_slot(p_key, _hash(p_key), _slot);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (num_elements == 0 || !_lookup_slot(p_key, _hash(p_key), slot)) {
+			return false;
+		}
+
+		if (num_elements == 1) {
+			// Last pair, start over from the first slot.
+			clear();
+			return true;
+		}
+
+		_get_element(slot).~MapKeyValue();
+		hashes[slot] = EMPTY_HASH;
+
+		const uint32_t prev = prev_slots[slot];
+		const uint32_t next = next_slots[slot];
+		if (prev != EMPTY_INDEX) {
+			next_slots[prev] = next;
+		} else {
+			head = next;
+		}
+		if (next != EMPTY_INDEX) {
+			prev_slots[next] = prev;
+		} else {
+			tail = prev;
+		}
+
+		// The next slot is kept, so an iterator on the erased pair can still be advanced.
+		prev_slots[slot] = free_slot;
+		free_slot = slot;
+		num_elements--;
+		return true;
+	}
+
+	// Returns the pair at `p_index` in iteration order.
+	// This is constant time unless pairs have been erased since the map was last cleared.
+	const MapKeyValue &get_by_index(uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, num_elements);
+		if (in_slot_order && used == num_elements) {
+			return _get_element(p_index);
+		}
+		uint32_t slot = head;
+		for (uint32_t i = 0; i < p_index; i++) {
+			slot = next_slots[slot];
+		}
+		return _get_element(slot);
+	}
+
+	void reserve(uint32_t p_new_capacity) {
+		if (p_new_capacity <= capacity) {
+			return;
+		}
+		_grow(p_new_capacity);
+	}
+
+	// Stable sort by key, same ordering as HashMap::sort(). Only the links are changed, pairs stay in place.
+	void sort() {
+		if (num_elements < 2) {
+			return;
+		}
+
+		uint32_t *order = (uint32_t *)Memory::alloc_static(sizeof(uint32_t) * num_elements);
+		uint32_t count = 0;
+		for (uint32_t slot = head; slot != EMPTY_INDEX; slot = next_slots[slot]) {
+			order[count++] = slot;
+		}
+
+		// Insertion sort, fast for the common case where the pairs are already sorted or nearly sorted.
+		bool moved = false;
+		for (uint32_t i = 1; i < count; i++) {
+			const uint32_t slot = order[i];
+			const TKey &key = _get_element(slot).key;
+			uint32_t insert_at = i;
+			while (insert_at > 0 && _hashmap_variant_less_than(key, _get_element(order[insert_at - 1]).key)) {
+				order[insert_at] = order[insert_at - 1];
+				insert_at--;
+			}
+			order[insert_at] = slot;
+			moved = moved || insert_at != i;
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			prev_slots[order[i]] = i > 0 ? order[i - 1] : EMPTY_INDEX;
+			next_slots[order[i]] = i + 1 < count ? order[i + 1] : EMPTY_INDEX;
+		}
+		head = order[0];
+		tail = order[count - 1];
+		in_slot_order = in_slot_order && !moved;
+
+		Memory::free_static(order);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const MapKeyValue &operator*() const {
+			return map->_get_element(slot);
+		}
+		_FORCE_INLINE_ const MapKeyValue *operator->() const {
+			return &map->_get_element(slot);
+		}
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			slot = map->next_slots[slot];
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return _is_end() ? b._is_end() : (map == b.map && slot == b.slot); }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return !(*this == b); }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return !_is_end();
+		}
+
+		_FORCE_INLINE_ ConstIterator(const CompactHashMap *p_map, uint32_t p_slot) {
+			map = p_map;
+			slot = p_slot;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		_FORCE_INLINE_ bool _is_end() const { return map == nullptr || slot == EMPTY_INDEX; }
+
+		const CompactHashMap *map = nullptr;
+		uint32_t slot = EMPTY_INDEX;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ MapKeyValue &operator*() const {
+			return map->_get_element(slot);
+		}
+		_FORCE_INLINE_ MapKeyValue *operator->() const {
+			return &map->_get_element(slot);
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			slot = map->next_slots[slot];
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return _is_end() ? b._is_end() : (map == b.map && slot == b.slot); }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return !(*this == b); }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return !_is_end();
+		}
+
+		_FORCE_INLINE_ Iterator(CompactHashMap *p_map, uint32_t p_slot) {
+			map = p_map;
+			slot = p_slot;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, slot);
+		}
+
+	private:
+		_FORCE_INLINE_ bool _is_end() const { return map == nullptr || slot == EMPTY_INDEX; }
+
+		CompactHashMap *map = nullptr;
+		uint32_t slot = EMPTY_INDEX;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, head);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, EMPTY_INDEX);
+	}
+
+	Iterator find(const TKey &p_key) {
+		uint32_t slot = 0;
+		if (num_elements == 0 || !_lookup_slot(p_key, _hash(p_key), slot)) {
+			return end();
+		}
+		return Iterator(this, slot);
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, head);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, EMPTY_INDEX);
+	}
+
+	ConstIterator find(const TKey &p_key) const {
+		uint32_t slot = 0;
+		if (num_elements == 0 || !_lookup_slot(p_key, _hash(p_key), slot)) {
+			return end();
+		}
+		return ConstIterator(this, slot);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t slot = 0;
+		bool exists = num_elements > 0 && _lookup_slot(p_key, _hash(p_key), slot);
+		CRASH_COND(!exists);
+		return _get_element(slot).value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t slot = 0;
+		if (num_elements == 0 || !_lookup_slot(p_key, hash, slot)) {
+			slot = _insert_new(p_key, TValue(), hash);
+		}
+		return _get_element(slot).value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = _hash(p_key);
+		uint32_t slot = 0;
+		if (num_elements > 0 && _lookup_slot(p_key, hash, slot)) {
+			_get_element(slot).value = p_value;
+		} else {
+			slot = _insert_new(p_key, p_value, hash);
+		}
+		return Iterator(this, slot);
+	}
+
+	/* Constructors */
+
+	CompactHashMap(const CompactHashMap &p_other) {
+		_copy_from(p_other);
+	}
+
+	CompactHashMap(CompactHashMap &&p_other) {
+		_move_from(p_other);
+	}
+
+	void operator=(const CompactHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		_copy_from(p_other);
+	}
+
+	void operator=(CompactHashMap &&p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		_free_storage();
+		_move_from(p_other);
+	}
+
+	CompactHashMap(uint32_t p_initial_capacity) {
+		if (p_initial_capacity > 0) {
+			reserve(p_initial_capacity);
+		}
+	}
+
+	CompactHashMap(std::initializer_list<KeyValue<TKey, TValue>> p_init) {
+		reserve(p_init.size());
+		for (const KeyValue<TKey, TValue> &E : p_init) {
+			insert(E.key, E.value);
+		}
+	}
+
+	CompactHashMap() {}
+
+	~CompactHashMap() {
+		_free_storage();
+	}
+};
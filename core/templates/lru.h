@@ -121,6 +121,11 @@ public:
 		}
 	}
 
+	// The entry that would be evicted next.
+	const Pair *get_least_recently_used() const {
+		return _list.is_empty() ? nullptr : &_list.back()->get();
+	}
+
 	_FORCE_INLINE_ size_t get_capacity() const { return capacity; }
 	_FORCE_INLINE_ size_t get_size() const { return _map.size(); }
 
@@ -0,0 +1,127 @@
+/**************************************************************************/
+/*  radix_sort.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "radix_sort.h"
+
+#include "core/object/worker_thread_pool.h"
+
+void RadixSort::_count_block(void *p_pass, uint32_t p_block) {
+	const Pass *pass = static_cast<const Pass *>(p_pass);
+	uint32_t *counts = pass->offsets + p_block * DIGIT_COUNT;
+	memset(counts, 0, sizeof(uint32_t) * DIGIT_COUNT);
+
+	uint32_t from = p_block * pass->block_size;
+	uint32_t to = MIN(from + pass->block_size, pass->count);
+	for (uint32_t i = from; i < to; i++) {
+		counts[(pass->keys_src[i] >> pass->shift) & (DIGIT_COUNT - 1)]++;
+	}
+}
+
+void RadixSort::_scatter_block(void *p_pass, uint32_t p_block) {
+	const Pass *pass = static_cast<const Pass *>(p_pass);
+	uint32_t *positions = pass->offsets + p_block * DIGIT_COUNT;
+
+	uint32_t from = p_block * pass->block_size;
+	uint32_t to = MIN(from + pass->block_size, pass->count);
+	for (uint32_t i = from; i < to; i++) {
+		uint32_t key = pass->keys_src[i];
+		uint32_t position = positions[(key >> pass->shift) & (DIGIT_COUNT - 1)]++;
+		pass->keys_dst[position] = key;
+		pass->values_dst[position] = pass->values_src[i];
+	}
+}
+
+void RadixSort::sort(uint32_t *r_keys, uint32_t *r_values, uint32_t p_count, bool p_allow_threads) {
+	if (p_count < 2) {
+		return;
+	}
+
+	uint32_t block_count = 1;
+	if (p_allow_threads && p_count >= PARALLEL_BLOCK_SIZE * 2 && WorkerThreadPool::get_singleton()) {
+		block_count = MIN(uint32_t(WorkerThreadPool::get_singleton()->get_thread_count()), p_count / PARALLEL_BLOCK_SIZE);
+		block_count = MAX(block_count, 1u);
+	}
+
+	keys_tmp.resize(p_count);
+	values_tmp.resize(p_count);
+	offsets.resize(block_count * DIGIT_COUNT);
+
+	Pass pass;
+	pass.keys_src = r_keys;
+	pass.values_src = r_values;
+	pass.keys_dst = keys_tmp.ptr();
+	pass.values_dst = values_tmp.ptr();
+	pass.count = p_count;
+	pass.block_size = (p_count + block_count - 1) / block_count;
+	pass.offsets = offsets.ptr();
+
+	for (pass.shift = 0; pass.shift < 32; pass.shift += DIGIT_BITS) {
+		if (block_count > 1) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&RadixSort::_count_block, &pass, block_count, -1, true, SNAME("RadixSortCount"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			_count_block(&pass, 0);
+		}
+
+		// Turn the counts into the position of the first key of each digit in each block.
+		bool single_digit = false;
+		uint32_t position = 0;
+		for (uint32_t digit = 0; digit < DIGIT_COUNT; digit++) {
+			uint32_t digit_start = position;
+			for (uint32_t block = 0; block < block_count; block++) {
+				uint32_t count = pass.offsets[block * DIGIT_COUNT + digit];
+				pass.offsets[block * DIGIT_COUNT + digit] = position;
+				position += count;
+			}
+			if (position - digit_start == p_count) {
+				single_digit = true;
+				break;
+			}
+		}
+		if (single_digit) {
+			continue; // All keys share this digit, the pass would not move anything.
+		}
+
+		if (block_count > 1) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&RadixSort::_scatter_block, &pass, block_count, -1, true, SNAME("RadixSortScatter"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			_scatter_block(&pass, 0);
+		}
+
+		SWAP(pass.keys_src, pass.keys_dst);
+		SWAP(pass.values_src, pass.values_dst);
+	}
+
+	if (pass.keys_src != r_keys) {
+		memcpy(r_keys, pass.keys_src, sizeof(uint32_t) * p_count);
+		memcpy(r_values, pass.values_src, sizeof(uint32_t) * p_count);
+	}
+}
@@ -0,0 +1,75 @@
+/**************************************************************************/
+/*  radix_sort.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+#include <cstring>
+
+// Stable LSD radix sort of 32-bit keys carrying an index each.
+// Large arrays are sorted in blocks on the WorkerThreadPool.
+class RadixSort {
+	enum {
+		DIGIT_BITS = 8,
+		DIGIT_COUNT = 1 << DIGIT_BITS,
+		PARALLEL_BLOCK_SIZE = 16384,
+	};
+
+	struct Pass {
+		uint32_t *keys_src = nullptr;
+		uint32_t *values_src = nullptr;
+		uint32_t *keys_dst = nullptr;
+		uint32_t *values_dst = nullptr;
+		uint32_t count = 0;
+		uint32_t block_size = 0;
+		uint32_t shift = 0;
+		uint32_t *offsets = nullptr; // DIGIT_COUNT per block.
+	};
+
+	LocalVector<uint32_t> keys_tmp;
+	LocalVector<uint32_t> values_tmp;
+	LocalVector<uint32_t> offsets;
+
+	static void _count_block(void *p_pass, uint32_t p_block);
+	static void _scatter_block(void *p_pass, uint32_t p_block);
+
+public:
+	// Maps a float to a key whose unsigned order matches the order of the floats.
+	static _FORCE_INLINE_ uint32_t float_to_key(float p_value) {
+		uint32_t bits;
+		memcpy(&bits, &p_value, sizeof(uint32_t));
+		return bits ^ ((bits & 0x80000000) ? 0xFFFFFFFF : 0x80000000);
+	}
+
+	// Sorts r_keys in ascending order, moving r_values along with them.
+	void sort(uint32_t *r_keys, uint32_t *r_values, uint32_t p_count, bool p_allow_threads = true);
+};
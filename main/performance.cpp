@@ -129,6 +129,9 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_OBSTACLE_COUNT);
 #endif // NAVIGATION_3D_DISABLED
+	BIND_ENUM_CONSTANT(RENDER_COMMAND_QUEUE_PENDING_COMMANDS);
+	BIND_ENUM_CONSTANT(RENDER_COMMAND_QUEUE_FLUSH_COMMANDS);
+	BIND_ENUM_CONSTANT(RENDER_COMMAND_QUEUE_FLUSH_MEM);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -209,6 +212,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation_3d/edges_free"),
 		PNAME("navigation_3d/obstacles"),
 #endif // NAVIGATION_3D_DISABLED
+		PNAME("raster/command_queue_pending"),
+		PNAME("raster/command_queue_flushed"),
+		PNAME("raster/command_queue_flushed_mem"),
 	};
 	static_assert(std::size(names) == MONITOR_MAX);
 
@@ -432,6 +438,12 @@ double Performance::get_monitor(Monitor p_monitor) const {
 		case NAVIGATION_3D_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
 #endif // NAVIGATION_3D_DISABLED
+		case RENDER_COMMAND_QUEUE_PENDING_COMMANDS:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_COMMAND_QUEUE_PENDING_COMMANDS);
+		case RENDER_COMMAND_QUEUE_FLUSH_COMMANDS:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_COMMAND_QUEUE_FLUSH_COMMANDS);
+		case RENDER_COMMAND_QUEUE_FLUSH_MEM:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_COMMAND_QUEUE_FLUSH_MEM);
 
 		default: {
 		}
@@ -503,6 +515,9 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 	static_assert((sizeof(types) / sizeof(MonitorType)) == MONITOR_MAX);
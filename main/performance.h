@@ -125,6 +125,9 @@ public:
 		NAVIGATION_3D_EDGE_CONNECTION_COUNT,
 		NAVIGATION_3D_EDGE_FREE_COUNT,
 		NAVIGATION_3D_OBSTACLE_COUNT,
+		RENDER_COMMAND_QUEUE_PENDING_COMMANDS,
+		RENDER_COMMAND_QUEUE_FLUSH_COMMANDS,
+		RENDER_COMMAND_QUEUE_FLUSH_MEM,
 		MONITOR_MAX
 	};
 
@@ -36,21 +36,21 @@ void ENetMultiplayerPeer::set_target_peer(int p_peer) {
 
 int ENetMultiplayerPeer::get_packet_peer() const {
 	ERR_FAIL_COND_V_MSG(!_is_active(), 1, "The multiplayer instance isn't currently active.");
-	ERR_FAIL_COND_V(incoming_packets.is_empty(), 1);
+	ERR_FAIL_COND_V(!_has_incoming_packets(), 1);
 
-	return incoming_packets.front()->get().from;
+	return incoming_packets[incoming_read].from;
 }
 
 MultiplayerPeer::TransferMode ENetMultiplayerPeer::get_packet_mode() const {
 	ERR_FAIL_COND_V_MSG(!_is_active(), TRANSFER_MODE_RELIABLE, "The multiplayer instance isn't currently active.");
-	ERR_FAIL_COND_V(incoming_packets.is_empty(), TRANSFER_MODE_RELIABLE);
-	return incoming_packets.front()->get().transfer_mode;
+	ERR_FAIL_COND_V(!_has_incoming_packets(), TRANSFER_MODE_RELIABLE);
+	return incoming_packets[incoming_read].transfer_mode;
 }
 
 int ENetMultiplayerPeer::get_packet_channel() const {
 	ERR_FAIL_COND_V_MSG(!_is_active(), 1, "The multiplayer instance isn't currently active.");
-	ERR_FAIL_COND_V(incoming_packets.is_empty(), 1);
-	int ch = incoming_packets.front()->get().channel;
+	ERR_FAIL_COND_V(!_has_incoming_packets(), 1);
+	int ch = incoming_packets[incoming_read].channel;
 	if (ch >= SYSCH_MAX) { // First 2 channels are reserved.
 		return ch - SYSCH_MAX + 1;
 	}
@@ -305,7 +305,7 @@ void ENetMultiplayerPeer::close() {
 	}
 
 	active_mode = MODE_NONE;
-	incoming_packets.clear();
+	_clear_incoming_packets();
 	peers.clear();
 	hosts.clear();
 	unique_id = 0;
@@ -314,16 +314,29 @@ void ENetMultiplayerPeer::close() {
 }
 
 int ENetMultiplayerPeer::get_available_packet_count() const {
-	return incoming_packets.size();
+	return incoming_packets.size() - incoming_read;
 }
 
 Error ENetMultiplayerPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
-	ERR_FAIL_COND_V_MSG(incoming_packets.is_empty(), ERR_UNAVAILABLE, "No incoming packets available.");
+	ERR_FAIL_COND_V_MSG(!_has_incoming_packets(), ERR_UNAVAILABLE, "No incoming packets available.");
 
 	_pop_current_packet();
 
-	current_packet = incoming_packets.front()->get();
-	incoming_packets.pop_front();
+	current_packet = incoming_packets[incoming_read++];
+	if (incoming_read == incoming_packets.size()) {
+		// Drained, start over keeping the capacity.
+		incoming_packets.clear();
+		incoming_read = 0;
+	} else if (incoming_read > incoming_packets.size() / 2) {
+		// Packets keep arriving before the queue drains, move the unread ones to the front
+		// so the consumed ones don't pile up. At most half the queue moves, so this stays cheap.
+		uint32_t unread = incoming_packets.size() - incoming_read;
+		for (uint32_t i = 0; i < unread; i++) {
+			incoming_packets[i] = incoming_packets[incoming_read + i];
+		}
+		incoming_packets.resize(unread);
+		incoming_read = 0;
+	}
 
 	*r_buffer = (const uint8_t *)(current_packet.packet->data);
 	r_buffer_size = current_packet.packet->dataLength;
@@ -428,6 +441,15 @@ void ENetMultiplayerPeer::_pop_current_packet() {
 	}
 }
 
+void ENetMultiplayerPeer::_clear_incoming_packets() {
+	for (uint32_t i = incoming_read; i < incoming_packets.size(); i++) {
+		incoming_packets[i].packet->referenceCount--;
+		_destroy_unused(incoming_packets[i].packet);
+	}
+	incoming_packets.clear();
+	incoming_read = 0;
+}
+
 MultiplayerPeer::ConnectionStatus ENetMultiplayerPeer::get_connection_status() const {
 	return connection_status;
 }
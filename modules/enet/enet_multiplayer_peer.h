@@ -33,6 +33,7 @@
 #include "enet_connection.h"
 
 #include "core/crypto/crypto.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/multiplayer_peer.h"
 
 #include <enet/enet.h>
@@ -77,12 +78,18 @@ private:
 		TransferMode transfer_mode = TRANSFER_MODE_RELIABLE;
 	};
 
-	List<Packet> incoming_packets;
+	// Packets reference the ENet packet memory directly, which is handed to get_packet() without copies.
+	// Stored in a flat queue, consumed from incoming_read, so no allocation happens per packet once warm.
+	// The consumed packets are dropped from the front once they make up more than half of it.
+	LocalVector<Packet> incoming_packets;
+	uint32_t incoming_read = 0;
 
 	Packet current_packet;
 
 	void _store_packet(int32_t p_source, ENetConnection::Event &p_event);
 	void _pop_current_packet();
+	void _clear_incoming_packets();
+	_FORCE_INLINE_ bool _has_incoming_packets() const { return incoming_read < incoming_packets.size(); }
 	void _disconnect_inactive_peers();
 	void _destroy_unused(ENetPacket *p_packet);
 	_FORCE_INLINE_ bool _is_active() const { return active_mode != MODE_NONE; }
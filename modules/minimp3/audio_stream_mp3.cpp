@@ -34,7 +34,29 @@
 
 #include "audio_stream_mp3.h"
 
-int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+#include "servers/audio/audio_decode_cache.h"
+
+bool AudioStreamPlaybackMP3::_read_frame(AudioFrame &r_frame) {
+	if (!decoded_frames.is_empty()) {
+		if (decoded_cursor >= (uint32_t)decoded_frames.size()) {
+			return false;
+		}
+		r_frame = decoded_frames[decoded_cursor++];
+		return true;
+	}
+
+	mp3dec_frame_info_t frame_info;
+	mp3d_sample_t *buf_frame = nullptr;
+
+	int samples_mixed = mp3dec_ex_read_frame(&mp3d, &buf_frame, &frame_info, mp3_stream->channels);
+	if (!samples_mixed) {
+		return false;
+	}
+	r_frame = AudioFrame(buf_frame[0], buf_frame[samples_mixed - 1]);
+	return true;
+}
+
+int AudioStreamPlaybackMP3::_decode(AudioFrame *p_buffer, int p_frames) {
 	if (!active) {
 		return 0;
 	}
@@ -52,13 +74,7 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 	}
 
 	while (todo && active) {
-		mp3dec_frame_info_t frame_info;
-		mp3d_sample_t *buf_frame = nullptr;
-
-		int samples_mixed = mp3dec_ex_read_frame(&mp3d, &buf_frame, &frame_info, mp3_stream->channels);
-
-		if (samples_mixed) {
-			p_buffer[p_frames - todo] = AudioFrame(buf_frame[0], buf_frame[samples_mixed - 1]);
+		if (_read_frame(p_buffer[p_frames - todo])) {
 			if (loop_fade_remaining < FADE_SIZE) {
 				p_buffer[p_frames - todo] += loop_fade[loop_fade_remaining] * (float(FADE_SIZE - loop_fade_remaining) / float(FADE_SIZE));
 				loop_fade_remaining++;
@@ -68,14 +84,12 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 
 			if (beat_loop && (int)frames_mixed >= beat_length_frames) {
 				for (int i = 0; i < FADE_SIZE; i++) {
-					samples_mixed = mp3dec_ex_read_frame(&mp3d, &buf_frame, &frame_info, mp3_stream->channels);
-					loop_fade[i] = AudioFrame(buf_frame[0], buf_frame[samples_mixed - 1]);
-					if (!samples_mixed) {
+					if (!_read_frame(loop_fade[i])) {
 						break;
 					}
 				}
 				loop_fade_remaining = 0;
-				seek(mp3_stream->loop_offset);
+				_seek(mp3_stream->loop_offset);
 				loops++;
 			}
 		}
@@ -83,7 +97,7 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 		else {
 			//EOF
 			if (use_loop) {
-				seek(mp3_stream->loop_offset);
+				_seek(mp3_stream->loop_offset);
 				loops++;
 			} else {
 				frames_mixed_this_step = p_frames - todo;
@@ -99,34 +113,77 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 	return frames_mixed_this_step;
 }
 
+int AudioStreamPlaybackMP3::_decode_ahead(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops) {
+	AudioStreamPlaybackMP3 *self = (AudioStreamPlaybackMP3 *)p_userdata;
+	int mixed = self->active ? self->_decode(p_buffer, p_frames) : 0;
+	r_position = self->frames_mixed;
+	r_loops = self->loops;
+	return mixed;
+}
+
+void AudioStreamPlaybackMP3::_seek_ahead(void *p_userdata, uint32_t p_position, bool p_restart) {
+	AudioStreamPlaybackMP3 *self = (AudioStreamPlaybackMP3 *)p_userdata;
+	if (p_restart) {
+		self->active = true;
+		self->loops = 0;
+	}
+	self->_seek(double(p_position) / self->mp3_stream->sample_rate);
+}
+
+int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+	if (!decode_ahead.is_enabled()) {
+		return _decode(p_buffer, p_frames);
+	}
+
+	if (!decode_ahead_active) {
+		return 0;
+	}
+	int mixed = decode_ahead.mix(p_buffer, p_frames);
+	if (decode_ahead.is_finished()) {
+		decode_ahead_active = false;
+	}
+	return mixed;
+}
+
 float AudioStreamPlaybackMP3::get_stream_sampling_rate() {
 	return mp3_stream->sample_rate;
 }
 
 void AudioStreamPlaybackMP3::start(double p_from_pos) {
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
+	if (decode_ahead.is_enabled()) {
+		// The decoder belongs to the decode thread, it starts it when handling the request.
+		decode_ahead.request_restart(uint32_t(p_from_pos * mp3_stream->sample_rate), true);
+		decode_ahead_active = true;
+	} else {
+		active = true;
+		_seek(p_from_pos);
+		loops = 0;
+	}
 	begin_resample();
 }
 
 void AudioStreamPlaybackMP3::stop() {
-	active = false;
+	if (decode_ahead.is_enabled()) {
+		decode_ahead_active = false;
+	} else {
+		active = false;
+	}
 }
 
 bool AudioStreamPlaybackMP3::is_playing() const {
-	return active;
+	return decode_ahead.is_enabled() ? decode_ahead_active : active;
 }
 
 int AudioStreamPlaybackMP3::get_loop_count() const {
-	return loops;
+	return decode_ahead.is_enabled() ? decode_ahead.get_loops() : loops;
 }
 
 double AudioStreamPlaybackMP3::get_playback_position() const {
-	return double(frames_mixed) / mp3_stream->sample_rate;
+	uint32_t position = decode_ahead.is_enabled() ? decode_ahead.get_position() : frames_mixed;
+	return double(position) / mp3_stream->sample_rate;
 }
 
-void AudioStreamPlaybackMP3::seek(double p_time) {
+void AudioStreamPlaybackMP3::_seek(double p_time) {
 	if (!active) {
 		return;
 	}
@@ -136,7 +193,20 @@ void AudioStreamPlaybackMP3::seek(double p_time) {
 	}
 
 	frames_mixed = uint32_t(mp3_stream->sample_rate * p_time);
-	mp3dec_ex_seek(&mp3d, (uint64_t)frames_mixed * mp3_stream->channels);
+	if (!decoded_frames.is_empty()) {
+		decoded_cursor = frames_mixed;
+	} else {
+		mp3dec_ex_seek(&mp3d, (uint64_t)frames_mixed * mp3_stream->channels);
+	}
+}
+
+void AudioStreamPlaybackMP3::seek(double p_time) {
+	if (!decode_ahead.is_enabled()) {
+		_seek(p_time);
+		return;
+	}
+
+	decode_ahead.request_restart(uint32_t(p_time * mp3_stream->sample_rate), false);
 }
 
 void AudioStreamPlaybackMP3::tag_used_streams() {
@@ -182,6 +252,10 @@ Variant AudioStreamPlaybackMP3::get_parameter(const StringName &p_name) const {
 }
 
 AudioStreamPlaybackMP3::~AudioStreamPlaybackMP3() {
+	if (decode_ahead.is_enabled()) {
+		// Make sure the decode thread is done with the decoder before closing it.
+		AudioDecodeAheadThread::remove_buffer(&decode_ahead);
+	}
 	mp3dec_ex_close(&mp3d);
 }
 
@@ -196,19 +270,59 @@ Ref<AudioStreamPlayback> AudioStreamMP3::instantiate_playback() {
 	mp3s.instantiate();
 	mp3s->mp3_stream = Ref<AudioStreamMP3>(this);
 
-	int errorcode = mp3dec_ex_open_buf(&mp3s->mp3d, data.ptr(), data_len, MP3D_SEEK_TO_SAMPLE);
-
 	mp3s->frames_mixed = 0;
 	mp3s->active = false;
 	mp3s->loops = 0;
 
+	bool cacheable = AudioDecodeCache::is_cacheable(length);
+	if (cacheable && AudioDecodeCache::get(get_instance_id(), mp3s->decoded_frames)) {
+		return mp3s;
+	}
+
+	int errorcode = mp3dec_ex_open_buf(&mp3s->mp3d, data.ptr(), data_len, MP3D_SEEK_TO_SAMPLE);
+
 	if (errorcode) {
 		ERR_FAIL_COND_V(errorcode, Ref<AudioStreamPlaybackMP3>());
 	}
 
+	if (AudioDecodeAheadThread::is_running()) {
+		if (cacheable && AudioDecodeCache::begin_decode(get_instance_id())) {
+			// Decoded in the background, this playback streams and the next ones use the cache.
+			AudioDecodeAheadThread::queue_job(&AudioStreamMP3::_decode_to_cache, Ref<AudioStreamMP3>(this));
+		}
+		mp3s->decode_ahead.setup(&AudioStreamPlaybackMP3::_decode_ahead, &AudioStreamPlaybackMP3::_seek_ahead, mp3s.ptr(), AudioDecodeAheadThread::get_buffer_frames(sample_rate));
+	}
+
 	return mp3s;
 }
 
+Vector<AudioFrame> AudioStreamMP3::_decode_all() const {
+	Vector<AudioFrame> frames;
+
+	mp3dec_ex_t mp3d = {};
+	int errorcode = mp3dec_ex_open_buf(&mp3d, data.ptr(), data_len, MP3D_SEEK_TO_SAMPLE);
+	ERR_FAIL_COND_V(errorcode, frames);
+
+	Vector<mp3d_sample_t> samples;
+	samples.resize(mp3d.samples);
+	size_t samples_read = mp3dec_ex_read(&mp3d, samples.ptrw(), mp3d.samples);
+	mp3dec_ex_close(&mp3d);
+
+	const mp3d_sample_t *src = samples.ptr();
+	frames.resize(samples_read / channels);
+	AudioFrame *dst = frames.ptrw();
+	for (int i = 0; i < frames.size(); i++) {
+		dst[i] = AudioFrame(src[i * channels], src[i * channels + channels - 1]);
+	}
+	return frames;
+}
+
+void AudioStreamMP3::_decode_to_cache(const Ref<RefCounted> &p_stream) {
+	AudioStreamMP3 *stream = Object::cast_to<AudioStreamMP3>(p_stream.ptr());
+	ERR_FAIL_NULL(stream);
+	AudioDecodeCache::finish_decode(stream->get_instance_id(), stream->_decode_all());
+}
+
 String AudioStreamMP3::get_stream_name() const {
 	return ""; //return stream_name;
 }
@@ -220,6 +334,8 @@ void AudioStreamMP3::clear_data() {
 void AudioStreamMP3::set_data(const Vector<uint8_t> &p_data) {
 	int src_data_len = p_data.size();
 
+	AudioDecodeCache::erase(get_instance_id());
+
 	mp3dec_ex_t *mp3d = memnew(mp3dec_ex_t);
 	int err = mp3dec_ex_open_buf(mp3d, p_data.ptr(), src_data_len, MP3D_SEEK_TO_SAMPLE);
 	if (err || mp3d->info.hz == 0) {
@@ -360,5 +476,6 @@ AudioStreamMP3::AudioStreamMP3() {
 }
 
 AudioStreamMP3::~AudioStreamMP3() {
+	AudioDecodeCache::erase(get_instance_id());
 	clear_data();
 }
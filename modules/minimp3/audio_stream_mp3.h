@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "servers/audio/audio_decode_ahead.h"
 #include "servers/audio/audio_stream.h"
 
 #include <minimp3_ex.h>
@@ -59,6 +60,20 @@ class AudioStreamPlaybackMP3 : public AudioStreamPlaybackResampled {
 	bool _is_sample = false;
 	Ref<AudioSamplePlayback> sample_playback;
 
+	// Short streams are decoded once and shared through AudioDecodeCache, the decoder isn't opened at all.
+	Vector<AudioFrame> decoded_frames;
+	uint32_t decoded_cursor = 0;
+
+	// Long streams are decoded ahead by the decode thread, the mixer only copies frames.
+	AudioDecodeAheadBuffer decode_ahead;
+	bool decode_ahead_active = false;
+
+	bool _read_frame(AudioFrame &r_frame);
+	int _decode(AudioFrame *p_buffer, int p_frames);
+	void _seek(double p_time);
+	static int _decode_ahead(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops);
+	static void _seek_ahead(void *p_userdata, uint32_t p_position, bool p_restart);
+
 protected:
 	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) override;
 	virtual float get_stream_sampling_rate() override;
@@ -108,6 +123,9 @@ class AudioStreamMP3 : public AudioStream {
 	int beat_count = 0;
 	int bar_beats = 4;
 
+	Vector<AudioFrame> _decode_all() const;
+	static void _decode_to_cache(const Ref<RefCounted> &p_stream);
+
 protected:
 	static void _bind_methods();
 
@@ -31,8 +31,14 @@
 #include "multiplayer_synchronizer.h"
 
 #include "core/config/engine.h"
+#include "core/io/marshalls.h"
+#include "scene/2d/node_2d.h"
 #include "scene/main/multiplayer_api.h"
 
+#ifndef _3D_DISABLED
+#include "scene/3d/node_3d.h"
+#endif // _3D_DISABLED
+
 Object *MultiplayerSynchronizer::_get_prop_target(Object *p_obj, const NodePath &p_path) {
 	if (p_path.get_name_count() == 0) {
 		return p_obj;
@@ -110,6 +116,10 @@ void MultiplayerSynchronizer::reset() {
 	last_watch_usec = 0;
 	sync_started = false;
 	watchers.clear();
+	quantized_baselines.clear();
+	quantized_baseline_head = 0;
+	quantized_received.clear();
+	interest_peers.clear();
 }
 
 uint32_t MultiplayerSynchronizer::get_net_id() const {
@@ -191,6 +201,9 @@ void MultiplayerSynchronizer::set_visibility_public(bool p_visible) {
 }
 
 bool MultiplayerSynchronizer::is_visible_to(int p_peer) {
+	if (use_interest_management && !interest_peers.has(p_peer)) {
+		return false; // Never visible to "all peers" (0) either, each peer is decided by its interest volume.
+	}
 	if (visibility_filters.size()) {
 		Variant arg = p_peer;
 		const Variant *argv[1] = { &arg };
@@ -242,6 +255,47 @@ MultiplayerSynchronizer::VisibilityUpdateMode MultiplayerSynchronizer::get_visib
 	return visibility_update_mode;
 }
 
+void MultiplayerSynchronizer::set_use_interest_management(bool p_enabled) {
+	if (use_interest_management == p_enabled) {
+		return;
+	}
+	use_interest_management = p_enabled;
+	update_visibility(0);
+}
+
+bool MultiplayerSynchronizer::is_using_interest_management() const {
+	return use_interest_management;
+}
+
+bool MultiplayerSynchronizer::get_interest_position(Vector3 &r_position) {
+	Node *node = get_root_node();
+	if (!node || !node->is_inside_tree()) {
+		return false;
+	}
+	Node2D *node_2d = Object::cast_to<Node2D>(node);
+	if (node_2d) {
+		const Vector2 position = node_2d->get_global_position();
+		r_position = Vector3(position.x, position.y, 0);
+		return true;
+	}
+#ifndef _3D_DISABLED
+	Node3D *node_3d = Object::cast_to<Node3D>(node);
+	if (node_3d) {
+		r_position = node_3d->get_global_position();
+		return true;
+	}
+#endif // _3D_DISABLED
+	return false;
+}
+
+void MultiplayerSynchronizer::set_interest_visibility_for(int p_peer, bool p_visible) {
+	if (p_visible) {
+		interest_peers.insert(p_peer);
+	} else {
+		interest_peers.erase(p_peer);
+	}
+}
+
 void MultiplayerSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_path", "path"), &MultiplayerSynchronizer::set_root_path);
 	ClassDB::bind_method(D_METHOD("get_root_path"), &MultiplayerSynchronizer::get_root_path);
@@ -267,12 +321,16 @@ void MultiplayerSynchronizer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_visibility_for", "peer", "visible"), &MultiplayerSynchronizer::set_visibility_for);
 	ClassDB::bind_method(D_METHOD("get_visibility_for", "peer"), &MultiplayerSynchronizer::get_visibility_for);
 
+	ClassDB::bind_method(D_METHOD("set_use_interest_management", "enabled"), &MultiplayerSynchronizer::set_use_interest_management);
+	ClassDB::bind_method(D_METHOD("is_using_interest_management"), &MultiplayerSynchronizer::is_using_interest_management);
+
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_path"), "set_root_path", "get_root_path");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "replication_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_replication_interval", "get_replication_interval");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "delta_interval", PROPERTY_HINT_RANGE, "0,5,0.001,suffix:s"), "set_delta_interval", "get_delta_interval");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "replication_config", PROPERTY_HINT_RESOURCE_TYPE, "SceneReplicationConfig", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_EDITOR_INSTANTIATE_OBJECT), "set_replication_config", "get_replication_config");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "visibility_update_mode", PROPERTY_HINT_ENUM, "Idle,Physics,None"), "set_visibility_update_mode", "get_visibility_update_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "public_visibility"), "set_visibility_public", "is_visibility_public");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_interest_management"), "set_use_interest_management", "is_using_interest_management");
 
 	BIND_ENUM_CONSTANT(VISIBILITY_PROCESS_IDLE);
 	BIND_ENUM_CONSTANT(VISIBILITY_PROCESS_PHYSICS);
@@ -329,6 +387,9 @@ double MultiplayerSynchronizer::get_delta_interval() const {
 
 void MultiplayerSynchronizer::set_replication_config(Ref<SceneReplicationConfig> p_config) {
 	replication_config = p_config;
+	quantized_baselines.clear();
+	quantized_baseline_head = 0;
+	quantized_received.clear();
 }
 
 Ref<SceneReplicationConfig> MultiplayerSynchronizer::get_replication_config() {
@@ -403,32 +464,40 @@ Error MultiplayerSynchronizer::_watch_changes(uint64_t p_usec) {
 	return OK;
 }
 
-List<Variant> MultiplayerSynchronizer::get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, uint64_t &r_indexes) {
-	r_indexes = 0;
-	List<Variant> out;
-
+uint64_t MultiplayerSynchronizer::get_delta_indexes(uint64_t p_cur_usec, uint64_t p_last_usec) {
 	if (last_watch_usec == p_cur_usec) {
 		// We already watched for changes in this frame.
 
 	} else if (p_cur_usec < p_last_usec + delta_interval_usec) {
 		// Too soon skip delta synchronization.
-		return out;
+		return 0;
 
 	} else {
 		// Watch for changes.
 		Error err = _watch_changes(p_cur_usec);
-		ERR_FAIL_COND_V(err != OK, out);
+		ERR_FAIL_COND_V(err != OK, 0);
 		last_watch_usec = p_cur_usec;
 	}
 
+	uint64_t indexes = 0;
 	const Watcher *ptr = watchers.size() ? watchers.ptr() : nullptr;
 	for (int i = 0; i < watchers.size(); i++) {
-		const Watcher &w = ptr[i];
-		if (w.last_change_usec <= p_last_usec) {
-			continue;
+		if (ptr[i].last_change_usec > p_last_usec) {
+			indexes |= 1ULL << i;
+		}
+	}
+	return indexes;
+}
+
+List<Variant> MultiplayerSynchronizer::get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, uint64_t &r_indexes) {
+	r_indexes = get_delta_indexes(p_cur_usec, p_last_usec);
+	List<Variant> out;
+
+	const Watcher *ptr = watchers.size() ? watchers.ptr() : nullptr;
+	for (int i = 0; i < watchers.size(); i++) {
+		if (r_indexes & (1ULL << i)) {
+			out.push_back(ptr[i].value);
 		}
-		out.push_back(w.value);
-		r_indexes |= 1ULL << i;
 	}
 	return out;
 }
@@ -447,6 +516,161 @@ List<NodePath> MultiplayerSynchronizer::get_delta_properties(uint64_t p_indexes)
 	return out;
 }
 
+bool MultiplayerSynchronizer::has_quantized_delta() const {
+	return replication_config.is_valid() && replication_config->has_watch_quantization();
+}
+
+const MultiplayerSynchronizer::QuantizedBaseline &MultiplayerSynchronizer::_get_quantized_baseline(uint64_t p_usec) {
+	const QuantizedBaseline *existing = _find_quantized_baseline(p_usec);
+	if (existing) {
+		return *existing;
+	}
+	if (quantized_baselines.is_empty()) {
+		quantized_baselines.resize(QUANTIZED_BASELINE_HISTORY);
+	}
+
+	// Replace the oldest one.
+	QuantizedBaseline &baseline = quantized_baselines[quantized_baseline_head];
+	quantized_baseline_head = (quantized_baseline_head + 1) % QUANTIZED_BASELINE_HISTORY;
+
+	const LocalVector<SceneReplicationConfig::Quantization> &quantization = replication_config->get_watch_quantization();
+	const Watcher *ptr = watchers.ptr();
+	baseline.usec = p_usec;
+	baseline.values.resize(watchers.size());
+	for (int i = 0; i < watchers.size(); i++) {
+		baseline.values[i] = ReplicationQuantizer::quantize(ptr[i].value, quantization[i]);
+	}
+	return baseline;
+}
+
+const MultiplayerSynchronizer::QuantizedBaseline *MultiplayerSynchronizer::_find_quantized_baseline(uint64_t p_usec) const {
+	for (const QuantizedBaseline &baseline : quantized_baselines) {
+		if (baseline.usec == p_usec && baseline.values.size() == uint32_t(watchers.size())) {
+			return &baseline;
+		}
+	}
+	return nullptr;
+}
+
+Error MultiplayerSynchronizer::encode_quantized_delta(uint64_t p_cur_usec, uint64_t p_indexes, uint64_t p_baseline_usec, LocalVector<uint8_t> &r_buffer) {
+	ERR_FAIL_COND_V(replication_config.is_null(), ERR_UNCONFIGURED);
+	const LocalVector<SceneReplicationConfig::Quantization> &quantization = replication_config->get_watch_quantization();
+	ERR_FAIL_COND_V(quantization.size() != uint32_t(watchers.size()), ERR_BUG);
+
+	// The state of this tick becomes the baseline of the peers it's sent to. Deltas are sent reliably and
+	// in order, so by the time the next one arrives the peer holds exactly these values.
+	const QuantizedBaseline &current = _get_quantized_baseline(p_cur_usec);
+	const QuantizedBaseline *baseline = p_baseline_usec ? _find_quantized_baseline(p_baseline_usec) : nullptr;
+
+	// [bit-packed size][bit-packed quantized properties][Variant encoded properties]
+	const uint32_t header = r_buffer.size();
+	r_buffer.resize(header + 4);
+	ReplicationQuantizer::BitWriter writer(r_buffer);
+	LocalVector<const Variant *> varp;
+	const Watcher *ptr = watchers.ptr();
+	for (uint32_t i = 0; i < quantization.size() && i < 64; i++) {
+		if (!(p_indexes & (1ULL << i))) {
+			continue;
+		}
+		const SceneReplicationConfig::Quantization &q = quantization[i];
+		if (q.mode == SceneReplicationConfig::PROPERTY_QUANTIZATION_NONE) {
+			varp.push_back(&ptr[i].value);
+			continue;
+		}
+		const ReplicationQuantizer::Value &value = current.values[i];
+		if (value.type == Variant::NIL) {
+			writer.write(ReplicationQuantizer::ENCODING_VARIANT, 2);
+			varp.push_back(&ptr[i].value);
+		} else if (baseline && baseline->values[i].type == value.type) {
+			writer.write(ReplicationQuantizer::ENCODING_DELTA, 2);
+			ReplicationQuantizer::write_delta(writer, value, baseline->values[i], q);
+		} else {
+			writer.write(ReplicationQuantizer::ENCODING_ABSOLUTE, 2);
+			ReplicationQuantizer::write_absolute(writer, value, q);
+		}
+	}
+	writer.flush();
+	encode_uint32(r_buffer.size() - header - 4, &r_buffer[header]);
+
+	if (varp.size()) {
+		int size;
+		Error err = MultiplayerAPI::encode_and_compress_variants(varp.ptr(), varp.size(), nullptr, size);
+		ERR_FAIL_COND_V(err != OK, err);
+		const uint32_t ofs = r_buffer.size();
+		r_buffer.resize(ofs + size);
+		MultiplayerAPI::encode_and_compress_variants(varp.ptr(), varp.size(), &r_buffer[ofs], size);
+	}
+	return OK;
+}
+
+Error MultiplayerSynchronizer::decode_quantized_delta(uint64_t p_indexes, const uint8_t *p_buffer, int p_size, Vector<Variant> &r_values) {
+	ERR_FAIL_COND_V(replication_config.is_null(), ERR_UNCONFIGURED);
+	const LocalVector<SceneReplicationConfig::Quantization> &quantization = replication_config->get_watch_quantization();
+	ERR_FAIL_COND_V(p_size < 4, ERR_INVALID_DATA);
+	const uint32_t bits_size = decode_uint32(p_buffer);
+	ERR_FAIL_COND_V(bits_size > uint32_t(p_size - 4), ERR_INVALID_DATA);
+
+	if (quantized_received.size() != quantization.size()) {
+		quantized_received.resize(quantization.size());
+	}
+
+	ReplicationQuantizer::BitReader reader(p_buffer + 4, bits_size);
+	LocalVector<int> variant_slots;
+	// Sized upfront, so a reused vector doesn't reallocate.
+	int count = 0;
+	for (uint32_t i = 0; i < quantization.size() && i < 64; i++) {
+		count += (p_indexes >> i) & 1;
+	}
+	r_values.resize(count);
+	int next_slot = 0;
+	for (uint32_t i = 0; i < quantization.size() && i < 64; i++) {
+		if (!(p_indexes & (1ULL << i))) {
+			continue;
+		}
+		const int slot = next_slot++;
+		const SceneReplicationConfig::Quantization &q = quantization[i];
+		if (q.mode == SceneReplicationConfig::PROPERTY_QUANTIZATION_NONE) {
+			variant_slots.push_back(slot);
+			continue;
+		}
+
+		ReplicationQuantizer::Value value;
+		switch (reader.read(2)) {
+			case ReplicationQuantizer::ENCODING_VARIANT: {
+				variant_slots.push_back(slot);
+			} break;
+			case ReplicationQuantizer::ENCODING_ABSOLUTE: {
+				ERR_FAIL_COND_V(!ReplicationQuantizer::read_absolute(reader, q, value), ERR_INVALID_DATA);
+				r_values.write[slot] = ReplicationQuantizer::dequantize(value, q);
+			} break;
+			case ReplicationQuantizer::ENCODING_DELTA: {
+				ERR_FAIL_COND_V(!ReplicationQuantizer::read_delta(reader, quantized_received[i], q, value), ERR_INVALID_DATA);
+				r_values.write[slot] = ReplicationQuantizer::dequantize(value, q);
+			} break;
+			default: {
+				ERR_FAIL_V(ERR_INVALID_DATA);
+			}
+		}
+		quantized_received[i] = value;
+	}
+	ERR_FAIL_COND_V(reader.has_overflowed(), ERR_INVALID_DATA);
+
+	int ofs = 4 + bits_size;
+	if (variant_slots.size()) {
+		Vector<Variant> variants;
+		variants.resize(variant_slots.size());
+		int consumed = 0;
+		Error err = MultiplayerAPI::decode_and_decompress_variants(variants, p_buffer + ofs, p_size - ofs, consumed);
+		ERR_FAIL_COND_V(err != OK, err);
+		ofs += consumed;
+		for (uint32_t i = 0; i < variant_slots.size(); i++) {
+			r_values.write[variant_slots[i]] = variants[i];
+		}
+	}
+	ERR_FAIL_COND_V(ofs != p_size, ERR_INVALID_DATA);
+	return OK;
+}
+
 SceneReplicationConfig *MultiplayerSynchronizer::get_replication_config_ptr() const {
 	return replication_config.ptr();
 }
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "replication_quantizer.h"
 #include "scene_replication_config.h"
 
 #include "scene/main/node.h"
@@ -58,9 +59,22 @@ private:
 	VisibilityUpdateMode visibility_update_mode = VISIBILITY_PROCESS_IDLE;
 	HashSet<Callable> visibility_filters;
 	HashSet<int> peer_visibility;
+	bool use_interest_management = false;
+	HashSet<int> interest_peers; // Peers whose interest volume contains this synchronizer, fed by SceneReplicationInterface.
 	Vector<Watcher> watchers;
 	uint64_t last_watch_usec = 0;
 
+	// Quantized watched state of the last ticks in which deltas were sent, the baselines of the next deltas.
+	static const int QUANTIZED_BASELINE_HISTORY = 32;
+	struct QuantizedBaseline {
+		uint64_t usec = 0;
+		LocalVector<ReplicationQuantizer::Value> values;
+	};
+	LocalVector<QuantizedBaseline> quantized_baselines;
+	uint32_t quantized_baseline_head = 0;
+	// Last quantized values received from the authority, the baselines of the deltas it sends.
+	LocalVector<ReplicationQuantizer::Value> quantized_received;
+
 	ObjectID root_node_cache;
 	uint64_t last_sync_usec = 0;
 	uint16_t last_inbound_sync = 0;
@@ -72,6 +86,8 @@ private:
 	void _stop();
 	void _update_process();
 	Error _watch_changes(uint64_t p_usec);
+	const QuantizedBaseline &_get_quantized_baseline(uint64_t p_usec);
+	const QuantizedBaseline *_find_quantized_baseline(uint64_t p_usec) const;
 
 protected:
 	static void _bind_methods();
@@ -116,8 +132,18 @@ public:
 	void remove_visibility_filter(Callable p_callback);
 	VisibilityUpdateMode get_visibility_update_mode() const;
 
+	void set_use_interest_management(bool p_enabled);
+	bool is_using_interest_management() const;
+	bool get_interest_position(Vector3 &r_position);
+	void set_interest_visibility_for(int p_peer, bool p_visible);
+
+	uint64_t get_delta_indexes(uint64_t p_cur_usec, uint64_t p_last_usec);
 	List<Variant> get_delta_state(uint64_t p_cur_usec, uint64_t p_last_usec, uint64_t &r_indexes);
 	List<NodePath> get_delta_properties(uint64_t p_indexes);
+
+	bool has_quantized_delta() const;
+	Error encode_quantized_delta(uint64_t p_cur_usec, uint64_t p_indexes, uint64_t p_baseline_usec, LocalVector<uint8_t> &r_buffer);
+	Error decode_quantized_delta(uint64_t p_indexes, const uint8_t *p_buffer, int p_size, Vector<Variant> &r_values);
 	SceneReplicationConfig *get_replication_config_ptr() const;
 
 	MultiplayerSynchronizer();
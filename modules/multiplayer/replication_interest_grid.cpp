@@ -0,0 +1,226 @@
+/**************************************************************************/
+/*  replication_interest_grid.cpp                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "replication_interest_grid.h"
+
+void ReplicationInterestGrid::_cell_insert(const Vector3i &p_cell, const ObjectID &p_id) {
+	LocalVector<ObjectID> *cell = cells.getptr(p_cell);
+	if (!cell) {
+		cell = &cells.insert(p_cell, LocalVector<ObjectID>())->value;
+	}
+	cell->push_back(p_id);
+}
+
+void ReplicationInterestGrid::_cell_remove(const Vector3i &p_cell, const ObjectID &p_id) {
+	LocalVector<ObjectID> *cell = cells.getptr(p_cell);
+	ERR_FAIL_NULL(cell); // Bug.
+	int64_t idx = cell->find(p_id);
+	ERR_FAIL_COND(idx < 0); // Bug.
+	cell->remove_at_unordered(idx);
+	if (cell->is_empty()) {
+		cells.erase(p_cell);
+	}
+}
+
+void ReplicationInterestGrid::_query(const Interest &p_interest, HashSet<ObjectID> &r_visible) const {
+	const Vector3 extents(p_interest.radius, p_interest.radius, p_interest.radius);
+	const Vector3i from = _get_cell(p_interest.position - extents);
+	const Vector3i to = _get_cell(p_interest.position + extents);
+	// Each side can span the whole int32_t range, so the count may not fit in 64 bits.
+	const double cell_count = double(int64_t(to.x) - from.x + 1) * double(int64_t(to.y) - from.y + 1) * double(int64_t(to.z) - from.z + 1);
+	if (cell_count >= cells.size()) {
+		// The volume covers more cells than there are populated ones, go through those instead.
+		for (const KeyValue<Vector3i, LocalVector<ObjectID>> &E : cells) {
+			if (E.key.x < from.x || E.key.x > to.x || E.key.y < from.y || E.key.y > to.y || E.key.z < from.z || E.key.z > to.z) {
+				continue;
+			}
+			for (const ObjectID &id : E.value) {
+				if (_is_inside(p_interest, entries[id].position)) {
+					r_visible.insert(id);
+				}
+			}
+		}
+		return;
+	}
+	// 64-bit counters, so a side ending on INT32_MAX doesn't overflow.
+	for (int64_t x = from.x; x <= to.x; x++) {
+		for (int64_t y = from.y; y <= to.y; y++) {
+			for (int64_t z = from.z; z <= to.z; z++) {
+				const LocalVector<ObjectID> *ids = cells.getptr(Vector3i(x, y, z));
+				if (!ids) {
+					continue;
+				}
+				for (const ObjectID &id : *ids) {
+					if (_is_inside(p_interest, entries[id].position)) {
+						r_visible.insert(id);
+					}
+				}
+			}
+		}
+	}
+}
+
+void ReplicationInterestGrid::set_cell_size(real_t p_size) {
+	ERR_FAIL_COND_MSG(p_size <= 0, "Cell size must be greater than 0.");
+	if (p_size == cell_size) {
+		return;
+	}
+	cell_size = p_size;
+	cells.clear();
+	for (KeyValue<ObjectID, Entry> &E : entries) {
+		E.value.cell = _get_cell(E.value.position);
+		_cell_insert(E.value.cell, E.key);
+	}
+	// Visibility itself does not depend on the cell size, no need to re-evaluate anything.
+}
+
+void ReplicationInterestGrid::set_position(const ObjectID &p_id, const Vector3 &p_position) {
+	Entry *entry = entries.getptr(p_id);
+	if (!entry) {
+		entry = &entries.insert(p_id, Entry())->value;
+		entry->position = p_position;
+		entry->cell = _get_cell(p_position);
+		_cell_insert(entry->cell, p_id);
+	} else if (entry->position == p_position) {
+		return;
+	} else {
+		entry->position = p_position;
+		const Vector3i cell = _get_cell(p_position);
+		if (cell != entry->cell) {
+			_cell_remove(entry->cell, p_id);
+			_cell_insert(cell, p_id);
+			entry->cell = cell;
+		}
+	}
+	if (!entry->dirty) {
+		entry->dirty = true;
+		dirty_entries.push_back(p_id);
+	}
+}
+
+void ReplicationInterestGrid::remove(const ObjectID &p_id) {
+	Entry *entry = entries.getptr(p_id);
+	if (!entry) {
+		return;
+	}
+	_cell_remove(entry->cell, p_id);
+	entries.erase(p_id);
+	for (KeyValue<int, Interest> &E : interests) {
+		E.value.visible.erase(p_id);
+	}
+	// Stale ids in dirty_entries are skipped during update.
+}
+
+void ReplicationInterestGrid::set_interest(int p_peer, const Vector3 &p_position, real_t p_radius) {
+	ERR_FAIL_COND_MSG(p_radius < 0, "Interest radius must be greater or equal to 0.");
+	Interest *interest = interests.getptr(p_peer);
+	if (!interest) {
+		interest = &interests.insert(p_peer, Interest())->value;
+	} else if (interest->position == p_position && interest->radius == p_radius) {
+		return;
+	}
+	interest->position = p_position;
+	interest->radius = p_radius;
+	if (!interest->dirty) {
+		interest->dirty = true;
+		dirty_interests.push_back(p_peer);
+	}
+}
+
+void ReplicationInterestGrid::remove_interest(int p_peer, LocalVector<Change> &r_changes) {
+	Interest *interest = interests.getptr(p_peer);
+	if (!interest) {
+		return;
+	}
+	for (const ObjectID &id : interest->visible) {
+		r_changes.push_back({ p_peer, id, false });
+	}
+	interests.erase(p_peer);
+}
+
+bool ReplicationInterestGrid::is_visible(int p_peer, const ObjectID &p_id) const {
+	const Interest *interest = interests.getptr(p_peer);
+	return interest && interest->visible.has(p_id);
+}
+
+void ReplicationInterestGrid::update(LocalVector<Change> &r_changes) {
+	// Peers whose volume changed get a full query.
+	for (const int peer : dirty_interests) {
+		Interest *interest = interests.getptr(peer);
+		if (!interest || !interest->dirty) {
+			continue; // Removed.
+		}
+		interest->dirty = false;
+		HashSet<ObjectID> visible;
+		_query(*interest, visible);
+		for (const ObjectID &id : interest->visible) {
+			if (!visible.has(id)) {
+				r_changes.push_back({ peer, id, false });
+			}
+		}
+		for (const ObjectID &id : visible) {
+			if (!interest->visible.has(id)) {
+				r_changes.push_back({ peer, id, true });
+			}
+		}
+		interest->visible = visible;
+	}
+	dirty_interests.clear();
+
+	// Objects that moved are tested against the remaining peers.
+	for (const ObjectID &id : dirty_entries) {
+		Entry *entry = entries.getptr(id);
+		if (!entry || !entry->dirty) {
+			continue; // Removed.
+		}
+		entry->dirty = false;
+		for (KeyValue<int, Interest> &E : interests) {
+			const bool inside = _is_inside(E.value, entry->position);
+			if (inside == E.value.visible.has(id)) {
+				continue;
+			}
+			if (inside) {
+				E.value.visible.insert(id);
+			} else {
+				E.value.visible.erase(id);
+			}
+			r_changes.push_back({ E.key, id, inside });
+		}
+	}
+	dirty_entries.clear();
+}
+
+void ReplicationInterestGrid::clear() {
+	entries.clear();
+	cells.clear();
+	interests.clear();
+	dirty_entries.clear();
+	dirty_interests.clear();
+}
@@ -0,0 +1,114 @@
+/**************************************************************************/
+/*  replication_interest_grid.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/vector3.h"
+#include "core/math/vector3i.h"
+#include "core/object/object_id.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+
+// Spatial interest management for scene replication.
+// Objects (synchronizers) and peer interest volumes (spheres) are kept in a uniform hash grid. Each update
+// only re-evaluates the peers whose volume changed and the objects that moved, and reports the resulting
+// visibility changes.
+class ReplicationInterestGrid {
+public:
+	struct Change {
+		int peer = 0;
+		ObjectID id;
+		bool visible = false;
+	};
+
+private:
+	struct Entry {
+		Vector3 position;
+		Vector3i cell;
+		bool dirty = false;
+	};
+
+	struct Interest {
+		Vector3 position;
+		real_t radius = 0;
+		bool dirty = false;
+		HashSet<ObjectID> visible;
+	};
+
+	real_t cell_size = 64;
+	HashMap<ObjectID, Entry> entries;
+	HashMap<Vector3i, LocalVector<ObjectID>> cells;
+	HashMap<int, Interest> interests;
+	LocalVector<ObjectID> dirty_entries;
+	LocalVector<int> dirty_interests;
+
+	_FORCE_INLINE_ static int32_t _get_cell_coord(double p_cell) {
+		// Vector3i can't hold cells that far away, they are merged into the border cells (NaN included).
+		if (!(p_cell > INT32_MIN)) {
+			return INT32_MIN;
+		}
+		if (p_cell >= INT32_MAX) {
+			return INT32_MAX;
+		}
+		return int32_t(p_cell);
+	}
+	_FORCE_INLINE_ Vector3i _get_cell(const Vector3 &p_position) const {
+		return Vector3i(
+				_get_cell_coord(Math::floor(double(p_position.x) / cell_size)),
+				_get_cell_coord(Math::floor(double(p_position.y) / cell_size)),
+				_get_cell_coord(Math::floor(double(p_position.z) / cell_size)));
+	}
+	_FORCE_INLINE_ static bool _is_inside(const Interest &p_interest, const Vector3 &p_position) {
+		return p_interest.position.distance_squared_to(p_position) <= p_interest.radius * p_interest.radius;
+	}
+	void _cell_insert(const Vector3i &p_cell, const ObjectID &p_id);
+	void _cell_remove(const Vector3i &p_cell, const ObjectID &p_id);
+	void _query(const Interest &p_interest, HashSet<ObjectID> &r_visible) const;
+
+public:
+	void set_cell_size(real_t p_size);
+	real_t get_cell_size() const { return cell_size; }
+
+	void set_position(const ObjectID &p_id, const Vector3 &p_position);
+	bool has(const ObjectID &p_id) const { return entries.has(p_id); }
+	void remove(const ObjectID &p_id);
+	uint32_t size() const { return entries.size(); }
+
+	void set_interest(int p_peer, const Vector3 &p_position, real_t p_radius);
+	bool has_interest(int p_peer) const { return interests.has(p_peer); }
+	// Removes the interest volume of a peer, the objects it could see are reported as no longer visible.
+	void remove_interest(int p_peer, LocalVector<Change> &r_changes);
+	bool is_visible(int p_peer, const ObjectID &p_id) const;
+
+	// Applies the pending moves and reports which objects entered or left the interest volume of each peer.
+	void update(LocalVector<Change> &r_changes);
+	void clear();
+};
@@ -0,0 +1,320 @@
+/**************************************************************************/
+/*  replication_quantizer.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "replication_quantizer.h"
+
+#include "core/math/quaternion.h"
+
+void ReplicationQuantizer::BitWriter::write(uint64_t p_value, int p_bits) {
+	while (p_bits > 0) {
+		int count = MIN(p_bits, 8 - pending_bits);
+		pending |= uint8_t((p_value & ((1U << count) - 1)) << pending_bits);
+		pending_bits += count;
+		p_value >>= count;
+		p_bits -= count;
+		if (pending_bits == 8) {
+			buffer.push_back(pending);
+			pending = 0;
+			pending_bits = 0;
+		}
+	}
+}
+
+void ReplicationQuantizer::BitWriter::write_var(uint64_t p_value) {
+	do {
+		write(p_value & 0xF, 4);
+		p_value >>= 4;
+		write(p_value ? 1 : 0, 1);
+	} while (p_value);
+}
+
+void ReplicationQuantizer::BitWriter::flush() {
+	if (pending_bits) {
+		buffer.push_back(pending);
+		pending = 0;
+		pending_bits = 0;
+	}
+}
+
+uint64_t ReplicationQuantizer::BitReader::read(int p_bits) {
+	if (position + p_bits > size_bits) {
+		overflow = true;
+		return 0;
+	}
+	uint64_t value = 0;
+	int shift = 0;
+	while (shift < p_bits) {
+		int bit = position & 7;
+		int count = MIN(p_bits - shift, 8 - bit);
+		value |= uint64_t((data[position >> 3] >> bit) & ((1U << count) - 1)) << shift;
+		position += count;
+		shift += count;
+	}
+	return value;
+}
+
+uint64_t ReplicationQuantizer::BitReader::read_var() {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 4) {
+		value |= read(4) << shift;
+		if (!read(1) || overflow) {
+			return value;
+		}
+	}
+	overflow = true; // Malformed, more than 64 bits.
+	return 0;
+}
+
+static int _bounded_int_bits(const SceneReplicationConfig::Quantization &p_quantization) {
+	// Computed unsigned, the range of a full 64-bit interval doesn't fit in int64_t.
+	uint64_t range = uint64_t(p_quantization.max) - uint64_t(p_quantization.min);
+	int bits = 0;
+	while (bits < 64 && (range >> bits)) {
+		bits++;
+	}
+	return bits;
+}
+
+int ReplicationQuantizer::get_component_count(Variant::Type p_type, const SceneReplicationConfig::Quantization &p_quantization) {
+	switch (p_quantization.mode) {
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT: {
+			switch (p_type) {
+				case Variant::FLOAT:
+					return 1;
+				case Variant::VECTOR2:
+					return 2;
+				case Variant::VECTOR3:
+					return 3;
+				case Variant::VECTOR4:
+					return 4;
+				default:
+					return 0;
+			}
+		}
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION: {
+			// Index of the largest component, followed by the three others ("smallest three").
+			return p_type == Variant::QUATERNION ? 4 : 0;
+		}
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT: {
+			return p_type == Variant::INT ? 1 : 0;
+		}
+		default:
+			return 0;
+	}
+}
+
+ReplicationQuantizer::Value ReplicationQuantizer::quantize(const Variant &p_value, const SceneReplicationConfig::Quantization &p_quantization) {
+	Value value;
+	int count = get_component_count(p_value.get_type(), p_quantization);
+	if (!count) {
+		return value;
+	}
+	value.type = p_value.get_type();
+
+	switch (p_quantization.mode) {
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT: {
+			real_t components[MAX_COMPONENTS] = {};
+			switch (value.type) {
+				case Variant::FLOAT: {
+					components[0] = p_value;
+				} break;
+				case Variant::VECTOR2: {
+					Vector2 v = p_value;
+					components[0] = v.x;
+					components[1] = v.y;
+				} break;
+				case Variant::VECTOR3: {
+					Vector3 v = p_value;
+					components[0] = v.x;
+					components[1] = v.y;
+					components[2] = v.z;
+				} break;
+				case Variant::VECTOR4: {
+					Vector4 v = p_value;
+					components[0] = v.x;
+					components[1] = v.y;
+					components[2] = v.z;
+					components[3] = v.w;
+				} break;
+				default:
+					break;
+			}
+			for (int i = 0; i < count; i++) {
+				const double component = Math::round(double(components[i]) / p_quantization.precision);
+				if (!Math::is_finite(component) || Math::abs(component) > MAX_FIXED_POINT_COMPONENT) {
+					return Value();
+				}
+				value.components[i] = int64_t(component);
+			}
+		} break;
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION: {
+			Quaternion q = p_value;
+			// Also catches non-finite components.
+			const real_t length_squared = q.length_squared();
+			if (!Math::is_finite(length_squared) || length_squared == 0) {
+				return Value(); // Can't be normalized.
+			}
+			q = q.normalized();
+			int largest = 0;
+			for (int i = 1; i < 4; i++) {
+				if (Math::abs(q[i]) > Math::abs(q[largest])) {
+					largest = i;
+				}
+			}
+			if (q[largest] < 0) {
+				q = -q; // q and -q are the same rotation, keep the omitted component positive.
+			}
+			const int64_t max_value = (1 << QUATERNION_COMPONENT_BITS) - 1;
+			value.components[0] = largest;
+			int c = 1;
+			for (int i = 0; i < 4; i++) {
+				if (i == largest) {
+					continue;
+				}
+				// The other components are within [-1/sqrt(2), 1/sqrt(2)].
+				real_t normalized = (q[i] + (real_t)Math::SQRT12) / (real_t)Math::SQRT2;
+				value.components[c++] = CLAMP(int64_t(Math::round(normalized * max_value)), 0, max_value);
+			}
+		} break;
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT: {
+			int64_t v = p_value;
+			value.components[0] = int64_t(uint64_t(CLAMP(v, p_quantization.min, p_quantization.max)) - uint64_t(p_quantization.min));
+		} break;
+		default:
+			break;
+	}
+	return value;
+}
+
+Variant ReplicationQuantizer::dequantize(const Value &p_value, const SceneReplicationConfig::Quantization &p_quantization) {
+	switch (p_quantization.mode) {
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT: {
+			real_t c[MAX_COMPONENTS];
+			for (int i = 0; i < MAX_COMPONENTS; i++) {
+				c[i] = p_value.components[i] * p_quantization.precision;
+			}
+			switch (p_value.type) {
+				case Variant::FLOAT:
+					return c[0];
+				case Variant::VECTOR2:
+					return Vector2(c[0], c[1]);
+				case Variant::VECTOR3:
+					return Vector3(c[0], c[1], c[2]);
+				case Variant::VECTOR4:
+					return Vector4(c[0], c[1], c[2], c[3]);
+				default:
+					return Variant();
+			}
+		}
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION: {
+			const real_t max_value = (1 << QUATERNION_COMPONENT_BITS) - 1;
+			int largest = CLAMP(int(p_value.components[0]), 0, 3);
+			Quaternion q;
+			real_t sum = 0;
+			int c = 1;
+			for (int i = 0; i < 4; i++) {
+				if (i == largest) {
+					continue;
+				}
+				q[i] = p_value.components[c++] / max_value * (real_t)Math::SQRT2 - (real_t)Math::SQRT12;
+				sum += q[i] * q[i];
+			}
+			q[largest] = Math::sqrt(MAX((real_t)0, 1 - sum));
+			return q.normalized();
+		}
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT: {
+			return int64_t(uint64_t(p_value.components[0]) + uint64_t(p_quantization.min));
+		}
+		default:
+			return Variant();
+	}
+}
+
+void ReplicationQuantizer::write_absolute(BitWriter &p_writer, const Value &p_value, const SceneReplicationConfig::Quantization &p_quantization) {
+	p_writer.write(p_value.type, 6);
+	switch (p_quantization.mode) {
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION: {
+			p_writer.write(p_value.components[0], 2);
+			for (int i = 1; i < 4; i++) {
+				p_writer.write(p_value.components[i], QUATERNION_COMPONENT_BITS);
+			}
+		} break;
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT: {
+			p_writer.write(p_value.components[0], _bounded_int_bits(p_quantization));
+		} break;
+		default: {
+			int count = get_component_count(p_value.type, p_quantization);
+			for (int i = 0; i < count; i++) {
+				p_writer.write_var(zigzag_encode(p_value.components[i]));
+			}
+		} break;
+	}
+}
+
+bool ReplicationQuantizer::read_absolute(BitReader &p_reader, const SceneReplicationConfig::Quantization &p_quantization, Value &r_value) {
+	r_value.type = Variant::Type(p_reader.read(6));
+	int count = r_value.type < Variant::VARIANT_MAX ? get_component_count(r_value.type, p_quantization) : 0;
+	ERR_FAIL_COND_V_MSG(!count, false, "Invalid quantized property type.");
+	switch (p_quantization.mode) {
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION: {
+			r_value.components[0] = p_reader.read(2);
+			for (int i = 1; i < 4; i++) {
+				r_value.components[i] = p_reader.read(QUATERNION_COMPONENT_BITS);
+			}
+		} break;
+		case SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT: {
+			r_value.components[0] = p_reader.read(_bounded_int_bits(p_quantization));
+		} break;
+		default: {
+			for (int i = 0; i < count; i++) {
+				r_value.components[i] = zigzag_decode(p_reader.read_var());
+			}
+		} break;
+	}
+	return !p_reader.has_overflowed();
+}
+
+void ReplicationQuantizer::write_delta(BitWriter &p_writer, const Value &p_value, const Value &p_baseline, const SceneReplicationConfig::Quantization &p_quantization) {
+	int count = get_component_count(p_value.type, p_quantization);
+	for (int i = 0; i < count; i++) {
+		// Wraps around for bounded ints spanning more than half the 64-bit range, read_delta() wraps back.
+		p_writer.write_var(zigzag_encode(int64_t(uint64_t(p_value.components[i]) - uint64_t(p_baseline.components[i]))));
+	}
+}
+
+bool ReplicationQuantizer::read_delta(BitReader &p_reader, const Value &p_baseline, const SceneReplicationConfig::Quantization &p_quantization, Value &r_value) {
+	r_value.type = p_baseline.type;
+	int count = get_component_count(r_value.type, p_quantization);
+	ERR_FAIL_COND_V_MSG(!count, false, "Received a quantized delta without a valid baseline.");
+	for (int i = 0; i < count; i++) {
+		r_value.components[i] = int64_t(uint64_t(p_baseline.components[i]) + uint64_t(zigzag_decode(p_reader.read_var())));
+	}
+	return !p_reader.has_overflowed();
+}
@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*  replication_quantizer.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "scene_replication_config.h"
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+// Compact encoding of quantized properties, used by MultiplayerSynchronizer for its delta states.
+// Values are turned into up to four integer components, which are bit-packed either as absolute values
+// or as the difference from a baseline both ends agree on.
+class ReplicationQuantizer {
+public:
+	static const int MAX_COMPONENTS = 4;
+	static const int QUATERNION_COMPONENT_BITS = 12;
+	// Larger fixed point components aren't quantized, so the difference of two of them always fits in 64 bits.
+	static const int64_t MAX_FIXED_POINT_COMPONENT = int64_t(1) << 53;
+
+	// How each quantized property is written, as a 2-bit header.
+	enum Encoding {
+		ENCODING_VARIANT, // Not quantizable (unsupported type), sent as a regular Variant.
+		ENCODING_ABSOLUTE,
+		ENCODING_DELTA,
+	};
+
+	struct Value {
+		Variant::Type type = Variant::NIL; // NIL if the value couldn't be quantized.
+		int64_t components[MAX_COMPONENTS] = {};
+	};
+
+	class BitWriter {
+		LocalVector<uint8_t> &buffer;
+		uint8_t pending = 0;
+		int pending_bits = 0;
+
+	public:
+		void write(uint64_t p_value, int p_bits);
+		// Variable length, 4 bits at a time plus a continuation bit.
+		void write_var(uint64_t p_value);
+		void flush();
+
+		BitWriter(LocalVector<uint8_t> &r_buffer) :
+				buffer(r_buffer) {}
+	};
+
+	class BitReader {
+		const uint8_t *data = nullptr;
+		uint64_t size_bits = 0;
+		uint64_t position = 0;
+		bool overflow = false;
+
+	public:
+		uint64_t read(int p_bits);
+		uint64_t read_var();
+		bool has_overflowed() const { return overflow; }
+
+		BitReader(const uint8_t *p_data, int p_size) :
+				data(p_data), size_bits(uint64_t(p_size) * 8) {}
+	};
+
+	_FORCE_INLINE_ static uint64_t zigzag_encode(int64_t p_value) { return (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63); }
+	_FORCE_INLINE_ static int64_t zigzag_decode(uint64_t p_value) { return int64_t(p_value >> 1) ^ -int64_t(p_value & 1); }
+
+	// Number of components for a value of the given type, 0 if the type isn't supported by the quantization mode.
+	static int get_component_count(Variant::Type p_type, const SceneReplicationConfig::Quantization &p_quantization);
+
+	// Values that can't be quantized (non-finite or too large) get a NIL type, and are sent as a regular Variant.
+	static Value quantize(const Variant &p_value, const SceneReplicationConfig::Quantization &p_quantization);
+	static Variant dequantize(const Value &p_value, const SceneReplicationConfig::Quantization &p_quantization);
+
+	static void write_absolute(BitWriter &p_writer, const Value &p_value, const SceneReplicationConfig::Quantization &p_quantization);
+	static bool read_absolute(BitReader &p_reader, const SceneReplicationConfig::Quantization &p_quantization, Value &r_value);
+	static void write_delta(BitWriter &p_writer, const Value &p_value, const Value &p_baseline, const SceneReplicationConfig::Quantization &p_quantization);
+	static bool read_delta(BitReader &p_reader, const Value &p_baseline, const SceneReplicationConfig::Quantization &p_quantization, Value &r_value);
+};
@@ -52,6 +52,24 @@ bool SceneReplicationConfig::_set(const StringName &p_name, const Variant &p_val
 			ERR_FAIL_COND_V(mode < REPLICATION_MODE_NEVER || mode > REPLICATION_MODE_ON_CHANGE, false);
 			property_set_replication_mode(prop.name, mode);
 			return true;
+		} else if (what == "quantization") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			PropertyQuantization quantization = (PropertyQuantization)p_value.operator int();
+			ERR_FAIL_COND_V(quantization < PROPERTY_QUANTIZATION_NONE || quantization > PROPERTY_QUANTIZATION_BOUNDED_INT, false);
+			property_set_quantization(prop.name, quantization);
+			return true;
+		} else if (what == "quantization_precision") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::FLOAT && p_value.get_type() != Variant::INT, false);
+			property_set_quantization_precision(prop.name, p_value);
+			return true;
+		} else if (what == "quantization_min") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			property_set_quantization_range(prop.name, p_value, MAX(int64_t(p_value), prop.quantization.max));
+			return true;
+		} else if (what == "quantization_max") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::INT, false);
+			property_set_quantization_range(prop.name, MIN(int64_t(p_value), prop.quantization.min), p_value);
+			return true;
 		}
 		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
 		if (what == "spawn") {
@@ -87,6 +105,18 @@ bool SceneReplicationConfig::_get(const StringName &p_name, Variant &r_ret) cons
 		} else if (what == "replication_mode") {
 			r_ret = prop.mode;
 			return true;
+		} else if (what == "quantization") {
+			r_ret = prop.quantization.mode;
+			return true;
+		} else if (what == "quantization_precision") {
+			r_ret = prop.quantization.precision;
+			return true;
+		} else if (what == "quantization_min") {
+			r_ret = prop.quantization.min;
+			return true;
+		} else if (what == "quantization_max") {
+			r_ret = prop.quantization.max;
+			return true;
 		}
 	}
 	return false;
@@ -97,6 +127,16 @@ void SceneReplicationConfig::_get_property_list(List<PropertyInfo> *p_list) cons
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/spawn", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/replication_mode", PROPERTY_HINT_ENUM, "Never,Always,On Change", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		const Quantization &quantization = properties.get(i).quantization;
+		if (quantization.mode != PROPERTY_QUANTIZATION_NONE) {
+			p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/quantization", PROPERTY_HINT_ENUM, "None,Fixed Point,Quaternion,Bounded Int", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+			if (quantization.mode == PROPERTY_QUANTIZATION_FIXED_POINT) {
+				p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/quantization_precision", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+			} else if (quantization.mode == PROPERTY_QUANTIZATION_BOUNDED_INT) {
+				p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/quantization_min", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+				p_list->push_back(PropertyInfo(Variant::INT, "properties/" + itos(i) + "/quantization_max", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+			}
+		}
 	}
 }
 
@@ -106,6 +146,8 @@ void SceneReplicationConfig::reset_state() {
 	sync_props.clear();
 	spawn_props.clear();
 	watch_props.clear();
+	watch_quantization.clear();
+	watch_quantized = false;
 }
 
 TypedArray<NodePath> SceneReplicationConfig::get_properties() const {
@@ -222,6 +264,57 @@ void SceneReplicationConfig::property_set_replication_mode(const NodePath &p_pat
 	dirty = true;
 }
 
+SceneReplicationConfig::PropertyQuantization SceneReplicationConfig::property_get_quantization(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, PROPERTY_QUANTIZATION_NONE);
+	return E->get().quantization.mode;
+}
+
+void SceneReplicationConfig::property_set_quantization(const NodePath &p_path, PropertyQuantization p_quantization) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	if (E->get().quantization.mode == p_quantization) {
+		return;
+	}
+	E->get().quantization.mode = p_quantization;
+	dirty = true;
+}
+
+real_t SceneReplicationConfig::property_get_quantization_precision(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, 0);
+	return E->get().quantization.precision;
+}
+
+void SceneReplicationConfig::property_set_quantization_precision(const NodePath &p_path, real_t p_precision) {
+	ERR_FAIL_COND_MSG(p_precision <= 0, "Quantization precision must be greater than 0.");
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().quantization.precision = p_precision;
+	dirty = true;
+}
+
+int64_t SceneReplicationConfig::property_get_quantization_min(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, 0);
+	return E->get().quantization.min;
+}
+
+int64_t SceneReplicationConfig::property_get_quantization_max(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, 0);
+	return E->get().quantization.max;
+}
+
+void SceneReplicationConfig::property_set_quantization_range(const NodePath &p_path, int64_t p_min, int64_t p_max) {
+	ERR_FAIL_COND_MSG(p_min > p_max, "Quantization minimum can't be greater than the maximum.");
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	E->get().quantization.min = p_min;
+	E->get().quantization.max = p_max;
+	dirty = true;
+}
+
 void SceneReplicationConfig::_update() {
 	if (!dirty) {
 		return;
@@ -230,6 +323,8 @@ void SceneReplicationConfig::_update() {
 	sync_props.clear();
 	spawn_props.clear();
 	watch_props.clear();
+	watch_quantization.clear();
+	watch_quantized = false;
 	for (const ReplicationProperty &prop : properties) {
 		if (prop.spawn) {
 			spawn_props.push_back(prop.name);
@@ -240,6 +335,8 @@ void SceneReplicationConfig::_update() {
 				break;
 			case REPLICATION_MODE_ON_CHANGE:
 				watch_props.push_back(prop.name);
+				watch_quantization.push_back(prop.quantization);
+				watch_quantized = watch_quantized || prop.quantization.mode != PROPERTY_QUANTIZATION_NONE;
 				break;
 			default:
 				break;
@@ -268,6 +365,20 @@ const List<NodePath> &SceneReplicationConfig::get_watch_properties() {
 	return watch_props;
 }
 
+const LocalVector<SceneReplicationConfig::Quantization> &SceneReplicationConfig::get_watch_quantization() {
+	if (dirty) {
+		_update();
+	}
+	return watch_quantization;
+}
+
+bool SceneReplicationConfig::has_watch_quantization() {
+	if (dirty) {
+		_update();
+	}
+	return watch_quantized;
+}
+
 void SceneReplicationConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_properties"), &SceneReplicationConfig::get_properties);
 	ClassDB::bind_method(D_METHOD("add_property", "path", "index"), &SceneReplicationConfig::add_property, DEFVAL(-1));
@@ -279,10 +390,23 @@ void SceneReplicationConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("property_get_replication_mode", "path"), &SceneReplicationConfig::property_get_replication_mode);
 	ClassDB::bind_method(D_METHOD("property_set_replication_mode", "path", "mode"), &SceneReplicationConfig::property_set_replication_mode);
 
+	ClassDB::bind_method(D_METHOD("property_get_quantization", "path"), &SceneReplicationConfig::property_get_quantization);
+	ClassDB::bind_method(D_METHOD("property_set_quantization", "path", "quantization"), &SceneReplicationConfig::property_set_quantization);
+	ClassDB::bind_method(D_METHOD("property_get_quantization_precision", "path"), &SceneReplicationConfig::property_get_quantization_precision);
+	ClassDB::bind_method(D_METHOD("property_set_quantization_precision", "path", "precision"), &SceneReplicationConfig::property_set_quantization_precision);
+	ClassDB::bind_method(D_METHOD("property_get_quantization_min", "path"), &SceneReplicationConfig::property_get_quantization_min);
+	ClassDB::bind_method(D_METHOD("property_get_quantization_max", "path"), &SceneReplicationConfig::property_get_quantization_max);
+	ClassDB::bind_method(D_METHOD("property_set_quantization_range", "path", "min", "max"), &SceneReplicationConfig::property_set_quantization_range);
+
 	BIND_ENUM_CONSTANT(REPLICATION_MODE_NEVER);
 	BIND_ENUM_CONSTANT(REPLICATION_MODE_ALWAYS);
 	BIND_ENUM_CONSTANT(REPLICATION_MODE_ON_CHANGE);
 
+	BIND_ENUM_CONSTANT(PROPERTY_QUANTIZATION_NONE);
+	BIND_ENUM_CONSTANT(PROPERTY_QUANTIZATION_FIXED_POINT);
+	BIND_ENUM_CONSTANT(PROPERTY_QUANTIZATION_QUATERNION);
+	BIND_ENUM_CONSTANT(PROPERTY_QUANTIZATION_BOUNDED_INT);
+
 	// Deprecated.
 	ClassDB::bind_method(D_METHOD("property_get_sync", "path"), &SceneReplicationConfig::property_get_sync);
 	ClassDB::bind_method(D_METHOD("property_set_sync", "path", "enabled"), &SceneReplicationConfig::property_set_sync);
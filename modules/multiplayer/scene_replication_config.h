@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 class SceneReplicationConfig : public Resource {
@@ -45,11 +46,26 @@ public:
 		REPLICATION_MODE_ON_CHANGE,
 	};
 
+	enum PropertyQuantization {
+		PROPERTY_QUANTIZATION_NONE,
+		PROPERTY_QUANTIZATION_FIXED_POINT,
+		PROPERTY_QUANTIZATION_QUATERNION,
+		PROPERTY_QUANTIZATION_BOUNDED_INT,
+	};
+
+	struct Quantization {
+		PropertyQuantization mode = PROPERTY_QUANTIZATION_NONE;
+		real_t precision = 0.001;
+		int64_t min = 0;
+		int64_t max = 255;
+	};
+
 private:
 	struct ReplicationProperty {
 		NodePath name;
 		bool spawn = true;
 		ReplicationMode mode = REPLICATION_MODE_ALWAYS;
+		Quantization quantization;
 
 		bool operator==(const ReplicationProperty &p_to) {
 			return name == p_to.name;
@@ -66,6 +82,8 @@ private:
 	List<NodePath> spawn_props;
 	List<NodePath> sync_props;
 	List<NodePath> watch_props;
+	LocalVector<Quantization> watch_quantization;
+	bool watch_quantized = false;
 	bool dirty = false;
 
 	void _update();
@@ -99,11 +117,25 @@ public:
 	ReplicationMode property_get_replication_mode(const NodePath &p_path);
 	void property_set_replication_mode(const NodePath &p_path, ReplicationMode p_mode);
 
+	PropertyQuantization property_get_quantization(const NodePath &p_path);
+	void property_set_quantization(const NodePath &p_path, PropertyQuantization p_quantization);
+
+	real_t property_get_quantization_precision(const NodePath &p_path);
+	void property_set_quantization_precision(const NodePath &p_path, real_t p_precision);
+
+	int64_t property_get_quantization_min(const NodePath &p_path);
+	int64_t property_get_quantization_max(const NodePath &p_path);
+	void property_set_quantization_range(const NodePath &p_path, int64_t p_min, int64_t p_max);
+
 	const List<NodePath> &get_spawn_properties();
 	const List<NodePath> &get_sync_properties();
 	const List<NodePath> &get_watch_properties();
+	// Quantization of each property in get_watch_properties().
+	const LocalVector<Quantization> &get_watch_quantization();
+	bool has_watch_quantization();
 
 	SceneReplicationConfig() {}
 };
 
 VARIANT_ENUM_CAST(SceneReplicationConfig::ReplicationMode);
+VARIANT_ENUM_CAST(SceneReplicationConfig::PropertyQuantization);
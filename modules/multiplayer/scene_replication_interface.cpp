@@ -34,6 +34,7 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/main/node.h"
 
 #define MAKE_ROOM(m_amount)             \
@@ -102,6 +103,8 @@ void SceneReplicationInterface::on_peer_change(int p_id, bool p_connected) {
 		ERR_FAIL_COND(!peers_info.has(p_id));
 		_free_remotes(peers_info[p_id]);
 		peers_info.erase(p_id);
+		interest_grid.remove_interest(p_id, interest_changes);
+		_apply_interest_changes();
 	}
 }
 
@@ -121,6 +124,7 @@ void SceneReplicationInterface::on_reset() {
 		ERR_CONTINUE(!sync);
 		sync->reset();
 	}
+	interest_grid.clear();
 	last_net_id = 0;
 }
 
@@ -138,16 +142,38 @@ void SceneReplicationInterface::on_network_process() {
 		spawn_queue.clear();
 	}
 
+	// Update visibility from interest volumes before deciding what to send.
+	_update_interest();
+
 	// Process syncs.
 	uint64_t usec = OS::get_singleton()->get_ticks_usec();
+	_clear_snapshots();
+	// Gather which states each peer needs, encoding each of them once. This touches the scene so it stays on this thread.
+	uint32_t outbound_count = 0;
+	uint32_t state_count = 0;
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
 		const HashSet<ObjectID> to_sync = E.value.sync_nodes;
 		if (to_sync.is_empty()) {
 			continue; // Nothing to sync
 		}
-		uint16_t sync_net_time = ++E.value.last_sent_sync;
-		_send_sync(E.key, to_sync, sync_net_time, usec);
-		_send_delta(E.key, to_sync, usec, E.value.last_watch_usecs);
+		if (outbound.size() <= outbound_count) {
+			outbound.resize(outbound_count + 1);
+		}
+		PeerOutbound &peer_outbound = outbound[outbound_count++];
+		peer_outbound.peer = E.key;
+		peer_outbound.sync_net_time = ++E.value.last_sent_sync;
+		_gather_sync(peer_outbound, to_sync, usec);
+		_gather_delta(peer_outbound, to_sync, usec, E.value.last_watch_usecs);
+		state_count += peer_outbound.sync_states.size() + peer_outbound.delta_states.size();
+	}
+
+	_assemble_outbound(outbound_count, outbound_count > 1 && state_count >= PARALLEL_ASSEMBLY_MIN_STATES);
+
+	for (uint32_t i = 0; i < outbound_count; i++) {
+		const PeerOutbound &peer_outbound = outbound[i];
+		for (const OutboundPacket &packet : peer_outbound.packets) {
+			_send_raw(&peer_outbound.buffer[packet.offset], packet.size, peer_outbound.peer, packet.reliable);
+		}
 	}
 }
 
@@ -277,7 +303,9 @@ Error SceneReplicationInterface::on_replication_stop(Object *p_obj, Variant p_co
 	TrackedNode &tobj = _track(oid);
 	tobj.synchronizers.erase(sid);
 	sync_nodes.erase(sid);
+	interest_grid.remove(sid);
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
+		sync->set_interest_visibility_for(E.key, false);
 		E.value.sync_nodes.erase(sid);
 		E.value.last_watch_usecs.erase(sid);
 		if (sync->get_net_id()) {
@@ -299,6 +327,58 @@ void SceneReplicationInterface::_visibility_changed(int p_peer, ObjectID p_sid)
 	_update_sync_visibility(p_peer, sync);
 }
 
+void SceneReplicationInterface::_update_interest() {
+	for (const ObjectID &sid : sync_nodes) {
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(sid);
+		ERR_CONTINUE(!sync);
+		Vector3 position;
+		if (sync->is_using_interest_management() && _has_authority(sync) && sync->get_interest_position(position)) {
+			interest_grid.set_position(sid, position);
+		} else if (interest_grid.has(sid)) {
+			// Disabled, or no longer ours.
+			interest_grid.remove(sid);
+			for (const KeyValue<int, PeerInfo> &E : peers_info) {
+				sync->set_interest_visibility_for(E.key, false);
+			}
+			sync->update_visibility(0);
+		}
+	}
+	interest_grid.update(interest_changes);
+	_apply_interest_changes();
+}
+
+void SceneReplicationInterface::_apply_interest_changes() {
+	// Feed the spawn and sync lists directly, no need to go through the visibility_changed signal.
+	for (const ReplicationInterestGrid::Change &change : interest_changes) {
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(change.id);
+		ERR_CONTINUE(!sync);
+		sync->set_interest_visibility_for(change.peer, change.visible);
+		if (!peers_info.has(change.peer)) {
+			continue; // Interest was set for a peer that is not (or no longer) connected.
+		}
+		_visibility_changed(change.peer, change.id);
+	}
+	interest_changes.clear();
+}
+
+void SceneReplicationInterface::set_peer_interest(int p_peer, const Vector3 &p_position, real_t p_radius) {
+	ERR_FAIL_COND_MSG(p_peer < 1, "Interest volumes must be assigned to a specific peer.");
+	interest_grid.set_interest(p_peer, p_position, p_radius);
+}
+
+void SceneReplicationInterface::clear_peer_interest(int p_peer) {
+	interest_grid.remove_interest(p_peer, interest_changes);
+	_apply_interest_changes();
+}
+
+void SceneReplicationInterface::set_interest_cell_size(real_t p_size) {
+	interest_grid.set_cell_size(p_size);
+}
+
+real_t SceneReplicationInterface::get_interest_cell_size() const {
+	return interest_grid.get_cell_size();
+}
+
 bool SceneReplicationInterface::is_rpc_visible(const ObjectID &p_oid, int p_peer) const {
 	if (!tracked_nodes.has(p_oid)) {
 		return true; // Untracked nodes are always visible to RPCs.
@@ -705,60 +785,193 @@ MultiplayerSynchronizer *SceneReplicationInterface::_find_synchronizer(int p_pee
 	return sync;
 }
 
-void SceneReplicationInterface::_send_delta(int p_peer, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> &p_last_watch_usecs) {
-	MAKE_ROOM(/* header */ 1 + /* element */ 4 + 8 + 4 + delta_mtu);
-	uint8_t *ptr = packet_cache.ptrw();
-	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC | (1 << SceneMultiplayer::CMD_FLAG_0_SHIFT);
-	int ofs = 1;
+void SceneReplicationInterface::_clear_snapshots() {
+	snapshot_buffer.clear();
+	sync_snapshots.clear();
+	delta_snapshots.clear();
+}
+
+Error SceneReplicationInterface::_get_sync_snapshot(MultiplayerSynchronizer *p_sync, Node *p_node, StateSnapshot &r_snapshot) {
+	const ObjectID oid = p_sync->get_instance_id();
+	const StateSnapshot *cached = sync_snapshots.getptr(oid);
+	if (cached) {
+		r_snapshot = *cached;
+		return OK;
+	}
+
+	Vector<Variant> vars;
+	Vector<const Variant *> varp;
+	const List<NodePath> props = p_sync->get_replication_config_ptr()->get_sync_properties();
+	Error err = MultiplayerSynchronizer::get_state(props, p_node, vars, varp);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to retrieve sync state.");
+	int size;
+	err = MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), nullptr, size);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to encode sync state.");
+
+	r_snapshot.offset = snapshot_buffer.size();
+	r_snapshot.size = size;
+	if (size) {
+		snapshot_buffer.resize(r_snapshot.offset + size);
+		MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), &snapshot_buffer[r_snapshot.offset], size);
+	}
+	sync_snapshots.insert(oid, r_snapshot);
+	return OK;
+}
+
+Error SceneReplicationInterface::_get_delta_snapshot(MultiplayerSynchronizer *p_sync, uint64_t p_indexes, uint64_t p_usec, uint64_t p_last_usec, StateSnapshot &r_snapshot) {
+	// Peers usually share the same set of changed properties, but may not when they started watching at different times.
+	// Quantized deltas also depend on the last state sent to the peer.
+	const ObjectID oid = p_sync->get_instance_id();
+	const bool quantized = p_sync->has_quantized_delta();
+	const uint64_t baseline_usec = quantized ? p_last_usec : 0;
+	LocalVector<StateSnapshot> *cached = delta_snapshots.getptr(oid);
+	if (cached) {
+		for (const StateSnapshot &snapshot : *cached) {
+			if (snapshot.indexes == p_indexes && snapshot.baseline_usec == baseline_usec) {
+				r_snapshot = snapshot;
+				return OK;
+			}
+		}
+	}
+
+	if (quantized) {
+		r_snapshot.indexes = p_indexes;
+		r_snapshot.baseline_usec = baseline_usec;
+		r_snapshot.offset = snapshot_buffer.size();
+		Error err = p_sync->encode_quantized_delta(p_usec, p_indexes, baseline_usec, snapshot_buffer);
+		if (err != OK) {
+			snapshot_buffer.resize(r_snapshot.offset);
+			ERR_FAIL_V_MSG(err, "Unable to encode delta state.");
+		}
+		r_snapshot.size = snapshot_buffer.size() - r_snapshot.offset;
+		if (!cached) {
+			cached = &delta_snapshots.insert(oid, LocalVector<StateSnapshot>())->value;
+		}
+		cached->push_back(r_snapshot);
+		return OK;
+	}
+
+	uint64_t indexes;
+	List<Variant> delta = p_sync->get_delta_state(p_usec, p_last_usec, indexes);
+	ERR_FAIL_COND_V(indexes != p_indexes, ERR_BUG);
+
+	Vector<const Variant *> varp;
+	varp.resize(delta.size());
+	const Variant **vptr = varp.ptrw();
+	int i = 0;
+	for (const Variant &v : delta) {
+		vptr[i] = &v;
+		i++;
+	}
+	int size;
+	Error err = MultiplayerAPI::encode_and_compress_variants(vptr, varp.size(), nullptr, size);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Unable to encode delta state.");
+
+	r_snapshot.indexes = p_indexes;
+	r_snapshot.offset = snapshot_buffer.size();
+	r_snapshot.size = size;
+	if (size) {
+		snapshot_buffer.resize(r_snapshot.offset + size);
+		MultiplayerAPI::encode_and_compress_variants(vptr, varp.size(), &snapshot_buffer[r_snapshot.offset], size);
+	}
+	if (!cached) {
+		cached = &delta_snapshots.insert(oid, LocalVector<StateSnapshot>())->value;
+	}
+	cached->push_back(r_snapshot);
+	return OK;
+}
+
+void SceneReplicationInterface::_gather_delta(PeerOutbound &r_outbound, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> &p_last_watch_usecs) {
+	const int peer = r_outbound.peer;
+	r_outbound.delta_states.clear();
 	for (const ObjectID &oid : p_synchronizers) {
 		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
 		ERR_CONTINUE(!sync || !sync->get_replication_config_ptr() || !_has_authority(sync));
 		uint32_t net_id;
-		if (!_verify_synchronizer(p_peer, sync, net_id)) {
+		if (!_verify_synchronizer(peer, sync, net_id)) {
 			continue;
 		}
 		uint64_t last_usec = p_last_watch_usecs.has(oid) ? p_last_watch_usecs[oid] : 0;
-		uint64_t indexes;
-		List<Variant> delta = sync->get_delta_state(p_usec, last_usec, indexes);
-
-		if (!delta.size()) {
+		uint64_t indexes = sync->get_delta_indexes(p_usec, last_usec);
+		if (!indexes) {
 			continue; // Nothing to update.
 		}
 
-		Vector<const Variant *> varp;
-		varp.resize(delta.size());
-		const Variant **vptr = varp.ptrw();
-		int i = 0;
-		for (const Variant &v : delta) {
-			vptr[i] = &v;
-			i++;
+		StateSnapshot snapshot;
+		if (_get_delta_snapshot(sync, indexes, p_usec, last_usec, snapshot) != OK) {
+			continue;
 		}
-		int size;
-		Error err = MultiplayerAPI::encode_and_compress_variants(vptr, varp.size(), nullptr, size);
-		ERR_CONTINUE_MSG(err != OK, "Unable to encode delta state.");
+		int size = snapshot.size;
 
 		ERR_CONTINUE_MSG(size > delta_mtu, vformat("Synchronizer delta bigger than MTU will not be sent (%d > %d): %s", size, delta_mtu, sync->get_path()));
 
-		if (ofs + 4 + 8 + 4 + size > delta_mtu) {
-			// Send what we got, and reset write.
-			_send_raw(packet_cache.ptr(), ofs, p_peer, true);
-			ofs = 1;
-		}
 		if (size) {
-			ofs += encode_uint32(sync->get_net_id(), &ptr[ofs]);
-			ofs += encode_uint64(indexes, &ptr[ofs]);
-			ofs += encode_uint32(size, &ptr[ofs]);
-			MultiplayerAPI::encode_and_compress_variants(vptr, varp.size(), &ptr[ofs], size);
-			ofs += size;
+			r_outbound.delta_states.push_back({ sync->get_net_id(), indexes, snapshot.offset, size });
 		}
 #ifdef DEBUG_ENABLED
 		_profile_node_data("delta_out", oid, size);
 #endif
-		peers_info[p_peer].last_watch_usecs[oid] = p_usec;
+		peers_info[peer].last_watch_usecs[oid] = p_usec;
 	}
-	if (ofs > 1) {
-		// Got some left over to send.
-		_send_raw(packet_cache.ptr(), ofs, p_peer, true);
+}
+
+void SceneReplicationInterface::_assemble_outbound(uint32_t p_outbound_count, bool p_parallel) {
+	// Packet assembly only copies the snapshots, so it can be split across peers.
+	if (p_parallel) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneReplicationInterface::_assemble_packets, outbound.ptr(), p_outbound_count, -1, true, SNAME("AssembleReplicationPackets"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < p_outbound_count; i++) {
+			_assemble_packets(i, outbound.ptr());
+		}
+	}
+}
+
+void SceneReplicationInterface::_assemble_packets(uint32_t p_index, PeerOutbound *p_outbound) {
+	PeerOutbound &outbound_peer = p_outbound[p_index];
+	LocalVector<uint8_t> &buffer = outbound_peer.buffer;
+	buffer.clear();
+	outbound_peer.packets.clear();
+
+	// Sync: [cmd][net time][net id, size, state]...
+	const uint8_t sync_header[3] = { SceneMultiplayer::NETWORK_COMMAND_SYNC, uint8_t(outbound_peer.sync_net_time & 0xFF), uint8_t(outbound_peer.sync_net_time >> 8) };
+	_assemble_states(outbound_peer, outbound_peer.sync_states, sync_header, 3, 4 + 4, sync_mtu, false);
+
+	// Delta: [cmd][net id, indexes, size, state]...
+	const uint8_t delta_header[1] = { uint8_t(SceneMultiplayer::NETWORK_COMMAND_SYNC | (1 << SceneMultiplayer::CMD_FLAG_0_SHIFT)) };
+	_assemble_states(outbound_peer, outbound_peer.delta_states, delta_header, 1, 4 + 8 + 4, delta_mtu, true);
+}
+
+void SceneReplicationInterface::_assemble_states(PeerOutbound &r_outbound, const LocalVector<OutboundState> &p_states, const uint8_t *p_header, int p_header_size, int p_state_header_size, int p_mtu, bool p_delta) {
+	LocalVector<uint8_t> &buffer = r_outbound.buffer;
+	OutboundPacket packet;
+	packet.reliable = p_delta;
+	packet.offset = -1;
+	for (const OutboundState &state : p_states) {
+		if (packet.offset >= 0 && packet.size + p_state_header_size + state.size > p_mtu) {
+			// Close the packet, and start a new one.
+			r_outbound.packets.push_back(packet);
+			packet.offset = -1;
+		}
+		if (packet.offset < 0) {
+			packet.offset = buffer.size();
+			packet.size = p_header_size;
+			buffer.resize(buffer.size() + p_header_size);
+			memcpy(&buffer[packet.offset], p_header, p_header_size);
+		}
+		uint32_t ofs = buffer.size();
+		buffer.resize(ofs + p_state_header_size + state.size);
+		uint8_t *ptr = buffer.ptr();
+		ofs += encode_uint32(state.net_id, &ptr[ofs]);
+		if (p_delta) {
+			ofs += encode_uint64(state.indexes, &ptr[ofs]);
+		}
+		ofs += encode_uint32(state.size, &ptr[ofs]);
+		memcpy(&ptr[ofs], &snapshot_buffer[state.offset], state.size);
+		packet.size += p_state_header_size + state.size;
+	}
+	if (packet.offset >= 0) {
+		r_outbound.packets.push_back(packet);
 	}
 }
 
@@ -780,14 +993,24 @@ Error SceneReplicationInterface::on_delta_receive(int p_from, const uint8_t *p_b
 		}
 		List<NodePath> props = sync->get_delta_properties(indexes);
 		ERR_FAIL_COND_V(props.is_empty(), ERR_INVALID_DATA);
+		// Reused across states, taken out while in use in case a property setter ends up here again.
 		Vector<Variant> vars;
-		vars.resize(props.size());
-		int consumed = 0;
-		Error err = MultiplayerAPI::decode_and_decompress_variants(vars, p_buffer + ofs, size, consumed);
-		ERR_FAIL_COND_V(err != OK, err);
-		ERR_FAIL_COND_V(uint32_t(consumed) != size, ERR_INVALID_DATA);
+		SWAP(vars, state_cache);
+		Error err;
+		if (sync->has_quantized_delta()) {
+			err = sync->decode_quantized_delta(indexes, p_buffer + ofs, size, vars);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(vars.size() != props.size(), ERR_INVALID_DATA);
+		} else {
+			vars.resize(props.size());
+			int consumed = 0;
+			err = MultiplayerAPI::decode_and_decompress_variants(vars, p_buffer + ofs, size, consumed);
+			ERR_FAIL_COND_V(err != OK, err);
+			ERR_FAIL_COND_V(uint32_t(consumed) != size, ERR_INVALID_DATA);
+		}
 		err = MultiplayerSynchronizer::set_state(props, node, vars);
 		ERR_FAIL_COND_V(err != OK, err);
+		SWAP(vars, state_cache);
 		ofs += size;
 		sync->emit_signal(SNAME("delta_synchronized"));
 #ifdef DEBUG_ENABLED
@@ -797,14 +1020,11 @@ Error SceneReplicationInterface::on_delta_receive(int p_from, const uint8_t *p_b
 	return OK;
 }
 
-void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> &p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec) {
-	MAKE_ROOM(/* header */ 3 + /* element */ 4 + 4 + sync_mtu);
-	uint8_t *ptr = packet_cache.ptrw();
-	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC;
-	int ofs = 1;
-	ofs += encode_uint16(p_sync_net_time, &ptr[1]);
+void SceneReplicationInterface::_gather_sync(PeerOutbound &r_outbound, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec) {
+	const int peer = r_outbound.peer;
+	r_outbound.sync_states.clear();
 	// Can only send updates for already notified nodes.
-	// This is a lazy implementation, we could optimize much more here with by grouping by replication config.
+	// The states are encoded once per tick (see _get_sync_snapshot), packets only copy them.
 	for (const ObjectID &oid : p_synchronizers) {
 		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
 		ERR_CONTINUE(!sync || !sync->get_replication_config_ptr() || !_has_authority(sync));
@@ -815,39 +1035,24 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> &
 		Node *node = sync->get_root_node();
 		ERR_CONTINUE(!node);
 		uint32_t net_id = sync->get_net_id();
-		if (!_verify_synchronizer(p_peer, sync, net_id)) {
+		if (!_verify_synchronizer(peer, sync, net_id)) {
 			// The path based sync is not yet confirmed, skipping.
 			continue;
 		}
-		int size;
-		Vector<Variant> vars;
-		Vector<const Variant *> varp;
-		const List<NodePath> props = sync->get_replication_config_ptr()->get_sync_properties();
-		Error err = MultiplayerSynchronizer::get_state(props, node, vars, varp);
-		ERR_CONTINUE_MSG(err != OK, "Unable to retrieve sync state.");
-		err = MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), nullptr, size);
-		ERR_CONTINUE_MSG(err != OK, "Unable to encode sync state.");
+		StateSnapshot snapshot;
+		if (_get_sync_snapshot(sync, node, snapshot) != OK) {
+			continue;
+		}
+		int size = snapshot.size;
 		// TODO Handle single state above MTU.
 		ERR_CONTINUE_MSG(size > sync_mtu, vformat("Node states bigger than MTU will not be sent (%d > %d): %s", size, sync_mtu, node->get_path()));
-		if (ofs + 4 + 4 + size > sync_mtu) {
-			// Send what we got, and reset write.
-			_send_raw(packet_cache.ptr(), ofs, p_peer, false);
-			ofs = 3;
-		}
 		if (size) {
-			ofs += encode_uint32(sync->get_net_id(), &ptr[ofs]);
-			ofs += encode_uint32(size, &ptr[ofs]);
-			MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), &ptr[ofs], size);
-			ofs += size;
+			r_outbound.sync_states.push_back({ sync->get_net_id(), 0, snapshot.offset, size });
 		}
 #ifdef DEBUG_ENABLED
 		_profile_node_data("sync_out", oid, size);
 #endif
 	}
-	if (ofs > 3) {
-		// Got some left over to send.
-		_send_raw(packet_cache.ptr(), ofs, p_peer, false);
-	}
 }
 
 Error SceneReplicationInterface::on_sync_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len) {
@@ -881,14 +1086,19 @@ Error SceneReplicationInterface::on_sync_receive(int p_from, const uint8_t *p_bu
 			ofs += size;
 			continue;
 		}
+		// Copied, property setters may edit the replication config.
 		const List<NodePath> props = sync->get_replication_config_ptr()->get_sync_properties();
+		// Reused across states, taken out while in use in case a property setter ends up here again.
 		Vector<Variant> vars;
+		SWAP(vars, state_cache);
 		vars.resize(props.size());
 		int consumed;
+		// Decoded straight from the packet memory, which the peer lends without copying.
 		Error err = MultiplayerAPI::decode_and_decompress_variants(vars, &p_buffer[ofs], size, consumed);
 		ERR_FAIL_COND_V(err, err);
 		err = MultiplayerSynchronizer::set_state(props, node, vars);
 		ERR_FAIL_COND_V(err, err);
+		SWAP(vars, state_cache);
 		ofs += size;
 		sync->emit_signal(SNAME("synchronized"));
 #ifdef DEBUG_ENABLED
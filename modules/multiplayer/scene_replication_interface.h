@@ -32,6 +32,7 @@
 
 #include "multiplayer_spawner.h"
 #include "multiplayer_synchronizer.h"
+#include "replication_interest_grid.h"
 
 #include "core/object/ref_counted.h"
 
@@ -40,6 +41,7 @@ class SceneCacheInterface;
 
 class SceneReplicationInterface : public RefCounted {
 	GDCLASS(SceneReplicationInterface, RefCounted);
+	friend class TestSceneReplicationInterfaceInternalsAccessor;
 
 private:
 	struct TrackedNode {
@@ -85,6 +87,48 @@ private:
 	int pending_buffer_size = 0;
 	List<uint32_t> pending_sync_net_ids;
 
+	// Synchronizer states encoded once per network tick, then copied into the packets of every peer that sees them.
+	struct StateSnapshot {
+		uint64_t indexes = 0; // Delta only, the watched properties included in the state.
+		uint64_t baseline_usec = 0; // Quantized delta only, the tick the state is relative to.
+		int offset = 0;
+		int size = 0;
+	};
+	LocalVector<uint8_t> snapshot_buffer;
+	HashMap<ObjectID, StateSnapshot> sync_snapshots;
+	HashMap<ObjectID, LocalVector<StateSnapshot>> delta_snapshots;
+
+	// Outgoing states of each peer for the current tick, gathered on the main thread, then assembled into packets
+	// in parallel (they only reference snapshot_buffer), and finally sent on the main thread.
+	static const uint32_t PARALLEL_ASSEMBLY_MIN_STATES = 1024;
+	struct OutboundState {
+		uint32_t net_id = 0;
+		uint64_t indexes = 0; // Delta only.
+		int offset = 0; // In snapshot_buffer.
+		int size = 0;
+	};
+	struct OutboundPacket {
+		int offset = 0; // In PeerOutbound::buffer.
+		int size = 0;
+		bool reliable = false;
+	};
+	struct PeerOutbound {
+		int peer = 0;
+		uint16_t sync_net_time = 0;
+		LocalVector<OutboundState> sync_states;
+		LocalVector<OutboundState> delta_states;
+		LocalVector<uint8_t> buffer;
+		LocalVector<OutboundPacket> packets;
+	};
+	LocalVector<PeerOutbound> outbound;
+
+	// Decoded states of incoming packets, kept to avoid an allocation per synchronizer and packet.
+	Vector<Variant> state_cache;
+
+	// Spatial interest management, for synchronizers using it.
+	ReplicationInterestGrid interest_grid;
+	LocalVector<ReplicationInterestGrid::Change> interest_changes;
+
 	// Replicator config.
 	SceneMultiplayer *multiplayer = nullptr;
 	SceneCacheInterface *multiplayer_cache = nullptr;
@@ -100,8 +144,14 @@ private:
 	bool _verify_synchronizer(int p_peer, MultiplayerSynchronizer *p_sync, uint32_t &r_net_id);
 	MultiplayerSynchronizer *_find_synchronizer(int p_peer, uint32_t p_net_ida);
 
-	void _send_sync(int p_peer, const HashSet<ObjectID> &p_synchronizers, uint16_t p_sync_net_time, uint64_t p_usec);
-	void _send_delta(int p_peer, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> &p_last_watch_usecs);
+	void _clear_snapshots();
+	Error _get_sync_snapshot(MultiplayerSynchronizer *p_sync, Node *p_node, StateSnapshot &r_snapshot);
+	Error _get_delta_snapshot(MultiplayerSynchronizer *p_sync, uint64_t p_indexes, uint64_t p_usec, uint64_t p_last_usec, StateSnapshot &r_snapshot);
+	void _gather_sync(PeerOutbound &r_outbound, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec);
+	void _gather_delta(PeerOutbound &r_outbound, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> &p_last_watch_usecs);
+	void _assemble_outbound(uint32_t p_outbound_count, bool p_parallel);
+	void _assemble_packets(uint32_t p_index, PeerOutbound *p_outbound);
+	void _assemble_states(PeerOutbound &r_outbound, const LocalVector<OutboundState> &p_states, const uint8_t *p_header, int p_header_size, int p_state_header_size, int p_mtu, bool p_delta);
 	Error _make_spawn_packet(Node *p_node, MultiplayerSpawner *p_spawner, int &r_len);
 	Error _make_despawn_packet(Node *p_node, int &r_len);
 	Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable);
@@ -110,6 +160,8 @@ private:
 	Error _update_sync_visibility(int p_peer, MultiplayerSynchronizer *p_sync);
 	Error _update_spawn_visibility(int p_peer, const ObjectID &p_oid);
 	void _free_remotes(const PeerInfo &p_info);
+	void _update_interest();
+	void _apply_interest_changes();
 
 	template <typename T>
 	static T *get_id_as(const ObjectID &p_id) {
@@ -145,6 +197,11 @@ public:
 	void set_max_delta_packet_size(int p_size);
 	int get_max_delta_packet_size() const;
 
+	void set_peer_interest(int p_peer, const Vector3 &p_position, real_t p_radius);
+	void clear_peer_interest(int p_peer);
+	void set_interest_cell_size(real_t p_size);
+	real_t get_interest_cell_size() const;
+
 	SceneReplicationInterface(SceneMultiplayer *p_multiplayer, SceneCacheInterface *p_cache) {
 		multiplayer = p_multiplayer;
 		multiplayer_cache = p_cache;
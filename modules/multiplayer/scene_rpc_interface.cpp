@@ -34,6 +34,9 @@
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "core/object/class_db.h"
+#include "core/object/script_language.h"
+#include "core/variant/variant_internal.h"
 #include "scene/main/multiplayer_api.h"
 #include "scene/main/node.h"
 #include "scene/main/window.h"
@@ -99,15 +102,264 @@ void SceneRPCInterface::_parse_rpc_config(const Variant &p_config, bool p_for_no
 	}
 }
 
+// Fixed-width layout of the typed argument encoding, see get_typed_argument_size.
+enum TypedComponent {
+	TYPED_COMPONENT_NONE,
+	TYPED_COMPONENT_BOOL,
+	TYPED_COMPONENT_INT64,
+	TYPED_COMPONENT_DOUBLE,
+	TYPED_COMPONENT_REAL,
+	TYPED_COMPONENT_INT32,
+	TYPED_COMPONENT_FLOAT,
+};
+
+static TypedComponent _get_typed_components(Variant::Type p_type, int &r_count) {
+	r_count = 1;
+	switch (p_type) {
+		case Variant::BOOL:
+			return TYPED_COMPONENT_BOOL;
+		case Variant::INT:
+			return TYPED_COMPONENT_INT64;
+		case Variant::FLOAT:
+			return TYPED_COMPONENT_DOUBLE;
+		case Variant::VECTOR2:
+			r_count = 2;
+			return TYPED_COMPONENT_REAL;
+		case Variant::VECTOR2I:
+			r_count = 2;
+			return TYPED_COMPONENT_INT32;
+		case Variant::RECT2:
+			r_count = 4;
+			return TYPED_COMPONENT_REAL;
+		case Variant::RECT2I:
+			r_count = 4;
+			return TYPED_COMPONENT_INT32;
+		case Variant::VECTOR3:
+			r_count = 3;
+			return TYPED_COMPONENT_REAL;
+		case Variant::VECTOR3I:
+			r_count = 3;
+			return TYPED_COMPONENT_INT32;
+		case Variant::TRANSFORM2D:
+			r_count = 6;
+			return TYPED_COMPONENT_REAL;
+		case Variant::VECTOR4:
+			r_count = 4;
+			return TYPED_COMPONENT_REAL;
+		case Variant::VECTOR4I:
+			r_count = 4;
+			return TYPED_COMPONENT_INT32;
+		case Variant::PLANE:
+			r_count = 4;
+			return TYPED_COMPONENT_REAL;
+		case Variant::QUATERNION:
+			r_count = 4;
+			return TYPED_COMPONENT_REAL;
+		case Variant::AABB:
+			r_count = 6;
+			return TYPED_COMPONENT_REAL;
+		case Variant::BASIS:
+			r_count = 9;
+			return TYPED_COMPONENT_REAL;
+		case Variant::TRANSFORM3D:
+			r_count = 12;
+			return TYPED_COMPONENT_REAL;
+		case Variant::PROJECTION:
+			r_count = 16;
+			return TYPED_COMPONENT_REAL;
+		case Variant::COLOR:
+			r_count = 4;
+			return TYPED_COMPONENT_FLOAT;
+		default:
+			r_count = 0;
+			return TYPED_COMPONENT_NONE;
+	}
+}
+
+int SceneRPCInterface::get_typed_argument_size(Variant::Type p_type, bool p_double_reals) {
+	int count;
+	switch (_get_typed_components(p_type, count)) {
+		case TYPED_COMPONENT_BOOL:
+			return 1;
+		case TYPED_COMPONENT_INT64:
+		case TYPED_COMPONENT_DOUBLE:
+			return 8;
+		case TYPED_COMPONENT_REAL:
+			return count * (p_double_reals ? 8 : 4);
+		case TYPED_COMPONENT_INT32:
+		case TYPED_COMPONENT_FLOAT:
+			return count * 4;
+		default:
+			return 0;
+	}
+}
+
+void SceneRPCInterface::encode_typed_argument(const Variant &p_value, uint8_t *r_buffer) {
+	// The components are read straight from the Variant storage, which is what ptrcall uses too.
+	const void *data = VariantInternal::get_opaque_pointer(&p_value);
+	int count;
+	switch (_get_typed_components(p_value.get_type(), count)) {
+		case TYPED_COMPONENT_BOOL: {
+			r_buffer[0] = *(const bool *)data ? 1 : 0;
+		} break;
+		case TYPED_COMPONENT_INT64: {
+			encode_uint64(*(const int64_t *)data, r_buffer);
+		} break;
+		case TYPED_COMPONENT_DOUBLE: {
+			encode_double(*(const double *)data, r_buffer);
+		} break;
+		case TYPED_COMPONENT_REAL: {
+			const real_t *reals = (const real_t *)data;
+			for (int i = 0; i < count; i++) {
+#ifdef REAL_T_IS_DOUBLE
+				r_buffer += encode_double(reals[i], r_buffer);
+#else
+				r_buffer += encode_float(reals[i], r_buffer);
+#endif
+			}
+		} break;
+		case TYPED_COMPONENT_INT32: {
+			const int32_t *ints = (const int32_t *)data;
+			for (int i = 0; i < count; i++) {
+				r_buffer += encode_uint32(ints[i], r_buffer);
+			}
+		} break;
+		case TYPED_COMPONENT_FLOAT: {
+			const float *floats = (const float *)data;
+			for (int i = 0; i < count; i++) {
+				r_buffer += encode_float(floats[i], r_buffer);
+			}
+		} break;
+		default: {
+			ERR_FAIL_MSG("Type has no fixed-width encoding."); // Bug.
+		}
+	}
+}
+
+void SceneRPCInterface::decode_typed_argument(Variant::Type p_type, const uint8_t *p_buffer, bool p_double_reals, Variant &r_value) {
+	VariantInternal::initialize(&r_value, p_type);
+	void *data = VariantInternal::get_opaque_pointer(&r_value);
+	int count;
+	switch (_get_typed_components(p_type, count)) {
+		case TYPED_COMPONENT_BOOL: {
+			*(bool *)data = p_buffer[0] != 0;
+		} break;
+		case TYPED_COMPONENT_INT64: {
+			*(int64_t *)data = (int64_t)decode_uint64(p_buffer);
+		} break;
+		case TYPED_COMPONENT_DOUBLE: {
+			*(double *)data = decode_double(p_buffer);
+		} break;
+		case TYPED_COMPONENT_REAL: {
+			real_t *reals = (real_t *)data;
+			for (int i = 0; i < count; i++) {
+				if (p_double_reals) {
+					reals[i] = decode_double(p_buffer);
+					p_buffer += 8;
+				} else {
+					reals[i] = decode_float(p_buffer);
+					p_buffer += 4;
+				}
+			}
+		} break;
+		case TYPED_COMPONENT_INT32: {
+			int32_t *ints = (int32_t *)data;
+			for (int i = 0; i < count; i++) {
+				ints[i] = (int32_t)decode_uint32(p_buffer);
+				p_buffer += 4;
+			}
+		} break;
+		case TYPED_COMPONENT_FLOAT: {
+			float *floats = (float *)data;
+			for (int i = 0; i < count; i++) {
+				floats[i] = decode_float(p_buffer);
+				p_buffer += 4;
+			}
+		} break;
+		default: {
+			r_value = Variant();
+			ERR_FAIL_MSG("Type has no fixed-width encoding."); // Bug.
+		}
+	}
+}
+
+void SceneRPCInterface::_compile_rpc_config(const Node *p_node, uint16_t p_id, RPCConfig &r_config) {
+	// Find the signature of the method that will be called, scripts take precedence like in Object::callp.
+	LocalVector<Variant::Type> types;
+	MethodBind *method_bind = nullptr;
+	ScriptInstance *script_instance = p_node->get_script_instance();
+	if (script_instance && script_instance->has_method(r_config.name)) {
+		Ref<Script> script = script_instance->get_script();
+		if (script.is_null()) {
+			return;
+		}
+		const MethodInfo info = script->get_method_info(r_config.name);
+		if (info.name != r_config.name || (info.flags & METHOD_FLAG_VARARG)) {
+			return;
+		}
+		for (const PropertyInfo &arg : info.arguments) {
+			types.push_back(arg.type);
+		}
+	} else if (p_id & (1 << 15)) {
+		method_bind = ClassDB::get_method(p_node->get_class_name(), r_config.name);
+		if (!method_bind || method_bind->is_vararg()) {
+			return;
+		}
+		for (int i = 0; i < method_bind->get_argument_count(); i++) {
+			types.push_back(method_bind->get_argument_type(i));
+		}
+		if (method_bind->has_return()) {
+			method_bind = nullptr; // Typed encoding still applies, but ptrcall would need storage for the return value.
+		}
+	} else {
+		return;
+	}
+
+	if (types.is_empty() || types.size() > TYPED_ARGUMENTS_MAX) {
+		return; // Calls without arguments are already as small as they can be.
+	}
+	int size = 0;
+	int real_count = 0;
+	uint32_t hash = hash_murmur3_one_32(types.size());
+	for (const Variant::Type type : types) {
+		const int type_size = get_typed_argument_size(type, false);
+		if (!type_size) {
+			return; // Untyped (or variable size) argument.
+		}
+		size += type_size;
+		real_count += (get_typed_argument_size(type, true) - type_size) / 4;
+		hash = hash_murmur3_one_32(type, hash);
+	}
+	r_config.argument_types = types;
+	r_config.typed_size = size;
+	r_config.typed_real_count = real_count;
+	r_config.signature = hash_fmix32(hash) & ~TYPED_SIGNATURE_DOUBLE_REALS;
+	r_config.method_bind = method_bind;
+}
+
 const SceneRPCInterface::RPCConfigCache &SceneRPCInterface::_get_node_config(const Node *p_node) {
 	const ObjectID oid = p_node->get_instance_id();
-	if (rpc_cache.has(oid)) {
-		return rpc_cache[oid];
+	ScriptInstance *script_instance = p_node->get_script_instance();
+	ObjectID script_id;
+	if (script_instance) {
+		Ref<Script> script = script_instance->get_script();
+		if (script.is_valid()) {
+			script_id = script->get_instance_id();
+		}
+	}
+	HashMap<ObjectID, RPCConfigCache>::Iterator E = rpc_cache.find(oid);
+	if (E && E->value.script_id == script_id) {
+		return E->value;
 	}
+	// Not cached yet, or compiled for a previous script (with different configs and method signatures).
 	RPCConfigCache cache;
+	cache.script_id = script_id;
 	_parse_rpc_config(p_node->get_node_rpc_config(), true, cache);
-	if (p_node->get_script_instance()) {
-		_parse_rpc_config(p_node->get_script_instance()->get_rpc_config(), false, cache);
+	if (script_instance) {
+		_parse_rpc_config(script_instance->get_rpc_config(), false, cache);
+	}
+	for (KeyValue<uint16_t, RPCConfig> &E : cache.configs) {
+		_compile_rpc_config(p_node, E.key, E.value);
 	}
 	rpc_cache[oid] = cache;
 	return rpc_cache[oid];
@@ -250,6 +502,11 @@ void SceneRPCInterface::_process_rpc(Node *p_node, const uint16_t p_rpc_method_i
 	int argc = 0;
 
 	const bool byte_only_or_no_args = p_packet[0] & BYTE_ONLY_OR_NO_ARGS_FLAG;
+	if (!byte_only_or_no_args && p_offset < p_packet_len && (p_packet[p_offset] & 0x80) && uint32_t(p_packet[p_offset] & 0x7F) == config.argument_types.size()) {
+		// Typed call, see _compile_rpc_config.
+		_process_typed_rpc(p_node, config, p_packet, p_packet_len, p_offset + 1);
+		return;
+	}
 	if (byte_only_or_no_args) {
 		if (p_offset < p_packet_len) {
 			// This packet contains only bytes.
@@ -258,6 +515,7 @@ void SceneRPCInterface::_process_rpc(Node *p_node, const uint16_t p_rpc_method_i
 	} else {
 		// Normal variant, takes the argument count from the packet.
 		ERR_FAIL_COND_MSG(p_offset >= p_packet_len, "Invalid packet received. Size too small.");
+		ERR_FAIL_COND_MSG(p_packet[p_offset] & 0x80, "RPC '" + String(config.name) + "' has a different signature on the remote peer.");
 		argc = p_packet[p_offset];
 		p_offset += 1;
 	}
@@ -287,6 +545,50 @@ void SceneRPCInterface::_process_rpc(Node *p_node, const uint16_t p_rpc_method_i
 	}
 }
 
+void SceneRPCInterface::_process_typed_rpc(Node *p_node, const RPCConfig &p_config, const uint8_t *p_packet, int p_packet_len, int p_offset) {
+	ERR_FAIL_COND_MSG(p_offset >= p_packet_len, "Invalid packet received. Size too small.");
+	// The sender may use another precision for reals.
+	const bool double_reals = p_packet[p_offset] & TYPED_SIGNATURE_DOUBLE_REALS;
+	const int typed_size = p_config.typed_size + (double_reals ? p_config.typed_real_count * 4 : 0);
+	ERR_FAIL_COND_MSG(p_offset + 1 + typed_size != p_packet_len, "Invalid packet received. Size doesn't match the RPC signature.");
+	ERR_FAIL_COND_MSG((p_packet[p_offset] & ~TYPED_SIGNATURE_DOUBLE_REALS) != p_config.signature, "RPC '" + String(p_config.name) + "' has a different signature on the remote peer.");
+	p_offset += 1;
+
+#ifdef DEBUG_ENABLED
+	_profile_node_data("rpc_in", p_node->get_instance_id(), p_packet_len);
+#endif
+
+	const int argc = p_config.argument_types.size();
+	LocalVector<Variant> args;
+	args.resize(argc);
+	for (int i = 0; i < argc; i++) {
+		decode_typed_argument(p_config.argument_types[i], &p_packet[p_offset], double_reals, args[i]);
+		p_offset += get_typed_argument_size(p_config.argument_types[i], double_reals);
+	}
+
+	if (p_config.method_bind) {
+		// Arguments are already of the exact types, skip validation and call the native method directly.
+		const void **ptrargs = (const void **)alloca(sizeof(void *) * argc);
+		for (int i = 0; i < argc; i++) {
+			ptrargs[i] = VariantInternal::get_opaque_pointer(&args[i]);
+		}
+		p_config.method_bind->ptrcall(p_node, ptrargs, nullptr);
+		return;
+	}
+
+	const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * argc);
+	for (int i = 0; i < argc; i++) {
+		argp[i] = &args[i];
+	}
+	Callable::CallError ce;
+	p_node->callp(p_config.name, argp, argc, ce);
+	if (ce.error != Callable::CallError::CALL_OK) {
+		String error = Variant::get_call_error_text(p_node, p_config.name, argp, argc, ce);
+		error = "RPC - " + error;
+		ERR_PRINT(error);
+	}
+}
+
 void SceneRPCInterface::_send_rpc(Node *p_node, int p_to, uint16_t p_rpc_id, const RPCConfig &p_config, const StringName &p_name, const Variant **p_arg, int p_argcount) {
 	Ref<MultiplayerPeer> peer = multiplayer->get_multiplayer_peer();
 	ERR_FAIL_COND_MSG(peer.is_null(), "Attempt to call RPC without active multiplayer peer.");
@@ -295,7 +597,8 @@ void SceneRPCInterface::_send_rpc(Node *p_node, int p_to, uint16_t p_rpc_id, con
 
 	ERR_FAIL_COND_MSG(peer->get_connection_status() == MultiplayerPeer::CONNECTION_DISCONNECTED, "Attempt to call RPC while multiplayer peer is disconnected.");
 
-	ERR_FAIL_COND_MSG(p_argcount > 255, "Too many arguments (>255).");
+	// The high bit of the argument count marks typed calls, see _process_rpc.
+	ERR_FAIL_COND_MSG(p_argcount > TYPED_ARGUMENTS_MAX, "Too many arguments (>127).");
 
 	if (p_to != 0 && !multiplayer->get_connected_peers().has(Math::abs(p_to))) {
 		ERR_FAIL_COND_MSG(p_to == multiplayer->get_unique_id(), "Attempt to call RPC on yourself! Peer unique ID: " + itos(multiplayer->get_unique_id()) + ".");
@@ -393,19 +696,39 @@ void SceneRPCInterface::_send_rpc(Node *p_node, int p_to, uint16_t p_rpc_id, con
 		ofs += 2;
 	}
 
-	int len;
-	Error err = MultiplayerAPI::encode_and_compress_variants(p_arg, p_argcount, nullptr, len, &byte_only_or_no_args, multiplayer->is_object_decoding_allowed());
-	ERR_FAIL_COND_MSG(err != OK, "Unable to encode RPC arguments. THIS IS LIKELY A BUG IN THE ENGINE!");
-	if (byte_only_or_no_args) {
-		MAKE_ROOM(ofs + len);
-	} else {
-		MAKE_ROOM(ofs + 1 + len);
-		packet_cache.write[ofs] = p_argcount;
-		ofs += 1;
+	// Use the typed encoding when the arguments match the compiled signature exactly.
+	bool typed = p_config.argument_types.size() && uint32_t(p_argcount) == p_config.argument_types.size();
+	for (int i = 0; typed && i < p_argcount; i++) {
+		typed = p_arg[i]->get_type() == p_config.argument_types[i];
 	}
-	if (len) {
-		MultiplayerAPI::encode_and_compress_variants(p_arg, p_argcount, &packet_cache.write[ofs], len, &byte_only_or_no_args, multiplayer->is_object_decoding_allowed());
-		ofs += len;
+
+	if (typed) {
+		// [argument count | 0x80][signature | precision flag][fixed-width arguments]
+		const bool double_reals = sizeof(real_t) == sizeof(double);
+		MAKE_ROOM(ofs + 2 + p_config.typed_size + (double_reals ? p_config.typed_real_count * 4 : 0));
+		uint8_t *ptr = packet_cache.ptrw();
+		ptr[ofs] = uint8_t(p_argcount) | 0x80;
+		ptr[ofs + 1] = p_config.signature | (double_reals ? TYPED_SIGNATURE_DOUBLE_REALS : 0);
+		ofs += 2;
+		for (int i = 0; i < p_argcount; i++) {
+			encode_typed_argument(*p_arg[i], &ptr[ofs]);
+			ofs += get_typed_argument_size(p_config.argument_types[i]);
+		}
+	} else {
+		int len;
+		Error err = MultiplayerAPI::encode_and_compress_variants(p_arg, p_argcount, nullptr, len, &byte_only_or_no_args, multiplayer->is_object_decoding_allowed());
+		ERR_FAIL_COND_MSG(err != OK, "Unable to encode RPC arguments. THIS IS LIKELY A BUG IN THE ENGINE!");
+		if (byte_only_or_no_args) {
+			MAKE_ROOM(ofs + len);
+		} else {
+			MAKE_ROOM(ofs + 1 + len);
+			packet_cache.write[ofs] = p_argcount;
+			ofs += 1;
+		}
+		if (len) {
+			MultiplayerAPI::encode_and_compress_variants(p_arg, p_argcount, &packet_cache.write[ofs], len, &byte_only_or_no_args, multiplayer->is_object_decoding_allowed());
+			ofs += len;
+		}
 	}
 
 	ERR_FAIL_COND(command_type > 7);
@@ -31,12 +31,14 @@
 #pragma once
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/multiplayer_api.h"
 
 class SceneMultiplayer;
 class SceneCacheInterface;
 class SceneReplicationInterface;
 class Node;
+class MethodBind;
 
 class SceneRPCInterface : public RefCounted {
 	GDCLASS(SceneRPCInterface, RefCounted);
@@ -49,6 +51,14 @@ private:
 		MultiplayerPeer::TransferMode transfer_mode = MultiplayerPeer::TRANSFER_MODE_RELIABLE;
 		int channel = 0;
 
+		// Compiled from the method signature when every argument has a fixed-width type (see _compile_rpc_config).
+		// Such calls are sent without type tags, and native methods are dispatched with ptrcall.
+		LocalVector<Variant::Type> argument_types;
+		int typed_size = 0; // With 32-bit reals.
+		int typed_real_count = 0;
+		uint8_t signature = 0;
+		MethodBind *method_bind = nullptr;
+
 		bool operator==(RPCConfig const &p_other) const {
 			return name == p_other.name;
 		}
@@ -57,6 +67,7 @@ private:
 	struct RPCConfigCache {
 		HashMap<uint16_t, RPCConfig> configs;
 		HashMap<StringName, uint16_t> ids;
+		ObjectID script_id; // The cache is rebuilt when the node's script changes.
 	};
 
 	struct SortRPCConfig {
@@ -91,14 +102,27 @@ private:
 
 protected:
 	void _process_rpc(Node *p_node, const uint16_t p_rpc_method_id, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
+	void _process_typed_rpc(Node *p_node, const RPCConfig &p_config, const uint8_t *p_packet, int p_packet_len, int p_offset);
 
 	void _send_rpc(Node *p_from, int p_to, uint16_t p_rpc_id, const RPCConfig &p_config, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	Node *_process_get_node(int p_from, const uint8_t *p_packet, uint32_t p_node_target, int p_packet_len);
 
 	void _parse_rpc_config(const Variant &p_config, bool p_for_node, RPCConfigCache &r_cache);
+	void _compile_rpc_config(const Node *p_node, uint16_t p_id, RPCConfig &r_config);
 	const RPCConfigCache &_get_node_config(const Node *p_node);
 
 public:
+	// Arguments are limited to 127, the high bit of the argument count marks typed calls.
+	static const int TYPED_ARGUMENTS_MAX = 127;
+	// Set in the signature byte when the sender encodes reals as doubles, like ENCODE_FLAG_64 in Variants.
+	static const uint8_t TYPED_SIGNATURE_DOUBLE_REALS = 0x80;
+
+	// Size of the fixed-width encoding of the given type, 0 if it has none.
+	// Reals are written with the precision of real_t, and read with either precision.
+	static int get_typed_argument_size(Variant::Type p_type, bool p_double_reals = sizeof(real_t) == sizeof(double));
+	static void encode_typed_argument(const Variant &p_value, uint8_t *r_buffer);
+	static void decode_typed_argument(Variant::Type p_type, const uint8_t *p_buffer, bool p_double_reals, Variant &r_value);
+
 	Error rpcp(Object *p_obj, int p_peer_id, const StringName &p_method, const Variant **p_arg, int p_argcount);
 	void process_rpc(int p_from, const uint8_t *p_packet, int p_packet_len);
 	String get_rpc_md5(const Object *p_obj);
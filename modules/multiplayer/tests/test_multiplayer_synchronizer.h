@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*  test_multiplayer_synchronizer.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "tests/test_macros.h"
+
+#include "../multiplayer_synchronizer.h"
+
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+
+namespace TestMultiplayerSynchronizer {
+
+static MultiplayerSynchronizer *_create_quantized_synchronizer(Node *p_parent) {
+	Node2D *node = memnew(Node2D);
+	p_parent->add_child(node);
+
+	Ref<SceneReplicationConfig> config;
+	config.instantiate();
+	const NodePath path(":position");
+	config->add_property(path);
+	config->property_set_replication_mode(path, SceneReplicationConfig::REPLICATION_MODE_ON_CHANGE);
+	config->property_set_quantization(path, SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT);
+	config->property_set_quantization_precision(path, 0.01);
+
+	MultiplayerSynchronizer *sync = memnew(MultiplayerSynchronizer);
+	sync->set_replication_config(config);
+	node->add_child(sync);
+	return sync;
+}
+
+static Vector2 _position_at_tick(int p_tick) {
+	return Vector2(p_tick, p_tick * 0.5);
+}
+
+// Encodes the state of the tick relative to the baseline tick (0 for none), and decodes it on the receiver.
+static Error _send(MultiplayerSynchronizer *p_sender, MultiplayerSynchronizer *p_receiver, int p_tick, int p_baseline_tick, Vector2 &r_position) {
+	LocalVector<uint8_t> buffer;
+	Error err = p_sender->encode_quantized_delta(p_tick * 1000, 1, p_baseline_tick * 1000, buffer);
+	if (err != OK) {
+		return err;
+	}
+	Vector<Variant> values;
+	err = p_receiver->decode_quantized_delta(1, buffer.ptr(), buffer.size(), values);
+	if (err == OK) {
+		r_position = values[0];
+	}
+	return err;
+}
+
+TEST_CASE("[Multiplayer][MultiplayerSynchronizer][SceneTree] Quantized delta baselines") {
+	Node *scene = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(scene);
+	MultiplayerSynchronizer *sender = _create_quantized_synchronizer(scene);
+	MultiplayerSynchronizer *receiver = _create_quantized_synchronizer(scene);
+	MultiplayerSynchronizer *late_receiver = _create_quantized_synchronizer(scene);
+	Node2D *node = Object::cast_to<Node2D>(sender->get_root_node());
+	REQUIRE(sender->has_quantized_delta());
+
+	// Each tick is sent relative to the previous one, the late receiver only got tick 3.
+	Vector2 position;
+	for (int tick = 1; tick <= 34; tick++) {
+		node->set_position(_position_at_tick(tick));
+		REQUIRE(sender->get_delta_indexes(tick * 1000, (tick - 1) * 1000) == 1);
+		REQUIRE(_send(sender, receiver, tick, tick - 1, position) == OK);
+		CHECK(position.distance_to(_position_at_tick(tick)) < 0.01);
+		if (tick == 3) {
+			REQUIRE(_send(sender, late_receiver, tick, 0, position) == OK);
+		}
+	}
+
+	SUBCASE("The oldest baseline kept can still be used") {
+		// Ticks 3 to 34 are the last 32 baselines.
+		REQUIRE(_send(sender, late_receiver, 34, 3, position) == OK);
+		CHECK(position.distance_to(_position_at_tick(34)) < 0.01);
+
+		ERR_PRINT_OFF;
+		MultiplayerSynchronizer *fresh_receiver = _create_quantized_synchronizer(scene);
+		CHECK_MESSAGE(_send(sender, fresh_receiver, 34, 3, position) != OK, "The state should be a delta, which can't be decoded without the baseline.");
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Evicted baselines fall back to the full state") {
+		// The baseline of tick 2 was replaced by tick 34.
+		MultiplayerSynchronizer *fresh_receiver = _create_quantized_synchronizer(scene);
+		REQUIRE(_send(sender, fresh_receiver, 34, 2, position) == OK);
+		CHECK(position.distance_to(_position_at_tick(34)) < 0.01);
+	}
+
+	SUBCASE("Unknown baselines fall back to the full state") {
+		MultiplayerSynchronizer *fresh_receiver = _create_quantized_synchronizer(scene);
+		REQUIRE(_send(sender, fresh_receiver, 34, 100, position) == OK);
+		CHECK(position.distance_to(_position_at_tick(34)) < 0.01);
+	}
+
+	SUBCASE("Values that can't be quantized are sent as Variant") {
+		node->set_position(Vector2(Math::NaN, 1e30));
+		REQUIRE(sender->get_delta_indexes(35000, 34000) == 1);
+		REQUIRE(_send(sender, receiver, 35, 34, position) == OK);
+		CHECK(Math::is_nan(position.x));
+		CHECK(position.y == real_t(1e30));
+
+		// And the next state isn't relative to them.
+		node->set_position(_position_at_tick(36));
+		REQUIRE(sender->get_delta_indexes(36000, 35000) == 1);
+		REQUIRE(_send(sender, receiver, 36, 35, position) == OK);
+		CHECK(position.distance_to(_position_at_tick(36)) < 0.01);
+	}
+
+	memdelete(scene);
+}
+
+} // namespace TestMultiplayerSynchronizer
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/*  test_replication_interest_grid.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "tests/test_macros.h"
+
+#include "../replication_interest_grid.h"
+
+namespace TestReplicationInterestGrid {
+
+static bool has_change(const LocalVector<ReplicationInterestGrid::Change> &p_changes, int p_peer, const ObjectID &p_id, bool p_visible) {
+	for (const ReplicationInterestGrid::Change &change : p_changes) {
+		if (change.peer == p_peer && change.id == p_id && change.visible == p_visible) {
+			return true;
+		}
+	}
+	return false;
+}
+
+TEST_CASE("[Multiplayer][ReplicationInterestGrid] Incremental visibility") {
+	ReplicationInterestGrid grid;
+	grid.set_cell_size(10);
+	const ObjectID near_id = ObjectID(uint64_t(1));
+	const ObjectID far_id = ObjectID(uint64_t(2));
+	LocalVector<ReplicationInterestGrid::Change> changes;
+
+	grid.set_position(near_id, Vector3(5, 0, 0));
+	grid.set_position(far_id, Vector3(100, 0, 0));
+	grid.set_interest(2, Vector3(), 20);
+	grid.set_interest(3, Vector3(100, 0, 0), 1);
+	grid.update(changes);
+	CHECK(changes.size() == 2);
+	CHECK(has_change(changes, 2, near_id, true));
+	CHECK(has_change(changes, 3, far_id, true));
+	CHECK(grid.is_visible(2, near_id));
+	CHECK_FALSE(grid.is_visible(2, far_id));
+
+	SUBCASE("Nothing moved") {
+		changes.clear();
+		grid.set_position(near_id, Vector3(5, 0, 0));
+		grid.set_interest(2, Vector3(), 20);
+		grid.update(changes);
+		CHECK(changes.is_empty());
+	}
+
+	SUBCASE("Object moves across cells") {
+		changes.clear();
+		grid.set_position(far_id, Vector3(15, 0, 0));
+		grid.update(changes);
+		CHECK(changes.size() == 2);
+		CHECK(has_change(changes, 2, far_id, true));
+		CHECK(has_change(changes, 3, far_id, false));
+	}
+
+	SUBCASE("Interest moves and grows") {
+		changes.clear();
+		grid.set_interest(2, Vector3(100, 0, 0), 200);
+		grid.update(changes);
+		CHECK(changes.size() == 1);
+		CHECK(has_change(changes, 2, far_id, true));
+		CHECK(grid.is_visible(2, near_id));
+	}
+
+	SUBCASE("Removal") {
+		changes.clear();
+		grid.remove(near_id);
+		CHECK_FALSE(grid.is_visible(2, near_id));
+		grid.remove_interest(3, changes);
+		CHECK(changes.size() == 1);
+		CHECK(has_change(changes, 3, far_id, false));
+		changes.clear();
+		grid.update(changes);
+		CHECK(changes.is_empty());
+	}
+
+	SUBCASE("Cell size change keeps visibility") {
+		changes.clear();
+		grid.set_cell_size(1);
+		grid.set_position(near_id, Vector3(6, 0, 0));
+		grid.update(changes);
+		CHECK(changes.is_empty());
+		CHECK(grid.is_visible(2, near_id));
+	}
+}
+
+TEST_CASE("[Multiplayer][ReplicationInterestGrid] Positions and radii beyond the cell range") {
+	ReplicationInterestGrid grid;
+	grid.set_cell_size(1);
+	const ObjectID near_id = ObjectID(uint64_t(1));
+	const ObjectID far_id = ObjectID(uint64_t(2));
+	const ObjectID other_far_id = ObjectID(uint64_t(3));
+	LocalVector<ReplicationInterestGrid::Change> changes;
+
+	grid.set_position(near_id, Vector3(5, 0, 0));
+	grid.set_position(far_id, Vector3(1e12, 0.5, 0.5));
+	grid.set_position(other_far_id, Vector3(2e12, -1e12, 0));
+
+	// Covers every cell of the grid.
+	grid.set_interest(2, Vector3(), 1e30);
+	// A single cell on the border, fewer than the populated ones, so it is looked up directly.
+	grid.set_interest(3, Vector3(1e12, 0.5, 0.5), 0.25);
+	grid.update(changes);
+	CHECK(changes.size() == 4);
+	CHECK(grid.is_visible(2, near_id));
+	CHECK(grid.is_visible(2, far_id));
+	CHECK(grid.is_visible(2, other_far_id));
+	CHECK(grid.is_visible(3, far_id));
+	CHECK_FALSE(grid.is_visible(3, other_far_id));
+	CHECK_FALSE(grid.is_visible(3, near_id));
+
+	changes.clear();
+	grid.set_position(far_id, Vector3(0, 0, 1));
+	grid.update(changes);
+	CHECK(changes.size() == 1);
+	CHECK(has_change(changes, 3, far_id, false));
+	CHECK(grid.is_visible(2, far_id));
+}
+
+} // namespace TestReplicationInterestGrid
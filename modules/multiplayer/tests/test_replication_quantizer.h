@@ -0,0 +1,202 @@
+/**************************************************************************/
+/*  test_replication_quantizer.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "tests/test_macros.h"
+
+#include "../replication_quantizer.h"
+
+namespace TestReplicationQuantizer {
+
+static SceneReplicationConfig::Quantization make_quantization(SceneReplicationConfig::PropertyQuantization p_mode) {
+	SceneReplicationConfig::Quantization q;
+	q.mode = p_mode;
+	return q;
+}
+
+TEST_CASE("[Multiplayer][ReplicationQuantizer] Bit packing") {
+	LocalVector<uint8_t> buffer;
+	ReplicationQuantizer::BitWriter writer(buffer);
+	writer.write(5, 3);
+	writer.write_var(0);
+	writer.write_var(1000);
+	writer.write(1, 1);
+	writer.write(0xABCDE, 20);
+	writer.flush();
+	// 3 + 5 + 15 + 1 + 20 bits.
+	CHECK(buffer.size() == 6);
+
+	ReplicationQuantizer::BitReader reader(buffer.ptr(), buffer.size());
+	CHECK(reader.read(3) == 5);
+	CHECK(reader.read_var() == 0);
+	CHECK(reader.read_var() == 1000);
+	CHECK(reader.read(1) == 1);
+	CHECK(reader.read(20) == 0xABCDE);
+	CHECK_FALSE(reader.has_overflowed());
+	reader.read(8);
+	CHECK(reader.has_overflowed());
+}
+
+TEST_CASE("[Multiplayer][ReplicationQuantizer] Zigzag") {
+	CHECK(ReplicationQuantizer::zigzag_encode(0) == 0);
+	CHECK(ReplicationQuantizer::zigzag_encode(-1) == 1);
+	CHECK(ReplicationQuantizer::zigzag_encode(1) == 2);
+	for (int64_t v : { int64_t(-123456789), int64_t(-2), int64_t(7), INT64_MAX, INT64_MIN }) {
+		CHECK(ReplicationQuantizer::zigzag_decode(ReplicationQuantizer::zigzag_encode(v)) == v);
+	}
+}
+
+TEST_CASE("[Multiplayer][ReplicationQuantizer] Absolute and delta round trip") {
+	SUBCASE("Fixed point vector") {
+		const SceneReplicationConfig::Quantization q = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT);
+		const ReplicationQuantizer::Value base = ReplicationQuantizer::quantize(Vector3(10, -5, 0.25), q);
+		const ReplicationQuantizer::Value value = ReplicationQuantizer::quantize(Vector3(10.01, -5, 0.2), q);
+		REQUIRE(value.type == Variant::VECTOR3);
+
+		LocalVector<uint8_t> absolute;
+		ReplicationQuantizer::BitWriter abs_writer(absolute);
+		ReplicationQuantizer::write_absolute(abs_writer, value, q);
+		abs_writer.flush();
+
+		LocalVector<uint8_t> delta;
+		ReplicationQuantizer::BitWriter delta_writer(delta);
+		ReplicationQuantizer::write_delta(delta_writer, value, base, q);
+		delta_writer.flush();
+		CHECK(delta.size() < absolute.size());
+
+		ReplicationQuantizer::Value decoded;
+		ReplicationQuantizer::BitReader abs_reader(absolute.ptr(), absolute.size());
+		REQUIRE(ReplicationQuantizer::read_absolute(abs_reader, q, decoded));
+		CHECK(Vector3(ReplicationQuantizer::dequantize(decoded, q)).is_equal_approx(Vector3(10.01, -5, 0.2)));
+
+		ReplicationQuantizer::BitReader delta_reader(delta.ptr(), delta.size());
+		REQUIRE(ReplicationQuantizer::read_delta(delta_reader, base, q, decoded));
+		CHECK(Vector3(ReplicationQuantizer::dequantize(decoded, q)).is_equal_approx(Vector3(10.01, -5, 0.2)));
+	}
+
+	SUBCASE("Quaternion") {
+		const SceneReplicationConfig::Quantization q = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION);
+		const Quaternion rotation = Quaternion(Vector3(0.3, 1, -0.2).normalized(), 1.2);
+		const ReplicationQuantizer::Value value = ReplicationQuantizer::quantize(rotation, q);
+		REQUIRE(value.type == Variant::QUATERNION);
+
+		LocalVector<uint8_t> buffer;
+		ReplicationQuantizer::BitWriter writer(buffer);
+		ReplicationQuantizer::write_absolute(writer, value, q);
+		writer.flush();
+
+		ReplicationQuantizer::Value decoded;
+		ReplicationQuantizer::BitReader reader(buffer.ptr(), buffer.size());
+		REQUIRE(ReplicationQuantizer::read_absolute(reader, q, decoded));
+		const Quaternion result = ReplicationQuantizer::dequantize(decoded, q);
+		CHECK(Math::abs(result.dot(rotation)) > 0.999);
+	}
+
+	SUBCASE("Bounded int") {
+		SceneReplicationConfig::Quantization q = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT);
+		q.min = -10;
+		q.max = 20;
+		const ReplicationQuantizer::Value value = ReplicationQuantizer::quantize(50, q);
+
+		LocalVector<uint8_t> buffer;
+		ReplicationQuantizer::BitWriter writer(buffer);
+		ReplicationQuantizer::write_absolute(writer, value, q);
+		writer.flush();
+
+		ReplicationQuantizer::Value decoded;
+		ReplicationQuantizer::BitReader reader(buffer.ptr(), buffer.size());
+		REQUIRE(ReplicationQuantizer::read_absolute(reader, q, decoded));
+		CHECK(int64_t(ReplicationQuantizer::dequantize(decoded, q)) == 20);
+	}
+
+	SUBCASE("Bounded int over the whole 64-bit range") {
+		SceneReplicationConfig::Quantization q = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT);
+		q.min = INT64_MIN;
+		q.max = INT64_MAX;
+		const ReplicationQuantizer::Value base = ReplicationQuantizer::quantize(INT64_MIN, q);
+		const ReplicationQuantizer::Value value = ReplicationQuantizer::quantize(INT64_MAX, q);
+
+		LocalVector<uint8_t> absolute;
+		ReplicationQuantizer::BitWriter abs_writer(absolute);
+		ReplicationQuantizer::write_absolute(abs_writer, value, q);
+		abs_writer.flush();
+		// 6 bits of type and 64 bits of value.
+		CHECK(absolute.size() == 9);
+
+		LocalVector<uint8_t> delta;
+		ReplicationQuantizer::BitWriter delta_writer(delta);
+		ReplicationQuantizer::write_delta(delta_writer, value, base, q);
+		delta_writer.flush();
+
+		ReplicationQuantizer::Value decoded;
+		ReplicationQuantizer::BitReader abs_reader(absolute.ptr(), absolute.size());
+		REQUIRE(ReplicationQuantizer::read_absolute(abs_reader, q, decoded));
+		CHECK(int64_t(ReplicationQuantizer::dequantize(decoded, q)) == INT64_MAX);
+
+		ReplicationQuantizer::BitReader delta_reader(delta.ptr(), delta.size());
+		REQUIRE(ReplicationQuantizer::read_delta(delta_reader, base, q, decoded));
+		CHECK(int64_t(ReplicationQuantizer::dequantize(decoded, q)) == INT64_MAX);
+	}
+
+	SUBCASE("Bounded int range with the maximum below the minimum") {
+		Ref<SceneReplicationConfig> config;
+		config.instantiate();
+		config->add_property(NodePath(":position"));
+		config->property_set_quantization(NodePath(":position"), SceneReplicationConfig::PROPERTY_QUANTIZATION_BOUNDED_INT);
+		config->property_set_quantization_range(NodePath(":position"), -5, 5);
+
+		ERR_PRINT_OFF;
+		config->property_set_quantization_range(NodePath(":position"), 10, 0);
+		ERR_PRINT_ON;
+		CHECK(config->property_get_quantization_min(NodePath(":position")) == -5);
+		CHECK(config->property_get_quantization_max(NodePath(":position")) == 5);
+	}
+
+	SUBCASE("Unsupported type") {
+		const SceneReplicationConfig::Quantization q = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT);
+		CHECK(ReplicationQuantizer::quantize(String("hello"), q).type == Variant::NIL);
+	}
+}
+
+TEST_CASE("[Multiplayer][ReplicationQuantizer] Values that can't be quantized") {
+	const SceneReplicationConfig::Quantization fixed = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_FIXED_POINT);
+	CHECK(ReplicationQuantizer::quantize(Math::NaN, fixed).type == Variant::NIL);
+	CHECK(ReplicationQuantizer::quantize(Math::INF, fixed).type == Variant::NIL);
+	CHECK(ReplicationQuantizer::quantize(Vector2(1, -Math::INF), fixed).type == Variant::NIL);
+	CHECK_MESSAGE(ReplicationQuantizer::quantize(1e30, fixed).type == Variant::NIL, "Values too large for 64-bit deltas should not be quantized.");
+	CHECK(ReplicationQuantizer::quantize(1e6, fixed).type == Variant::FLOAT);
+
+	const SceneReplicationConfig::Quantization quaternion = make_quantization(SceneReplicationConfig::PROPERTY_QUANTIZATION_QUATERNION);
+	CHECK(ReplicationQuantizer::quantize(Quaternion(0, 0, 0, 0), quaternion).type == Variant::NIL);
+	CHECK(ReplicationQuantizer::quantize(Quaternion(Math::NaN, 0, 0, 1), quaternion).type == Variant::NIL);
+}
+
+} // namespace TestReplicationQuantizer
@@ -0,0 +1,305 @@
+/**************************************************************************/
+/*  test_scene_replication_interface.h                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "tests/test_macros.h"
+
+#include "../multiplayer_synchronizer.h"
+#include "../scene_cache_interface.h"
+#include "../scene_multiplayer.h"
+#include "../scene_replication_interface.h"
+
+#include "core/io/marshalls.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+
+class TestSceneReplicationInterfaceInternalsAccessor {
+public:
+	struct State {
+		int offset = 0;
+		int size = 0;
+	};
+
+	static void begin_tick(SceneReplicationInterface *p_replication) {
+		p_replication->_clear_snapshots();
+	}
+
+	static LocalVector<State> gather_sync(SceneReplicationInterface *p_replication, int p_peer, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec) {
+		SceneReplicationInterface::PeerOutbound outbound;
+		outbound.peer = p_peer;
+		p_replication->_gather_sync(outbound, p_synchronizers, p_usec);
+		LocalVector<State> states;
+		for (const SceneReplicationInterface::OutboundState &state : outbound.sync_states) {
+			states.push_back({ state.offset, state.size });
+		}
+		return states;
+	}
+
+	static LocalVector<State> gather_delta(SceneReplicationInterface *p_replication, int p_peer, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, const HashMap<ObjectID, uint64_t> &p_last_watch_usecs) {
+		SceneReplicationInterface::PeerOutbound outbound;
+		outbound.peer = p_peer;
+		p_replication->_gather_delta(outbound, p_synchronizers, p_usec, p_last_watch_usecs);
+		LocalVector<State> states;
+		for (const SceneReplicationInterface::OutboundState &state : outbound.delta_states) {
+			states.push_back({ state.offset, state.size });
+		}
+		return states;
+	}
+
+	struct Packet {
+		int peer = 0;
+		PackedByteArray data;
+		bool reliable = false;
+	};
+
+	// Runs a network tick up to the point where the packets would be sent, and returns them instead.
+	static LocalVector<Packet> assemble_packets(SceneReplicationInterface *p_replication, const LocalVector<int> &p_peers, const HashSet<ObjectID> &p_synchronizers, uint64_t p_usec, bool p_parallel) {
+		p_replication->_clear_snapshots();
+		p_replication->outbound.resize(p_peers.size());
+		for (uint32_t i = 0; i < p_peers.size(); i++) {
+			SceneReplicationInterface::PeerOutbound &outbound = p_replication->outbound[i];
+			outbound.peer = p_peers[i];
+			outbound.sync_net_time = 1;
+			p_replication->_gather_sync(outbound, p_synchronizers, p_usec);
+			p_replication->_gather_delta(outbound, p_synchronizers, p_usec, HashMap<ObjectID, uint64_t>());
+		}
+		p_replication->_assemble_outbound(p_peers.size(), p_parallel);
+
+		LocalVector<Packet> packets;
+		for (uint32_t i = 0; i < p_peers.size(); i++) {
+			const SceneReplicationInterface::PeerOutbound &outbound = p_replication->outbound[i];
+			for (const SceneReplicationInterface::OutboundPacket &outbound_packet : outbound.packets) {
+				Packet packet;
+				packet.peer = outbound.peer;
+				packet.reliable = outbound_packet.reliable;
+				packet.data.resize(outbound_packet.size);
+				memcpy(packet.data.ptrw(), &outbound.buffer[outbound_packet.offset], outbound_packet.size);
+				packets.push_back(packet);
+			}
+		}
+		return packets;
+	}
+
+	static int get_snapshot_buffer_size(SceneReplicationInterface *p_replication) {
+		return p_replication->snapshot_buffer.size();
+	}
+
+	static Vector<Variant> decode_state(SceneReplicationInterface *p_replication, const State &p_state, int p_count) {
+		Vector<Variant> vars;
+		vars.resize(p_count);
+		int consumed = 0;
+		Error err = MultiplayerAPI::decode_and_decompress_variants(vars, &p_replication->snapshot_buffer[p_state.offset], p_state.size, consumed);
+		CHECK(err == OK);
+		CHECK(consumed == p_state.size);
+		return vars;
+	}
+};
+
+namespace TestSceneReplicationInterface {
+
+static MultiplayerSynchronizer *_create_synchronized_node(Node *p_parent, uint32_t p_net_id, SceneReplicationConfig::ReplicationMode p_mode) {
+	Node2D *node = memnew(Node2D);
+	p_parent->add_child(node);
+
+	Ref<SceneReplicationConfig> config;
+	config.instantiate();
+	for (const NodePath &path : { NodePath(":position"), NodePath(":rotation") }) {
+		config->add_property(path);
+		config->property_set_replication_mode(path, p_mode);
+	}
+
+	MultiplayerSynchronizer *sync = memnew(MultiplayerSynchronizer);
+	sync->set_replication_config(config);
+	node->add_child(sync);
+	// Not path based, so no confirmation from the peers is needed.
+	sync->set_net_id(p_net_id);
+	return sync;
+}
+
+TEST_CASE("[Multiplayer][SceneReplicationInterface][SceneTree] Peers share the encoded states of a tick") {
+	Ref<SceneMultiplayer> multiplayer;
+	multiplayer.instantiate();
+	Ref<SceneCacheInterface> cache = memnew(SceneCacheInterface(multiplayer.ptr()));
+	Ref<SceneReplicationInterface> replication = memnew(SceneReplicationInterface(multiplayer.ptr(), cache.ptr()));
+
+	Node *scene = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(scene);
+
+	const int peers[3] = { 2, 3, 4 };
+
+	SUBCASE("Sync states") {
+		MultiplayerSynchronizer *sync_a = _create_synchronized_node(scene, 1, SceneReplicationConfig::REPLICATION_MODE_ALWAYS);
+		MultiplayerSynchronizer *sync_b = _create_synchronized_node(scene, 2, SceneReplicationConfig::REPLICATION_MODE_ALWAYS);
+		Node2D *node_a = Object::cast_to<Node2D>(sync_a->get_root_node());
+		node_a->set_position(Vector2(1, 2));
+		HashSet<ObjectID> synchronizers;
+		synchronizers.insert(sync_a->get_instance_id());
+		synchronizers.insert(sync_b->get_instance_id());
+
+		TestSceneReplicationInterfaceInternalsAccessor::begin_tick(replication.ptr());
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> first = TestSceneReplicationInterfaceInternalsAccessor::gather_sync(replication.ptr(), peers[0], synchronizers, 1000);
+		REQUIRE(first.size() == 2);
+		const int encoded_size = TestSceneReplicationInterfaceInternalsAccessor::get_snapshot_buffer_size(replication.ptr());
+		CHECK(encoded_size == first[0].size + first[1].size);
+
+		for (int i = 1; i < 3; i++) {
+			LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> states = TestSceneReplicationInterfaceInternalsAccessor::gather_sync(replication.ptr(), peers[i], synchronizers, 1000);
+			REQUIRE(states.size() == 2);
+			for (uint32_t j = 0; j < 2; j++) {
+				CHECK_MESSAGE(states[j].offset == first[j].offset, "Every peer should get the same encoded state.");
+				CHECK(states[j].size == first[j].size);
+			}
+		}
+		CHECK_MESSAGE(TestSceneReplicationInterfaceInternalsAccessor::get_snapshot_buffer_size(replication.ptr()) == encoded_size, "Each state should be encoded once per tick.");
+
+		// The next tick encodes the states again, with the new values.
+		node_a->set_position(Vector2(3, 4));
+		TestSceneReplicationInterfaceInternalsAccessor::begin_tick(replication.ptr());
+		for (int i = 0; i < 3; i++) {
+			LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> states = TestSceneReplicationInterfaceInternalsAccessor::gather_sync(replication.ptr(), peers[i], synchronizers, 2000);
+			REQUIRE(states.size() == 2);
+			bool found = false;
+			for (const TestSceneReplicationInterfaceInternalsAccessor::State &state : states) {
+				Vector<Variant> vars = TestSceneReplicationInterfaceInternalsAccessor::decode_state(replication.ptr(), state, 2);
+				found = found || vars[0] == Variant(Vector2(3, 4));
+				CHECK_FALSE_MESSAGE(vars[0] == Variant(Vector2(1, 2)), "States of the previous tick should not be reused.");
+			}
+			CHECK(found);
+		}
+		CHECK(TestSceneReplicationInterfaceInternalsAccessor::get_snapshot_buffer_size(replication.ptr()) == encoded_size);
+	}
+
+	SUBCASE("Delta states") {
+		MultiplayerSynchronizer *sync = _create_synchronized_node(scene, 1, SceneReplicationConfig::REPLICATION_MODE_ON_CHANGE);
+		Node2D *node = Object::cast_to<Node2D>(sync->get_root_node());
+		HashSet<ObjectID> synchronizers;
+		synchronizers.insert(sync->get_instance_id());
+		HashMap<ObjectID, uint64_t> never_watched;
+		HashMap<ObjectID, uint64_t> watched;
+		watched[sync->get_instance_id()] = 1000;
+
+		// All the properties are new to every peer, so they share one delta.
+		TestSceneReplicationInterfaceInternalsAccessor::begin_tick(replication.ptr());
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> first = TestSceneReplicationInterfaceInternalsAccessor::gather_delta(replication.ptr(), peers[0], synchronizers, 1000, never_watched);
+		REQUIRE(first.size() == 1);
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> second = TestSceneReplicationInterfaceInternalsAccessor::gather_delta(replication.ptr(), peers[1], synchronizers, 1000, never_watched);
+		REQUIRE(second.size() == 1);
+		CHECK(second[0].offset == first[0].offset);
+		CHECK(TestSceneReplicationInterfaceInternalsAccessor::get_snapshot_buffer_size(replication.ptr()) == first[0].size);
+
+		// Only the rotation changed since the last tick, except for a peer which didn't receive anything yet.
+		node->set_rotation(1.0);
+		TestSceneReplicationInterfaceInternalsAccessor::begin_tick(replication.ptr());
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> changed = TestSceneReplicationInterfaceInternalsAccessor::gather_delta(replication.ptr(), peers[0], synchronizers, 2000, watched);
+		REQUIRE(changed.size() == 1);
+		Vector<Variant> vars = TestSceneReplicationInterfaceInternalsAccessor::decode_state(replication.ptr(), changed[0], 1);
+		CHECK(vars[0] == Variant(real_t(1.0)));
+
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> shared = TestSceneReplicationInterfaceInternalsAccessor::gather_delta(replication.ptr(), peers[1], synchronizers, 2000, watched);
+		REQUIRE(shared.size() == 1);
+		CHECK(shared[0].offset == changed[0].offset);
+
+		LocalVector<TestSceneReplicationInterfaceInternalsAccessor::State> full = TestSceneReplicationInterfaceInternalsAccessor::gather_delta(replication.ptr(), peers[2], synchronizers, 2000, never_watched);
+		REQUIRE(full.size() == 1);
+		CHECK_MESSAGE(full[0].offset != changed[0].offset, "Peers needing other properties should get their own delta.");
+		CHECK(TestSceneReplicationInterfaceInternalsAccessor::get_snapshot_buffer_size(replication.ptr()) == changed[0].size + full[0].size);
+	}
+
+	memdelete(scene);
+}
+
+TEST_CASE("[Multiplayer][SceneReplicationInterface][SceneTree] Packets assembled on the WorkerThreadPool") {
+	Ref<SceneMultiplayer> multiplayer;
+	multiplayer.instantiate();
+	Ref<SceneCacheInterface> cache = memnew(SceneCacheInterface(multiplayer.ptr()));
+	Ref<SceneReplicationInterface> replication = memnew(SceneReplicationInterface(multiplayer.ptr(), cache.ptr()));
+	replication->set_max_sync_packet_size(128);
+
+	Node *scene = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(scene);
+
+	const int sync_count = 100;
+	HashSet<ObjectID> synchronizers;
+	for (int i = 0; i < sync_count; i++) {
+		MultiplayerSynchronizer *sync = _create_synchronized_node(scene, i + 1, SceneReplicationConfig::REPLICATION_MODE_ALWAYS);
+		Object::cast_to<Node2D>(sync->get_root_node())->set_position(Vector2(i, -i));
+		synchronizers.insert(sync->get_instance_id());
+	}
+	LocalVector<int> peers;
+	for (int peer = 2; peer < 10; peer++) {
+		peers.push_back(peer);
+	}
+
+	const LocalVector<TestSceneReplicationInterfaceInternalsAccessor::Packet> serial = TestSceneReplicationInterfaceInternalsAccessor::assemble_packets(replication.ptr(), peers, synchronizers, 1000, false);
+	const LocalVector<TestSceneReplicationInterfaceInternalsAccessor::Packet> parallel = TestSceneReplicationInterfaceInternalsAccessor::assemble_packets(replication.ptr(), peers, synchronizers, 2000, true);
+
+	// Every peer gets all the states, split to fit the packet size.
+	REQUIRE(parallel.size() > peers.size());
+	HashMap<int, HashSet<uint32_t>> received;
+	for (const TestSceneReplicationInterfaceInternalsAccessor::Packet &packet : parallel) {
+		REQUIRE(packet.data.size() > 3);
+		CHECK(packet.data.size() <= 128);
+		CHECK_FALSE(packet.reliable);
+		CHECK(packet.data[0] == SceneMultiplayer::NETWORK_COMMAND_SYNC);
+		// [cmd][net time][net id, size, state]...
+		int ofs = 3;
+		while (ofs < packet.data.size()) {
+			REQUIRE(ofs + 8 <= packet.data.size());
+			const uint32_t net_id = decode_uint32(&packet.data[ofs]);
+			const uint32_t size = decode_uint32(&packet.data[ofs + 4]);
+			ofs += 8;
+			REQUIRE(ofs + int(size) <= packet.data.size());
+			Vector<Variant> vars;
+			vars.resize(2);
+			int consumed = 0;
+			CHECK(MultiplayerAPI::decode_and_decompress_variants(vars, &packet.data[ofs], size, consumed) == OK);
+			CHECK(vars[0] == Variant(Vector2(net_id - 1, 1.0 - net_id)));
+			ofs += size;
+			CHECK_MESSAGE(!received[packet.peer].has(net_id), "A state should be sent once per peer.");
+			received[packet.peer].insert(net_id);
+		}
+	}
+	CHECK(received.size() == peers.size());
+	for (const KeyValue<int, HashSet<uint32_t>> &E : received) {
+		CHECK(E.value.size() == sync_count);
+	}
+
+	// Splitting the work across threads gives the same packets, in the same order.
+	REQUIRE(serial.size() == parallel.size());
+	for (uint32_t i = 0; i < serial.size(); i++) {
+		CHECK(serial[i].peer == parallel[i].peer);
+		CHECK(serial[i].data == parallel[i].data);
+	}
+
+	memdelete(scene);
+}
+
+} // namespace TestSceneReplicationInterface
@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  test_scene_rpc_interface.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "tests/test_macros.h"
+
+#include "../scene_multiplayer.h"
+#include "../scene_rpc_interface.h"
+
+#include "core/io/marshalls.h"
+
+namespace TestSceneRPCInterface {
+
+TEST_CASE("[Multiplayer][SceneRPCInterface] Typed argument encoding") {
+	const Variant values[] = {
+		true,
+		int64_t(-1234567890123),
+		3.14159265358979,
+		Vector2(1.5, -2.5),
+		Vector2i(-7, 9),
+		Vector3(1, 2, 3),
+		Vector3i(4, -5, 6),
+		Rect2(1, 2, 3, 4),
+		Quaternion(0, 0.7071068, 0, 0.7071068),
+		Transform3D(Basis(Vector3(0, 1, 0), 0.5), Vector3(10, 20, 30)),
+		Color(0.1, 0.2, 0.3, 0.4),
+	};
+	for (const Variant &value : values) {
+		const int size = SceneRPCInterface::get_typed_argument_size(value.get_type());
+		REQUIRE_MESSAGE(size > 0, Variant::get_type_name(value.get_type()));
+		LocalVector<uint8_t> buffer;
+		buffer.resize(size);
+		SceneRPCInterface::encode_typed_argument(value, buffer.ptr());
+		Variant decoded;
+		SceneRPCInterface::decode_typed_argument(value.get_type(), buffer.ptr(), sizeof(real_t) == sizeof(double), decoded);
+		CHECK_MESSAGE(decoded == value, Variant::get_type_name(value.get_type()));
+	}
+
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::BOOL) == 1);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::INT) == 8);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::VECTOR3) == int(3 * sizeof(real_t)));
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::NIL) == 0);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::STRING) == 0);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::OBJECT) == 0);
+}
+
+TEST_CASE("[Multiplayer][SceneRPCInterface] Typed arguments from peers with another real precision") {
+	// Whatever real_t is in this build, reals from both single and double precision peers are read.
+	const Vector3 value(1.5, -2.25, 1024.0);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::VECTOR3, false) == 12);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::VECTOR3, true) == 24);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::COLOR, true) == 16);
+	CHECK(SceneRPCInterface::get_typed_argument_size(Variant::INT, false) == 8);
+
+	uint8_t single_buffer[12];
+	uint8_t double_buffer[24];
+	for (int i = 0; i < 3; i++) {
+		encode_float(value[i], &single_buffer[i * 4]);
+		encode_double(value[i], &double_buffer[i * 8]);
+	}
+	Variant decoded;
+	SceneRPCInterface::decode_typed_argument(Variant::VECTOR3, single_buffer, false, decoded);
+	CHECK(decoded == Variant(value));
+	SceneRPCInterface::decode_typed_argument(Variant::VECTOR3, double_buffer, true, decoded);
+	CHECK(decoded == Variant(value));
+}
+
+} // namespace TestSceneRPCInterface
@@ -30,9 +30,44 @@
 
 #include "audio_stream_ogg_vorbis.h"
 
+#include "servers/audio/audio_decode_cache.h"
+
 #include <ogg/ogg.h>
 
 int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_frames) {
+	if (!decode_ahead.is_enabled()) {
+		return _decode(p_buffer, p_frames);
+	}
+
+	if (!decode_ahead_active) {
+		return 0;
+	}
+	int mixed = decode_ahead.mix(p_buffer, p_frames);
+	if (decode_ahead.is_finished()) {
+		decode_ahead_active = false;
+	}
+	return mixed;
+}
+
+int AudioStreamPlaybackOggVorbis::_decode_ahead(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops) {
+	AudioStreamPlaybackOggVorbis *self = (AudioStreamPlaybackOggVorbis *)p_userdata;
+	int mixed = self->active ? self->_decode(p_buffer, p_frames) : 0;
+	r_position = self->frames_mixed;
+	r_loops = self->loops;
+	return mixed;
+}
+
+void AudioStreamPlaybackOggVorbis::_seek_ahead(void *p_userdata, uint32_t p_position, bool p_restart) {
+	AudioStreamPlaybackOggVorbis *self = (AudioStreamPlaybackOggVorbis *)p_userdata;
+	if (p_restart) {
+		self->loop_fade_remaining = FADE_SIZE;
+		self->active = true;
+		self->loops = 0;
+	}
+	self->_seek(double(p_position) / self->vorbis_data->get_sampling_rate());
+}
+
+int AudioStreamPlaybackOggVorbis::_decode(AudioFrame *p_buffer, int p_frames) {
 	ERR_FAIL_COND_V(!ready, 0);
 
 	if (!active) {
@@ -112,7 +147,7 @@ int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 					loop_fade_remaining = 0;
 				}
 
-				seek(vorbis_stream->loop_offset);
+				_seek(vorbis_stream->loop_offset);
 				loops++;
 				// We still have buffer to fill, start from this element in the next iteration.
 				continue;
@@ -125,7 +160,7 @@ int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 			if (use_loop && is_not_empty) {
 				//loop
 
-				seek(vorbis_stream->loop_offset);
+				_seek(vorbis_stream->loop_offset);
 				loops++;
 				// We still have buffer to fill, start from this element in the next iteration.
 
@@ -142,6 +177,14 @@ int AudioStreamPlaybackOggVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 
 int AudioStreamPlaybackOggVorbis::_mix_frames_vorbis(AudioFrame *p_buffer, int p_frames) {
 	ERR_FAIL_COND_V(!ready, p_frames);
+	if (!decoded_frames.is_empty()) {
+		int frames = MIN(p_frames, decoded_frames.size() - (int)decoded_cursor);
+		memcpy(p_buffer, decoded_frames.ptr() + decoded_cursor, frames * sizeof(AudioFrame));
+		decoded_cursor += frames;
+		have_samples_left = decoded_cursor < (uint32_t)decoded_frames.size();
+		have_packets_left = false;
+		return frames;
+	}
 	if (!have_samples_left) {
 		ogg_packet *packet = nullptr;
 		int err;
@@ -227,27 +270,38 @@ bool AudioStreamPlaybackOggVorbis::_alloc_vorbis() {
 
 void AudioStreamPlaybackOggVorbis::start(double p_from_pos) {
 	ERR_FAIL_COND(!ready);
-	loop_fade_remaining = FADE_SIZE;
-	active = true;
-	seek(p_from_pos);
-	loops = 0;
+	if (decode_ahead.is_enabled()) {
+		// The decoder belongs to the decode thread, it starts it when handling the request.
+		decode_ahead.request_restart(uint32_t(p_from_pos * vorbis_data->get_sampling_rate()), true);
+		decode_ahead_active = true;
+	} else {
+		loop_fade_remaining = FADE_SIZE;
+		active = true;
+		_seek(p_from_pos);
+		loops = 0;
+	}
 	begin_resample();
 }
 
 void AudioStreamPlaybackOggVorbis::stop() {
-	active = false;
+	if (decode_ahead.is_enabled()) {
+		decode_ahead_active = false;
+	} else {
+		active = false;
+	}
 }
 
 bool AudioStreamPlaybackOggVorbis::is_playing() const {
-	return active;
+	return decode_ahead.is_enabled() ? decode_ahead_active : active;
 }
 
 int AudioStreamPlaybackOggVorbis::get_loop_count() const {
-	return loops;
+	return decode_ahead.is_enabled() ? decode_ahead.get_loops() : loops;
 }
 
 double AudioStreamPlaybackOggVorbis::get_playback_position() const {
-	return double(frames_mixed) / (double)vorbis_data->get_sampling_rate();
+	uint32_t position = decode_ahead.is_enabled() ? decode_ahead.get_position() : frames_mixed;
+	return double(position) / (double)vorbis_data->get_sampling_rate();
 }
 
 void AudioStreamPlaybackOggVorbis::tag_used_streams() {
@@ -274,6 +328,15 @@ Variant AudioStreamPlaybackOggVorbis::get_parameter(const StringName &p_name) co
 }
 
 void AudioStreamPlaybackOggVorbis::seek(double p_time) {
+	if (!decode_ahead.is_enabled()) {
+		_seek(p_time);
+		return;
+	}
+
+	decode_ahead.request_restart(uint32_t(p_time * vorbis_data->get_sampling_rate()), false);
+}
+
+void AudioStreamPlaybackOggVorbis::_seek(double p_time) {
 	ERR_FAIL_COND(!ready);
 	ERR_FAIL_COND(vorbis_stream.is_null());
 	if (!active) {
@@ -288,6 +351,13 @@ void AudioStreamPlaybackOggVorbis::seek(double p_time) {
 
 	const int64_t desired_sample = p_time * get_stream_sampling_rate();
 
+	if (!decoded_frames.is_empty()) {
+		decoded_cursor = MIN(uint32_t(desired_sample), (uint32_t)decoded_frames.size());
+		have_samples_left = decoded_cursor < (uint32_t)decoded_frames.size();
+		have_packets_left = false;
+		return;
+	}
+
 	if (!vorbis_data_playback->seek_page(desired_sample)) {
 		WARN_PRINT("seek failed");
 		return;
@@ -392,6 +462,10 @@ void AudioStreamPlaybackOggVorbis::set_sample_playback(const Ref<AudioSamplePlay
 }
 
 AudioStreamPlaybackOggVorbis::~AudioStreamPlaybackOggVorbis() {
+	if (decode_ahead.is_enabled()) {
+		// Make sure the decode thread is done with the decoder before freeing it.
+		AudioDecodeAheadThread::remove_buffer(&decode_ahead);
+	}
 	if (block_is_allocated) {
 		vorbis_block_clear(&block);
 	}
@@ -406,7 +480,7 @@ AudioStreamPlaybackOggVorbis::~AudioStreamPlaybackOggVorbis() {
 	}
 }
 
-Ref<AudioStreamPlayback> AudioStreamOggVorbis::instantiate_playback() {
+Ref<AudioStreamPlaybackOggVorbis> AudioStreamOggVorbis::_create_playback() {
 	Ref<AudioStreamPlaybackOggVorbis> ovs;
 
 	ERR_FAIL_COND_V(packet_sequence.is_null(), nullptr);
@@ -417,13 +491,75 @@ Ref<AudioStreamPlayback> AudioStreamOggVorbis::instantiate_playback() {
 	ovs->frames_mixed = 0;
 	ovs->active = false;
 	ovs->loops = 0;
-	if (ovs->_alloc_vorbis()) {
+	return ovs;
+}
+
+Ref<AudioStreamPlaybackOggVorbis> AudioStreamOggVorbis::_instantiate_decoder() {
+	Ref<AudioStreamPlaybackOggVorbis> ovs = _create_playback();
+	if (ovs.is_valid() && ovs->_alloc_vorbis()) {
 		return ovs;
 	}
 	// Failed to allocate data structures.
 	return nullptr;
 }
 
+Vector<AudioFrame> AudioStreamOggVorbis::_decode_all() {
+	Vector<AudioFrame> frames;
+
+	Ref<AudioStreamPlaybackOggVorbis> decoder = _instantiate_decoder();
+	ERR_FAIL_COND_V(decoder.is_null(), frames);
+
+	decoder->active = true;
+	decoder->_seek(0);
+
+	AudioFrame buffer[1024];
+	while (decoder->have_packets_left || decoder->have_samples_left) {
+		int mixed = decoder->_mix_frames_vorbis(buffer, 1024);
+		if (mixed <= 0) {
+			break;
+		}
+		int64_t offset = frames.size();
+		frames.resize(offset + mixed);
+		memcpy(frames.ptrw() + offset, buffer, mixed * sizeof(AudioFrame));
+	}
+	return frames;
+}
+
+void AudioStreamOggVorbis::_decode_to_cache(const Ref<RefCounted> &p_stream) {
+	AudioStreamOggVorbis *stream = Object::cast_to<AudioStreamOggVorbis>(p_stream.ptr());
+	ERR_FAIL_NULL(stream);
+	AudioDecodeCache::finish_decode(stream->get_instance_id(), stream->_decode_all());
+}
+
+Ref<AudioStreamPlayback> AudioStreamOggVorbis::instantiate_playback() {
+	bool cacheable = AudioDecodeCache::is_cacheable(get_length());
+
+	Vector<AudioFrame> decoded_frames;
+	if (cacheable && AudioDecodeCache::get(get_instance_id(), decoded_frames)) {
+		Ref<AudioStreamPlaybackOggVorbis> ovs = _create_playback();
+		if (ovs.is_valid()) {
+			ovs->decoded_frames = decoded_frames;
+			ovs->ready = true;
+		}
+		return ovs;
+	}
+
+	Ref<AudioStreamPlaybackOggVorbis> ovs = _instantiate_decoder();
+	if (ovs.is_null()) {
+		return nullptr;
+	}
+
+	if (AudioDecodeAheadThread::is_running()) {
+		if (cacheable && AudioDecodeCache::begin_decode(get_instance_id())) {
+			// Decoded in the background, this playback streams and the next ones use the cache.
+			AudioDecodeAheadThread::queue_job(&AudioStreamOggVorbis::_decode_to_cache, Ref<AudioStreamOggVorbis>(this));
+		}
+		ovs->decode_ahead.setup(&AudioStreamPlaybackOggVorbis::_decode_ahead, &AudioStreamPlaybackOggVorbis::_seek_ahead, ovs.ptr(), AudioDecodeAheadThread::get_buffer_frames(packet_sequence->get_sampling_rate()));
+	}
+
+	return ovs;
+}
+
 String AudioStreamOggVorbis::get_stream_name() const {
 	return ""; //return stream_name;
 }
@@ -463,6 +599,7 @@ void AudioStreamOggVorbis::maybe_update_info() {
 }
 
 void AudioStreamOggVorbis::set_packet_sequence(Ref<OggPacketSequence> p_packet_sequence) {
+	AudioDecodeCache::erase(get_instance_id());
 	packet_sequence = p_packet_sequence;
 	if (packet_sequence.is_valid()) {
 		maybe_update_info();
@@ -702,4 +839,6 @@ void AudioStreamOggVorbis::_bind_methods() {
 
 AudioStreamOggVorbis::AudioStreamOggVorbis() {}
 
-AudioStreamOggVorbis::~AudioStreamOggVorbis() {}
+AudioStreamOggVorbis::~AudioStreamOggVorbis() {
+	AudioDecodeCache::erase(get_instance_id());
+}
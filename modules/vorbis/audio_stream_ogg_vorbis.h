@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/variant/variant.h"
+#include "servers/audio/audio_decode_ahead.h"
 #include "servers/audio/audio_stream.h"
 
 #include "modules/ogg/ogg_packet_sequence.h"
@@ -78,8 +79,20 @@ class AudioStreamPlaybackOggVorbis : public AudioStreamPlaybackResampled {
 	bool _is_sample = false;
 	Ref<AudioSamplePlayback> sample_playback;
 
+	// Short streams are decoded once and shared through AudioDecodeCache, the vorbis decoder isn't allocated at all.
+	Vector<AudioFrame> decoded_frames;
+	uint32_t decoded_cursor = 0;
+
+	// Long streams are decoded ahead by the decode thread, the mixer only copies frames.
+	AudioDecodeAheadBuffer decode_ahead;
+	bool decode_ahead_active = false;
+
 	int _mix_frames(AudioFrame *p_buffer, int p_frames);
 	int _mix_frames_vorbis(AudioFrame *p_buffer, int p_frames);
+	int _decode(AudioFrame *p_buffer, int p_frames);
+	void _seek(double p_time);
+	static int _decode_ahead(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops);
+	static void _seek_ahead(void *p_userdata, uint32_t p_position, bool p_restart);
 
 	// Allocates vorbis data structures. Returns true upon success, false on failure.
 	bool _alloc_vorbis();
@@ -130,6 +143,11 @@ class AudioStreamOggVorbis : public AudioStream {
 
 	Ref<OggPacketSequence> packet_sequence;
 
+	Ref<AudioStreamPlaybackOggVorbis> _create_playback();
+	Ref<AudioStreamPlaybackOggVorbis> _instantiate_decoder();
+	Vector<AudioFrame> _decode_all();
+	static void _decode_to_cache(const Ref<RefCounted> &p_stream);
+
 	double bpm = 0;
 	int beat_count = 0;
 	int bar_beats = 4;
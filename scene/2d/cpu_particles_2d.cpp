@@ -31,8 +31,9 @@
 #include "cpu_particles_2d.h"
 #include "cpu_particles_2d.compat.inc"
 
-#include "core/math/random_number_generator.h"
+#include "core/math/random_pcg.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/2d/gpu_particles_2d.h"
 #include "scene/resources/atlas_texture.h"
 #include "scene/resources/canvas_item_material.h"
@@ -80,6 +81,7 @@ void CPUParticles2D::set_amount(int p_amount) {
 	RS::get_singleton()->multimesh_allocate_data(multimesh, p_amount, RS::MULTIMESH_TRANSFORM_2D, true, true);
 
 	particle_order.resize(p_amount);
+	particle_sort_keys.resize(p_amount);
 }
 
 void CPUParticles2D::set_lifetime(double p_lifetime) {
@@ -744,9 +746,6 @@ void CPUParticles2D::_particles_process(double p_delta) {
 	p_delta *= speed_scale;
 
 	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
 
 	double prev_time = time;
 	time += p_delta;
@@ -759,29 +758,59 @@ void CPUParticles2D::_particles_process(double p_delta) {
 		}
 	}
 
-	Transform2D emission_xform;
-	Transform2D velocity_xform;
+	ProcessStep step;
+	step.particles = particles.ptrw();
+	step.delta = p_delta;
+	step.prev_time = prev_time;
 	if (!local_coords) {
 		if (!_interpolation_data.interpolated_follow) {
-			emission_xform = get_global_transform();
+			step.emission_xform = get_global_transform();
 		} else {
-			TransformInterpolator::interpolate_transform_2d(_interpolation_data.global_xform_prev, _interpolation_data.global_xform_curr, emission_xform, Engine::get_singleton()->get_physics_interpolation_fraction());
+			TransformInterpolator::interpolate_transform_2d(_interpolation_data.global_xform_prev, _interpolation_data.global_xform_curr, step.emission_xform, Engine::get_singleton()->get_physics_interpolation_fraction());
 		}
-		velocity_xform = emission_xform;
-		velocity_xform[2] = Vector2();
+		step.velocity_xform = step.emission_xform;
+		step.velocity_xform[2] = Vector2();
+	}
+	step.system_phase = time / lifetime;
+
+	// Gradients sort their points when first sampled, do it before sampling them from several threads.
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0);
+	}
+	if (color_initial_ramp.is_valid()) {
+		color_initial_ramp->get_color_at_offset(0.0);
+	}
+
+	// Particles are independent from each other, process them in chunks on the WorkerThreadPool.
+	int chunk_count = (pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles2D::_particles_process_chunk, &step, chunk_count, -1, true, SNAME("CPUParticles2DProcess"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (chunk_count == 1) {
+		_particles_process_chunk(0, &step);
 	}
 
-	double system_phase = time / lifetime;
+	if (!Math::is_equal_approx(time, 0.0) && active && !step.should_be_active.is_set()) {
+		active = false;
+		emit_signal(SceneStringName(finished));
+	}
+}
+
+void CPUParticles2D::_particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step) {
+	int pcount = particles.size();
+	Particle *parray = p_step->particles;
+	RandomPCG rng;
 
-	bool should_be_active = false;
-	for (int i = 0; i < pcount; i++) {
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pcount);
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		double local_delta = p_delta;
+		double local_delta = p_step->delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -790,7 +819,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 
 		if (randomness_ratio > 0.0) {
 			uint32_t _seed = cycle;
-			if (restart_phase >= system_phase) {
+			if (restart_phase >= p_step->system_phase) {
 				_seed -= uint32_t(1);
 			}
 			_seed *= uint32_t(pcount);
@@ -803,10 +832,10 @@ void CPUParticles2D::_particles_process(double p_delta) {
 		double restart_time = restart_phase * lifetime;
 		bool restart = false;
 
-		if (time > prev_time) {
+		if (time > p_step->prev_time) {
 			// restart_time >= prev_time is used so particles emit in the first frame they are processed
 
-			if (restart_time >= prev_time && restart_time < time) {
+			if (restart_time >= p_step->prev_time && restart_time < time) {
 				restart = true;
 				if (fractional_delta) {
 					local_delta = time - restart_time;
@@ -814,7 +843,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			}
 
 		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
+			if (restart_time >= p_step->prev_time) {
 				restart = true;
 				if (fractional_delta) {
 					local_delta = lifetime - restart_time + time;
@@ -857,22 +886,22 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			}
 
 			p.seed = seed + uint32_t(i) + i + cycle;
-			rng->set_seed(p.seed);
+			rng.seed(p.seed);
 
-			p.angle_rand = rng->randf();
-			p.scale_rand = rng->randf();
-			p.hue_rot_rand = rng->randf();
-			p.anim_offset_rand = rng->randf();
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
 			if (color_initial_ramp.is_valid()) {
-				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng->randf());
+				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng.randf());
 			} else {
 				p.start_color_rand = Color(1, 1, 1, 1);
 			}
 
-			real_t angle1_rad = direction.angle() + Math::deg_to_rad((rng->randf() * 2.0 - 1.0) * spread);
+			real_t angle1_rad = direction.angle() + Math::deg_to_rad((rng.randf() * 2.0 - 1.0) * spread);
 			Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
-			p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+			p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 
 			real_t base_angle = tex_angle * Math::lerp(parameters_min[PARAM_ANGLE], parameters_max[PARAM_ANGLE], p.angle_rand);
 			p.rotation = Math::deg_to_rad(base_angle);
@@ -880,7 +909,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			p.custom[0] = 0.0; // unused
 			p.custom[1] = 0.0; // phase [0..1]
 			p.custom[2] = tex_anim_offset * Math::lerp(parameters_min[PARAM_ANIM_OFFSET], parameters_max[PARAM_ANIM_OFFSET], p.anim_offset_rand);
-			p.custom[3] = (1.0 - rng->randf() * lifetime_randomness);
+			p.custom[3] = (1.0 - rng.randf() * lifetime_randomness);
 			p.transform = Transform2D();
 			p.time = 0;
 			p.lifetime = lifetime * p.custom[3];
@@ -891,17 +920,17 @@ void CPUParticles2D::_particles_process(double p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t t = Math::TAU * rng->randf();
-					real_t radius = emission_sphere_radius * rng->randf();
+					real_t t = Math::TAU * rng.randf();
+					real_t radius = emission_sphere_radius * rng.randf();
 					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_SPHERE_SURFACE: {
-					real_t s = rng->randf(), t = Math::TAU * rng->randf();
+					real_t s = rng.randf(), t = Math::TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_RECTANGLE: {
-					p.transform[2] = Vector2(rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0) * emission_rect_extents;
+					p.transform[2] = Vector2(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_rect_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -910,7 +939,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
 					p.transform[2] = emission_points.get(random_idx);
 
@@ -932,8 +961,8 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			}
 
 			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
+				p.velocity = p_step->velocity_xform.xform(p.velocity);
+				p.transform = p_step->emission_xform * p.transform;
 			}
 
 		} else if (!p.active) {
@@ -1002,7 +1031,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			//apply linear acceleration
 			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * tex_linear_accel * Math::lerp(parameters_min[PARAM_LINEAR_ACCEL], parameters_max[PARAM_LINEAR_ACCEL], rand_from_seed(_seed)) : Vector2();
 			//apply radial acceleration
-			Vector2 org = emission_xform[2];
+			Vector2 org = p_step->emission_xform[2];
 			Vector2 diff = pos - org;
 			force += diff.length() > 0.0 ? diff.normalized() * (tex_radial_accel)*Math::lerp(parameters_min[PARAM_RADIAL_ACCEL], parameters_max[PARAM_RADIAL_ACCEL], rand_from_seed(_seed)) : Vector2();
 			//apply tangential acceleration;
@@ -1119,11 +1148,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 
 		p.transform[2] += p.velocity * local_delta;
 
-		should_be_active = true;
-	}
-	if (!Math::is_equal_approx(time, 0.0) && active && !should_be_active) {
-		active = false;
-		emit_signal(SceneStringName(finished));
+		p_step->should_be_active.set();
 	}
 }
 
@@ -1132,29 +1157,48 @@ void CPUParticles2D::_update_particle_data_buffer() {
 
 	int pc = particles.size();
 
-	int *ow;
-	int *order = nullptr;
+	const uint32_t *order = nullptr;
 
-	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
-		ow = particle_order.ptrw();
-		order = ow;
+		uint32_t *keys = particle_sort_keys.ptr();
+		uint32_t *ow = particle_order.ptr();
 
 		for (int i = 0; i < pc; i++) {
-			order[i] = i;
+			ow[i] = i;
 		}
 		if (draw_order == DRAW_ORDER_LIFETIME) {
-			SortArray<int, SortLifetime> sorter;
-			sorter.compare.particles = r;
-			sorter.sort(order, pc);
+			// Oldest first.
+			for (int i = 0; i < pc; i++) {
+				keys[i] = ~RadixSort::float_to_key(r[i].time);
+			}
+			particle_sort.sort(keys, ow, pc);
 		}
+		order = ow;
 	}
 
-	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
+	// Each chunk writes its own part of the instance buffer.
+	particle_data_ptr = particle_data.ptrw();
+	int chunk_count = (pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles2D::_update_particle_data_chunk, order, chunk_count, -1, true, SNAME("CPUParticles2DUpdateData"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (chunk_count == 1) {
+		_update_particle_data_chunk(0, order);
+	}
+	particle_data_ptr = nullptr;
+}
+
+void CPUParticles2D::_update_particle_data_chunk(uint32_t p_chunk, const uint32_t *p_order) {
+	int pc = particles.size();
+	const Particle *r = particles.ptr();
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pc);
+	float *ptr = particle_data_ptr + from * 16;
+	for (int i = from; i < to; i++) {
+		int idx = p_order ? p_order[i] : i;
 
 		Transform2D t = r[idx].transform;
 
@@ -1650,7 +1694,6 @@ CPUParticles2D::CPUParticles2D() {
 	set_use_local_coordinates(false);
 	set_seed(Math::rand());
 
-	rng.instantiate();
 
 	set_param_min(PARAM_INITIAL_LINEAR_VELOCITY, 0);
 	set_param_min(PARAM_ANGULAR_VELOCITY, 0);
@@ -30,10 +30,9 @@
 
 #pragma once
 
+#include "core/templates/radix_sort.h"
 #include "scene/2d/node_2d.h"
 
-class RandomNumberGenerator;
-
 class CPUParticles2D : public Node2D {
 private:
 	GDCLASS(CPUParticles2D, Node2D);
@@ -110,24 +109,27 @@ private:
 
 	Vector<Particle> particles;
 	Vector<float> particle_data;
-	Vector<int> particle_order;
-
-	struct SortLifetime {
-		const Particle *particles = nullptr;
-
-		bool operator()(int p_a, int p_b) const {
-			return particles[p_a].time > particles[p_b].time;
-		}
+	LocalVector<uint32_t> particle_order;
+	LocalVector<uint32_t> particle_sort_keys;
+	RadixSort particle_sort;
+	float *particle_data_ptr = nullptr; // Valid while the instance buffer is written.
+
+	// Particles are processed and written to the instance buffer in chunks, in parallel when there are several.
+	enum {
+		PROCESS_CHUNK_SIZE = 256,
 	};
 
-	struct SortAxis {
-		const Particle *particles = nullptr;
-		Vector2 axis;
-		bool operator()(int p_a, int p_b) const {
-			return axis.dot(particles[p_a].transform[2]) < axis.dot(particles[p_b].transform[2]);
-		}
+	struct ProcessStep {
+		Particle *particles = nullptr;
+		double delta = 0.0;
+		double prev_time = 0.0;
+		double system_phase = 0.0;
+		Transform2D emission_xform;
+		Transform2D velocity_xform;
+		SafeFlag should_be_active;
 	};
 
+
 	//
 
 	bool one_shot = false;
@@ -184,11 +186,11 @@ private:
 
 	Vector2 gravity = Vector2(0, 980);
 
-	Ref<RandomNumberGenerator> rng;
-
 	void _update_internal();
 	void _particles_process(double p_delta);
+	void _particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step);
 	void _update_particle_data_buffer();
+	void _update_particle_data_chunk(uint32_t p_chunk, const uint32_t *p_order);
 	void _set_emitting();
 
 	Mutex update_mutex;
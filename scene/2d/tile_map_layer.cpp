@@ -199,9 +199,6 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 
 	// ----------- Quadrants processing -----------
 
-	// List all rendering quadrants to update, creating new ones if needed.
-	SelfList<RenderingQuadrant>::List dirty_rendering_quadrant_list;
-
 	// Check if anything changed that might change the quadrant shape.
 	// If so, recreate everything.
 	bool quadrant_shape_changed = dirty.flags[DIRTY_FLAGS_LAYER_Y_SORT_ENABLED] || dirty.flags[DIRTY_FLAGS_TILE_SET] ||
@@ -210,6 +207,7 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 
 	// Free all quadrants.
 	if (forced_cleanup || quadrant_shape_changed) {
+		dirty_rendering_quadrant_list.clear();
 		for (const KeyValue<Vector2i, Ref<RenderingQuadrant>> &kv : rendering_quadrant_map) {
 			for (const RID &ci : kv.value->canvas_items) {
 				if (ci.is_valid()) {
@@ -238,12 +236,18 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 			}
 		}
 
-		// Update all dirty quadrants.
+		// Update dirty quadrants, up to the per-update budget. The remaining ones stay listed for the next update.
 		bool needs_set_not_interpolated = is_inside_tree() && get_tree()->is_physics_interpolation_enabled() && !is_physics_interpolated();
+		int budget = _get_quadrant_update_budget();
+		int updated_count = 0;
 		for (SelfList<RenderingQuadrant> *quadrant_list_element = dirty_rendering_quadrant_list.first(); quadrant_list_element;) {
-			SelfList<RenderingQuadrant> *next_quadrant_list_element = quadrant_list_element->next(); // "Hack" to clear the list while iterating.
+			if (budget > 0 && updated_count++ >= budget) {
+				break;
+			}
+			SelfList<RenderingQuadrant> *next_quadrant_list_element = quadrant_list_element->next();
+			dirty_rendering_quadrant_list.remove(quadrant_list_element);
 
-			const Ref<RenderingQuadrant> &rendering_quadrant = quadrant_list_element->self();
+			const Ref<RenderingQuadrant> rendering_quadrant = quadrant_list_element->self();
 
 			// Check if the quadrant has a tile.
 			bool has_a_tile = false;
@@ -366,8 +370,6 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 			quadrant_list_element = next_quadrant_list_element;
 		}
 
-		dirty_rendering_quadrant_list.clear();
-
 		// Reset the drawing indices.
 		{
 			int index = -(int64_t)0x80000000; // Always must be drawn below children.
@@ -691,32 +693,92 @@ void TileMapLayer::_rendering_draw_cell_debug(const RID &p_canvas_item, const Ve
 /////////////////////////////// Physics //////////////////////////////////////
 
 #ifndef PHYSICS_2D_DISABLED
-void TileMapLayer::_physics_update(bool p_force_cleanup) {
-	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+void PhysicsQuadrant::Build::merge_full_cells(Body &r_body, const Vector2 &p_cell_origin, const Vector2 &p_cell_size) {
+	// Rasterize the cells in their bounding rect.
+	Rect2i bounds(r_body.full_cells[0], Vector2i(1, 1));
+	for (const Vector2i &coords : r_body.full_cells) {
+		bounds.expand_to(coords);
+		bounds.expand_to(coords + Vector2i(1, 1));
+	}
+	LocalVector<uint8_t> grid;
+	grid.resize(bounds.size.x * bounds.size.y);
+	memset(grid.ptr(), 0, grid.size());
+	for (const Vector2i &coords : r_body.full_cells) {
+		const Vector2i local = coords - bounds.position;
+		grid[local.y * bounds.size.x + local.x] = 1;
+	}
+
+	// Greedily grow each rectangle along X first, then along Y as long as whole rows are filled.
+	for (int y = 0; y < bounds.size.y; y++) {
+		for (int x = 0; x < bounds.size.x; x++) {
+			if (!grid[y * bounds.size.x + x]) {
+				continue;
+			}
+			int width = 1;
+			while (x + width < bounds.size.x && grid[y * bounds.size.x + x + width]) {
+				width++;
+			}
+			int height = 1;
+			while (y + height < bounds.size.y) {
+				const uint8_t *row = &grid[(y + height) * bounds.size.x + x];
+				bool filled = true;
+				for (int i = 0; i < width; i++) {
+					if (!row[i]) {
+						filled = false;
+						break;
+					}
+				}
+				if (!filled) {
+					break;
+				}
+				height++;
+			}
+			for (int j = 0; j < height; j++) {
+				memset(&grid[(y + j) * bounds.size.x + x], 0, width);
+			}
+
+			const Vector2 from = p_cell_origin + Vector2(bounds.position + Vector2i(x, y)) * p_cell_size;
+			const Vector2 to = from + Vector2(width, height) * p_cell_size;
+			Vector<Vector2> rectangle = { from, Vector2(to.x, from.y), to, Vector2(from.x, to.y) };
+			r_body.convex_polygons.push_back(rectangle);
+		}
+	}
+	r_body.full_cells.clear();
+}
 
+void PhysicsQuadrant::Build::merge(void *p_build) {
+	Build *build = (Build *)p_build;
+	for (Body &body : build->bodies) {
+		if (!body.full_cells.is_empty()) {
+			merge_full_cells(body, build->cell_origin, build->cell_size);
+		}
+		if (body.polygons.is_empty()) {
+			continue;
+		}
+		Vector<Vector<Vector2>> out_polygons;
+		Vector<Vector<Vector2>> out_holes;
+		Geometry2D::merge_many_polygons(body.polygons, out_polygons, out_holes);
+		body.convex_polygons.append_array(Geometry2D::decompose_many_polygons_in_convex(out_polygons, out_holes));
+		body.polygons.clear();
+	}
+}
+
+void TileMapLayer::_physics_update(bool p_force_cleanup) {
 	// Check if we should cleanup everything.
 	bool forced_cleanup = p_force_cleanup || !enabled || !collision_enabled || !is_inside_tree() || tile_set.is_null();
 
 	// ----------- Quadrants processing -----------
 
-	// List all physics quadrants to update, creating new ones if needed.
-	SelfList<PhysicsQuadrant>::List dirty_physics_quadrant_list;
-
 	// Check if anything changed that might change the quadrant shape.
 	// If so, recreate everything.
-	bool quadrant_shape_changed = dirty.flags[DIRTY_FLAGS_TILE_SET] || dirty.flags[DIRTY_FLAGS_LAYER_PHYSICS_QUADRANT_SIZE];
+	bool quadrant_shape_changed = dirty.flags[DIRTY_FLAGS_TILE_SET] || dirty.flags[DIRTY_FLAGS_LAYER_PHYSICS_QUADRANT_SIZE] || dirty.flags[DIRTY_FLAGS_LAYER_RECTANGLE_COLLISION_MERGING];
 
 	// Free all quadrants.
 	if (forced_cleanup || quadrant_shape_changed) {
+		dirty_physics_quadrant_list.clear();
 		for (const KeyValue<Vector2i, Ref<PhysicsQuadrant>> &kv : physics_quadrant_map) {
-			// Clear bodies.
-			for (KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kvbody : kv.value->bodies) {
-				if (kvbody.value.body.is_valid()) {
-					bodies_coords.erase(kvbody.value.body);
-					ps->free(kvbody.value.body);
-				}
-			}
-			kv.value->bodies.clear();
+			_physics_quadrant_abandon_build(**kv.value);
+			_physics_quadrant_free_bodies(**kv.value);
 			kv.value->cells.clear();
 		}
 		physics_quadrant_map.clear();
@@ -724,9 +786,6 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 	}
 
 	if (!forced_cleanup) {
-		RID space = get_world_2d()->get_space();
-		Transform2D gl_transform = get_global_transform();
-
 		// List all quadrants to update, recreating them if needed.
 		if (dirty.flags[DIRTY_FLAGS_LAYER_IN_TREE] || _physics_was_cleaned_up) {
 			// Update all cells.
@@ -742,11 +801,42 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 			}
 		}
 
-		// Update all dirty quadrants.
+		int budget = _get_quadrant_update_budget();
+		int updated_count = 0;
+
+		// Swap in the shapes of finished threaded builds first.
+		for (SelfList<PhysicsQuadrant> *quadrant_list_element = building_physics_quadrant_list.first(); quadrant_list_element;) {
+			SelfList<PhysicsQuadrant> *next_quadrant_list_element = quadrant_list_element->next();
+			PhysicsQuadrant *physics_quadrant = quadrant_list_element->self();
+			if (!flushing_quadrant_updates && !WorkerThreadPool::get_singleton()->is_task_completed(physics_quadrant->build->task)) {
+				quadrant_list_element = next_quadrant_list_element;
+				continue;
+			}
+			if (budget > 0 && updated_count++ >= budget) {
+				break;
+			}
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(physics_quadrant->build->task);
+			building_physics_quadrant_list.remove(quadrant_list_element);
+			_physics_quadrant_commit(*physics_quadrant, *physics_quadrant->build);
+			memdelete(physics_quadrant->build);
+			physics_quadrant->build = nullptr;
+
+			quadrant_list_element = next_quadrant_list_element;
+		}
+
+		// Update dirty quadrants, up to the per-update budget. The remaining ones stay listed for the next update.
+		bool threaded = use_threaded_collision_build && !flushing_quadrant_updates;
 		for (SelfList<PhysicsQuadrant> *quadrant_list_element = dirty_physics_quadrant_list.first(); quadrant_list_element;) {
-			SelfList<PhysicsQuadrant> *next_quadrant_list_element = quadrant_list_element->next(); // "Hack" to clear the list while iterating.
+			if (budget > 0 && updated_count++ >= budget) {
+				break;
+			}
+			SelfList<PhysicsQuadrant> *next_quadrant_list_element = quadrant_list_element->next();
+			dirty_physics_quadrant_list.remove(quadrant_list_element);
+
+			const Ref<PhysicsQuadrant> physics_quadrant = quadrant_list_element->self();
 
-			const Ref<PhysicsQuadrant> &physics_quadrant = quadrant_list_element->self();
+			// Any running build is outdated now.
+			_physics_quadrant_abandon_build(**physics_quadrant);
 
 			// Check if the quadrant has a tile.
 			bool has_a_tile = false;
@@ -759,139 +849,21 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 			}
 
 			if (has_a_tile) {
-				// Process the quadrant.
-
-				// First, clear the quadrant bodies.
-				for (KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kvbody : physics_quadrant->bodies) {
-					RID &body = kvbody.value.body;
-					if (body.is_valid()) {
-						bodies_coords.erase(body);
-						ps->free(body);
-						body = RID();
-					}
-				}
-				physics_quadrant->bodies.clear();
-				physics_quadrant->shapes.clear();
-
-				// Quadrant origin
-				Vector2 quadrant_origin = tile_set->map_to_local(physics_quadrant->quadrant_coords);
-
-				// Recreate the quadrant bodies.
-				for (uint32_t tile_set_physics_layer = 0; tile_set_physics_layer < (uint32_t)tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
-					Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
-					uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(tile_set_physics_layer);
-					uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(tile_set_physics_layer);
-
-					// Merge polygons together for each quadrant.
-					for (SelfList<CellData> *cell_data_quadrant_list_element = physics_quadrant->cells.first(); cell_data_quadrant_list_element; cell_data_quadrant_list_element = cell_data_quadrant_list_element->next()) {
-						CellData &cell_data = *cell_data_quadrant_list_element->self();
-
-						TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(cell_data.cell.source_id));
-
-						// Get the tile data.
-						const TileData *tile_data;
-						if (cell_data.runtime_tile_data_cache) {
-							tile_data = cell_data.runtime_tile_data_cache;
-						} else {
-							tile_data = atlas_source->get_tile_data(cell_data.cell.get_atlas_coords(), cell_data.cell.alternative_tile);
-						}
-
-						// Transform flags.
-						bool flip_h = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_FLIP_H);
-						bool flip_v = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_FLIP_V);
-						bool transpose = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_TRANSPOSE);
-
-						Vector2 linear_velocity = tile_data->get_constant_linear_velocity(tile_set_physics_layer);
-						real_t angular_velocity = tile_data->get_constant_angular_velocity(tile_set_physics_layer);
-
-						// Setup polygons for merge.
-						for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
-							// Iterate over the polygons.
-							int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
-
-							// Check if we need to create a new body.
-							PhysicsQuadrant::PhysicsBodyKey physics_body_key;
-							physics_body_key.physics_layer = tile_set_physics_layer;
-							physics_body_key.linear_velocity = linear_velocity;
-							physics_body_key.angular_velocity = angular_velocity;
-							physics_body_key.one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
-							physics_body_key.one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
-
-							if (!physics_quadrant->bodies.has(physics_body_key)) {
-								RID body = ps->body_create();
-								physics_quadrant->bodies[physics_body_key] = {};
-								physics_quadrant->bodies[physics_body_key].body = body;
-								bodies_coords[body] = physics_quadrant->quadrant_coords;
-
-								// Create or update the body.
-								ps->body_set_mode(body, use_kinematic_bodies ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
-								ps->body_set_space(body, space);
-
-								Transform2D xform;
-								xform.set_origin(quadrant_origin);
-								xform = gl_transform * xform;
-								ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
-
-								ps->body_attach_object_instance_id(body, tile_map_node ? tile_map_node->get_instance_id() : get_instance_id());
-								ps->body_set_collision_layer(body, physics_layer);
-								ps->body_set_collision_mask(body, physics_mask);
-								ps->body_set_pickable(body, false);
-								ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, linear_velocity);
-								ps->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, angular_velocity);
-
-								if (!physics_material.is_valid()) {
-									ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
-									ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
-								} else {
-									ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
-									ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
-								}
-							}
-
-							for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
-								Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index, flip_h, flip_v, transpose);
-
-								// Translate the polygon.
-								Vector<Vector2> convex_polygon = shape->get_points();
-								for (int i = 0; i < convex_polygon.size(); i++) {
-									convex_polygon.set(i, convex_polygon[i] + tile_set->map_to_local(cell_data.coords) - quadrant_origin);
-								}
-
-								physics_quadrant->bodies[physics_body_key].polygons.push_back(convex_polygon);
-							}
-						}
-					}
-				}
-
-				// Iterate over the bodies
-				for (const KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kvbody : physics_quadrant->bodies) {
-					// Actually merge the polygons.
-					Vector<Vector<Vector2>> out_polygons;
-					Vector<Vector<Vector2>> out_holes;
-					Geometry2D::merge_many_polygons(kvbody.value.polygons, out_polygons, out_holes);
-					// Create shapes for each polygon.
-					int body_shape_index = 0;
-					Vector<Vector<Vector2>> convex_polygons = Geometry2D::decompose_many_polygons_in_convex(out_polygons, out_holes);
-					for (Vector<Vector2> &convex_polygon : convex_polygons) {
-						Ref<ConvexPolygonShape2D> shape;
-						shape.instantiate();
-						shape->set_points(convex_polygon);
-						ps->body_add_shape(kvbody.value.body, shape->get_rid());
-						ps->body_set_shape_as_one_way_collision(kvbody.value.body, body_shape_index, kvbody.key.one_way_collision, kvbody.key.one_way_collision_margin);
-						physics_quadrant->shapes.push_back(shape);
-						body_shape_index++;
-					}
+				// Process the quadrant. The current bodies are kept until the new shapes are ready.
+				PhysicsQuadrant::Build *build = memnew(PhysicsQuadrant::Build);
+				_physics_quadrant_collect_polygons(**physics_quadrant, *build);
+				if (threaded) {
+					physics_quadrant->build = build;
+					building_physics_quadrant_list.add(&physics_quadrant->building_quadrant_list_element);
+					build->task = WorkerThreadPool::get_singleton()->add_native_task(&PhysicsQuadrant::Build::merge, build, false, SNAME("TileMapLayer physics quadrant build"));
+				} else {
+					PhysicsQuadrant::Build::merge(build);
+					_physics_quadrant_commit(**physics_quadrant, *build);
+					memdelete(build);
 				}
 			} else {
 				// Free the quadrant.
-				for (KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kv : physics_quadrant->bodies) {
-					RID &body = kv.value.body;
-					if (body.is_valid()) {
-						bodies_coords.erase(body);
-						ps->free(body);
-					}
-				}
-				physics_quadrant->bodies.clear();
+				_physics_quadrant_free_bodies(**physics_quadrant);
 				physics_quadrant->cells.clear();
 				physics_quadrant_map.erase(physics_quadrant->quadrant_coords);
 			}
@@ -899,10 +871,9 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 			quadrant_list_element = next_quadrant_list_element;
 		}
 
-		dirty_physics_quadrant_list.clear();
-
 		// Updates on physics changes.
 		if (dirty.flags[DIRTY_FLAGS_LAYER_USE_KINEMATIC_BODIES]) {
+			PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
 			for (KeyValue<Vector2i, Ref<PhysicsQuadrant>> &kv : physics_quadrant_map) {
 				Ref<PhysicsQuadrant> &physics_quadrant = kv.value;
 				for (const KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kvbody : physics_quadrant->bodies) {
@@ -912,11 +883,196 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 		}
 	}
 
+	_physics_free_abandoned_builds(forced_cleanup || flushing_quadrant_updates);
+
 	// -----------
 	// Mark the physics state as up to date.
 	_physics_was_cleaned_up = forced_cleanup || !occlusion_enabled;
 }
 
+void TileMapLayer::_physics_quadrant_collect_polygons(const PhysicsQuadrant &p_physics_quadrant, PhysicsQuadrant::Build &r_build) const {
+	// Quadrant origin
+	Vector2 quadrant_origin = tile_set->map_to_local(p_physics_quadrant.quadrant_coords);
+
+	// On square tiles, polygons covering a whole cell are merged into rectangles instead of going through the polygon merge.
+	bool merge_full_cells = use_rectangle_collision_merging && tile_set->get_tile_shape() == TileSet::TILE_SHAPE_SQUARE;
+	Vector2 half_cell_size = tile_set->get_tile_size() / 2.0;
+	if (merge_full_cells) {
+		r_build.cell_size = tile_set->get_tile_size();
+		r_build.cell_origin = tile_set->map_to_local(Vector2i()) - half_cell_size - quadrant_origin;
+	}
+
+	HashMap<PhysicsQuadrant::PhysicsBodyKey, uint32_t, PhysicsQuadrant::PhysicsBodyKeyHasher> body_indices;
+	for (uint32_t tile_set_physics_layer = 0; tile_set_physics_layer < (uint32_t)tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
+		// Gather the polygons of each body for the merge.
+		for (const SelfList<CellData> *cell_data_quadrant_list_element = p_physics_quadrant.cells.first(); cell_data_quadrant_list_element; cell_data_quadrant_list_element = cell_data_quadrant_list_element->next()) {
+			const CellData &cell_data = *cell_data_quadrant_list_element->self();
+
+			TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(cell_data.cell.source_id));
+
+			// Get the tile data.
+			const TileData *tile_data;
+			if (cell_data.runtime_tile_data_cache) {
+				tile_data = cell_data.runtime_tile_data_cache;
+			} else {
+				tile_data = atlas_source->get_tile_data(cell_data.cell.get_atlas_coords(), cell_data.cell.alternative_tile);
+			}
+
+			// Transform flags.
+			bool flip_h = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_FLIP_H);
+			bool flip_v = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_FLIP_V);
+			bool transpose = (cell_data.cell.alternative_tile & TileSetAtlasSource::TRANSFORM_TRANSPOSE);
+
+			Vector2 linear_velocity = tile_data->get_constant_linear_velocity(tile_set_physics_layer);
+			real_t angular_velocity = tile_data->get_constant_angular_velocity(tile_set_physics_layer);
+			Vector2 cell_offset = tile_set->map_to_local(cell_data.coords) - quadrant_origin;
+
+			for (int polygon_index = 0; polygon_index < tile_data->get_collision_polygons_count(tile_set_physics_layer); polygon_index++) {
+				// Iterate over the polygons.
+				int shapes_count = tile_data->get_collision_polygon_shapes_count(tile_set_physics_layer, polygon_index);
+
+				// Check if we need a new body.
+				PhysicsQuadrant::PhysicsBodyKey physics_body_key;
+				physics_body_key.physics_layer = tile_set_physics_layer;
+				physics_body_key.linear_velocity = linear_velocity;
+				physics_body_key.angular_velocity = angular_velocity;
+				physics_body_key.one_way_collision = tile_data->is_collision_polygon_one_way(tile_set_physics_layer, polygon_index);
+				physics_body_key.one_way_collision_margin = tile_data->get_collision_polygon_one_way_margin(tile_set_physics_layer, polygon_index);
+
+				HashMap<PhysicsQuadrant::PhysicsBodyKey, uint32_t, PhysicsQuadrant::PhysicsBodyKeyHasher>::Iterator E = body_indices.find(physics_body_key);
+				if (!E) {
+					E = body_indices.insert(physics_body_key, r_build.bodies.size());
+					r_build.bodies.push_back(PhysicsQuadrant::Build::Body());
+					r_build.bodies[E->value].key = physics_body_key;
+				}
+				PhysicsQuadrant::Build::Body &body = r_build.bodies[E->value];
+
+				if (merge_full_cells && shapes_count == 1 && _is_full_cell_polygon(tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, 0, flip_h, flip_v, transpose)->get_points(), half_cell_size)) {
+					body.full_cells.push_back(cell_data.coords);
+					continue;
+				}
+
+				for (int shape_index = 0; shape_index < shapes_count; shape_index++) {
+					Ref<ConvexPolygonShape2D> shape = tile_data->get_collision_polygon_shape(tile_set_physics_layer, polygon_index, shape_index, flip_h, flip_v, transpose);
+
+					// Translate the polygon.
+					Vector<Vector2> convex_polygon = shape->get_points();
+					Vector2 *convex_polygon_ptrw = convex_polygon.ptrw();
+					for (int i = 0; i < convex_polygon.size(); i++) {
+						convex_polygon_ptrw[i] += cell_offset;
+					}
+
+					body.polygons.push_back(convex_polygon);
+				}
+			}
+		}
+	}
+}
+
+bool TileMapLayer::_is_full_cell_polygon(const Vector<Vector2> &p_polygon, const Vector2 &p_half_cell_size) {
+	if (p_polygon.size() != 4) {
+		return false;
+	}
+	// Each point must be a distinct corner of the cell.
+	uint32_t corners = 0;
+	for (const Vector2 &point : p_polygon) {
+		if (!Math::is_equal_approx(Math::abs(point.x), p_half_cell_size.x) || !Math::is_equal_approx(Math::abs(point.y), p_half_cell_size.y)) {
+			return false;
+		}
+		corners |= 1 << ((point.x > 0 ? 1 : 0) | (point.y > 0 ? 2 : 0));
+	}
+	return corners == 0b1111;
+}
+
+void TileMapLayer::_physics_quadrant_commit(PhysicsQuadrant &r_physics_quadrant, const PhysicsQuadrant::Build &p_build) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	// First, clear the quadrant bodies.
+	_physics_quadrant_free_bodies(r_physics_quadrant);
+
+	RID space = get_world_2d()->get_space();
+	Transform2D xform;
+	xform.set_origin(tile_set->map_to_local(r_physics_quadrant.quadrant_coords));
+	xform = get_global_transform() * xform;
+
+	// Recreate the quadrant bodies.
+	for (const PhysicsQuadrant::Build::Body &build_body : p_build.bodies) {
+		const PhysicsQuadrant::PhysicsBodyKey &key = build_body.key;
+		Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(key.physics_layer);
+
+		RID body = ps->body_create();
+		r_physics_quadrant.bodies[key].body = body;
+		bodies_coords[body] = r_physics_quadrant.quadrant_coords;
+
+		ps->body_set_mode(body, use_kinematic_bodies ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
+		ps->body_set_space(body, space);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
+
+		ps->body_attach_object_instance_id(body, tile_map_node ? tile_map_node->get_instance_id() : get_instance_id());
+		ps->body_set_collision_layer(body, tile_set->get_physics_layer_collision_layer(key.physics_layer));
+		ps->body_set_collision_mask(body, tile_set->get_physics_layer_collision_mask(key.physics_layer));
+		ps->body_set_pickable(body, false);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, key.linear_velocity);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, key.angular_velocity);
+
+		if (!physics_material.is_valid()) {
+			ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
+			ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
+		} else {
+			ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
+			ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
+		}
+
+		// Create shapes for each polygon.
+		int body_shape_index = 0;
+		for (const Vector<Vector2> &convex_polygon : build_body.convex_polygons) {
+			Ref<ConvexPolygonShape2D> shape;
+			shape.instantiate();
+			shape->set_points(convex_polygon);
+			ps->body_add_shape(body, shape->get_rid());
+			ps->body_set_shape_as_one_way_collision(body, body_shape_index, key.one_way_collision, key.one_way_collision_margin);
+			r_physics_quadrant.shapes.push_back(shape);
+			body_shape_index++;
+		}
+	}
+}
+
+void TileMapLayer::_physics_quadrant_free_bodies(PhysicsQuadrant &r_physics_quadrant) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	for (KeyValue<PhysicsQuadrant::PhysicsBodyKey, PhysicsQuadrant::PhysicsBodyValue> &kvbody : r_physics_quadrant.bodies) {
+		RID &body = kvbody.value.body;
+		if (body.is_valid()) {
+			bodies_coords.erase(body);
+			ps->free(body);
+			body = RID();
+		}
+	}
+	r_physics_quadrant.bodies.clear();
+	r_physics_quadrant.shapes.clear();
+}
+
+void TileMapLayer::_physics_quadrant_abandon_build(PhysicsQuadrant &r_physics_quadrant) {
+	if (!r_physics_quadrant.build) {
+		return;
+	}
+	building_physics_quadrant_list.remove(&r_physics_quadrant.building_quadrant_list_element);
+	abandoned_physics_builds.push_back(r_physics_quadrant.build);
+	r_physics_quadrant.build = nullptr;
+}
+
+void TileMapLayer::_physics_free_abandoned_builds(bool p_wait) {
+	for (uint32_t i = 0; i < abandoned_physics_builds.size();) {
+		PhysicsQuadrant::Build *build = abandoned_physics_builds[i];
+		if (!p_wait && !WorkerThreadPool::get_singleton()->is_task_completed(build->task)) {
+			i++;
+			continue;
+		}
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(build->task);
+		memdelete(build);
+		abandoned_physics_builds.remove_at_unordered(i);
+	}
+}
+
 void TileMapLayer::_physics_quadrants_update_cell(CellData &r_cell_data, SelfList<PhysicsQuadrant>::List &r_dirty_physics_quadrant_list) {
 	// Check if the cell is valid and retrieve its y_sort_origin.
 	bool is_valid = false;
@@ -2008,6 +2164,25 @@ void TileMapLayer::_internal_update(bool p_force_cleanup) {
 	dirty.cell_list.clear();
 
 	pending_update = false;
+
+	// Quadrants left over by the update budget or still building are handled on the next frames.
+	set_process_internal(!p_force_cleanup && _has_pending_quadrant_updates());
+}
+
+int TileMapLayer::_get_quadrant_update_budget() const {
+	return flushing_quadrant_updates ? 0 : quadrant_update_budget;
+}
+
+bool TileMapLayer::_has_pending_quadrant_updates() const {
+	if (dirty_rendering_quadrant_list.first()) {
+		return true;
+	}
+#ifndef PHYSICS_2D_DISABLED
+	if (dirty_physics_quadrant_list.first() || building_physics_quadrant_list.first() || !abandoned_physics_builds.is_empty()) {
+		return true;
+	}
+#endif // PHYSICS_2D_DISABLED
+	return false;
 }
 
 void TileMapLayer::_physics_interpolated_changed() {
@@ -2074,6 +2249,10 @@ void TileMapLayer::_notification(int p_what) {
 			dirty.flags[DIRTY_FLAGS_LAYER_VISIBILITY] = true;
 			_queue_internal_update();
 		} break;
+
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			_queue_internal_update();
+		} break;
 	}
 
 	_rendering_notification(p_what);
@@ -2141,6 +2320,9 @@ void TileMapLayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_tile_set", "tile_set"), &TileMapLayer::set_tile_set);
 	ClassDB::bind_method(D_METHOD("get_tile_set"), &TileMapLayer::get_tile_set);
 
+	ClassDB::bind_method(D_METHOD("set_quadrant_update_budget", "budget"), &TileMapLayer::set_quadrant_update_budget);
+	ClassDB::bind_method(D_METHOD("get_quadrant_update_budget"), &TileMapLayer::get_quadrant_update_budget);
+
 	ClassDB::bind_method(D_METHOD("set_y_sort_origin", "y_sort_origin"), &TileMapLayer::set_y_sort_origin);
 	ClassDB::bind_method(D_METHOD("get_y_sort_origin"), &TileMapLayer::get_y_sort_origin);
 	ClassDB::bind_method(D_METHOD("set_x_draw_order_reversed", "x_draw_order_reversed"), &TileMapLayer::set_x_draw_order_reversed);
@@ -2152,6 +2334,10 @@ void TileMapLayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_collision_enabled"), &TileMapLayer::is_collision_enabled);
 	ClassDB::bind_method(D_METHOD("set_use_kinematic_bodies", "use_kinematic_bodies"), &TileMapLayer::set_use_kinematic_bodies);
 	ClassDB::bind_method(D_METHOD("is_using_kinematic_bodies"), &TileMapLayer::is_using_kinematic_bodies);
+	ClassDB::bind_method(D_METHOD("set_use_threaded_collision_build", "enabled"), &TileMapLayer::set_use_threaded_collision_build);
+	ClassDB::bind_method(D_METHOD("is_using_threaded_collision_build"), &TileMapLayer::is_using_threaded_collision_build);
+	ClassDB::bind_method(D_METHOD("set_use_rectangle_collision_merging", "enabled"), &TileMapLayer::set_use_rectangle_collision_merging);
+	ClassDB::bind_method(D_METHOD("is_using_rectangle_collision_merging"), &TileMapLayer::is_using_rectangle_collision_merging);
 	ClassDB::bind_method(D_METHOD("set_collision_visibility_mode", "visibility_mode"), &TileMapLayer::set_collision_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_collision_visibility_mode"), &TileMapLayer::get_collision_visibility_mode);
 	ClassDB::bind_method(D_METHOD("set_physics_quadrant_size", "size"), &TileMapLayer::set_physics_quadrant_size);
@@ -2177,6 +2363,7 @@ void TileMapLayer::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "enabled"), "set_enabled", "is_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "tile_set", PROPERTY_HINT_RESOURCE_TYPE, "TileSet"), "set_tile_set", "get_tile_set");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "quadrant_update_budget", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_quadrant_update_budget", "get_quadrant_update_budget");
 	ADD_GROUP("Rendering", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "occlusion_enabled"), "set_occlusion_enabled", "is_occlusion_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "y_sort_origin"), "set_y_sort_origin", "get_y_sort_origin");
@@ -2185,6 +2372,8 @@ void TileMapLayer::_bind_methods() {
 	ADD_GROUP("Physics", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_enabled"), "set_collision_enabled", "is_collision_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_kinematic_bodies"), "set_use_kinematic_bodies", "is_using_kinematic_bodies");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_threaded_collision_build"), "set_use_threaded_collision_build", "is_using_threaded_collision_build");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_rectangle_collision_merging"), "set_use_rectangle_collision_merging", "is_using_rectangle_collision_merging");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_visibility_mode", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_collision_visibility_mode", "get_collision_visibility_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "physics_quadrant_size"), "set_physics_quadrant_size", "get_physics_quadrant_size");
 #ifndef NAVIGATION_2D_DISABLED
@@ -3005,7 +3194,9 @@ Vector2i TileMapLayer::get_coords_for_body_rid(RID p_physics_body) const {
 #endif // PHYSICS_2D_DISABLED
 
 void TileMapLayer::update_internals() {
+	flushing_quadrant_updates = true;
 	_internal_update(false);
+	flushing_quadrant_updates = false;
 }
 
 void TileMapLayer::notify_runtime_tile_data_update() {
@@ -3094,6 +3285,19 @@ TileMapLayer::HighlightMode TileMapLayer::get_highlight_mode() const {
 	return highlight_mode;
 }
 
+void TileMapLayer::set_quadrant_update_budget(int p_budget) {
+	ERR_FAIL_COND_MSG(p_budget < 0, "The quadrant update budget cannot be negative.");
+	if (quadrant_update_budget == p_budget) {
+		return;
+	}
+	quadrant_update_budget = p_budget;
+	_queue_internal_update();
+}
+
+int TileMapLayer::get_quadrant_update_budget() const {
+	return quadrant_update_budget;
+}
+
 void TileMapLayer::set_tile_map_data_from_array(const Vector<uint8_t> &p_data) {
 	if (p_data.is_empty()) {
 		clear();
@@ -3291,6 +3495,28 @@ bool TileMapLayer::is_using_kinematic_bodies() const {
 	return use_kinematic_bodies;
 }
 
+void TileMapLayer::set_use_threaded_collision_build(bool p_use_threaded_collision_build) {
+	use_threaded_collision_build = p_use_threaded_collision_build;
+}
+
+bool TileMapLayer::is_using_threaded_collision_build() const {
+	return use_threaded_collision_build;
+}
+
+void TileMapLayer::set_use_rectangle_collision_merging(bool p_use_rectangle_collision_merging) {
+	if (use_rectangle_collision_merging == p_use_rectangle_collision_merging) {
+		return;
+	}
+	use_rectangle_collision_merging = p_use_rectangle_collision_merging;
+	dirty.flags[DIRTY_FLAGS_LAYER_RECTANGLE_COLLISION_MERGING] = true;
+	_queue_internal_update();
+	emit_signal(CoreStringName(changed));
+}
+
+bool TileMapLayer::is_using_rectangle_collision_merging() const {
+	return use_rectangle_collision_merging;
+}
+
 void TileMapLayer::set_collision_visibility_mode(TileMapLayer::DebugVisibilityMode p_show_collision) {
 	if (collision_visibility_mode == p_show_collision) {
 		return;
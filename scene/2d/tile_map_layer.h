@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/object/worker_thread_pool.h"
 #include "scene/resources/2d/tile_set.h"
 
 #ifndef NAVIGATION_2D_DISABLED
@@ -281,7 +282,25 @@ public:
 
 	struct PhysicsBodyValue {
 		RID body;
-		Vector<Vector<Vector2>> polygons;
+	};
+
+	// Collision polygons of the quadrant, merged into convex shapes either right away or on the WorkerThreadPool.
+	// Only read by the task once it is queued, the result is committed on the main thread.
+	struct Build {
+		struct Body {
+			PhysicsBodyKey key;
+			Vector<Vector<Vector2>> polygons;
+			LocalVector<Vector2i> full_cells; // Cells fully covered by a square collision polygon, merged into rectangles.
+			Vector<Vector<Vector2>> convex_polygons;
+		};
+		LocalVector<Body> bodies;
+		// Position of the cell (0, 0) top-left corner relative to the quadrant origin, and the cell size. Square tiles only.
+		Vector2 cell_origin;
+		Vector2 cell_size;
+		WorkerThreadPool::TaskID task = WorkerThreadPool::INVALID_TASK_ID;
+
+		static void merge_full_cells(Body &r_body, const Vector2 &p_cell_origin, const Vector2 &p_cell_size);
+		static void merge(void *p_build);
 	};
 
 	struct CoordsWorldComparator {
@@ -301,13 +320,21 @@ public:
 	HashMap<PhysicsBodyKey, PhysicsBodyValue, PhysicsBodyKeyHasher> bodies;
 	LocalVector<Ref<ConvexPolygonShape2D>> shapes;
 
+	Build *build = nullptr; // Running threaded build.
+
 	SelfList<PhysicsQuadrant> dirty_quadrant_list_element;
+	SelfList<PhysicsQuadrant> building_quadrant_list_element;
 
 	PhysicsQuadrant() :
-			dirty_quadrant_list_element(this) {
+			dirty_quadrant_list_element(this),
+			building_quadrant_list_element(this) {
 	}
 
 	~PhysicsQuadrant() {
+		if (build) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(build->task);
+			memdelete(build);
+		}
 		cells.clear();
 	}
 };
@@ -315,6 +342,7 @@ public:
 
 class TileMapLayer : public Node2D {
 	GDCLASS(TileMapLayer, Node2D);
+	friend class TestTileMapLayerInternalsAccessor;
 
 public:
 	enum HighlightMode {
@@ -348,6 +376,7 @@ public:
 		DIRTY_FLAGS_LAYER_COLLISION_ENABLED,
 		DIRTY_FLAGS_LAYER_USE_KINEMATIC_BODIES,
 		DIRTY_FLAGS_LAYER_PHYSICS_QUADRANT_SIZE,
+		DIRTY_FLAGS_LAYER_RECTANGLE_COLLISION_MERGING,
 		DIRTY_FLAGS_LAYER_COLLISION_VISIBILITY_MODE,
 		DIRTY_FLAGS_LAYER_OCCLUSION_ENABLED,
 		DIRTY_FLAGS_LAYER_NAVIGATION_ENABLED,
@@ -382,6 +411,8 @@ private:
 
 	bool collision_enabled = true;
 	bool use_kinematic_bodies = false;
+	bool use_threaded_collision_build = false;
+	bool use_rectangle_collision_merging = false;
 	int physics_quadrant_size = 16;
 	DebugVisibilityMode collision_visibility_mode = DEBUG_VISIBILITY_MODE_DEFAULT;
 
@@ -391,8 +422,11 @@ private:
 	RID navigation_map_override;
 	DebugVisibilityMode navigation_visibility_mode = DEBUG_VISIBILITY_MODE_DEFAULT;
 
+	int quadrant_update_budget = 0;
+
 	// Internal.
 	bool pending_update = false;
+	bool flushing_quadrant_updates = false; // Ignore the update budget and wait for threaded builds.
 
 	// For keeping compatibility with TileMap.
 	TileMap *tile_map_node = nullptr;
@@ -432,6 +466,7 @@ private:
 #endif // DEBUG_ENABLED
 
 	HashMap<Vector2i, Ref<RenderingQuadrant>> rendering_quadrant_map;
+	SelfList<RenderingQuadrant>::List dirty_rendering_quadrant_list; // Kept between updates when over budget.
 	bool _rendering_was_cleaned_up = false;
 	void _rendering_update(bool p_force_cleanup);
 	void _rendering_notification(int p_what);
@@ -445,8 +480,17 @@ private:
 #ifndef PHYSICS_2D_DISABLED
 	HashMap<Vector2i, Ref<PhysicsQuadrant>> physics_quadrant_map;
 	HashMap<RID, Vector2i> bodies_coords; // Mapping for RID to coords.
+	SelfList<PhysicsQuadrant>::List dirty_physics_quadrant_list; // Kept between updates when over budget.
+	SelfList<PhysicsQuadrant>::List building_physics_quadrant_list;
+	LocalVector<PhysicsQuadrant::Build *> abandoned_physics_builds; // Outdated before completion, freed once done.
 	bool _physics_was_cleaned_up = false;
 	void _physics_update(bool p_force_cleanup);
+	static bool _is_full_cell_polygon(const Vector<Vector2> &p_polygon, const Vector2 &p_half_cell_size);
+	void _physics_quadrant_collect_polygons(const PhysicsQuadrant &p_physics_quadrant, PhysicsQuadrant::Build &r_build) const;
+	void _physics_quadrant_commit(PhysicsQuadrant &r_physics_quadrant, const PhysicsQuadrant::Build &p_build);
+	void _physics_quadrant_free_bodies(PhysicsQuadrant &r_physics_quadrant);
+	void _physics_quadrant_abandon_build(PhysicsQuadrant &r_physics_quadrant);
+	void _physics_free_abandoned_builds(bool p_wait);
 	void _physics_notification(int p_what);
 	void _physics_quadrants_update_cell(CellData &r_cell_data, SelfList<PhysicsQuadrant>::List &r_dirty_physics_quadrant_list);
 	void _physics_clear_cell(CellData &r_cell_data);
@@ -489,6 +533,8 @@ private:
 	void _queue_internal_update();
 	void _deferred_internal_update();
 	void _internal_update(bool p_force_cleanup);
+	int _get_quadrant_update_budget() const;
+	bool _has_pending_quadrant_updates() const;
 
 	virtual void _physics_interpolated_changed() override;
 
@@ -591,6 +637,9 @@ public:
 	void set_highlight_mode(HighlightMode p_highlight_mode);
 	HighlightMode get_highlight_mode() const;
 
+	void set_quadrant_update_budget(int p_budget);
+	int get_quadrant_update_budget() const;
+
 	virtual void set_self_modulate(const Color &p_self_modulate) override;
 	virtual void set_y_sort_enabled(bool p_y_sort_enabled) override;
 	void set_y_sort_origin(int p_y_sort_origin);
@@ -606,6 +655,10 @@ public:
 	bool is_collision_enabled() const;
 	void set_use_kinematic_bodies(bool p_use_kinematic_bodies);
 	bool is_using_kinematic_bodies() const;
+	void set_use_threaded_collision_build(bool p_use_threaded_collision_build);
+	bool is_using_threaded_collision_build() const;
+	void set_use_rectangle_collision_merging(bool p_use_rectangle_collision_merging);
+	bool is_using_rectangle_collision_merging() const;
 	void set_collision_visibility_mode(DebugVisibilityMode p_show_collision);
 	DebugVisibilityMode get_collision_visibility_mode() const;
 	void set_physics_quadrant_size(int p_size);
@@ -31,7 +31,8 @@
 #include "cpu_particles_3d.h"
 #include "cpu_particles_3d.compat.inc"
 
-#include "core/math/random_number_generator.h"
+#include "core/math/random_pcg.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/main/viewport.h"
@@ -85,6 +86,7 @@ void CPUParticles3D::set_amount(int p_amount) {
 	RS::get_singleton()->multimesh_allocate_data(multimesh, p_amount, RS::MULTIMESH_TRANSFORM_3D, true, true);
 
 	particle_order.resize(p_amount);
+	particle_sort_keys.resize(p_amount);
 }
 
 void CPUParticles3D::set_lifetime(double p_lifetime) {
@@ -720,9 +722,6 @@ void CPUParticles3D::_particles_process(double p_delta) {
 	p_delta *= speed_scale;
 
 	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
 
 	double prev_time = time;
 	time += p_delta;
@@ -735,24 +734,54 @@ void CPUParticles3D::_particles_process(double p_delta) {
 		}
 	}
 
-	Transform3D emission_xform;
-	Basis velocity_xform;
+	ProcessStep step;
+	step.particles = particles.ptrw();
+	step.delta = p_delta;
+	step.prev_time = prev_time;
 	if (!local_coords) {
-		emission_xform = get_global_transform_interpolated();
-		velocity_xform = emission_xform.basis;
+		step.emission_xform = get_global_transform_interpolated();
+		step.velocity_xform = step.emission_xform.basis;
+	}
+	step.system_phase = time / lifetime;
+
+	// Gradients sort their points when first sampled, do it before sampling them from several threads.
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0);
+	}
+	if (color_initial_ramp.is_valid()) {
+		color_initial_ramp->get_color_at_offset(0.0);
+	}
+
+	// Particles are independent from each other, process them in chunks on the WorkerThreadPool.
+	int chunk_count = (pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles3D::_particles_process_chunk, &step, chunk_count, -1, true, SNAME("CPUParticles3DProcess"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (chunk_count == 1) {
+		_particles_process_chunk(0, &step);
 	}
 
-	double system_phase = time / lifetime;
+	if (!Math::is_equal_approx(time, 0.0) && active && !step.should_be_active.is_set()) {
+		active = false;
+		emit_signal(SceneStringName(finished));
+	}
+}
 
-	bool should_be_active = false;
-	for (int i = 0; i < pcount; i++) {
+void CPUParticles3D::_particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step) {
+	int pcount = particles.size();
+	Particle *parray = p_step->particles;
+	RandomPCG rng;
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pcount);
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		double local_delta = p_delta;
+		double local_delta = p_step->delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -761,7 +790,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 
 		if (randomness_ratio > 0.0) {
 			uint32_t _seed = cycle;
-			if (restart_phase >= system_phase) {
+			if (restart_phase >= p_step->system_phase) {
 				_seed -= uint32_t(1);
 			}
 			_seed *= uint32_t(pcount);
@@ -774,10 +803,10 @@ void CPUParticles3D::_particles_process(double p_delta) {
 		double restart_time = restart_phase * lifetime;
 		bool restart = false;
 
-		if (time > prev_time) {
+		if (time > p_step->prev_time) {
 			// restart_time >= prev_time is used so particles emit in the first frame they are processed
 
-			if (restart_time >= prev_time && restart_time < time) {
+			if (restart_time >= p_step->prev_time && restart_time < time) {
 				restart = true;
 				if (fractional_delta) {
 					local_delta = time - restart_time;
@@ -785,7 +814,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 			}
 
 		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
+			if (restart_time >= p_step->prev_time) {
 				restart = true;
 				if (fractional_delta) {
 					local_delta = lifetime - restart_time + time;
@@ -828,26 +857,26 @@ void CPUParticles3D::_particles_process(double p_delta) {
 			}
 
 			p.seed = seed + uint32_t(1) + i + cycle;
-			rng->set_seed(p.seed);
-			p.angle_rand = rng->randf();
-			p.scale_rand = rng->randf();
-			p.hue_rot_rand = rng->randf();
-			p.anim_offset_rand = rng->randf();
+			rng.seed(p.seed);
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
 			if (color_initial_ramp.is_valid()) {
-				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng->randf());
+				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng.randf());
 			} else {
 				p.start_color_rand = Color(1, 1, 1, 1);
 			}
 
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg_to_rad((rng->randf() * 2.0 - 1.0) * spread);
+				real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg_to_rad((rng.randf() * 2.0 - 1.0) * spread);
 				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+				p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 			} else {
 				//initiate velocity spread in 3D
-				real_t angle1_rad = Math::deg_to_rad((rng->randf() * (real_t)2.0 - (real_t)1.0) * spread);
-				real_t angle2_rad = Math::deg_to_rad((rng->randf() * (real_t)2.0 - (real_t)1.0) * ((real_t)1.0 - flatness) * spread);
+				real_t angle1_rad = Math::deg_to_rad((rng.randf() * (real_t)2.0 - (real_t)1.0) * spread);
+				real_t angle2_rad = Math::deg_to_rad((rng.randf() * (real_t)2.0 - (real_t)1.0) * ((real_t)1.0 - flatness) * spread);
 
 				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
 				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
@@ -867,14 +896,14 @@ void CPUParticles3D::_particles_process(double p_delta) {
 				binormal.normalize();
 				Vector3 normal = binormal.cross(direction_nrm);
 				spread_direction = binormal * spread_direction.x + normal * spread_direction.y + direction_nrm * spread_direction.z;
-				p.velocity = spread_direction * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+				p.velocity = spread_direction * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 			}
 
 			real_t base_angle = tex_angle * Math::lerp(parameters_min[PARAM_ANGLE], parameters_max[PARAM_ANGLE], p.angle_rand);
 			p.custom[0] = Math::deg_to_rad(base_angle); //angle
 			p.custom[1] = 0.0; //phase
 			p.custom[2] = tex_anim_offset * Math::lerp(parameters_min[PARAM_ANIM_OFFSET], parameters_max[PARAM_ANIM_OFFSET], p.anim_offset_rand); //animation offset (0-1)
-			p.custom[3] = (1.0 - rng->randf() * lifetime_randomness);
+			p.custom[3] = (1.0 - rng.randf() * lifetime_randomness);
 			p.transform = Transform3D();
 			p.time = 0;
 			p.lifetime = lifetime * p.custom[3];
@@ -885,20 +914,20 @@ void CPUParticles3D::_particles_process(double p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t s = 2.0 * rng->randf() - 1.0;
-					real_t t = Math::TAU * rng->randf();
-					real_t x = rng->randf();
+					real_t s = 2.0 * rng.randf() - 1.0;
+					real_t t = Math::TAU * rng.randf();
+					real_t x = rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform.origin = Vector3(0, 0, 0).lerp(Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s), x);
 				} break;
 				case EMISSION_SHAPE_SPHERE_SURFACE: {
-					real_t s = 2.0 * rng->randf() - 1.0;
-					real_t t = Math::TAU * rng->randf();
+					real_t s = 2.0 * rng.randf() - 1.0;
+					real_t t = Math::TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform.origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
 				} break;
 				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0) * emission_box_extents;
+					p.transform.origin = Vector3(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_box_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -907,7 +936,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
 					p.transform.origin = emission_points.get(random_idx);
 
@@ -942,11 +971,11 @@ void CPUParticles3D::_particles_process(double p_delta) {
 				case EMISSION_SHAPE_RING: {
 					real_t radius_clamped = MAX(0.001, emission_ring_radius);
 					real_t top_radius = MAX(radius_clamped - Math::tan(Math::deg_to_rad(90.0 - emission_ring_cone_angle)) * emission_ring_height, 0.0);
-					real_t y_pos = rng->randf();
+					real_t y_pos = rng.randf();
 					real_t skew = MAX(MIN(radius_clamped, top_radius) / MAX(radius_clamped, top_radius), 0.5);
 					y_pos = radius_clamped < top_radius ? Math::pow(y_pos, skew) : 1.0 - Math::pow(y_pos, skew);
-					real_t ring_random_angle = rng->randf() * Math::TAU;
-					real_t ring_random_radius = Math::sqrt(rng->randf() * (radius_clamped * radius_clamped - emission_ring_inner_radius * emission_ring_inner_radius) + emission_ring_inner_radius * emission_ring_inner_radius);
+					real_t ring_random_angle = rng.randf() * Math::TAU;
+					real_t ring_random_radius = Math::sqrt(rng.randf() * (radius_clamped * radius_clamped - emission_ring_inner_radius * emission_ring_inner_radius) + emission_ring_inner_radius * emission_ring_inner_radius);
 					ring_random_radius = Math::lerp(ring_random_radius, ring_random_radius * (top_radius / radius_clamped), y_pos);
 					Vector3 axis = emission_ring_axis == Vector3(0.0, 0.0, 0.0) ? Vector3(0.0, 0.0, 1.0) : emission_ring_axis.normalized();
 					Vector3 ortho_axis;
@@ -966,8 +995,8 @@ void CPUParticles3D::_particles_process(double p_delta) {
 			}
 
 			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
+				p.velocity = p_step->velocity_xform.xform(p.velocity);
+				p.transform = p_step->emission_xform * p.transform;
 			}
 
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
@@ -1046,7 +1075,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 			//apply linear acceleration
 			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * tex_linear_accel * Math::lerp(parameters_min[PARAM_LINEAR_ACCEL], parameters_max[PARAM_LINEAR_ACCEL], rand_from_seed(alt_seed)) : Vector3();
 			//apply radial acceleration
-			Vector3 org = emission_xform.origin;
+			Vector3 org = p_step->emission_xform.origin;
 			Vector3 diff = position - org;
 			force += diff.length() > 0.0 ? diff.normalized() * (tex_radial_accel)*Math::lerp(parameters_min[PARAM_RADIAL_ACCEL], parameters_max[PARAM_RADIAL_ACCEL], rand_from_seed(alt_seed)) : Vector3();
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
@@ -1219,11 +1248,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 
 		p.transform.origin += p.velocity * local_delta;
 
-		should_be_active = true;
-	}
-	if (!Math::is_equal_approx(time, 0.0) && active && !should_be_active) {
-		active = false;
-		emit_signal(SceneStringName(finished));
+		p_step->should_be_active.set();
 	}
 }
 
@@ -1232,24 +1257,21 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 	int pc = particles.size();
 
-	int *ow;
-	int *order = nullptr;
+	const uint32_t *order = nullptr;
 
-	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
-		ow = particle_order.ptrw();
-		order = ow;
+		uint32_t *keys = particle_sort_keys.ptr();
+		uint32_t *ow = particle_order.ptr();
+		bool sort = false;
 
-		for (int i = 0; i < pc; i++) {
-			order[i] = i;
-		}
 		if (draw_order == DRAW_ORDER_LIFETIME) {
-			SortArray<int, SortLifetime> sorter;
-			sorter.compare.particles = r;
-			sorter.sort(order, pc);
+			// Oldest first.
+			for (int i = 0; i < pc; i++) {
+				keys[i] = ~RadixSort::float_to_key(r[i].time);
+			}
+			sort = true;
 		} else if (draw_order == DRAW_ORDER_VIEW_DEPTH) {
 			ERR_FAIL_NULL(get_viewport());
 			Camera3D *c = get_viewport()->get_camera_3d();
@@ -1264,16 +1286,45 @@ void CPUParticles3D::_update_particle_data_buffer() {
 					dir = dir.normalized();
 				}
 
-				SortArray<int, SortAxis> sorter;
-				sorter.compare.particles = r;
-				sorter.compare.axis = dir;
-				sorter.sort(order, pc);
+				for (int i = 0; i < pc; i++) {
+					keys[i] = RadixSort::float_to_key(dir.dot(r[i].transform.origin));
+				}
+				sort = true;
 			}
 		}
+
+		for (int i = 0; i < pc; i++) {
+			ow[i] = i;
+		}
+		if (sort) {
+			particle_sort.sort(keys, ow, pc);
+		}
+		order = ow;
+	}
+
+	// Each chunk writes its own part of the instance buffer.
+	particle_data_ptr = particle_data.ptrw();
+	int chunk_count = (pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles3D::_update_particle_data_chunk, order, chunk_count, -1, true, SNAME("CPUParticles3DUpdateData"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (chunk_count == 1) {
+		_update_particle_data_chunk(0, order);
 	}
+	particle_data_ptr = nullptr;
 
-	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
+	can_update.set();
+}
+
+void CPUParticles3D::_update_particle_data_chunk(uint32_t p_chunk, const uint32_t *p_order) {
+	int pc = particles.size();
+	const Particle *r = particles.ptr();
+
+	int from = p_chunk * PROCESS_CHUNK_SIZE;
+	int to = MIN(from + PROCESS_CHUNK_SIZE, pc);
+	float *ptr = particle_data_ptr + from * 20;
+	for (int i = from; i < to; i++) {
+		int idx = p_order ? p_order[i] : i;
 
 		Transform3D t = r[idx].transform;
 
@@ -1312,8 +1363,6 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 		ptr += 20;
 	}
-
-	can_update.set();
 }
 
 void CPUParticles3D::_set_redraw(bool p_redraw) {
@@ -1776,8 +1825,6 @@ CPUParticles3D::CPUParticles3D() {
 	set_amount(8);
 	set_seed(Math::rand());
 
-	rng.instantiate();
-
 	set_param_min(PARAM_INITIAL_LINEAR_VELOCITY, 0);
 	set_param_min(PARAM_ANGULAR_VELOCITY, 0);
 	set_param_min(PARAM_ORBIT_VELOCITY, 0);
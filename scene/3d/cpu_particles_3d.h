@@ -30,10 +30,9 @@
 
 #pragma once
 
+#include "core/templates/radix_sort.h"
 #include "scene/3d/visual_instance_3d.h"
 
-class RandomNumberGenerator;
-
 class CPUParticles3D : public GeometryInstance3D {
 private:
 	GDCLASS(CPUParticles3D, GeometryInstance3D);
@@ -111,22 +110,24 @@ private:
 
 	Vector<Particle> particles;
 	Vector<float> particle_data;
-	Vector<int> particle_order;
-
-	struct SortLifetime {
-		const Particle *particles = nullptr;
-
-		bool operator()(int p_a, int p_b) const {
-			return particles[p_a].time > particles[p_b].time;
-		}
+	LocalVector<uint32_t> particle_order;
+	LocalVector<uint32_t> particle_sort_keys;
+	RadixSort particle_sort;
+	float *particle_data_ptr = nullptr; // Valid while the instance buffer is written.
+
+	// Particles are processed and written to the instance buffer in chunks, in parallel when there are several.
+	enum {
+		PROCESS_CHUNK_SIZE = 256,
 	};
 
-	struct SortAxis {
-		const Particle *particles = nullptr;
-		Vector3 axis;
-		bool operator()(int p_a, int p_b) const {
-			return axis.dot(particles[p_a].transform.origin) < axis.dot(particles[p_b].transform.origin);
-		}
+	struct ProcessStep {
+		Particle *particles = nullptr;
+		double delta = 0.0;
+		double prev_time = 0.0;
+		double system_phase = 0.0;
+		Transform3D emission_xform;
+		Basis velocity_xform;
+		SafeFlag should_be_active;
 	};
 
 	//
@@ -191,11 +192,11 @@ private:
 
 	Vector3 gravity = Vector3(0, -9.8, 0);
 
-	Ref<RandomNumberGenerator> rng;
-
 	void _update_internal();
 	void _particles_process(double p_delta);
+	void _particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step);
 	void _update_particle_data_buffer();
+	void _update_particle_data_chunk(uint32_t p_chunk, const uint32_t *p_order);
 	void _set_emitting();
 
 	Mutex update_mutex;
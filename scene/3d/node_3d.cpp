@@ -83,6 +83,14 @@ void Node3D::_notify_dirty() {
 	}
 }
 
+void Node3D::_transform_notification_subscribed() {
+	// Propagation stops at branches that are already dirty, on the assumption that every node listening in them is queued.
+	// A node that starts listening while dirty isn't, so resolve it (and its dirty parents) now.
+	if (is_inside_tree() && _test_dirty_bits(DIRTY_GLOBAL_TRANSFORM)) {
+		_ALLOW_DISCARD_ get_global_transform();
+	}
+}
+
 void Node3D::_update_local_transform() const {
 	// This function is called when the local transform (data.local_transform) is dirty and the right value is contained in the Euler rotation and scale.
 	data.local_transform.basis.set_euler_scale(data.euler_rotation, data.scale, data.euler_rotation_order);
@@ -108,6 +116,14 @@ void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 		return;
 	}
 
+	// A dirty global transform means this whole branch was already marked and every node listening in it queued
+	// for NOTIFICATION_TRANSFORM_CHANGED (SceneTree resolves the queued nodes before notifying them), so there is
+	// nothing left to do. Physics interpolation relies on its own dirty flag being set on every node, so it still
+	// gets the full walk.
+	if (_test_dirty_bits(DIRTY_GLOBAL_TRANSFORM) && !get_tree()->is_physics_interpolation_enabled()) {
+		return;
+	}
+
 	for (Node3D *&E : data.children) {
 		if (E->data.top_level) {
 			continue; //don't propagate to a top_level
@@ -253,6 +269,12 @@ void Node3D::_notification(int p_what) {
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			ERR_THREAD_GUARD;
 
+			// The node is no longer queued, so it must not stay dirty (see _propagate_transform_changed()).
+			// This is usually a no-op, as SceneTree resolves the queued transforms in a batch beforehand.
+			if (is_inside_tree() && _test_dirty_bits(DIRTY_GLOBAL_TRANSFORM)) {
+				_ALLOW_DISCARD_ get_global_transform();
+			}
+
 #ifdef TOOLS_ENABLED
 			for (int i = 0; i < data.gizmos.size(); i++) {
 				data.gizmos.write[i]->transform();
@@ -804,6 +826,7 @@ void Node3D::add_gizmo(Ref<Node3DGizmo> p_gizmo) {
 		return;
 	}
 	data.gizmos.push_back(p_gizmo);
+	_transform_notification_subscribed();
 
 	if (p_gizmo.is_valid() && is_inside_world()) {
 		p_gizmo->create();
@@ -1159,6 +1182,16 @@ Vector3 Node3D::to_global(Vector3 p_local) const {
 void Node3D::set_notify_transform(bool p_enabled) {
 	ERR_THREAD_GUARD;
 	data.notify_transform = p_enabled;
+	if (p_enabled) {
+		_transform_notification_subscribed();
+	}
+}
+
+void Node3D::set_ignore_transform_notification(bool p_ignore) {
+	data.ignore_notification = p_ignore;
+	if (!p_ignore) {
+		_transform_notification_subscribed();
+	}
 }
 
 bool Node3D::is_transform_notification_enabled() const {
@@ -1454,6 +1487,8 @@ Node3D::Node3D() :
 	data.fti_is_identity_xform = false;
 	data.fti_processed = false;
 
+	data.transform_resolve_queued = false;
+
 #ifdef TOOLS_ENABLED
 	data.gizmos_disabled = false;
 	data.gizmos_dirty = false;
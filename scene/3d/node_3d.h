@@ -50,6 +50,7 @@ public:
 class Node3D : public Node {
 	GDCLASS(Node3D, Node);
 
+	friend class SceneTree;
 	friend class SceneTreeFTI;
 	friend class SceneTreeFTITests;
 
@@ -147,6 +148,10 @@ private:
 		bool fti_is_identity_xform : 1;
 		bool fti_processed : 1;
 
+		// Batched global transform resolve, see SceneTree::_resolve_node_3d_transforms().
+		bool transform_resolve_queued : 1;
+		uint32_t transform_resolve_depth = 0;
+
 		RID visibility_parent;
 
 		Node3D *parent = nullptr;
@@ -174,6 +179,7 @@ private:
 
 	void _update_gizmos();
 	void _notify_dirty();
+	void _transform_notification_subscribed();
 	void _propagate_transform_changed(Node3D *p_origin);
 
 	void _propagate_visibility_changed();
@@ -183,7 +189,7 @@ private:
 	void _propagate_transform_changed_deferred();
 
 protected:
-	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) { data.ignore_notification = p_ignore; }
+	void set_ignore_transform_notification(bool p_ignore);
 
 	_FORCE_INLINE_ void _update_local_transform() const;
 	_FORCE_INLINE_ void _update_rotation_and_scale() const;
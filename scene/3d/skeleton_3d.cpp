@@ -31,6 +31,7 @@
 #include "skeleton_3d.h"
 #include "skeleton_3d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "scene/3d/skeleton_modifier_3d.h"
 #if !defined(DISABLE_DEPRECATED) && !defined(PHYSICS_3D_DISABLED)
 #include "scene/3d/physics/physical_bone_simulator_3d.h"
@@ -66,6 +67,9 @@ SkinReference::~SkinReference() {
 
 ///////////////////////////////////////
 
+LocalVector<ObjectID> Skeleton3D::update_queue;
+bool Skeleton3D::update_flush_queued = false;
+
 bool Skeleton3D::_set(const StringName &p_path, const Variant &p_value) {
 #if !defined(DISABLE_DEPRECATED) && !defined(PHYSICS_3D_DISABLED)
 	if (p_path == SNAME("animate_physical_bones")) {
@@ -334,118 +338,223 @@ void Skeleton3D::_notification(int p_what) {
 		} break;
 #endif // TOOLS_ENABLED
 		case NOTIFICATION_UPDATE_SKELETON: {
-			// Update bone transforms to apply unprocessed poses.
-			force_update_all_dirty_bones();
+			if (_update_skeleton_begin()) {
+				_update_skeleton_compute();
+				_update_skeleton_end();
+			}
+		} break;
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			_lod_advance(get_process_delta_time());
+		} break;
+		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
+			_lod_advance(get_physics_process_delta_time());
+		} break;
+	}
+}
 
-			updating = true;
+bool Skeleton3D::_update_skeleton_begin() {
+	_update_process_order();
 
-			Bone *bonesptr = bones.ptr();
-			int len = bones.size();
+	// Process modifiers.
+	_find_modifiers();
+	if (!modifiers.is_empty()) {
+		// Modifiers read global poses, they must be up to date before processing.
+		force_update_all_dirty_bones();
+	}
 
-			thread_local LocalVector<bool> bone_global_pose_dirty_backup;
+	updating = true;
 
-			// Process modifiers.
+	Bone *bonesptr = bones.ptr();
+	int len = bones.size();
 
-			thread_local LocalVector<BonePoseBackup> bones_backup;
-			_find_modifiers();
-			if (!modifiers.is_empty()) {
-				bones_backup.resize(bones.size());
-				// Store unmodified bone poses.
-				for (uint32_t i = 0; i < bones.size(); i++) {
-					bones_backup[i].save(bonesptr[i]);
-				}
-				// Store dirty flags for global bone poses.
-				bone_global_pose_dirty_backup = bone_global_pose_dirty;
+	if (!modifiers.is_empty()) {
+		bones_backup.resize(bones.size());
+		// Store unmodified bone poses.
+		for (uint32_t i = 0; i < bones.size(); i++) {
+			bones_backup[i].save(bonesptr[i]);
+		}
+		bone_global_poses_backup = bone_global_poses;
+		// Store dirty flags for global bone poses.
+		bone_global_pose_dirty_backup = bone_global_pose_dirty;
 
-				if (update_flags & UPDATE_FLAG_MODIFIER) {
-					_process_modifiers();
+		if (update_flags & UPDATE_FLAG_MODIFIER) {
+			_process_modifiers();
+		}
+	}
+
+	// Abort if pose is not changed.
+	if (!(update_flags & UPDATE_FLAG_POSE)) {
+		updating = false;
+		update_flags = UPDATE_FLAG_NONE;
+		// Apply unprocessed poses, as the update would have.
+		force_update_all_dirty_bones();
+		return false;
+	}
+
+	// Resolve skin binds, global poses and skin transforms are computed by _update_skeleton_compute().
+	for (SkinReference *E : skin_bindings) {
+		const Skin *skin = E->skin.operator->();
+		RID skeleton = E->skeleton;
+		uint32_t bind_count = skin->get_bind_count();
+
+		if (E->bind_count != bind_count) {
+			RS::get_singleton()->skeleton_allocate_data(skeleton, bind_count);
+			E->bind_count = bind_count;
+			E->skin_bone_indices.resize(bind_count);
+			E->skin_bone_indices_ptrs = E->skin_bone_indices.ptrw();
+		}
+		E->skin_transforms.resize(bind_count);
+
+		if (E->skeleton_version != version) {
+			for (uint32_t i = 0; i < bind_count; i++) {
+				StringName bind_name = skin->get_bind_name(i);
+
+				if (bind_name != StringName()) {
+					// Bind name used, use this.
+					bool found = false;
+					for (int j = 0; j < len; j++) {
+						if (bonesptr[j].name == bind_name) {
+							E->skin_bone_indices_ptrs[i] = j;
+							found = true;
+							break;
+						}
+					}
+
+					if (!found) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
+						E->skin_bone_indices_ptrs[i] = 0;
+					}
+				} else if (skin->get_bind_bone(i) >= 0) {
+					int bind_index = skin->get_bind_bone(i);
+					if (bind_index >= len) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
+						E->skin_bone_indices_ptrs[i] = 0;
+					} else {
+						E->skin_bone_indices_ptrs[i] = bind_index;
+					}
+				} else {
+					ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
+					E->skin_bone_indices_ptrs[i] = 0;
 				}
 			}
 
-			// Abort if pose is not changed.
-			if (!(update_flags & UPDATE_FLAG_POSE)) {
-				updating = false;
-				update_flags = UPDATE_FLAG_NONE;
-				return;
-			}
+			E->skeleton_version = version;
+		}
+	}
 
-			emit_signal(SceneStringName(skeleton_updated));
+	return true;
+}
 
-			// Update skins.
-			RenderingServer *rs = RenderingServer::get_singleton();
-			for (SkinReference *E : skin_bindings) {
-				const Skin *skin = E->skin.operator->();
-				RID skeleton = E->skeleton;
-				uint32_t bind_count = skin->get_bind_count();
+void Skeleton3D::_update_skeleton_compute() {
+	// Only touches this skeleton and its skins, so it's safe to run for many skeletons at once.
+	_update_dirty_bone_global_poses();
 
-				if (E->bind_count != bind_count) {
-					RS::get_singleton()->skeleton_allocate_data(skeleton, bind_count);
-					E->bind_count = bind_count;
-					E->skin_bone_indices.resize(bind_count);
-					E->skin_bone_indices_ptrs = E->skin_bone_indices.ptrw();
-				}
+	const Bone *bonesptr = bones.ptr();
+	const Transform3D *global_poses = bone_global_poses.ptr();
+	uint32_t len = bones.size();
+	for (SkinReference *E : skin_bindings) {
+		const Skin *skin = E->skin.operator->();
+		Transform3D *skin_transforms = E->skin_transforms.ptr();
+		for (uint32_t i = 0; i < E->bind_count; i++) {
+			uint32_t bone_index = E->skin_bone_indices_ptrs[i];
+			ERR_CONTINUE(bone_index >= len);
+			skin_transforms[i] = global_poses[bonesptr[bone_index].nested_set_offset] * skin->get_bind_pose(i);
+		}
+	}
+}
 
-				if (E->skeleton_version != version) {
-					for (uint32_t i = 0; i < bind_count; i++) {
-						StringName bind_name = skin->get_bind_name(i);
-
-						if (bind_name != StringName()) {
-							// Bind name used, use this.
-							bool found = false;
-							for (int j = 0; j < len; j++) {
-								if (bonesptr[j].name == bind_name) {
-									E->skin_bone_indices_ptrs[i] = j;
-									found = true;
-									break;
-								}
-							}
-
-							if (!found) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
-								E->skin_bone_indices_ptrs[i] = 0;
-							}
-						} else if (skin->get_bind_bone(i) >= 0) {
-							int bind_index = skin->get_bind_bone(i);
-							if (bind_index >= len) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
-								E->skin_bone_indices_ptrs[i] = 0;
-							} else {
-								E->skin_bone_indices_ptrs[i] = bind_index;
-							}
-						} else {
-							ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
-							E->skin_bone_indices_ptrs[i] = 0;
-						}
-					}
+void Skeleton3D::_update_skeleton_end() {
+	if (dirty) {
+		// Unprocessed poses were applied by _update_skeleton_compute(), notify as force_update_all_dirty_bones() does.
+		updating = false;
+		_bone_transforms_updated();
+		updating = true;
+	}
 
-					E->skeleton_version = version;
-				}
+	emit_signal(SceneStringName(skeleton_updated));
 
-				for (uint32_t i = 0; i < bind_count; i++) {
-					uint32_t bone_index = E->skin_bone_indices_ptrs[i];
-					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].global_pose * skin->get_bind_pose(i));
-				}
-			}
+	// Update skins.
+	RenderingServer *rs = RenderingServer::get_singleton();
+	for (SkinReference *E : skin_bindings) {
+		RID skeleton = E->skeleton;
+		const Transform3D *skin_transforms = E->skin_transforms.ptr();
+		for (uint32_t i = 0; i < E->skin_transforms.size(); i++) {
+			rs->skeleton_bone_set_transform(skeleton, i, skin_transforms[i]);
+		}
+	}
 
-			if (!modifiers.is_empty()) {
-				// Restore unmodified bone poses.
-				for (uint32_t i = 0; i < bones.size(); i++) {
-					bones_backup[i].restore(bones[i]);
-				}
-				// Restore dirty flags for global bone poses.
-				bone_global_pose_dirty = bone_global_pose_dirty_backup;
-			}
+	if (!modifiers.is_empty()) {
+		// Restore unmodified bone poses.
+		for (uint32_t i = 0; i < bones.size(); i++) {
+			bones_backup[i].restore(bones[i]);
+		}
+		bone_global_poses = bone_global_poses_backup;
+		// Restore dirty flags for global bone poses.
+		bone_global_pose_dirty = bone_global_pose_dirty_backup;
+	}
 
-			updating = false;
-			update_flags = UPDATE_FLAG_NONE;
-		} break;
-		case NOTIFICATION_INTERNAL_PROCESS: {
-			advance(get_process_delta_time());
-		} break;
-		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			advance(get_physics_process_delta_time());
-		} break;
+	updating = false;
+	update_flags = UPDATE_FLAG_NONE;
+}
+
+void Skeleton3D::_queue_update() {
+	// Thread groups update their skeletons on their own thread.
+	if (!Thread::is_main_thread() || !is_accessible_from_caller_thread()) {
+		notify_deferred_thread_group(NOTIFICATION_UPDATE_SKELETON);
+		return;
+	}
+	update_queue.push_back(get_instance_id());
+	if (!update_flush_queued) {
+		update_flush_queued = true;
+		// Flushed right after all nodes have been processed.
+		callable_mp_static(&Skeleton3D::_flush_update_queue).call_deferred();
+	}
+}
+
+void Skeleton3D::_update_skeleton_task(void *p_userdata, uint32_t p_index) {
+	Skeleton3D *skeleton = static_cast<Skeleton3D **>(p_userdata)[p_index];
+	skeleton->_update_skeleton_compute();
+}
+
+void Skeleton3D::_flush_update_queue() {
+	update_flush_queued = false;
+
+	LocalVector<ObjectID> queue = update_queue;
+	update_queue.clear();
+
+	// Modifiers may call into scripts, so they run for every skeleton first.
+	LocalVector<ObjectID> skeleton_ids;
+	for (const ObjectID &id : queue) {
+		Skeleton3D *skeleton = ObjectDB::get_instance<Skeleton3D>(id);
+		if (skeleton && skeleton->_update_skeleton_begin()) {
+			skeleton_ids.push_back(id);
+		}
+	}
+
+	// Those scripts may have freed skeletons that were already begun, so look them up once nothing else can run.
+	LocalVector<Skeleton3D *> skeletons;
+	LocalVector<ObjectID> computed_ids;
+	for (const ObjectID &id : skeleton_ids) {
+		Skeleton3D *skeleton = ObjectDB::get_instance<Skeleton3D>(id);
+		if (skeleton) {
+			skeletons.push_back(skeleton);
+			computed_ids.push_back(id);
+		}
+	}
+
+	if (skeletons.size() == 1) {
+		_update_skeleton_task(skeletons.ptr(), 0);
+	} else if (skeletons.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&Skeleton3D::_update_skeleton_task, skeletons.ptr(), skeletons.size(), -1, true, SNAME("Skeleton3DUpdate"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	// The skeleton_updated signal may free any skeleton, so check them again before uploading.
+	for (const ObjectID &id : computed_ids) {
+		Skeleton3D *skeleton = ObjectDB::get_instance<Skeleton3D>(id);
+		if (skeleton) {
+			skeleton->_update_skeleton_end();
+		}
 	}
 }
 
@@ -457,6 +566,37 @@ void Skeleton3D::advance(double p_delta) {
 	}
 }
 
+void Skeleton3D::_lod_advance(double p_delta) {
+	if (lod_policy.is_null()) {
+		advance(p_delta);
+		return;
+	}
+	double delta = 0.0;
+	lod_hold = !lod_state.advance(lod_policy, this, p_delta, delta);
+	if (lod_hold) {
+		return;
+	}
+	if (lod_update_held) {
+		lod_update_held = false;
+		_queue_update();
+	}
+	advance(delta);
+}
+
+void Skeleton3D::set_lod_policy(const Ref<AnimationLODPolicy> &p_policy) {
+	lod_policy = p_policy;
+	lod_state = AnimationLODState();
+	lod_hold = false;
+	if (lod_update_held) {
+		lod_update_held = false;
+		_queue_update();
+	}
+}
+
+Ref<AnimationLODPolicy> Skeleton3D::get_lod_policy() const {
+	return lod_policy;
+}
+
 void Skeleton3D::set_modifier_callback_mode_process(Skeleton3D::ModifierCallbackModeProcess p_mode) {
 	if (modifier_callback_mode_process == p_mode) {
 		return;
@@ -489,6 +629,8 @@ void Skeleton3D::_make_modifiers_dirty() {
 
 void Skeleton3D::_update_bones_nested_set() const {
 	nested_set_offset_to_bone_index.resize(bones.size());
+	nested_set_parent_offsets.resize(bones.size());
+	bone_global_poses.resize(bones.size());
 	bone_global_pose_dirty.resize(bones.size());
 	_make_bone_global_poses_dirty();
 
@@ -496,6 +638,11 @@ void Skeleton3D::_update_bones_nested_set() const {
 	for (int bone : parentless_bones) {
 		offset += _update_bone_nested_set(bone, offset);
 	}
+
+	for (uint32_t i = 0; i < bones.size(); i++) {
+		const Bone &bone = bones[nested_set_offset_to_bone_index[i]];
+		nested_set_parent_offsets[i] = bone.parent >= 0 ? bones[bone.parent].nested_set_offset : -1;
+	}
 }
 
 int Skeleton3D::_update_bone_nested_set(int p_bone, int p_offset) const {
@@ -562,7 +709,7 @@ void Skeleton3D::_update_bone_global_pose(int p_bone) const {
 		int offset = bones[bone].nested_set_offset;
 		// Stop searching when global pose is not dirty.
 		if (!bone_global_pose_dirty[offset]) {
-			global_pose = bones[bone].global_pose;
+			global_pose = bone_global_poses[offset];
 			break;
 		}
 
@@ -583,7 +730,7 @@ void Skeleton3D::_update_bone_global_pose(int p_bone) const {
 		}
 #endif // _DISABLE_DEPRECATED
 
-		bone.global_pose = global_pose;
+		bone_global_poses[bone.nested_set_offset] = global_pose;
 		bone_global_pose_dirty[bone.nested_set_offset] = false;
 	}
 }
@@ -592,7 +739,7 @@ Transform3D Skeleton3D::get_bone_global_pose(int p_bone) const {
 	const int bone_size = bones.size();
 	ERR_FAIL_INDEX_V(p_bone, bone_size, Transform3D());
 	_update_bone_global_pose(p_bone);
-	return bones[p_bone].global_pose;
+	return bone_global_poses[bones[p_bone].nested_set_offset];
 }
 
 void Skeleton3D::set_bone_global_pose(int p_bone, const Transform3D &p_pose) {
@@ -969,7 +1116,11 @@ void Skeleton3D::_update_deferred(UpdateFlag p_update_flag) {
 		}
 #endif //TOOLS_ENABLED
 		if (update_flags == UPDATE_FLAG_NONE && !updating) {
-			notify_deferred_thread_group(NOTIFICATION_UPDATE_SKELETON); // It must never be called more than once in a single frame.
+			if (lod_hold) {
+				lod_update_held = true; // Sent by _lod_advance() once the policy lets the skeleton update.
+			} else {
+				_queue_update(); // It must never be called more than once in a single frame.
+			}
 		}
 		update_flags |= p_update_flag;
 	}
@@ -1086,9 +1237,11 @@ void Skeleton3D::force_update_all_bone_transforms() {
 
 void Skeleton3D::_force_update_all_bone_transforms() const {
 	_update_process_order();
-	for (int i = 0; i < parentless_bones.size(); i++) {
-		_force_update_bone_children_transforms(parentless_bones[i]);
-	}
+	_update_dirty_bone_global_poses();
+	_bone_transforms_updated();
+}
+
+void Skeleton3D::_bone_transforms_updated() const {
 	if (rest_dirty) {
 		rest_dirty = false;
 		const_cast<Skeleton3D *>(this)->emit_signal(SNAME("rest_updated"));
@@ -1111,66 +1264,57 @@ void Skeleton3D::_force_update_bone_children_transforms(int p_bone_idx) const {
 	ERR_FAIL_INDEX(p_bone_idx, bone_size);
 
 	_update_process_order();
+	_update_dirty_bone_global_poses();
+}
 
+void Skeleton3D::_update_dirty_bone_global_poses() const {
+	const int bone_size = bones.size();
 	Bone *bonesptr = bones.ptr();
+	const int *bone_indices = nested_set_offset_to_bone_index.ptr();
+	const int *parent_offsets = nested_set_parent_offsets.ptr();
+	Transform3D *global_poses = bone_global_poses.ptr();
+	bool *global_pose_dirty = bone_global_pose_dirty.ptr();
 
-	// Loop through nested set.
+	// Loop through nested set, parents are always updated before their children.
 	for (int offset = 0; offset < bone_size; offset++) {
 		if (rest_dirty) {
-			int current_bone_idx = nested_set_offset_to_bone_index[offset];
-			Bone &b = bonesptr[current_bone_idx];
+			Bone &b = bonesptr[bone_indices[offset]];
 			b.global_rest = b.parent >= 0 ? bonesptr[b.parent].global_rest * b.rest : b.rest; // Rest needs update apert from pose.
 		}
 
-		if (!bone_global_pose_dirty[offset]) {
+		if (!global_pose_dirty[offset]) {
 			continue;
 		}
 
-		int current_bone_idx = nested_set_offset_to_bone_index[offset];
-		Bone &b = bonesptr[current_bone_idx];
+		Bone &b = bonesptr[bone_indices[offset]];
 		bool bone_enabled = b.enabled && !show_rest_only;
-
 		if (bone_enabled) {
 			b.update_pose_cache();
-			Transform3D pose = b.pose_cache;
+		}
+		const Transform3D &pose = bone_enabled ? b.pose_cache : b.rest;
 
-			if (b.parent >= 0) {
-				b.global_pose = bonesptr[b.parent].global_pose * pose;
-			} else {
-				b.global_pose = pose;
-			}
+		int parent_offset = parent_offsets[offset];
+		if (parent_offset >= 0) {
+			global_poses[offset] = global_poses[parent_offset] * pose;
 		} else {
-			if (b.parent >= 0) {
-				b.global_pose = bonesptr[b.parent].global_pose * b.rest;
-			} else {
-				b.global_pose = b.rest;
-			}
+			global_poses[offset] = pose;
 		}
 
 #ifndef DISABLE_DEPRECATED
-		if (bone_enabled) {
-			Transform3D pose = b.pose_cache;
-			if (b.parent >= 0) {
-				b.pose_global_no_override = bonesptr[b.parent].pose_global_no_override * pose;
-			} else {
-				b.pose_global_no_override = pose;
-			}
+		if (b.parent >= 0) {
+			b.pose_global_no_override = bonesptr[b.parent].pose_global_no_override * pose;
 		} else {
-			if (b.parent >= 0) {
-				b.pose_global_no_override = bonesptr[b.parent].pose_global_no_override * b.rest;
-			} else {
-				b.pose_global_no_override = b.rest;
-			}
+			b.pose_global_no_override = pose;
 		}
 		if (b.global_pose_override_amount >= CMP_EPSILON) {
-			b.global_pose = b.global_pose.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
+			global_poses[offset] = global_poses[offset].interpolate_with(b.global_pose_override, b.global_pose_override_amount);
 		}
 		if (b.global_pose_override_reset) {
 			b.global_pose_override_amount = 0.0;
 		}
 #endif // _DISABLE_DEPRECATED
 
-		bone_global_pose_dirty[offset] = false;
+		global_pose_dirty[offset] = false;
 	}
 }
 
@@ -1315,8 +1459,12 @@ void Skeleton3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("advance", "delta"), &Skeleton3D::advance);
 
+	ClassDB::bind_method(D_METHOD("set_lod_policy", "policy"), &Skeleton3D::set_lod_policy);
+	ClassDB::bind_method(D_METHOD("get_lod_policy"), &Skeleton3D::get_lod_policy);
+
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "motion_scale", PROPERTY_HINT_RANGE, "0.001,10,0.001,or_greater"), "set_motion_scale", "get_motion_scale");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "show_rest_only"), "set_show_rest_only", "is_show_rest_only");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "lod_policy", PROPERTY_HINT_RESOURCE_TYPE, "AnimationLODPolicy"), "set_lod_policy", "get_lod_policy");
 
 	ADD_GROUP("Modifier", "modifier_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "modifier_callback_mode_process", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_modifier_callback_mode_process", "get_modifier_callback_mode_process");
@@ -32,6 +32,7 @@
 
 #include "core/templates/a_hash_map.h"
 #include "scene/3d/node_3d.h"
+#include "scene/animation/animation_lod_policy.h"
 #include "scene/resources/3d/skin.h"
 
 typedef int BoneId;
@@ -49,6 +50,7 @@ class SkinReference : public RefCounted {
 	uint64_t skeleton_version = 0;
 	Vector<uint32_t> skin_bone_indices;
 	uint32_t *skin_bone_indices_ptrs = nullptr;
+	LocalVector<Transform3D> skin_transforms; // Computed with the global poses, uploaded on the main thread.
 
 protected:
 	static void _bind_methods();
@@ -111,7 +113,6 @@ private:
 		Vector3 pose_position;
 		Quaternion pose_rotation;
 		Vector3 pose_scale = Vector3(1, 1, 1);
-		Transform3D global_pose;
 		int nested_set_offset = 0; // Offset in nested set of bone hierarchy.
 		int nested_set_span = 0; // Subtree span in nested set of bone hierarchy.
 
@@ -138,14 +139,12 @@ private:
 		Vector3 pose_position;
 		Quaternion pose_rotation;
 		Vector3 pose_scale = Vector3(1, 1, 1);
-		Transform3D global_pose;
 
 		void save(const Bone &p_bone) {
 			pose_cache = p_bone.pose_cache;
 			pose_position = p_bone.pose_position;
 			pose_rotation = p_bone.pose_rotation;
 			pose_scale = p_bone.pose_scale;
-			global_pose = p_bone.global_pose;
 		}
 
 		void restore(Bone &r_bone) {
@@ -153,10 +152,24 @@ private:
 			r_bone.pose_position = pose_position;
 			r_bone.pose_rotation = pose_rotation;
 			r_bone.pose_scale = pose_scale;
-			r_bone.global_pose = global_pose;
 		}
 	};
 
+	// Unmodified poses, restored once the modified ones have been sent to the skins.
+	LocalVector<BonePoseBackup> bones_backup;
+	LocalVector<Transform3D> bone_global_poses_backup;
+	LocalVector<bool> bone_global_pose_dirty_backup;
+
+	// Skeletons updated from the main thread are batched, their global poses and skins are computed on WorkerThreadPool.
+	static LocalVector<ObjectID> update_queue;
+	static bool update_flush_queued;
+	void _queue_update();
+	bool _update_skeleton_begin();
+	void _update_skeleton_compute();
+	void _update_skeleton_end();
+	static void _update_skeleton_task(void *p_userdata, uint32_t p_index);
+	static void _flush_update_queue();
+
 	HashSet<SkinReference *> skin_bindings;
 	void _skin_changed();
 
@@ -189,14 +202,25 @@ private:
 	void _process_changed();
 	void _make_modifiers_dirty();
 
+	// Level of detail, holds skeleton updates back until the next frame the policy lets the skeleton update in.
+	Ref<AnimationLODPolicy> lod_policy;
+	AnimationLODState lod_state;
+	bool lod_hold = false;
+	bool lod_update_held = false;
+	void _lod_advance(double p_delta);
+
 	// Global bone pose calculation.
 	mutable LocalVector<int> nested_set_offset_to_bone_index; // Map from Bone::nested_set_offset to bone index.
 	mutable LocalVector<bool> bone_global_pose_dirty; // Indexable with Bone::nested_set_offset.
+	mutable LocalVector<int> nested_set_parent_offsets; // Indexable with Bone::nested_set_offset, -1 for parentless bones.
+	mutable LocalVector<Transform3D> bone_global_poses; // Indexable with Bone::nested_set_offset.
 	void _update_bones_nested_set() const;
 	int _update_bone_nested_set(int p_bone, int p_offset) const;
 	void _make_bone_global_poses_dirty() const;
 	void _make_bone_global_pose_subtree_dirty(int p_bone) const;
 	void _update_bone_global_pose(int p_bone) const;
+	void _update_dirty_bone_global_poses() const;
+	void _bone_transforms_updated() const;
 
 #ifndef DISABLE_DEPRECATED
 	void _add_bone_bind_compat_88791(const String &p_name);
@@ -298,6 +322,9 @@ public:
 
 	void advance(double p_delta);
 
+	void set_lod_policy(const Ref<AnimationLODPolicy> &p_policy);
+	Ref<AnimationLODPolicy> get_lod_policy() const;
+
 #ifndef DISABLE_DEPRECATED
 	Transform3D get_bone_global_pose_no_override(int p_bone) const;
 	void clear_bones_global_pose_override();
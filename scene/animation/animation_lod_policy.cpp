@@ -0,0 +1,232 @@
+/**************************************************************************/
+/*  animation_lod_policy.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "animation_lod_policy.h"
+
+#include "core/config/engine.h"
+#include "scene/main/viewport.h"
+
+#ifndef _3D_DISABLED
+#include "scene/3d/camera_3d.h"
+#include "scene/3d/visible_on_screen_notifier_3d.h"
+#endif // _3D_DISABLED
+
+void AnimationLODPolicy::set_lod_distances(const PackedFloat32Array &p_distances) {
+	lod_distances = p_distances;
+	lod_distances.sort();
+	emit_changed();
+}
+
+PackedFloat32Array AnimationLODPolicy::get_lod_distances() const {
+	return lod_distances;
+}
+
+void AnimationLODPolicy::set_update_intervals(const PackedInt32Array &p_intervals) {
+	update_intervals = p_intervals;
+	emit_changed();
+}
+
+PackedInt32Array AnimationLODPolicy::get_update_intervals() const {
+	return update_intervals;
+}
+
+void AnimationLODPolicy::set_offscreen_update_interval(int p_interval) {
+	ERR_FAIL_COND(p_interval < 0);
+	offscreen_update_interval = p_interval;
+	emit_changed();
+}
+
+int AnimationLODPolicy::get_offscreen_update_interval() const {
+	return offscreen_update_interval;
+}
+
+void AnimationLODPolicy::set_visibility_notifier(const NodePath &p_path) {
+	visibility_notifier = p_path;
+	emit_changed();
+}
+
+NodePath AnimationLODPolicy::get_visibility_notifier() const {
+	return visibility_notifier;
+}
+
+void AnimationLODPolicy::set_low_priority_distance(float p_distance) {
+	low_priority_distance = p_distance;
+	emit_changed();
+}
+
+float AnimationLODPolicy::get_low_priority_distance() const {
+	return low_priority_distance;
+}
+
+void AnimationLODPolicy::set_low_priority_tracks(const PackedStringArray &p_patterns) {
+	low_priority_tracks = p_patterns;
+	emit_changed();
+}
+
+PackedStringArray AnimationLODPolicy::get_low_priority_tracks() const {
+	return low_priority_tracks;
+}
+
+void AnimationLODPolicy::set_interpolate(bool p_interpolate) {
+	interpolate = p_interpolate;
+	emit_changed();
+}
+
+bool AnimationLODPolicy::is_interpolating() const {
+	return interpolate;
+}
+
+int AnimationLODPolicy::get_lod_level(float p_distance) const {
+	int level = 0;
+	for (float distance : lod_distances) {
+		if (p_distance < distance) {
+			break;
+		}
+		level++;
+	}
+	return level;
+}
+
+int AnimationLODPolicy::get_update_interval(int p_lod_level) const {
+	if (update_intervals.is_empty()) {
+		return 1;
+	}
+	// Levels without an interval of their own use the last one.
+	return MAX(1, update_intervals[MIN(p_lod_level, update_intervals.size() - 1)]);
+}
+
+bool AnimationLODPolicy::is_low_priority_track(const NodePath &p_path) const {
+	if (low_priority_tracks.is_empty()) {
+		return false;
+	}
+	String path = p_path;
+	for (const String &pattern : low_priority_tracks) {
+		if (path.match(pattern)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void AnimationLODPolicy::evaluate(Node *p_node, int &r_update_interval, bool &r_skip_low_priority) const {
+	r_update_interval = 1;
+	r_skip_low_priority = false;
+#ifndef _3D_DISABLED
+	ERR_FAIL_NULL(p_node);
+	if (!p_node->is_inside_tree()) {
+		return;
+	}
+
+	Node *base = p_node->get_owner() ? p_node->get_owner() : p_node;
+
+	if (!visibility_notifier.is_empty()) {
+		VisibleOnScreenNotifier3D *notifier = Object::cast_to<VisibleOnScreenNotifier3D>(base->get_node_or_null(visibility_notifier));
+		if (notifier && !notifier->is_on_screen()) {
+			r_update_interval = offscreen_update_interval;
+			r_skip_low_priority = true;
+			return;
+		}
+	}
+
+	Node3D *reference = Object::cast_to<Node3D>(base);
+	for (Node *node = p_node; !reference && node; node = node->get_parent()) {
+		reference = Object::cast_to<Node3D>(node);
+	}
+	Viewport *viewport = p_node->get_viewport();
+	ERR_FAIL_NULL(viewport);
+	Camera3D *camera = viewport->get_camera_3d();
+	if (!reference || !camera) {
+		return;
+	}
+
+	float distance = camera->get_global_position().distance_to(reference->get_global_position());
+	r_update_interval = get_update_interval(get_lod_level(distance));
+	r_skip_low_priority = distance >= low_priority_distance;
+#endif // _3D_DISABLED
+}
+
+void AnimationLODPolicy::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_lod_distances", "distances"), &AnimationLODPolicy::set_lod_distances);
+	ClassDB::bind_method(D_METHOD("get_lod_distances"), &AnimationLODPolicy::get_lod_distances);
+	ClassDB::bind_method(D_METHOD("set_update_intervals", "intervals"), &AnimationLODPolicy::set_update_intervals);
+	ClassDB::bind_method(D_METHOD("get_update_intervals"), &AnimationLODPolicy::get_update_intervals);
+	ClassDB::bind_method(D_METHOD("set_offscreen_update_interval", "interval"), &AnimationLODPolicy::set_offscreen_update_interval);
+	ClassDB::bind_method(D_METHOD("get_offscreen_update_interval"), &AnimationLODPolicy::get_offscreen_update_interval);
+	ClassDB::bind_method(D_METHOD("set_visibility_notifier", "path"), &AnimationLODPolicy::set_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("get_visibility_notifier"), &AnimationLODPolicy::get_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("set_low_priority_distance", "distance"), &AnimationLODPolicy::set_low_priority_distance);
+	ClassDB::bind_method(D_METHOD("get_low_priority_distance"), &AnimationLODPolicy::get_low_priority_distance);
+	ClassDB::bind_method(D_METHOD("set_low_priority_tracks", "patterns"), &AnimationLODPolicy::set_low_priority_tracks);
+	ClassDB::bind_method(D_METHOD("get_low_priority_tracks"), &AnimationLODPolicy::get_low_priority_tracks);
+	ClassDB::bind_method(D_METHOD("set_interpolate", "interpolate"), &AnimationLODPolicy::set_interpolate);
+	ClassDB::bind_method(D_METHOD("is_interpolating"), &AnimationLODPolicy::is_interpolating);
+
+	ClassDB::bind_method(D_METHOD("get_lod_level", "distance"), &AnimationLODPolicy::get_lod_level);
+	ClassDB::bind_method(D_METHOD("get_update_interval", "lod_level"), &AnimationLODPolicy::get_update_interval);
+	ClassDB::bind_method(D_METHOD("is_low_priority_track", "path"), &AnimationLODPolicy::is_low_priority_track);
+
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "lod_distances", PROPERTY_HINT_NONE, "suffix:m"), "set_lod_distances", "get_lod_distances");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "update_intervals"), "set_update_intervals", "get_update_intervals");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "offscreen_update_interval", PROPERTY_HINT_RANGE, "0,60,1"), "set_offscreen_update_interval", "get_offscreen_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "visibility_notifier"), "set_visibility_notifier", "get_visibility_notifier");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "interpolate"), "set_interpolate", "is_interpolating");
+	ADD_GROUP("Low Priority", "low_priority_");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "low_priority_distance", PROPERTY_HINT_RANGE, "0,1000,0.01,or_greater,suffix:m"), "set_low_priority_distance", "get_low_priority_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_STRING_ARRAY, "low_priority_tracks"), "set_low_priority_tracks", "get_low_priority_tracks");
+}
+
+bool AnimationLODState::advance(const Ref<AnimationLODPolicy> &p_policy, Node *p_node, double p_delta, double &r_delta) {
+	if (p_policy.is_null() || Engine::get_singleton()->is_editor_hint()) {
+		update_interval = 1;
+		skip_low_priority = false;
+	} else {
+		p_policy->evaluate(p_node, update_interval, skip_low_priority);
+	}
+
+	if (update_interval == 0) {
+		// Paused, the time doesn't catch up once resumed.
+		accumulated_delta = 0.0;
+		return false;
+	}
+	accumulated_delta += p_delta;
+
+	if (frames == 0) {
+		// The first frame always updates.
+		phase = hash_murmur3_one_64(uint64_t(p_node->get_instance_id()));
+	} else if ((frames + phase) % uint32_t(update_interval) != 0) {
+		frames++;
+		return false;
+	}
+	frames++;
+
+	r_delta = accumulated_delta;
+	accumulated_delta = 0.0;
+	return true;
+}
@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  animation_lod_policy.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/resource.h"
+
+class Node;
+
+// Decides how often an animated node is updated, from its distance to the camera and its visibility.
+// The same policy can be shared by AnimationMixers and Skeleton3Ds.
+class AnimationLODPolicy : public Resource {
+	GDCLASS(AnimationLODPolicy, Resource);
+
+	PackedFloat32Array lod_distances = { 15.0, 40.0 };
+	PackedInt32Array update_intervals = { 1, 2, 4 };
+	int offscreen_update_interval = 8;
+	NodePath visibility_notifier;
+	float low_priority_distance = 15.0;
+	PackedStringArray low_priority_tracks;
+	bool interpolate = true;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_lod_distances(const PackedFloat32Array &p_distances);
+	PackedFloat32Array get_lod_distances() const;
+
+	void set_update_intervals(const PackedInt32Array &p_intervals);
+	PackedInt32Array get_update_intervals() const;
+
+	void set_offscreen_update_interval(int p_interval);
+	int get_offscreen_update_interval() const;
+
+	void set_visibility_notifier(const NodePath &p_path);
+	NodePath get_visibility_notifier() const;
+
+	void set_low_priority_distance(float p_distance);
+	float get_low_priority_distance() const;
+
+	void set_low_priority_tracks(const PackedStringArray &p_patterns);
+	PackedStringArray get_low_priority_tracks() const;
+
+	void set_interpolate(bool p_interpolate);
+	bool is_interpolating() const;
+
+	int get_lod_level(float p_distance) const;
+	int get_update_interval(int p_lod_level) const;
+	bool is_low_priority_track(const NodePath &p_path) const;
+
+	// Distance and visibility are measured on the owner of p_node, so nodes of the same scene share them.
+	void evaluate(Node *p_node, int &r_update_interval, bool &r_skip_low_priority) const;
+};
+
+// Per node state of the update throttling.
+struct AnimationLODState {
+	double accumulated_delta = 0.0;
+	uint32_t frames = 0;
+	// Seeded from the instance ID on the first update, so nodes created together update in different frames.
+	uint32_t phase = 0;
+	int update_interval = 1;
+	bool skip_low_priority = false;
+
+	// Returns true if the node must be updated in this frame, r_delta receives the time elapsed since its last update.
+	bool advance(const Ref<AnimationLODPolicy> &p_policy, Node *p_node, double p_delta, double &r_delta);
+};
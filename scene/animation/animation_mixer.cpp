@@ -33,6 +33,7 @@
 
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/string/string_name.h"
 #include "scene/2d/audio_stream_player_2d.h"
 #include "scene/animation/animation_player.h"
@@ -523,6 +524,33 @@ AnimationMixer::AnimationCallbackModeDiscrete AnimationMixer::get_callback_mode_
 	return callback_mode_discrete;
 }
 
+void AnimationMixer::set_lod_policy(const Ref<AnimationLODPolicy> &p_policy) {
+	if (lod_policy == p_policy) {
+		return;
+	}
+	if (lod_policy.is_valid()) {
+		lod_policy->disconnect_changed(callable_mp(this, &AnimationMixer::_lod_policy_changed));
+	}
+	lod_policy = p_policy;
+	if (lod_policy.is_valid()) {
+		lod_policy->connect_changed(callable_mp(this, &AnimationMixer::_lod_policy_changed));
+	}
+	lod_state = AnimationLODState();
+	_clear_caches();
+}
+
+Ref<AnimationLODPolicy> AnimationMixer::get_lod_policy() const {
+	return lod_policy;
+}
+
+void AnimationMixer::set_parallel_blending(bool p_enabled) {
+	parallel_blending = p_enabled;
+}
+
+bool AnimationMixer::is_parallel_blending() const {
+	return parallel_blending;
+}
+
 void AnimationMixer::set_audio_max_polyphony(int p_audio_max_polyphony) {
 	ERR_FAIL_COND(p_audio_max_polyphony < 0 || p_audio_max_polyphony > 128);
 	audio_max_polyphony = p_audio_max_polyphony;
@@ -576,6 +604,7 @@ void AnimationMixer::_clear_caches() {
 	animation_track_num_to_track_cache.clear();
 	cache_valid = false;
 	capture_cache.clear();
+	lod_interpolation_frames = 0;
 
 	emit_signal(SNAME("caches_cleared"));
 }
@@ -964,6 +993,7 @@ bool AnimationMixer::_update_caches() {
 
 	for (KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
 		K.value->blend_idx = track_map[K.value->path];
+		K.value->low_priority = lod_policy.is_valid() && lod_policy->is_low_priority_track(K.value->path);
 	}
 
 	animation_track_num_to_track_cache.clear();
@@ -983,6 +1013,9 @@ bool AnimationMixer::_update_caches() {
 /* -- Blending processor ---------------------- */
 /* -------------------------------------------- */
 
+LocalVector<ObjectID> AnimationMixer::parallel_blend_queue;
+bool AnimationMixer::parallel_blend_flush_queued = false;
+
 void AnimationMixer::_process_animation(double p_delta, bool p_update_only) {
 	_blend_init();
 	if (_blend_pre_process(p_delta, track_count, track_map)) {
@@ -996,6 +1029,151 @@ void AnimationMixer::_process_animation(double p_delta, bool p_update_only) {
 	clear_animation_instances();
 }
 
+void AnimationMixer::_lod_process_animation(double p_delta) {
+	if (lod_policy.is_null()) {
+		_queue_process_animation(p_delta);
+		return;
+	}
+	double delta = 0.0;
+	if (lod_state.advance(lod_policy, this, p_delta, delta)) {
+		lod_interpolation_request = lod_policy->is_interpolating() ? lod_state.update_interval : 0;
+		_queue_process_animation(delta);
+	} else if (lod_interpolation_frame < lod_interpolation_frames) {
+		lod_interpolation_frame++;
+		_lod_interpolate_transforms();
+	}
+}
+
+void AnimationMixer::_lod_interpolate_transforms() {
+#ifndef _3D_DISABLED
+	real_t weight = real_t(lod_interpolation_frame) / real_t(lod_interpolation_frames);
+	for (const KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
+		if (K.value->type != Animation::TYPE_POSITION_3D) {
+			continue;
+		}
+		TrackCacheTransform *t = static_cast<TrackCacheTransform *>(K.value);
+		if (!t->lod_interpolating) {
+			continue;
+		}
+		if (t->skeleton_id.is_valid()) {
+			Skeleton3D *t_skeleton = ObjectDB::get_instance<Skeleton3D>(t->skeleton_id);
+			if (!t_skeleton) {
+				continue;
+			}
+			if (t->loc_used) {
+				t_skeleton->set_bone_pose_position(t->bone_idx, t->lod_from_loc.lerp(t->loc, weight));
+			}
+			if (t->rot_used) {
+				t_skeleton->set_bone_pose_rotation(t->bone_idx, t->lod_from_rot.slerp(t->rot, weight));
+			}
+			if (t->scale_used) {
+				t_skeleton->set_bone_pose_scale(t->bone_idx, t->lod_from_scale.lerp(t->scale, weight));
+			}
+		} else {
+			Node3D *t_node_3d = ObjectDB::get_instance<Node3D>(t->object_id);
+			if (!t_node_3d) {
+				continue;
+			}
+			if (t->loc_used) {
+				t_node_3d->set_position(t->lod_from_loc.lerp(t->loc, weight));
+			}
+			if (t->rot_used) {
+				t_node_3d->set_rotation(t->lod_from_rot.slerp(t->rot, weight).get_euler());
+			}
+			if (t->scale_used) {
+				t_node_3d->set_scale(t->lod_from_scale.lerp(t->scale, weight));
+			}
+		}
+	}
+#endif // _3D_DISABLED
+}
+
+void AnimationMixer::_lod_policy_changed() {
+	_clear_caches();
+}
+
+void AnimationMixer::_queue_process_animation(double p_delta) {
+	// A script overriding _post_process_key_value() can't be called from a worker thread.
+	if (!parallel_blending || GDVIRTUAL_IS_OVERRIDDEN(_post_process_key_value) || !Thread::is_main_thread()) {
+		_process_animation(p_delta);
+		return;
+	}
+	if (parallel_blend_queued) {
+		parallel_blend_delta += p_delta;
+		return;
+	}
+	parallel_blend_queued = true;
+	parallel_blend_delta = p_delta;
+	parallel_blend_queue.push_back(get_instance_id());
+	if (!parallel_blend_flush_queued) {
+		parallel_blend_flush_queued = true;
+		// Flushed right after all nodes have been processed.
+		callable_mp_static(&AnimationMixer::_flush_parallel_blend).call_deferred();
+	}
+}
+
+void AnimationMixer::_parallel_blend_task(void *p_userdata, uint32_t p_index) {
+	AnimationMixer *mixer = static_cast<AnimationMixer **>(p_userdata)[p_index];
+	mixer->_blend_process(mixer->parallel_blend_delta, false, BLEND_PROCESS_PASS_SAMPLE);
+}
+
+void AnimationMixer::_flush_parallel_blend() {
+	parallel_blend_flush_queued = false;
+
+	LocalVector<ObjectID> queue = parallel_blend_queue;
+	parallel_blend_queue.clear();
+
+	// Gather the playback state of every mixer first, it may call into scripts.
+	LocalVector<AnimationMixer *> mixers;
+	LocalVector<ObjectID> mixer_ids;
+	for (const ObjectID &id : queue) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(id);
+		if (!mixer) {
+			continue;
+		}
+		mixer->parallel_blend_queued = false;
+		if (!mixer->active || !mixer->is_inside_tree()) {
+			continue;
+		}
+		if (GDVIRTUAL_IS_OVERRIDDEN_PTR(mixer, _post_process_key_value)) {
+			// A script was attached since the mixer was queued.
+			mixer->_process_animation(mixer->parallel_blend_delta);
+			continue;
+		}
+		mixer->_blend_init();
+		if (mixer->_blend_pre_process(mixer->parallel_blend_delta, mixer->track_count, mixer->track_map)) {
+			mixer->_blend_capture(mixer->parallel_blend_delta);
+			mixer->_blend_calc_total_weight();
+			// Not overridden, so skip looking for the script method from the workers.
+			mixer->is_GDVIRTUAL_CALL_post_process_key_value = false;
+			mixers.push_back(mixer);
+			mixer_ids.push_back(id);
+		} else {
+			mixer->clear_animation_instances();
+		}
+	}
+
+	if (mixers.size() == 1) {
+		_parallel_blend_task(mixers.ptr(), 0);
+	} else if (mixers.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&AnimationMixer::_parallel_blend_task, mixers.ptr(), mixers.size(), -1, true, SNAME("AnimationMixerParallelBlend"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	// Method, audio and discrete tracks may free any mixer, so check them again before applying.
+	for (uint32_t i = 0; i < mixers.size(); i++) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(mixer_ids[i]);
+		if (!mixer) {
+			continue;
+		}
+		mixer->_blend_process(mixer->parallel_blend_delta, false, BLEND_PROCESS_PASS_EVENTS);
+		mixer->_blend_apply();
+		mixer->_blend_post_process();
+		mixer->emit_signal(SNAME("mixer_applied"));
+		mixer->clear_animation_instances();
+	}
+}
+
 Variant AnimationMixer::_post_process_key_value(const Ref<Animation> &p_anim, int p_track, Variant &p_value, ObjectID p_object_id, int p_object_sub_idx) {
 #ifndef _3D_DISABLED
 	switch (p_anim->track_get_type(p_track)) {
@@ -1165,7 +1343,24 @@ void AnimationMixer::_blend_calc_total_weight() {
 	}
 }
 
-void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
+bool AnimationMixer::_is_event_track(const Ref<Animation> &p_anim, int p_track) const {
+	switch (p_anim->track_get_type(p_track)) {
+		case Animation::TYPE_VALUE: {
+			// Discrete value tracks are set on the object while blending, unless they are forced to be continuous.
+			return callback_mode_discrete != ANIMATION_CALLBACK_MODE_DISCRETE_FORCE_CONTINUOUS && p_anim->value_track_get_update_mode(p_track) == Animation::UPDATE_DISCRETE;
+		} break;
+		case Animation::TYPE_METHOD:
+		case Animation::TYPE_AUDIO:
+		case Animation::TYPE_ANIMATION: {
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+	return false;
+}
+
+void AnimationMixer::_blend_process(double p_delta, bool p_update_only, BlendProcessPass p_pass) {
 	// Apply value/transform/blend/bezier blends to track caches and execute method/audio/animation tracks.
 #ifdef TOOLS_ENABLED
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
@@ -1193,6 +1388,10 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 		Animation::Track *const *tracks_ptr = tracks.ptr();
 		real_t a_length = a->get_length();
 		int count = tracks.size();
+#ifndef _3D_DISABLED
+		// Compressed transform tracks are sampled all at once, the other tracks one by one below.
+		bool transform_sampled = p_pass != BLEND_PROCESS_PASS_EVENTS && a->sample_compressed_transform_tracks(time, transform_samples);
+#endif // _3D_DISABLED
 		for (int i = 0; i < count; i++) {
 			const Animation::Track *animation_track = tracks_ptr[i];
 			if (!animation_track->enabled) {
@@ -1202,6 +1401,9 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 			if (track == nullptr) {
 				continue; // No path, but avoid error spamming.
 			}
+			if (track->low_priority && lod_state.skip_low_priority) {
+				continue;
+			}
 			int blend_idx = track->blend_idx;
 			ERR_CONTINUE(blend_idx < 0 || blend_idx >= track_count);
 			real_t blend = blend_idx < track_weights_count ? track_weights_ptr[blend_idx] * weight : weight;
@@ -1213,6 +1415,9 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 				}
 				blend = blend / track->total_weight;
 			}
+			if (p_pass != BLEND_PROCESS_PASS_ALL && _is_event_track(a, i) != (p_pass == BLEND_PROCESS_PASS_EVENTS)) {
+				continue;
+			}
 			Animation::TrackType ttype = animation_track->type;
 			track->root_motion = root_motion_track == animation_track->path;
 			switch (ttype) {
@@ -1350,9 +1555,13 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Vector3 loc;
-						Error err = a->try_position_track_interpolate(i, time, &loc);
-						if (err != OK) {
-							continue;
+						if (transform_sampled && transform_samples.is_sampled(i)) {
+							loc = transform_samples.get_vector3(i);
+						} else {
+							Error err = a->try_position_track_interpolate(i, time, &loc);
+							if (err != OK) {
+								continue;
+							}
 						}
 						loc = post_process_key_value(a, i, loc, t->object_id, t->bone_idx);
 						t->loc += (loc - t->init_loc) * blend;
@@ -1438,9 +1647,13 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Quaternion rot;
-						Error err = a->try_rotation_track_interpolate(i, time, &rot);
-						if (err != OK) {
-							continue;
+						if (transform_sampled && transform_samples.is_sampled(i)) {
+							rot = transform_samples.get_quaternion(i);
+						} else {
+							Error err = a->try_rotation_track_interpolate(i, time, &rot);
+							if (err != OK) {
+								continue;
+							}
 						}
 						rot = post_process_key_value(a, i, rot, t->object_id, t->bone_idx);
 						t->rot = (t->rot * Quaternion().slerp(t->init_rot.inverse() * rot, blend)).normalized();
@@ -1526,9 +1739,13 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 					}
 					{
 						Vector3 scale;
-						Error err = a->try_scale_track_interpolate(i, time, &scale);
-						if (err != OK) {
-							continue;
+						if (transform_sampled && transform_samples.is_sampled(i)) {
+							scale = transform_samples.get_vector3(i);
+						} else {
+							Error err = a->try_scale_track_interpolate(i, time, &scale);
+							if (err != OK) {
+								continue;
+							}
 						}
 						scale = post_process_key_value(a, i, scale, t->object_id, t->bone_idx);
 						t->scale += (scale - t->init_scale) * blend;
@@ -1851,13 +2068,27 @@ void AnimationMixer::_blend_process(double p_delta, bool p_update_only) {
 }
 
 void AnimationMixer::_blend_apply() {
+	// With LOD interpolation, transforms are not set here but reached over the next frames, see _lod_interpolate_transforms().
+	int interpolation_frames = lod_interpolation_request;
+	lod_interpolation_request = 0;
+	bool lod_interpolate = interpolation_frames > 1;
+	lod_interpolation_frames = 0;
+
 	// Finally, set the tracks.
 	for (const KeyValue<Animation::TypeHash, TrackCache *> &K : track_cache) {
 		TrackCache *track = K.value;
+#ifndef _3D_DISABLED
+		if (track->type == Animation::TYPE_POSITION_3D) {
+			static_cast<TrackCacheTransform *>(track)->lod_interpolating = false;
+		}
+#endif // _3D_DISABLED
 		bool is_zero_amount = Math::is_zero_approx(track->total_weight);
 		if (!deterministic && is_zero_amount) {
 			continue;
 		}
+		if (track->low_priority && lod_state.skip_low_priority) {
+			continue; // Keep the last applied value.
+		}
 		switch (track->type) {
 			case Animation::TYPE_POSITION_3D: {
 #ifndef _3D_DISABLED
@@ -1875,6 +2106,13 @@ void AnimationMixer::_blend_apply() {
 					if (!t_skeleton) {
 						return;
 					}
+					if (lod_interpolate) {
+						t->lod_interpolating = true;
+						t->lod_from_loc = t_skeleton->get_bone_pose_position(t->bone_idx);
+						t->lod_from_rot = t_skeleton->get_bone_pose_rotation(t->bone_idx);
+						t->lod_from_scale = t_skeleton->get_bone_pose_scale(t->bone_idx);
+						break;
+					}
 					if (t->loc_used) {
 						t_skeleton->set_bone_pose_position(t->bone_idx, t->loc);
 					}
@@ -1890,6 +2128,13 @@ void AnimationMixer::_blend_apply() {
 					if (!t_node_3d) {
 						return;
 					}
+					if (lod_interpolate) {
+						t->lod_interpolating = true;
+						t->lod_from_loc = t_node_3d->get_position();
+						t->lod_from_rot = t_node_3d->get_quaternion();
+						t->lod_from_scale = t_node_3d->get_scale();
+						break;
+					}
 					if (t->loc_used) {
 						t_node_3d->set_position(t->loc);
 					}
@@ -2014,6 +2259,12 @@ void AnimationMixer::_blend_apply() {
 			} // The rest don't matter.
 		}
 	}
+
+	if (lod_interpolate) {
+		lod_interpolation_frame = 1;
+		lod_interpolation_frames = interpolation_frames;
+		_lod_interpolate_transforms();
+	}
 }
 
 void AnimationMixer::_call_object(ObjectID p_object_id, const StringName &p_method, const Vector<Variant> &p_params, bool p_deferred) {
@@ -2352,13 +2603,13 @@ void AnimationMixer::_notification(int p_what) {
 
 		case NOTIFICATION_INTERNAL_PROCESS: {
 			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_IDLE) {
-				_process_animation(get_process_delta_time());
+				_lod_process_animation(get_process_delta_time());
 			}
 		} break;
 
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
 			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_PHYSICS) {
-				_process_animation(get_physics_process_delta_time());
+				_lod_process_animation(get_physics_process_delta_time());
 			}
 		} break;
 
@@ -2422,6 +2673,12 @@ void AnimationMixer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_callback_mode_discrete", "mode"), &AnimationMixer::set_callback_mode_discrete);
 	ClassDB::bind_method(D_METHOD("get_callback_mode_discrete"), &AnimationMixer::get_callback_mode_discrete);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_blending", "enabled"), &AnimationMixer::set_parallel_blending);
+	ClassDB::bind_method(D_METHOD("is_parallel_blending"), &AnimationMixer::is_parallel_blending);
+
+	ClassDB::bind_method(D_METHOD("set_lod_policy", "policy"), &AnimationMixer::set_lod_policy);
+	ClassDB::bind_method(D_METHOD("get_lod_policy"), &AnimationMixer::get_lod_policy);
+
 	/* ---- Audio ---- */
 	ClassDB::bind_method(D_METHOD("set_audio_max_polyphony", "max_polyphony"), &AnimationMixer::set_audio_max_polyphony);
 	ClassDB::bind_method(D_METHOD("get_audio_max_polyphony"), &AnimationMixer::get_audio_max_polyphony);
@@ -2455,6 +2712,8 @@ void AnimationMixer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "is_deterministic");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reset_on_save", PROPERTY_HINT_NONE, ""), "set_reset_on_save_enabled", "is_reset_on_save_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_node"), "set_root_node", "get_root_node");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_blending"), "set_parallel_blending", "is_parallel_blending");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "lod_policy", PROPERTY_HINT_RESOURCE_TYPE, "AnimationLODPolicy"), "set_lod_policy", "get_lod_policy");
 
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
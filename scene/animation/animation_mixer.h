@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/templates/a_hash_map.h"
+#include "scene/animation/animation_lod_policy.h"
 #include "scene/animation/tween.h"
 #include "scene/main/node.h"
 #include "scene/resources/animation.h"
@@ -42,6 +43,7 @@ class AnimatedValuesBackup;
 class AnimationMixer : public Node {
 	GDCLASS(AnimationMixer, Node);
 	friend AnimatedValuesBackup;
+	friend class TestAnimationMixerInternalsAccessor;
 #ifdef TOOLS_ENABLED
 	bool editing = false;
 	bool dummy = false;
@@ -151,6 +153,7 @@ protected:
 		int blend_idx = -1;
 		ObjectID object_id;
 		real_t total_weight = 0.0;
+		bool low_priority = false; // Skipped at the distance given by the LOD policy.
 
 		TrackCache() = default;
 		TrackCache(const TrackCache &p_other) :
@@ -177,6 +180,11 @@ protected:
 		Vector3 loc;
 		Quaternion rot;
 		Vector3 scale;
+		// Pose the LOD interpolation starts from, the target is loc, rot and scale.
+		bool lod_interpolating = false;
+		Vector3 lod_from_loc;
+		Quaternion lod_from_rot;
+		Vector3 lod_from_scale;
 
 		TrackCacheTransform(const TrackCacheTransform &p_other) :
 				TrackCache(p_other),
@@ -325,6 +333,38 @@ protected:
 	AHashMap<NodePath, int> track_map;
 	int track_count = 0;
 	bool deterministic = false;
+	Animation::TransformTrackSamples transform_samples; // Scratch space for sampling compressed animations.
+
+	enum BlendProcessPass {
+		BLEND_PROCESS_PASS_ALL,
+		BLEND_PROCESS_PASS_SAMPLE, // Only tracks which write to the track caches, safe to run on a worker thread.
+		BLEND_PROCESS_PASS_EVENTS, // Only tracks which affect other objects directly, must run on the main thread.
+	};
+
+	/* ---- Parallel blending ---- */
+	// Mixers with parallel blending enabled are queued instead of processed in their own notification.
+	// The queue is flushed once per frame: tracks are sampled for all queued mixers at once on the
+	// WorkerThreadPool, then the results are applied on the main thread.
+	bool parallel_blending = false;
+	bool parallel_blend_queued = false;
+	double parallel_blend_delta = 0.0;
+	static LocalVector<ObjectID> parallel_blend_queue;
+	static bool parallel_blend_flush_queued;
+
+	/* ---- Level of detail ---- */
+	Ref<AnimationLODPolicy> lod_policy;
+	AnimationLODState lod_state;
+	int lod_interpolation_request = 0;
+	int lod_interpolation_frame = 0;
+	int lod_interpolation_frames = 0;
+
+	void _lod_process_animation(double p_delta);
+	void _lod_interpolate_transforms();
+	void _lod_policy_changed();
+
+	void _queue_process_animation(double p_delta);
+	static void _parallel_blend_task(void *p_userdata, uint32_t p_index);
+	static void _flush_parallel_blend();
 
 	/* ---- Root motion accumulator for Skeleton3D ---- */
 	NodePath root_motion_track;
@@ -366,7 +406,8 @@ protected:
 	virtual bool _blend_pre_process(double p_delta, int p_track_count, const AHashMap<NodePath, int> &p_track_map);
 	virtual void _blend_capture(double p_delta);
 	void _blend_calc_total_weight(); // For indeterministic blending.
-	void _blend_process(double p_delta, bool p_update_only = false);
+	void _blend_process(double p_delta, bool p_update_only = false, BlendProcessPass p_pass = BLEND_PROCESS_PASS_ALL);
+	bool _is_event_track(const Ref<Animation> &p_anim, int p_track) const;
 	void _blend_apply();
 	virtual void _blend_post_process();
 	void _call_object(ObjectID p_object_id, const StringName &p_method, const Vector<Variant> &p_params, bool p_deferred);
@@ -433,6 +474,12 @@ public:
 	void set_callback_mode_discrete(AnimationCallbackModeDiscrete p_mode);
 	AnimationCallbackModeDiscrete get_callback_mode_discrete() const;
 
+	void set_parallel_blending(bool p_enabled);
+	bool is_parallel_blending() const;
+
+	void set_lod_policy(const Ref<AnimationLODPolicy> &p_policy);
+	Ref<AnimationLODPolicy> get_lod_policy() const;
+
 	/* ---- Audio ---- */
 	void set_audio_max_polyphony(int p_audio_max_polyphony);
 	int get_audio_max_polyphony() const;
@@ -186,9 +186,99 @@ void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 	}
 }
 
+#ifndef _3D_DISABLED
+void SceneTree::_resolve_node_3d_transform(uint32_t p_index, Node3D **p_nodes) {
+	_ALLOW_DISCARD_ p_nodes[p_index]->get_global_transform();
+}
+
+void SceneTree::_resolve_node_3d_transforms() {
+	// Flatten the dirty branches above the queued Node3Ds into a list where parents come before their children,
+	// so each global transform is computed exactly once, from a parent that is already resolved.
+	transform_resolve_nodes.clear();
+	uint32_t max_depth = 0;
+
+	for (SelfList<Node> *n = xform_change_list.first(); n; n = n->next()) {
+		Node3D *node_3d = Object::cast_to<Node3D>(n->self());
+		if (!node_3d) {
+			continue;
+		}
+
+		transform_resolve_chain.clear();
+		Node3D *node = node_3d;
+		while (node && !node->data.transform_resolve_queued && node->_test_dirty_bits(Node3D::DIRTY_GLOBAL_TRANSFORM)) {
+			transform_resolve_chain.push_back(node);
+			node = node->data.top_level ? nullptr : node->data.parent;
+		}
+
+		uint32_t depth = (node && node->data.transform_resolve_queued) ? node->data.transform_resolve_depth + 1 : 0;
+		for (int64_t i = int64_t(transform_resolve_chain.size()) - 1; i >= 0; i--) {
+			Node3D *chain_node = transform_resolve_chain[i];
+			chain_node->data.transform_resolve_queued = true;
+			chain_node->data.transform_resolve_depth = depth;
+			max_depth = MAX(max_depth, depth);
+			depth++;
+			transform_resolve_nodes.push_back(chain_node);
+		}
+	}
+
+	uint32_t count = transform_resolve_nodes.size();
+	if (count < TRANSFORM_RESOLVE_THREADED_MIN_NODES) {
+		for (Node3D *node : transform_resolve_nodes) {
+			_ALLOW_DISCARD_ node->get_global_transform();
+			node->data.transform_resolve_queued = false;
+		}
+		return;
+	}
+
+	// Bucket the nodes by depth. A level only reads the global transforms of the levels above it,
+	// so the nodes within a level can be resolved in parallel.
+	transform_resolve_level_ends.resize(max_depth + 1);
+	for (uint32_t &level_end : transform_resolve_level_ends) {
+		level_end = 0;
+	}
+	for (Node3D *node : transform_resolve_nodes) {
+		transform_resolve_level_ends[node->data.transform_resolve_depth]++;
+	}
+	uint32_t level_start = 0;
+	for (uint32_t &level_end : transform_resolve_level_ends) {
+		uint32_t level_count = level_end;
+		level_end = level_start;
+		level_start += level_count;
+	}
+	transform_resolve_levels.resize(count);
+	for (Node3D *node : transform_resolve_nodes) {
+		transform_resolve_levels[transform_resolve_level_ends[node->data.transform_resolve_depth]++] = node;
+		node->data.transform_resolve_queued = false;
+	}
+
+	level_start = 0;
+	for (uint32_t level_end : transform_resolve_level_ends) {
+		uint32_t level_count = level_end - level_start;
+		Node3D **level_nodes = transform_resolve_levels.ptr() + level_start;
+		if (level_count >= TRANSFORM_RESOLVE_THREADED_MIN_LEVEL_NODES) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_resolve_node_3d_transform, level_nodes, level_count, -1, true, SNAME("ResolveNode3DTransforms"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < level_count; i++) {
+				_resolve_node_3d_transform(i, level_nodes);
+			}
+		}
+		level_start = level_end;
+	}
+}
+#endif // _3D_DISABLED
+
 void SceneTree::flush_transform_notifications() {
 	_THREAD_SAFE_METHOD_
 
+#ifndef _3D_DISABLED
+	// Resolve all the global transforms the notified nodes are about to read in one pass.
+	_resolve_node_3d_transforms();
+#endif // _3D_DISABLED
+
+	// Submit the resulting instance transforms to the RenderingServer as a single command.
+	RS::get_singleton()->begin_instance_transform_batch();
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -197,6 +287,8 @@ void SceneTree::flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	RS::get_singleton()->end_instance_transform_batch();
 }
 
 bool SceneTree::is_accessibility_enabled() const {
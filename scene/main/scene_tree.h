@@ -248,6 +248,20 @@ private:
 
 	SelfList<Node>::List xform_change_list;
 
+#ifndef _3D_DISABLED
+	static const uint32_t TRANSFORM_RESOLVE_THREADED_MIN_NODES = 1024;
+	static const uint32_t TRANSFORM_RESOLVE_THREADED_MIN_LEVEL_NODES = 256;
+
+	// Dirty Node3D branches flattened so that parents come before their children.
+	LocalVector<Node3D *> transform_resolve_nodes;
+	LocalVector<Node3D *> transform_resolve_chain;
+	LocalVector<Node3D *> transform_resolve_levels;
+	LocalVector<uint32_t> transform_resolve_level_ends;
+
+	void _resolve_node_3d_transform(uint32_t p_index, Node3D **p_nodes);
+	void _resolve_node_3d_transforms();
+#endif // _3D_DISABLED
+
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
 #endif
@@ -608,6 +608,9 @@ void SceneTreeFTI::frame_update(Node *p_root, bool p_frame_start) {
 
 	_update_request_resets();
 
+	// Submit the interpolated instance transforms to the RenderingServer as a single command.
+	RS::get_singleton()->begin_instance_transform_batch();
+
 	float interpolation_fraction = Engine::get_singleton()->get_physics_interpolation_fraction();
 	uint32_t frame = Engine::get_singleton()->get_frames_drawn();
 
@@ -721,6 +724,8 @@ void SceneTreeFTI::frame_update(Node *p_root, bool p_frame_start) {
 
 	data.frame_xform_list_forced.clear();
 
+	RS::get_singleton()->end_instance_transform_batch();
+
 	if (!p_frame_start && data.periodic_debug_log) {
 		data.periodic_debug_log = false;
 	}
@@ -33,6 +33,11 @@
 
 #include "core/io/marshalls.h"
 
+#if (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(REAL_T_IS_DOUBLE)
+#define ANIMATION_SAMPLE_SSE2_ENABLED
+#include <emmintrin.h>
+#endif
+
 bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 	String prop_name = p_name;
 
@@ -5319,26 +5324,312 @@ bool Animation::_blend_shape_interpolate_compressed(uint32_t p_compressed_track,
 	return true;
 }
 
+int32_t Animation::_find_compressed_page(double p_time) const {
+	int32_t page_index = -1;
+	for (uint32_t i = 0; i < compression.pages.size(); i++) {
+		if (compression.pages[i].time_offset > p_time) {
+			break;
+		}
+		page_index = i;
+	}
+	return page_index;
+}
+
+typedef Animation::TransformTrackSamples TransformTrackSamples;
+
+// Dequantizes the keys of position and scale tracks and interpolates them, writing the result to the "from" lanes.
+static void _interpolate_pos_scale_lanes(real_t *const *p_lanes, uint32_t p_count) {
+	uint32_t i = 0;
+#ifdef ANIMATION_SAMPLE_SSE2_ENABLED
+	const __m128 range = _mm_set1_ps(65535.0f);
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 weight = _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_WEIGHT] + i);
+		for (int c = 0; c < 3; c++) {
+			__m128 bounds_position = _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_BOUNDS_POSITION_X + c] + i);
+			__m128 bounds_size = _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_BOUNDS_SIZE_X + c] + i);
+			__m128 from = _mm_add_ps(bounds_position, _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_FROM_X + c] + i), range), bounds_size));
+			__m128 to = _mm_add_ps(bounds_position, _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_TO_X + c] + i), range), bounds_size));
+			_mm_storeu_ps(p_lanes[TransformTrackSamples::LANE_FROM_X + c] + i, _mm_add_ps(from, _mm_mul_ps(weight, _mm_sub_ps(to, from))));
+		}
+	}
+#endif // ANIMATION_SAMPLE_SSE2_ENABLED
+	for (; i < p_count; i++) {
+		real_t weight = p_lanes[TransformTrackSamples::LANE_WEIGHT][i];
+		for (int c = 0; c < 3; c++) {
+			real_t bounds_position = p_lanes[TransformTrackSamples::LANE_BOUNDS_POSITION_X + c][i];
+			real_t bounds_size = p_lanes[TransformTrackSamples::LANE_BOUNDS_SIZE_X + c][i];
+			real_t from = bounds_position + (p_lanes[TransformTrackSamples::LANE_FROM_X + c][i] / (real_t)65535.0) * bounds_size;
+			real_t to = bounds_position + (p_lanes[TransformTrackSamples::LANE_TO_X + c][i] / (real_t)65535.0) * bounds_size;
+			p_lanes[TransformTrackSamples::LANE_FROM_X + c][i] = Math::lerp(from, to, weight);
+		}
+	}
+}
+
+// Dequantizes rotation keys starting at lane p_base: x and y hold the octahedron encoded axis, z the angle.
+// Writes the decoded axis to x, y and z and the angle to w.
+static void _decode_rotation_lanes(real_t *const *p_lanes, int p_base, uint32_t p_count) {
+	real_t *lx = p_lanes[p_base + 0];
+	real_t *ly = p_lanes[p_base + 1];
+	real_t *lz = p_lanes[p_base + 2];
+	real_t *lw = p_lanes[p_base + 3];
+	uint32_t i = 0;
+#ifdef ANIMATION_SAMPLE_SSE2_ENABLED
+	const __m128 range = _mm_set1_ps(65535.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 tau = _mm_set1_ps((float)Math::TAU);
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 fx = _mm_sub_ps(_mm_mul_ps(_mm_div_ps(_mm_loadu_ps(lx + i), range), two), one);
+		__m128 fy = _mm_sub_ps(_mm_mul_ps(_mm_div_ps(_mm_loadu_ps(ly + i), range), two), one);
+		__m128 angle = _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(lz + i), range), tau);
+		__m128 nz = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, fx)), _mm_andnot_ps(sign_mask, fy));
+		__m128 t = _mm_min_ps(_mm_max_ps(_mm_xor_ps(nz, sign_mask), zero), one);
+		__m128 neg_t = _mm_xor_ps(t, sign_mask);
+		__m128 x_positive = _mm_cmpge_ps(fx, zero);
+		__m128 y_positive = _mm_cmpge_ps(fy, zero);
+		__m128 nx = _mm_add_ps(fx, _mm_or_ps(_mm_and_ps(x_positive, neg_t), _mm_andnot_ps(x_positive, t)));
+		__m128 ny = _mm_add_ps(fy, _mm_or_ps(_mm_and_ps(y_positive, neg_t), _mm_andnot_ps(y_positive, t)));
+		// Never zero, see Vector3::octahedron_decode().
+		__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+		_mm_storeu_ps(lx + i, _mm_div_ps(nx, len));
+		_mm_storeu_ps(ly + i, _mm_div_ps(ny, len));
+		_mm_storeu_ps(lz + i, _mm_div_ps(nz, len));
+		_mm_storeu_ps(lw + i, angle);
+	}
+#endif // ANIMATION_SAMPLE_SSE2_ENABLED
+	for (; i < p_count; i++) {
+		Vector3 axis = Vector3::octahedron_decode(Vector2(lx[i] / (real_t)65535.0, ly[i] / (real_t)65535.0));
+		lw[i] = (lz[i] / (real_t)65535.0) * (real_t)Math::TAU;
+		lx[i] = axis.x;
+		ly[i] = axis.y;
+		lz[i] = axis.z;
+	}
+}
+
+// Same as Quaternion::slerp(), with the result written to the "from" lanes. Only the coefficients are computed one by one.
+static void _slerp_rotation_lanes(real_t *const *p_lanes, uint32_t p_count) {
+	uint32_t i = 0;
+#ifdef ANIMATION_SAMPLE_SSE2_ENABLED
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 cosine = _mm_setzero_ps();
+		for (int c = 0; c < 4; c++) {
+			cosine = _mm_add_ps(cosine, _mm_mul_ps(_mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_FROM_X + c] + i), _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_TO_X + c] + i)));
+		}
+		// Flip the target to take the shortest path.
+		__m128 flip = _mm_and_ps(_mm_cmplt_ps(cosine, zero), sign_mask);
+		for (int c = 0; c < 4; c++) {
+			_mm_storeu_ps(p_lanes[TransformTrackSamples::LANE_TO_X + c] + i, _mm_xor_ps(_mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_TO_X + c] + i), flip));
+		}
+		_mm_storeu_ps(p_lanes[TransformTrackSamples::LANE_COSINE] + i, _mm_xor_ps(cosine, flip));
+	}
+#endif // ANIMATION_SAMPLE_SSE2_ENABLED
+	for (; i < p_count; i++) {
+		real_t cosine = 0;
+		for (int c = 0; c < 4; c++) {
+			cosine += p_lanes[TransformTrackSamples::LANE_FROM_X + c][i] * p_lanes[TransformTrackSamples::LANE_TO_X + c][i];
+		}
+		if (cosine < 0.0f) {
+			cosine = -cosine;
+			for (int c = 0; c < 4; c++) {
+				p_lanes[TransformTrackSamples::LANE_TO_X + c][i] = -p_lanes[TransformTrackSamples::LANE_TO_X + c][i];
+			}
+		}
+		p_lanes[TransformTrackSamples::LANE_COSINE][i] = cosine;
+	}
+
+	for (i = 0; i < p_count; i++) {
+		real_t cosine = p_lanes[TransformTrackSamples::LANE_COSINE][i];
+		real_t weight = p_lanes[TransformTrackSamples::LANE_WEIGHT][i];
+		if ((1.0f - cosine) > (real_t)CMP_EPSILON) {
+			real_t omega = Math::acos(cosine);
+			real_t sinom = Math::sin(omega);
+			p_lanes[TransformTrackSamples::LANE_SCALE_FROM][i] = Math::sin((1.0 - weight) * omega) / sinom;
+			p_lanes[TransformTrackSamples::LANE_SCALE_TO][i] = Math::sin(weight * omega) / sinom;
+		} else {
+			p_lanes[TransformTrackSamples::LANE_SCALE_FROM][i] = 1.0f - weight;
+			p_lanes[TransformTrackSamples::LANE_SCALE_TO][i] = weight;
+		}
+	}
+
+	i = 0;
+#ifdef ANIMATION_SAMPLE_SSE2_ENABLED
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 scale_from = _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_SCALE_FROM] + i);
+		__m128 scale_to = _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_SCALE_TO] + i);
+		for (int c = 0; c < 4; c++) {
+			__m128 from = _mm_mul_ps(scale_from, _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_FROM_X + c] + i));
+			__m128 to = _mm_mul_ps(scale_to, _mm_loadu_ps(p_lanes[TransformTrackSamples::LANE_TO_X + c] + i));
+			_mm_storeu_ps(p_lanes[TransformTrackSamples::LANE_FROM_X + c] + i, _mm_add_ps(from, to));
+		}
+	}
+#endif // ANIMATION_SAMPLE_SSE2_ENABLED
+	for (; i < p_count; i++) {
+		real_t scale_from = p_lanes[TransformTrackSamples::LANE_SCALE_FROM][i];
+		real_t scale_to = p_lanes[TransformTrackSamples::LANE_SCALE_TO][i];
+		for (int c = 0; c < 4; c++) {
+			p_lanes[TransformTrackSamples::LANE_FROM_X + c][i] = scale_from * p_lanes[TransformTrackSamples::LANE_FROM_X + c][i] + scale_to * p_lanes[TransformTrackSamples::LANE_TO_X + c][i];
+		}
+	}
+}
+
+bool Animation::sample_compressed_transform_tracks(double p_time, TransformTrackSamples &r_samples) const {
+	if (!compression.enabled) {
+		return false;
+	}
+
+	uint32_t track_count = tracks.size();
+	r_samples.x.resize(track_count);
+	r_samples.y.resize(track_count);
+	r_samples.z.resize(track_count);
+	r_samples.w.resize(track_count);
+	r_samples.valid.resize(track_count);
+	memset(r_samples.valid.ptr(), 0, track_count);
+
+	p_time = CLAMP(p_time, 0, length);
+	int32_t page_index = _find_compressed_page(p_time);
+	ERR_FAIL_COND_V(page_index == -1, false); //should not happen
+
+	TransformTrackSamples::Lanes &pos_scale = r_samples.pos_scale;
+	TransformTrackSamples::Lanes &rotation = r_samples.rotation;
+	pos_scale.tracks.clear();
+	rotation.tracks.clear();
+	for (int i = 0; i < TransformTrackSamples::LANE_MAX; i++) {
+		pos_scale.lanes[i].clear();
+		rotation.lanes[i].clear();
+	}
+
+	// Fetch the keys around p_time. The delta bit stream of each track can only be read sequentially, so this part is done track by track.
+	for (uint32_t i = 0; i < track_count; i++) {
+		const Track *t = tracks[i];
+		int32_t compressed_track = -1;
+		TransformTrackSamples::Lanes *lanes = nullptr;
+		switch (t->type) {
+			case TYPE_POSITION_3D: {
+				compressed_track = static_cast<const PositionTrack *>(t)->compressed_track;
+				lanes = &pos_scale;
+			} break;
+			case TYPE_ROTATION_3D: {
+				compressed_track = static_cast<const RotationTrack *>(t)->compressed_track;
+				lanes = &rotation;
+			} break;
+			case TYPE_SCALE_3D: {
+				compressed_track = static_cast<const ScaleTrack *>(t)->compressed_track;
+				lanes = &pos_scale;
+			} break;
+			default: {
+			} break;
+		}
+		if (compressed_track < 0) {
+			continue;
+		}
+
+		Vector3i current;
+		Vector3i next;
+		double time_current;
+		double time_next;
+		if (!_fetch_compressed_in_page<3>(page_index, compressed_track, p_time, current, time_current, next, time_next)) {
+			continue;
+		}
+
+		// Keys outside of the interpolation range use a single key, like _pos_scale_interpolate_compressed() and _rotation_interpolate_compressed().
+		real_t weight = 0.0;
+		if (time_current >= p_time || time_current == time_next) {
+			next = current;
+		} else if (p_time >= time_next) {
+			current = next;
+		} else {
+			weight = (p_time - time_current) / (time_next - time_current);
+		}
+
+		lanes->tracks.push_back(i);
+		for (int c = 0; c < 3; c++) {
+			lanes->lanes[TransformTrackSamples::LANE_FROM_X + c].push_back(current[c]);
+			lanes->lanes[TransformTrackSamples::LANE_TO_X + c].push_back(next[c]);
+		}
+		lanes->lanes[TransformTrackSamples::LANE_WEIGHT].push_back(weight);
+		if (lanes == &pos_scale) {
+			const AABB &bounds = compression.bounds[compressed_track];
+			for (int c = 0; c < 3; c++) {
+				pos_scale.lanes[TransformTrackSamples::LANE_BOUNDS_POSITION_X + c].push_back(bounds.position[c]);
+				pos_scale.lanes[TransformTrackSamples::LANE_BOUNDS_SIZE_X + c].push_back(bounds.size[c]);
+			}
+		}
+	}
+
+	real_t *lanes_ptr[TransformTrackSamples::LANE_MAX];
+
+	uint32_t pos_scale_count = pos_scale.tracks.size();
+	for (int i = 0; i < TransformTrackSamples::LANE_MAX; i++) {
+		lanes_ptr[i] = pos_scale.lanes[i].ptr();
+	}
+	_interpolate_pos_scale_lanes(lanes_ptr, pos_scale_count);
+	for (uint32_t i = 0; i < pos_scale_count; i++) {
+		uint32_t track = pos_scale.tracks[i];
+		r_samples.x[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_X][i];
+		r_samples.y[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_Y][i];
+		r_samples.z[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_Z][i];
+		r_samples.w[track] = 0.0;
+		r_samples.valid[track] = 1;
+	}
+
+	uint32_t rotation_count = rotation.tracks.size();
+	rotation.lanes[TransformTrackSamples::LANE_FROM_W].resize(rotation_count);
+	rotation.lanes[TransformTrackSamples::LANE_TO_W].resize(rotation_count);
+	rotation.lanes[TransformTrackSamples::LANE_COSINE].resize(rotation_count);
+	rotation.lanes[TransformTrackSamples::LANE_SCALE_FROM].resize(rotation_count);
+	rotation.lanes[TransformTrackSamples::LANE_SCALE_TO].resize(rotation_count);
+	for (int i = 0; i < TransformTrackSamples::LANE_MAX; i++) {
+		lanes_ptr[i] = rotation.lanes[i].ptr();
+	}
+	_decode_rotation_lanes(lanes_ptr, TransformTrackSamples::LANE_FROM_X, rotation_count);
+	_decode_rotation_lanes(lanes_ptr, TransformTrackSamples::LANE_TO_X, rotation_count);
+	// Axis-angle to quaternion, see _uncompress_quaternion().
+	for (int base : { (int)TransformTrackSamples::LANE_FROM_X, (int)TransformTrackSamples::LANE_TO_X }) {
+		for (uint32_t i = 0; i < rotation_count; i++) {
+			Quaternion q(Vector3(lanes_ptr[base + 0][i], lanes_ptr[base + 1][i], lanes_ptr[base + 2][i]), lanes_ptr[base + 3][i]);
+			lanes_ptr[base + 0][i] = q.x;
+			lanes_ptr[base + 1][i] = q.y;
+			lanes_ptr[base + 2][i] = q.z;
+			lanes_ptr[base + 3][i] = q.w;
+		}
+	}
+	_slerp_rotation_lanes(lanes_ptr, rotation_count);
+	for (uint32_t i = 0; i < rotation_count; i++) {
+		uint32_t track = rotation.tracks[i];
+		r_samples.x[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_X][i];
+		r_samples.y[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_Y][i];
+		r_samples.z[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_Z][i];
+		r_samples.w[track] = lanes_ptr[TransformTrackSamples::LANE_FROM_W][i];
+		r_samples.valid[track] = 1;
+	}
+
+	return true;
+}
+
 template <uint32_t COMPONENTS>
 bool Animation::_fetch_compressed(uint32_t p_compressed_track, double p_time, Vector3i &r_current_value, double &r_current_time, Vector3i &r_next_value, double &r_next_time, uint32_t *key_index) const {
 	ERR_FAIL_COND_V(!compression.enabled, false);
 	ERR_FAIL_UNSIGNED_INDEX_V(p_compressed_track, compression.bounds.size(), false);
 	p_time = CLAMP(p_time, 0, length);
+
+	int32_t page_index = _find_compressed_page(p_time);
+	ERR_FAIL_COND_V(page_index == -1, false); //should not happen
+
+	return _fetch_compressed_in_page<COMPONENTS>(page_index, p_compressed_track, p_time, r_current_value, r_current_time, r_next_value, r_next_time, key_index);
+}
+
+template <uint32_t COMPONENTS>
+bool Animation::_fetch_compressed_in_page(uint32_t p_page, uint32_t p_compressed_track, double p_time, Vector3i &r_current_value, double &r_current_time, Vector3i &r_next_value, double &r_next_time, uint32_t *key_index) const {
 	if (key_index) {
 		*key_index = 0;
 	}
 
 	double frame_to_sec = 1.0 / double(compression.fps);
-
-	int32_t page_index = -1;
-	for (uint32_t i = 0; i < compression.pages.size(); i++) {
-		if (compression.pages[i].time_offset > p_time) {
-			break;
-		}
-		page_index = i;
-	}
-
-	ERR_FAIL_COND_V(page_index == -1, false); //should not happen
+	uint32_t page_index = p_page;
 
 	double page_base_time = compression.pages[page_index].time_offset;
 	const uint8_t *page_data = compression.pages[page_index].data.ptr();
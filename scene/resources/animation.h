@@ -104,6 +104,51 @@ public:
 	};
 #endif // TOOLS_ENABLED
 
+	// Output of sample_compressed_transform_tracks(), indexed by track.
+	// Position and scale tracks write x, y and z, rotation tracks write the quaternion to x, y, z and w.
+	struct TransformTrackSamples {
+		enum Lane {
+			LANE_FROM_X,
+			LANE_FROM_Y,
+			LANE_FROM_Z,
+			LANE_FROM_W,
+			LANE_TO_X,
+			LANE_TO_Y,
+			LANE_TO_Z,
+			LANE_TO_W,
+			LANE_WEIGHT,
+			LANE_BOUNDS_POSITION_X,
+			LANE_BOUNDS_POSITION_Y,
+			LANE_BOUNDS_POSITION_Z,
+			LANE_BOUNDS_SIZE_X,
+			LANE_BOUNDS_SIZE_Y,
+			LANE_BOUNDS_SIZE_Z,
+			LANE_COSINE,
+			LANE_SCALE_FROM,
+			LANE_SCALE_TO,
+			LANE_MAX
+		};
+
+		// Scratch space reused between calls, one element per sampled track in each lane.
+		struct Lanes {
+			LocalVector<uint32_t> tracks;
+			LocalVector<real_t> lanes[LANE_MAX];
+		};
+
+		LocalVector<real_t> x;
+		LocalVector<real_t> y;
+		LocalVector<real_t> z;
+		LocalVector<real_t> w;
+		LocalVector<uint8_t> valid;
+
+		Lanes pos_scale;
+		Lanes rotation;
+
+		_FORCE_INLINE_ bool is_sampled(int p_track) const { return (uint32_t)p_track < valid.size() && valid[p_track]; }
+		_FORCE_INLINE_ Vector3 get_vector3(int p_track) const { return Vector3(x[p_track], y[p_track], z[p_track]); }
+		_FORCE_INLINE_ Quaternion get_quaternion(int p_track) const { return Quaternion(x[p_track], y[p_track], z[p_track], w[p_track]); }
+	};
+
 	struct Track {
 		TrackType type = TrackType::TYPE_ANIMATION;
 		InterpolationType interpolation = INTERPOLATION_LINEAR;
@@ -362,6 +407,9 @@ private:
 	template <uint32_t COMPONENTS>
 	bool _fetch_compressed(uint32_t p_compressed_track, double p_time, Vector3i &r_current_value, double &r_current_time, Vector3i &r_next_value, double &r_next_time, uint32_t *key_index = nullptr) const;
 	template <uint32_t COMPONENTS>
+	bool _fetch_compressed_in_page(uint32_t p_page, uint32_t p_compressed_track, double p_time, Vector3i &r_current_value, double &r_current_time, Vector3i &r_next_value, double &r_next_time, uint32_t *key_index = nullptr) const;
+	int32_t _find_compressed_page(double p_time) const;
+	template <uint32_t COMPONENTS>
 	bool _fetch_compressed_by_index(uint32_t p_compressed_track, int p_index, Vector3i &r_value, double &r_time) const;
 	int _get_compressed_key_count(uint32_t p_compressed_track) const;
 	template <uint32_t COMPONENTS>
@@ -462,6 +510,10 @@ public:
 	Error try_scale_track_interpolate(int p_track, double p_time, Vector3 *r_interpolation, bool p_backward = false) const;
 	Vector3 scale_track_interpolate(int p_track, double p_time, bool p_backward = false) const;
 
+	// Samples all compressed position, rotation and scale tracks at once, sharing the page lookup and
+	// interpolating the tracks together. Returns false if the animation is not compressed.
+	bool sample_compressed_transform_tracks(double p_time, TransformTrackSamples &r_samples) const;
+
 	int blend_shape_track_insert_key(int p_track, double p_time, float p_blend);
 	Error blend_shape_track_get_key(int p_track, int p_key, float *r_blend) const;
 	Error try_blend_shape_track_interpolate(int p_track, double p_time, float *r_blend, bool p_backward = false) const;
@@ -0,0 +1,295 @@
+/**************************************************************************/
+/*  audio_decode_ahead.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_decode_ahead.h"
+
+#include "core/math/math_funcs.h"
+
+bool AudioDecodeAheadBuffer::_fill(uint32_t p_max_chunks) {
+	uint64_t current_request = request.load(std::memory_order_acquire);
+	uint32_t generation = _get_request_generation(current_request);
+	if (generation != decode_generation) {
+		seek_func(decode_userdata, uint32_t(current_request & REQUEST_POSITION_MASK), (current_request & REQUEST_RESTART) != 0);
+		decode_generation = generation;
+		decoding_finished = false;
+		acknowledged_generation.store(generation, std::memory_order_release);
+	}
+
+	uint32_t write = write_index.load(std::memory_order_relaxed);
+	for (uint32_t filled = 0; filled < p_max_chunks; filled++) {
+		if (decoding_finished || write - read_index.load(std::memory_order_acquire) >= chunks.size()) {
+			return false;
+		}
+
+		Chunk &chunk = chunks[write & chunk_mask];
+		int decoded = decode_func(decode_userdata, chunk.frames, CHUNK_FRAMES, chunk.end_position, chunk.loops);
+		chunk.frame_count = CLAMP(decoded, 0, (int)CHUNK_FRAMES);
+		chunk.end_of_stream = chunk.frame_count < CHUNK_FRAMES;
+		chunk.generation = decode_generation;
+		decoding_finished = chunk.end_of_stream;
+
+		write++;
+		write_index.store(write, std::memory_order_release);
+	}
+
+	return !decoding_finished && write - read_index.load(std::memory_order_acquire) < chunks.size();
+}
+
+void AudioDecodeAheadBuffer::setup(DecodeFunc p_decode_func, SeekFunc p_seek_func, void *p_userdata, uint32_t p_frames) {
+	ERR_FAIL_COND_MSG(is_enabled(), "Decode-ahead buffer is already set up.");
+	ERR_FAIL_NULL(p_decode_func);
+	ERR_FAIL_NULL(p_seek_func);
+
+	uint32_t chunk_count = next_power_of_2(MAX(p_frames / CHUNK_FRAMES, uint32_t(MIN_CHUNKS)));
+	chunks.resize(chunk_count);
+	chunk_mask = chunk_count - 1;
+
+	decode_func = p_decode_func;
+	seek_func = p_seek_func;
+	decode_userdata = p_userdata;
+	AudioDecodeAheadThread::add_buffer(this);
+}
+
+void AudioDecodeAheadBuffer::request_restart(uint32_t p_position, bool p_restart) {
+	uint64_t current_request = request.load(std::memory_order_relaxed);
+	uint64_t next_request;
+	do {
+		uint32_t generation = _get_request_generation(current_request);
+		uint64_t flags = p_restart ? REQUEST_RESTART : 0;
+		if (generation != acknowledged_generation.load(std::memory_order_acquire)) {
+			// A start that wasn't seen by the decode thread yet must not be lost to a seek replacing it.
+			flags |= current_request & REQUEST_RESTART;
+		}
+		next_request = (uint64_t(generation + 1) << 32) | flags | MIN(uint64_t(p_position), REQUEST_POSITION_MASK);
+	} while (!request.compare_exchange_weak(current_request, next_request, std::memory_order_release, std::memory_order_relaxed));
+
+	AudioDecodeAheadThread::wake();
+}
+
+int AudioDecodeAheadBuffer::mix(AudioFrame *p_buffer, int p_frames) {
+	uint64_t current_request = request.load(std::memory_order_acquire);
+	if (_get_request_generation(current_request) != read_generation) {
+		read_generation = _get_request_generation(current_request);
+		read_offset = 0;
+		position = uint32_t(current_request & REQUEST_POSITION_MASK);
+		if (current_request & REQUEST_RESTART) {
+			loops = 0;
+		}
+		finished = false;
+	}
+
+	int mixed = 0;
+	uint32_t read = read_index.load(std::memory_order_relaxed);
+
+	while (mixed < p_frames && !finished) {
+		if (read == write_index.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		const Chunk &chunk = chunks[read & chunk_mask];
+		if (chunk.generation != read_generation) {
+			if (int32_t(chunk.generation - read_generation) > 0) {
+				// Decoded for a request posted after this call started, it's used next time.
+				break;
+			}
+			// Decoded before the last seek, drop it.
+			read_offset = 0;
+			read++;
+			read_index.store(read, std::memory_order_release);
+			continue;
+		}
+
+		uint32_t to_copy = MIN(chunk.frame_count - read_offset, uint32_t(p_frames - mixed));
+		memcpy(&p_buffer[mixed], &chunk.frames[read_offset], to_copy * sizeof(AudioFrame));
+		mixed += to_copy;
+		read_offset += to_copy;
+
+		uint32_t remaining = chunk.frame_count - read_offset;
+		// Positions are only known at chunk boundaries. A loop inside the chunk makes this off by less than a chunk.
+		position = chunk.end_position > remaining ? chunk.end_position - remaining : 0;
+		loops = chunk.loops;
+
+		if (remaining == 0) {
+			finished = chunk.end_of_stream;
+			read_offset = 0;
+			read++;
+			read_index.store(read, std::memory_order_release);
+		}
+	}
+
+	if (finished) {
+		for (int i = mixed; i < p_frames; i++) {
+			p_buffer[i] = AudioFrame(0, 0);
+		}
+		return mixed;
+	}
+
+	if (mixed < p_frames) {
+		// The decode thread fell behind, or hasn't caught up with a seek yet. Keep the stream going.
+		underruns++;
+		for (int i = mixed; i < p_frames; i++) {
+			p_buffer[i] = AudioFrame(0, 0);
+		}
+	}
+
+	if (write_index.load(std::memory_order_relaxed) - read <= chunks.size() / 2) {
+		AudioDecodeAheadThread::wake();
+	}
+
+	return p_frames;
+}
+
+AudioDecodeAheadBuffer::~AudioDecodeAheadBuffer() {
+	if (is_enabled()) {
+		AudioDecodeAheadThread::remove_buffer(this);
+	}
+}
+
+Thread AudioDecodeAheadThread::thread;
+Semaphore AudioDecodeAheadThread::semaphore;
+SafeFlag AudioDecodeAheadThread::exit_thread;
+SafeFlag AudioDecodeAheadThread::running;
+Mutex AudioDecodeAheadThread::mutex;
+LocalVector<AudioDecodeAheadBuffer *> AudioDecodeAheadThread::buffers;
+LocalVector<AudioDecodeAheadThread::Job> AudioDecodeAheadThread::jobs;
+double AudioDecodeAheadThread::buffer_time = 0.0;
+
+void AudioDecodeAheadThread::_thread_func(void *p_userdata) {
+	LocalVector<AudioDecodeAheadBuffer *> to_fill;
+
+	while (true) {
+		semaphore.wait();
+
+		bool pending = true;
+		while (pending && !exit_thread.is_set()) {
+			pending = false;
+
+			Job job;
+			{
+				MutexLock lock(mutex);
+				to_fill = buffers;
+				if (!jobs.is_empty()) {
+					job = jobs[0];
+					jobs.remove_at(0);
+				}
+			}
+
+			// Buffers are filled a few chunks at a time, so one stream decoding never holds back the others, and
+			// the list lock is only held to check that the buffer wasn't removed in the meantime.
+			for (AudioDecodeAheadBuffer *buffer : to_fill) {
+				mutex.lock();
+				if (buffers.find(buffer) < 0) {
+					mutex.unlock();
+					continue;
+				}
+				buffer->mutex.lock();
+				mutex.unlock();
+
+				pending = buffer->_fill(AudioDecodeAheadBuffer::FILL_CHUNKS) || pending;
+				buffer->mutex.unlock();
+			}
+
+			if (job.func) {
+				job.func(job.userdata);
+				pending = true;
+			}
+		}
+
+		if (exit_thread.is_set()) {
+			break;
+		}
+	}
+}
+
+void AudioDecodeAheadThread::add_buffer(AudioDecodeAheadBuffer *p_buffer) {
+	MutexLock lock(mutex);
+	buffers.push_back(p_buffer);
+}
+
+void AudioDecodeAheadThread::remove_buffer(AudioDecodeAheadBuffer *p_buffer) {
+	{
+		MutexLock lock(mutex);
+		buffers.erase(p_buffer);
+	}
+	// The thread only starts filling a buffer while holding the list lock, so once it's out of the list,
+	// waiting for the fill in progress (if any) is enough.
+	MutexLock buffer_lock(p_buffer->mutex);
+}
+
+void AudioDecodeAheadThread::queue_job(JobFunc p_func, const Ref<RefCounted> &p_userdata) {
+	ERR_FAIL_COND(!running.is_set());
+	{
+		MutexLock lock(mutex);
+		Job job;
+		job.func = p_func;
+		job.userdata = p_userdata;
+		jobs.push_back(job);
+	}
+	semaphore.post();
+}
+
+void AudioDecodeAheadThread::wake() {
+	if (running.is_set()) {
+		semaphore.post();
+	}
+}
+
+bool AudioDecodeAheadThread::is_running() {
+	return running.is_set();
+}
+
+uint32_t AudioDecodeAheadThread::get_buffer_frames(double p_sample_rate) {
+	return uint32_t(buffer_time * p_sample_rate);
+}
+
+void AudioDecodeAheadThread::init(double p_buffer_time) {
+	buffer_time = p_buffer_time;
+#ifdef THREADS_ENABLED
+	if (running.is_set() || buffer_time <= 0.0) {
+		return;
+	}
+	exit_thread.clear();
+	running.set();
+	thread.start(&AudioDecodeAheadThread::_thread_func, nullptr);
+#endif
+}
+
+void AudioDecodeAheadThread::finish() {
+	if (!running.is_set()) {
+		return;
+	}
+	exit_thread.set();
+	semaphore.post();
+	thread.wait_to_finish();
+	running.clear();
+
+	MutexLock lock(mutex);
+	jobs.clear();
+}
@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  audio_decode_ahead.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/audio_frame.h"
+#include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+#include <atomic>
+
+// Ring of decoded frames filled ahead of the mixer by the decode thread, so long compressed streams
+// don't decode on the audio thread. The decoder is only ever used by the decode thread.
+// The ring has a single producer (the decode thread) and a single consumer (the mixer), neither takes a lock to use it.
+// Starting and seeking are posted as requests: the decode thread seeks the decoder and tags the chunks it decodes
+// afterwards with the request generation, the reader drops every chunk decoded before the request.
+class AudioDecodeAheadBuffer {
+public:
+	// Decodes up to p_frames frames, returning how many were decoded (fewer means the stream ended).
+	// r_position is the position of the decoder after the call, in frames, and r_loops its loop count.
+	typedef int (*DecodeFunc)(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops);
+	// Moves the decoder to p_position frames. p_restart is set for AudioStreamPlayback::start(), which also resets loops.
+	typedef void (*SeekFunc)(void *p_userdata, uint32_t p_position, bool p_restart);
+
+private:
+	friend class AudioDecodeAheadThread;
+
+	enum {
+		CHUNK_FRAMES = 256,
+		MIN_CHUNKS = 8,
+		// Chunks decoded per buffer before the decode thread moves on to the next one.
+		FILL_CHUNKS = 4,
+	};
+
+	// Requests are packed in a single 64-bit word so they are posted and read atomically:
+	// the generation in the high half, then the restart flag and the position in frames.
+	static constexpr uint64_t REQUEST_RESTART = uint64_t(1) << 31;
+	static constexpr uint64_t REQUEST_POSITION_MASK = REQUEST_RESTART - 1;
+
+	struct Chunk {
+		AudioFrame frames[CHUNK_FRAMES];
+		uint32_t frame_count = 0;
+		uint32_t end_position = 0;
+		int loops = 0;
+		uint32_t generation = 0;
+		bool end_of_stream = false;
+	};
+
+	DecodeFunc decode_func = nullptr;
+	SeekFunc seek_func = nullptr;
+	void *decode_userdata = nullptr;
+	// Held by the decode thread while it uses the decoder, for at most FILL_CHUNKS chunks.
+	Mutex mutex;
+
+	LocalVector<Chunk> chunks;
+	uint32_t chunk_mask = 0;
+	// Both indices only ever increase, chunks are accessed with `index & chunk_mask`.
+	std::atomic<uint32_t> read_index = 0;
+	std::atomic<uint32_t> write_index = 0;
+	std::atomic<uint64_t> request = 0;
+	// Last generation the decode thread seeked to.
+	std::atomic<uint32_t> acknowledged_generation = 0;
+
+	// Only accessed by the decode thread.
+	uint32_t decode_generation = 0;
+	bool decoding_finished = true;
+
+	// Only accessed by the reader.
+	uint32_t read_generation = 0;
+	uint32_t read_offset = 0;
+	uint32_t position = 0;
+	int loops = 0;
+	bool finished = false;
+	uint32_t underruns = 0;
+
+	static _FORCE_INLINE_ uint32_t _get_request_generation(uint64_t p_request) { return uint32_t(p_request >> 32); }
+
+	// Applies the latest request and decodes up to p_max_chunks chunks. Called by the decode thread with the mutex held.
+	// Returns true if there is room left for more.
+	bool _fill(uint32_t p_max_chunks);
+
+public:
+	// Allocates a ring holding about p_frames frames and registers it with the decode thread.
+	// Nothing is decoded until the first request_restart().
+	void setup(DecodeFunc p_decode_func, SeekFunc p_seek_func, void *p_userdata, uint32_t p_frames);
+	_FORCE_INLINE_ bool is_enabled() const { return decode_func != nullptr; }
+
+	// Taken by the decode thread while it decodes, lock it to wait until it is done with the decoder.
+	_FORCE_INLINE_ Mutex &get_mutex() { return mutex; }
+
+	// Asks the decode thread to seek the decoder to p_position and drops everything decoded before. Never blocks,
+	// so it can be called from any thread, including the audio thread. Until the new frames arrive, mix() outputs silence.
+	void request_restart(uint32_t p_position, bool p_restart);
+
+	// Copies decoded frames, returning fewer than p_frames once the stream ended. Frames missing because the
+	// decode thread fell behind are replaced by silence.
+	int mix(AudioFrame *p_buffer, int p_frames);
+
+	_FORCE_INLINE_ uint32_t get_position() const { return position; }
+	_FORCE_INLINE_ int get_loops() const { return loops; }
+	_FORCE_INLINE_ bool is_finished() const { return finished; }
+	_FORCE_INLINE_ uint32_t get_underruns() const { return underruns; }
+
+	~AudioDecodeAheadBuffer();
+};
+
+// Background thread filling every registered AudioDecodeAheadBuffer a few chunks at a time, and running jobs
+// such as decoding whole streams for AudioDecodeCache. It sleeps until a reader consumed half of its ring.
+class AudioDecodeAheadThread {
+public:
+	typedef void (*JobFunc)(const Ref<RefCounted> &p_userdata);
+
+private:
+	struct Job {
+		JobFunc func = nullptr;
+		Ref<RefCounted> userdata;
+	};
+
+	static Thread thread;
+	static Semaphore semaphore;
+	static SafeFlag exit_thread;
+	static SafeFlag running;
+	// Protects the lists below. Never held while decoding.
+	static Mutex mutex;
+	static LocalVector<AudioDecodeAheadBuffer *> buffers;
+	static LocalVector<Job> jobs;
+	static double buffer_time;
+
+	static void _thread_func(void *p_userdata);
+
+public:
+	static void add_buffer(AudioDecodeAheadBuffer *p_buffer);
+	// Once this returns, the decode thread no longer uses the buffer or its decoder.
+	static void remove_buffer(AudioDecodeAheadBuffer *p_buffer);
+	static void queue_job(JobFunc p_func, const Ref<RefCounted> &p_userdata);
+	static void wake();
+
+	// Without the thread (no thread support or disabled), buffers are never set up and streams decode on the audio thread.
+	static bool is_running();
+	// How many frames of a stream at p_sample_rate to decode ahead.
+	static uint32_t get_buffer_frames(double p_sample_rate);
+
+	static void init(double p_buffer_time);
+	static void finish();
+};
@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  audio_decode_cache.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_decode_cache.h"
+
+Mutex AudioDecodeCache::mutex;
+LRUCache<ObjectID, Vector<AudioFrame>> AudioDecodeCache::cache(INT_MAX);
+HashSet<ObjectID> AudioDecodeCache::pending;
+uint64_t AudioDecodeCache::memory_used = 0;
+uint64_t AudioDecodeCache::memory_budget = 0;
+double AudioDecodeCache::max_length = 0.0;
+
+void AudioDecodeCache::_erase(ObjectID p_stream) {
+	const Vector<AudioFrame> *frames = cache.getptr(p_stream);
+	if (!frames) {
+		return;
+	}
+	memory_used -= frames->size() * sizeof(AudioFrame);
+	cache.erase(p_stream);
+}
+
+void AudioDecodeCache::_evict(uint64_t p_budget) {
+	while (memory_used > p_budget) {
+		const LRUCache<ObjectID, Vector<AudioFrame>>::Pair *lru = cache.get_least_recently_used();
+		ERR_FAIL_NULL(lru);
+		_erase(lru->key);
+	}
+}
+
+void AudioDecodeCache::set_limits(double p_max_length, uint64_t p_memory_budget) {
+	MutexLock lock(mutex);
+	max_length = p_max_length;
+	memory_budget = p_memory_budget;
+	_evict(memory_budget);
+}
+
+bool AudioDecodeCache::is_cacheable(double p_length) {
+	MutexLock lock(mutex);
+	return memory_budget > 0 && p_length > 0.0 && p_length <= max_length;
+}
+
+bool AudioDecodeCache::get(ObjectID p_stream, Vector<AudioFrame> &r_frames) {
+	MutexLock lock(mutex);
+	const Vector<AudioFrame> *frames = cache.getptr(p_stream);
+	if (!frames) {
+		return false;
+	}
+	r_frames = *frames;
+	return true;
+}
+
+void AudioDecodeCache::_insert(ObjectID p_stream, const Vector<AudioFrame> &p_frames) {
+	uint64_t size = p_frames.size() * sizeof(AudioFrame);
+
+	_erase(p_stream);
+	if (p_frames.is_empty() || size > memory_budget) {
+		return;
+	}
+
+	_evict(memory_budget - size);
+	cache.insert(p_stream, p_frames);
+	memory_used += size;
+}
+
+void AudioDecodeCache::insert(ObjectID p_stream, const Vector<AudioFrame> &p_frames) {
+	MutexLock lock(mutex);
+	_insert(p_stream, p_frames);
+}
+
+bool AudioDecodeCache::begin_decode(ObjectID p_stream) {
+	MutexLock lock(mutex);
+	if (memory_budget == 0 || cache.has(p_stream) || pending.has(p_stream)) {
+		return false;
+	}
+	pending.insert(p_stream);
+	return true;
+}
+
+void AudioDecodeCache::finish_decode(ObjectID p_stream, const Vector<AudioFrame> &p_frames) {
+	MutexLock lock(mutex);
+	if (!pending.erase(p_stream)) {
+		// The stream changed or was freed while decoding.
+		return;
+	}
+	_insert(p_stream, p_frames);
+}
+
+void AudioDecodeCache::erase(ObjectID p_stream) {
+	MutexLock lock(mutex);
+	pending.erase(p_stream);
+	_erase(p_stream);
+}
+
+void AudioDecodeCache::clear() {
+	MutexLock lock(mutex);
+	cache.clear();
+	pending.clear();
+	memory_used = 0;
+}
+
+uint64_t AudioDecodeCache::get_memory_used() {
+	MutexLock lock(mutex);
+	return memory_used;
+}
@@ -0,0 +1,75 @@
+/**************************************************************************/
+/*  audio_decode_cache.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/audio_frame.h"
+#include "core/object/object_id.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/lru.h"
+#include "core/templates/vector.h"
+
+// Shared cache of fully decoded PCM for short compressed streams (Ogg Vorbis, MP3...).
+// Frames are decoded once, in the background by the decode thread, instead of once per voice on the audio thread.
+// Entries are copy-on-write vectors, so evicting one never frees frames still used by a playback.
+class AudioDecodeCache {
+	static Mutex mutex;
+	// Bounded by memory_budget, not by entry count.
+	static LRUCache<ObjectID, Vector<AudioFrame>> cache;
+	// Streams being decoded. Erasing a stream cancels its decode, so stale frames are never inserted.
+	static HashSet<ObjectID> pending;
+	static uint64_t memory_used;
+	static uint64_t memory_budget;
+	static double max_length;
+
+	static void _insert(ObjectID p_stream, const Vector<AudioFrame> &p_frames);
+	static void _erase(ObjectID p_stream);
+	static void _evict(uint64_t p_budget);
+
+public:
+	// Streams longer than p_max_length seconds are not cached. A budget of zero disables the cache.
+	static void set_limits(double p_max_length, uint64_t p_memory_budget);
+	static bool is_cacheable(double p_length);
+
+	static bool get(ObjectID p_stream, Vector<AudioFrame> &r_frames);
+	static void insert(ObjectID p_stream, const Vector<AudioFrame> &p_frames);
+
+	// Returns true if the caller should decode the stream and pass the frames to finish_decode(),
+	// false if it's already cached or being decoded.
+	static bool begin_decode(ObjectID p_stream);
+	static void finish_decode(ObjectID p_stream, const Vector<AudioFrame> &p_frames);
+
+	// Must be called when the data of a stream changes or when it's freed.
+	static void erase(ObjectID p_stream);
+	static void clear();
+
+	static uint64_t get_memory_used();
+};
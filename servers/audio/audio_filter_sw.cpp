@@ -32,6 +32,32 @@
 
 #include "core/math/math_funcs.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_FILTER_SSE2_ENABLED
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_FILTER_NEON_ENABLED
+#include <arm_neon.h>
+#endif
+
+#if defined(AUDIO_FILTER_SSE2_ENABLED)
+template <typename T>
+static _FORCE_INLINE_ void _store_lanes(__m128d p_vec, T &r_left, T &r_right) {
+	double lanes[2];
+	_mm_storeu_pd(lanes, p_vec);
+	r_left = lanes[0];
+	r_right = lanes[1];
+}
+#elif defined(AUDIO_FILTER_NEON_ENABLED)
+template <typename T>
+static _FORCE_INLINE_ void _store_lanes(float64x2_t p_vec, T &r_left, T &r_right) {
+	double lanes[2];
+	vst1q_f64(lanes, p_vec);
+	r_left = lanes[0];
+	r_right = lanes[1];
+}
+#endif
+
 void AudioFilterSW::set_mode(Mode p_mode) {
 	mode = p_mode;
 }
@@ -260,3 +286,112 @@ void AudioFilterSW::Processor::process(float *p_samples, int p_amount, int p_str
 		}
 	}
 }
+
+void AudioFilterSW::Processor::process_stereo(Processor *p_left, Processor *p_right, AudioFrame *p_frames, int p_amount, bool p_interpolate) {
+	if (!p_left->filter || !p_right->filter) {
+		p_left->process(&p_frames[0].left, p_amount, 2, p_interpolate);
+		p_right->process(&p_frames[0].right, p_amount, 2, p_interpolate);
+		return;
+	}
+
+	// Biquads are recursive, so the two channels are what can run side by side. Coefficients are doubles and
+	// history is rounded to float after every sample, exactly like process_one(), so the result is identical.
+#if defined(AUDIO_FILTER_SSE2_ENABLED)
+	__m128d b0 = _mm_setr_pd(p_left->coeffs.b0, p_right->coeffs.b0);
+	__m128d b1 = _mm_setr_pd(p_left->coeffs.b1, p_right->coeffs.b1);
+	__m128d b2 = _mm_setr_pd(p_left->coeffs.b2, p_right->coeffs.b2);
+	__m128d a1 = _mm_setr_pd(p_left->coeffs.a1, p_right->coeffs.a1);
+	__m128d a2 = _mm_setr_pd(p_left->coeffs.a2, p_right->coeffs.a2);
+	__m128d ha1 = _mm_setr_pd(p_left->ha1, p_right->ha1);
+	__m128d ha2 = _mm_setr_pd(p_left->ha2, p_right->ha2);
+	__m128d hb1 = _mm_setr_pd(p_left->hb1, p_right->hb1);
+	__m128d hb2 = _mm_setr_pd(p_left->hb2, p_right->hb2);
+
+	const __m128d incr_b0 = _mm_setr_pd(p_left->incr_coeffs.b0, p_right->incr_coeffs.b0);
+	const __m128d incr_b1 = _mm_setr_pd(p_left->incr_coeffs.b1, p_right->incr_coeffs.b1);
+	const __m128d incr_b2 = _mm_setr_pd(p_left->incr_coeffs.b2, p_right->incr_coeffs.b2);
+	const __m128d incr_a1 = _mm_setr_pd(p_left->incr_coeffs.a1, p_right->incr_coeffs.a1);
+	const __m128d incr_a2 = _mm_setr_pd(p_left->incr_coeffs.a2, p_right->incr_coeffs.a2);
+
+	for (int i = 0; i < p_amount; i++) {
+		__m128d pre = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i *)&p_frames[i])));
+		__m128d sum = _mm_mul_pd(pre, b0);
+		sum = _mm_add_pd(sum, _mm_mul_pd(hb1, b1));
+		sum = _mm_add_pd(sum, _mm_mul_pd(hb2, b2));
+		sum = _mm_add_pd(sum, _mm_mul_pd(ha1, a1));
+		sum = _mm_add_pd(sum, _mm_mul_pd(ha2, a2));
+		__m128 sample = _mm_cvtpd_ps(sum);
+		_mm_storel_epi64((__m128i *)&p_frames[i], _mm_castps_si128(sample));
+
+		ha2 = ha1;
+		hb2 = hb1;
+		hb1 = pre;
+		ha1 = _mm_cvtps_pd(sample);
+
+		if (p_interpolate) {
+			b0 = _mm_add_pd(b0, incr_b0);
+			b1 = _mm_add_pd(b1, incr_b1);
+			b2 = _mm_add_pd(b2, incr_b2);
+			a1 = _mm_add_pd(a1, incr_a1);
+			a2 = _mm_add_pd(a2, incr_a2);
+		}
+	}
+#elif defined(AUDIO_FILTER_NEON_ENABLED)
+	float64x2_t b0 = { p_left->coeffs.b0, p_right->coeffs.b0 };
+	float64x2_t b1 = { p_left->coeffs.b1, p_right->coeffs.b1 };
+	float64x2_t b2 = { p_left->coeffs.b2, p_right->coeffs.b2 };
+	float64x2_t a1 = { p_left->coeffs.a1, p_right->coeffs.a1 };
+	float64x2_t a2 = { p_left->coeffs.a2, p_right->coeffs.a2 };
+	float64x2_t ha1 = { p_left->ha1, p_right->ha1 };
+	float64x2_t ha2 = { p_left->ha2, p_right->ha2 };
+	float64x2_t hb1 = { p_left->hb1, p_right->hb1 };
+	float64x2_t hb2 = { p_left->hb2, p_right->hb2 };
+
+	const float64x2_t incr_b0 = { p_left->incr_coeffs.b0, p_right->incr_coeffs.b0 };
+	const float64x2_t incr_b1 = { p_left->incr_coeffs.b1, p_right->incr_coeffs.b1 };
+	const float64x2_t incr_b2 = { p_left->incr_coeffs.b2, p_right->incr_coeffs.b2 };
+	const float64x2_t incr_a1 = { p_left->incr_coeffs.a1, p_right->incr_coeffs.a1 };
+	const float64x2_t incr_a2 = { p_left->incr_coeffs.a2, p_right->incr_coeffs.a2 };
+
+	for (int i = 0; i < p_amount; i++) {
+		float64x2_t pre = vcvt_f64_f32(vld1_f32(&p_frames[i].left));
+		float64x2_t sum = vmulq_f64(pre, b0);
+		sum = vaddq_f64(sum, vmulq_f64(hb1, b1));
+		sum = vaddq_f64(sum, vmulq_f64(hb2, b2));
+		sum = vaddq_f64(sum, vmulq_f64(ha1, a1));
+		sum = vaddq_f64(sum, vmulq_f64(ha2, a2));
+		float32x2_t sample = vcvt_f32_f64(sum);
+		vst1_f32(&p_frames[i].left, sample);
+
+		ha2 = ha1;
+		hb2 = hb1;
+		hb1 = pre;
+		ha1 = vcvt_f64_f32(sample);
+
+		if (p_interpolate) {
+			b0 = vaddq_f64(b0, incr_b0);
+			b1 = vaddq_f64(b1, incr_b1);
+			b2 = vaddq_f64(b2, incr_b2);
+			a1 = vaddq_f64(a1, incr_a1);
+			a2 = vaddq_f64(a2, incr_a2);
+		}
+	}
+#endif
+
+#if defined(AUDIO_FILTER_SSE2_ENABLED) || defined(AUDIO_FILTER_NEON_ENABLED)
+	_store_lanes(ha1, p_left->ha1, p_right->ha1);
+	_store_lanes(ha2, p_left->ha2, p_right->ha2);
+	_store_lanes(hb1, p_left->hb1, p_right->hb1);
+	_store_lanes(hb2, p_left->hb2, p_right->hb2);
+	if (p_interpolate) {
+		_store_lanes(b0, p_left->coeffs.b0, p_right->coeffs.b0);
+		_store_lanes(b1, p_left->coeffs.b1, p_right->coeffs.b1);
+		_store_lanes(b2, p_left->coeffs.b2, p_right->coeffs.b2);
+		_store_lanes(a1, p_left->coeffs.a1, p_right->coeffs.a1);
+		_store_lanes(a2, p_left->coeffs.a2, p_right->coeffs.a2);
+	}
+#else
+	p_left->process(&p_frames[0].left, p_amount, 2, p_interpolate);
+	p_right->process(&p_frames[0].right, p_amount, 2, p_interpolate);
+#endif
+}
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/math/audio_frame.h"
 #include "core/typedefs.h"
 
 class AudioFilterSW {
@@ -69,6 +70,8 @@ public:
 		void update_coeffs(int p_interp_buffer_len = 0);
 		_ALWAYS_INLINE_ void process_one(float &p_sample);
 		_ALWAYS_INLINE_ void process_one_interp(float &p_sample);
+		// Filters the left and right channels of p_frames in place, in a single pass and using SIMD where available.
+		static void process_stereo(Processor *p_left, Processor *p_right, AudioFrame *p_frames, int p_amount, bool p_interpolate = false);
 
 		Processor();
 	};
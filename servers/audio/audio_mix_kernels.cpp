@@ -0,0 +1,535 @@
+/**************************************************************************/
+/*  audio_mix_kernels.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_mix_kernels.h"
+
+#include "core/string/print_string.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_MIX_SSE2_ENABLED
+#include <emmintrin.h>
+// AVX2 functions are compiled with a target attribute and only called after checking the CPU at runtime.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define AUDIO_MIX_AVX2_ENABLED
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define AUDIO_MIX_NEON_ENABLED
+#include <arm_neon.h>
+#endif
+
+/* Scalar */
+
+static void _mix_ramp_scalar(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	for (uint32_t i = 0; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] += (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _apply_ramp_scalar(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	for (uint32_t i = 0; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] = (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _accumulate_scalar(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	for (uint32_t i = 0; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+static AudioFrame _scale_and_peak_scalar(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) {
+	AudioFrame peak = AudioFrame(0, 0);
+	for (uint32_t i = 0; i < p_frames; i++) {
+		p_buffer[i] *= p_volume;
+
+		float l = Math::abs(p_buffer[i].left);
+		if (l > peak.left) {
+			peak.left = l;
+		}
+		float r = Math::abs(p_buffer[i].right);
+		if (r > peak.right) {
+			peak.right = r;
+		}
+	}
+	return peak;
+}
+
+static _FORCE_INLINE_ AudioFrame _cubic_interpolate(const AudioFrame *p_src, uint64_t p_pos) {
+	// Standard cubic interpolation (great quality/performance ratio).
+	const AudioFrame *y = &p_src[p_pos >> AudioMixKernels::RESAMPLE_FP_BITS];
+	float mu = (p_pos & AudioMixKernels::RESAMPLE_FP_MASK) / float(AudioMixKernels::RESAMPLE_FP_LEN);
+
+	float mu2 = mu * mu;
+	float h11 = mu2 * (mu - 1);
+	float z = mu2 - h11;
+	float h01 = z - h11;
+	float h10 = mu - z;
+
+	return y[1] + (y[2] - y[1]) * h01 + ((y[2] - y[0]) * h10 + (y[3] - y[1]) * h11) * 0.5;
+}
+
+static void _resample_cubic_scalar(AudioFrame *p_dst, const AudioFrame *p_src, uint64_t p_offset, uint64_t p_increment, uint32_t p_frames) {
+	for (uint32_t i = 0; i < p_frames; i++) {
+		p_dst[i] = _cubic_interpolate(p_src, p_offset);
+		p_offset += p_increment;
+	}
+}
+
+/* SSE2 */
+
+#ifdef AUDIO_MIX_SSE2_ENABLED
+
+static void _mix_ramp_sse2(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const __m128 vol_start = _mm_setr_ps(p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right);
+	const __m128 vol_end = _mm_setr_ps(p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right);
+	const __m128 frames = _mm_set1_ps((float)p_frames);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 step = _mm_set1_ps(2.0f);
+	__m128 index = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 t = _mm_div_ps(index, frames);
+		__m128 vol = _mm_add_ps(_mm_mul_ps(vol_end, t), _mm_mul_ps(_mm_sub_ps(one, t), vol_start));
+		__m128 dst = _mm_loadu_ps(&p_dst[i].left);
+		_mm_storeu_ps(&p_dst[i].left, _mm_add_ps(dst, _mm_mul_ps(vol, _mm_loadu_ps(&p_src[i].left))));
+		index = _mm_add_ps(index, step);
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] += (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _apply_ramp_sse2(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const __m128 vol_start = _mm_setr_ps(p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right);
+	const __m128 vol_end = _mm_setr_ps(p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right);
+	const __m128 frames = _mm_set1_ps((float)p_frames);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 step = _mm_set1_ps(2.0f);
+	__m128 index = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 t = _mm_div_ps(index, frames);
+		__m128 vol = _mm_add_ps(_mm_mul_ps(vol_end, t), _mm_mul_ps(_mm_sub_ps(one, t), vol_start));
+		_mm_storeu_ps(&p_dst[i].left, _mm_mul_ps(vol, _mm_loadu_ps(&p_src[i].left)));
+		index = _mm_add_ps(index, step);
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] = (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _accumulate_sse2(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		_mm_storeu_ps(&p_dst[i].left, _mm_add_ps(_mm_loadu_ps(&p_dst[i].left), _mm_loadu_ps(&p_src[i].left)));
+	}
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+static AudioFrame _scale_and_peak_sse2(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) {
+	const __m128 volume = _mm_set1_ps(p_volume);
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	__m128 peak = _mm_setzero_ps();
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 v = _mm_mul_ps(_mm_loadu_ps(&p_buffer[i].left), volume);
+		_mm_storeu_ps(&p_buffer[i].left, v);
+		peak = _mm_max_ps(peak, _mm_andnot_ps(sign_mask, v));
+	}
+	peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, peak);
+	AudioFrame result = AudioFrame(lanes[0], lanes[1]);
+	for (; i < p_frames; i++) {
+		p_buffer[i] *= p_volume;
+		result.left = MAX(result.left, Math::abs(p_buffer[i].left));
+		result.right = MAX(result.right, Math::abs(p_buffer[i].right));
+	}
+	return result;
+}
+
+static _FORCE_INLINE_ __m128 _load_frame_pair_sse2(const AudioFrame *p_a, const AudioFrame *p_b) {
+	return _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)p_a), (const __m64 *)p_b);
+}
+
+static void _resample_cubic_sse2(AudioFrame *p_dst, const AudioFrame *p_src, uint64_t p_offset, uint64_t p_increment, uint32_t p_frames) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		uint64_t pos_a = p_offset;
+		uint64_t pos_b = p_offset + p_increment;
+		p_offset += p_increment * 2;
+
+		const AudioFrame *y_a = &p_src[pos_a >> AudioMixKernels::RESAMPLE_FP_BITS];
+		const AudioFrame *y_b = &p_src[pos_b >> AudioMixKernels::RESAMPLE_FP_BITS];
+		float mu_a = (pos_a & AudioMixKernels::RESAMPLE_FP_MASK) / float(AudioMixKernels::RESAMPLE_FP_LEN);
+		float mu_b = (pos_b & AudioMixKernels::RESAMPLE_FP_MASK) / float(AudioMixKernels::RESAMPLE_FP_LEN);
+
+		__m128 y0 = _load_frame_pair_sse2(&y_a[0], &y_b[0]);
+		__m128 y1 = _load_frame_pair_sse2(&y_a[1], &y_b[1]);
+		__m128 y2 = _load_frame_pair_sse2(&y_a[2], &y_b[2]);
+		__m128 y3 = _load_frame_pair_sse2(&y_a[3], &y_b[3]);
+
+		__m128 mu = _mm_setr_ps(mu_a, mu_a, mu_b, mu_b);
+		__m128 mu2 = _mm_mul_ps(mu, mu);
+		__m128 h11 = _mm_mul_ps(mu2, _mm_sub_ps(mu, one));
+		__m128 z = _mm_sub_ps(mu2, h11);
+		__m128 h01 = _mm_sub_ps(z, h11);
+		__m128 h10 = _mm_sub_ps(mu, z);
+
+		__m128 tangents = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(y2, y0), h10), _mm_mul_ps(_mm_sub_ps(y3, y1), h11));
+		__m128 result = _mm_add_ps(_mm_add_ps(y1, _mm_mul_ps(_mm_sub_ps(y2, y1), h01)), _mm_mul_ps(tangents, half));
+		_mm_storeu_ps(&p_dst[i].left, result);
+	}
+	for (; i < p_frames; i++) {
+		p_dst[i] = _cubic_interpolate(p_src, p_offset);
+		p_offset += p_increment;
+	}
+}
+
+#endif // AUDIO_MIX_SSE2_ENABLED
+
+/* AVX2 */
+
+#ifdef AUDIO_MIX_AVX2_ENABLED
+
+__attribute__((target("avx2"))) static void _mix_ramp_avx2(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const __m256 vol_start = _mm256_setr_ps(p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right);
+	const __m256 vol_end = _mm256_setr_ps(p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right);
+	const __m256 frames = _mm256_set1_ps((float)p_frames);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 step = _mm256_set1_ps(4.0f);
+	__m256 index = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_frames; i += 4) {
+		__m256 t = _mm256_div_ps(index, frames);
+		__m256 vol = _mm256_add_ps(_mm256_mul_ps(vol_end, t), _mm256_mul_ps(_mm256_sub_ps(one, t), vol_start));
+		__m256 dst = _mm256_loadu_ps(&p_dst[i].left);
+		_mm256_storeu_ps(&p_dst[i].left, _mm256_add_ps(dst, _mm256_mul_ps(vol, _mm256_loadu_ps(&p_src[i].left))));
+		index = _mm256_add_ps(index, step);
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] += (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+__attribute__((target("avx2"))) static void _apply_ramp_avx2(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const __m256 vol_start = _mm256_setr_ps(p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right);
+	const __m256 vol_end = _mm256_setr_ps(p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right);
+	const __m256 frames = _mm256_set1_ps((float)p_frames);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 step = _mm256_set1_ps(4.0f);
+	__m256 index = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_frames; i += 4) {
+		__m256 t = _mm256_div_ps(index, frames);
+		__m256 vol = _mm256_add_ps(_mm256_mul_ps(vol_end, t), _mm256_mul_ps(_mm256_sub_ps(one, t), vol_start));
+		_mm256_storeu_ps(&p_dst[i].left, _mm256_mul_ps(vol, _mm256_loadu_ps(&p_src[i].left)));
+		index = _mm256_add_ps(index, step);
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] = (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+__attribute__((target("avx2"))) static void _accumulate_avx2(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	uint32_t i = 0;
+	for (; i + 4 <= p_frames; i += 4) {
+		_mm256_storeu_ps(&p_dst[i].left, _mm256_add_ps(_mm256_loadu_ps(&p_dst[i].left), _mm256_loadu_ps(&p_src[i].left)));
+	}
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+__attribute__((target("avx2"))) static AudioFrame _scale_and_peak_avx2(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) {
+	const __m256 volume = _mm256_set1_ps(p_volume);
+	const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+	__m256 peak = _mm256_setzero_ps();
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_frames; i += 4) {
+		__m256 v = _mm256_mul_ps(_mm256_loadu_ps(&p_buffer[i].left), volume);
+		_mm256_storeu_ps(&p_buffer[i].left, v);
+		peak = _mm256_max_ps(peak, _mm256_andnot_ps(sign_mask, v));
+	}
+	__m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+	peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, peak4);
+	AudioFrame result = AudioFrame(lanes[0], lanes[1]);
+	for (; i < p_frames; i++) {
+		p_buffer[i] *= p_volume;
+		result.left = MAX(result.left, Math::abs(p_buffer[i].left));
+		result.right = MAX(result.right, Math::abs(p_buffer[i].right));
+	}
+	return result;
+}
+
+#endif // AUDIO_MIX_AVX2_ENABLED
+
+/* NEON */
+
+#ifdef AUDIO_MIX_NEON_ENABLED
+
+static _FORCE_INLINE_ float32x4_t _ramp_volume_neon(float32x4_t p_vol_start, float32x4_t p_vol_end, float32x4_t p_t) {
+	return vaddq_f32(vmulq_f32(p_vol_end, p_t), vmulq_f32(vsubq_f32(vdupq_n_f32(1.0f), p_t), p_vol_start));
+}
+
+static void _mix_ramp_neon(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const float start_lanes[4] = { p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right };
+	const float end_lanes[4] = { p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right };
+	const float32x4_t vol_start = vld1q_f32(start_lanes);
+	const float32x4_t vol_end = vld1q_f32(end_lanes);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		// NEON has no vector division on 32-bit ARM, so compute the interpolation parameter the same way as the scalar path.
+		const float t_lanes[4] = { (float)i / p_frames, (float)i / p_frames, (float)(i + 1) / p_frames, (float)(i + 1) / p_frames };
+		float32x4_t vol = _ramp_volume_neon(vol_start, vol_end, vld1q_f32(t_lanes));
+		vst1q_f32(&p_dst[i].left, vaddq_f32(vld1q_f32(&p_dst[i].left), vmulq_f32(vol, vld1q_f32(&p_src[i].left))));
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] += (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _apply_ramp_neon(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+	const float start_lanes[4] = { p_vol_start.left, p_vol_start.right, p_vol_start.left, p_vol_start.right };
+	const float end_lanes[4] = { p_vol_end.left, p_vol_end.right, p_vol_end.left, p_vol_end.right };
+	const float32x4_t vol_start = vld1q_f32(start_lanes);
+	const float32x4_t vol_end = vld1q_f32(end_lanes);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		const float t_lanes[4] = { (float)i / p_frames, (float)i / p_frames, (float)(i + 1) / p_frames, (float)(i + 1) / p_frames };
+		float32x4_t vol = _ramp_volume_neon(vol_start, vol_end, vld1q_f32(t_lanes));
+		vst1q_f32(&p_dst[i].left, vmulq_f32(vol, vld1q_f32(&p_src[i].left)));
+	}
+	for (; i < p_frames; i++) {
+		float lerp_param = (float)i / p_frames;
+		p_dst[i] = (p_vol_end * lerp_param + (1 - lerp_param) * p_vol_start) * p_src[i];
+	}
+}
+
+static void _accumulate_neon(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		vst1q_f32(&p_dst[i].left, vaddq_f32(vld1q_f32(&p_dst[i].left), vld1q_f32(&p_src[i].left)));
+	}
+	for (; i < p_frames; i++) {
+		p_dst[i] += p_src[i];
+	}
+}
+
+static AudioFrame _scale_and_peak_neon(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) {
+	float32x4_t peak = vdupq_n_f32(0.0f);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		float32x4_t v = vmulq_n_f32(vld1q_f32(&p_buffer[i].left), p_volume);
+		vst1q_f32(&p_buffer[i].left, v);
+		peak = vmaxq_f32(peak, vabsq_f32(v));
+	}
+	float32x2_t peak2 = vmax_f32(vget_low_f32(peak), vget_high_f32(peak));
+
+	AudioFrame result = AudioFrame(vget_lane_f32(peak2, 0), vget_lane_f32(peak2, 1));
+	for (; i < p_frames; i++) {
+		p_buffer[i] *= p_volume;
+		result.left = MAX(result.left, Math::abs(p_buffer[i].left));
+		result.right = MAX(result.right, Math::abs(p_buffer[i].right));
+	}
+	return result;
+}
+
+static void _resample_cubic_neon(AudioFrame *p_dst, const AudioFrame *p_src, uint64_t p_offset, uint64_t p_increment, uint32_t p_frames) {
+	const float32x4_t one = vdupq_n_f32(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 2 <= p_frames; i += 2) {
+		uint64_t pos_a = p_offset;
+		uint64_t pos_b = p_offset + p_increment;
+		p_offset += p_increment * 2;
+
+		const AudioFrame *y_a = &p_src[pos_a >> AudioMixKernels::RESAMPLE_FP_BITS];
+		const AudioFrame *y_b = &p_src[pos_b >> AudioMixKernels::RESAMPLE_FP_BITS];
+		float mu_a = (pos_a & AudioMixKernels::RESAMPLE_FP_MASK) / float(AudioMixKernels::RESAMPLE_FP_LEN);
+		float mu_b = (pos_b & AudioMixKernels::RESAMPLE_FP_MASK) / float(AudioMixKernels::RESAMPLE_FP_LEN);
+
+		float32x4_t y0 = vcombine_f32(vld1_f32(&y_a[0].left), vld1_f32(&y_b[0].left));
+		float32x4_t y1 = vcombine_f32(vld1_f32(&y_a[1].left), vld1_f32(&y_b[1].left));
+		float32x4_t y2 = vcombine_f32(vld1_f32(&y_a[2].left), vld1_f32(&y_b[2].left));
+		float32x4_t y3 = vcombine_f32(vld1_f32(&y_a[3].left), vld1_f32(&y_b[3].left));
+
+		float32x4_t mu = vcombine_f32(vdup_n_f32(mu_a), vdup_n_f32(mu_b));
+		float32x4_t mu2 = vmulq_f32(mu, mu);
+		float32x4_t h11 = vmulq_f32(mu2, vsubq_f32(mu, one));
+		float32x4_t z = vsubq_f32(mu2, h11);
+		float32x4_t h01 = vsubq_f32(z, h11);
+		float32x4_t h10 = vsubq_f32(mu, z);
+
+		float32x4_t tangents = vaddq_f32(vmulq_f32(vsubq_f32(y2, y0), h10), vmulq_f32(vsubq_f32(y3, y1), h11));
+		float32x4_t result = vaddq_f32(vaddq_f32(y1, vmulq_f32(vsubq_f32(y2, y1), h01)), vmulq_n_f32(tangents, 0.5f));
+		vst1q_f32(&p_dst[i].left, result);
+	}
+	for (; i < p_frames; i++) {
+		p_dst[i] = _cubic_interpolate(p_src, p_offset);
+		p_offset += p_increment;
+	}
+}
+
+#endif // AUDIO_MIX_NEON_ENABLED
+
+/* Dispatch */
+
+AudioMixKernels::Functions AudioMixKernels::functions = AudioMixKernels::get_instruction_set_functions(AudioMixKernels::ISA_SCALAR);
+AudioMixKernels::InstructionSet AudioMixKernels::instruction_set = AudioMixKernels::ISA_SCALAR;
+
+bool AudioMixKernels::is_instruction_set_supported(InstructionSet p_instruction_set) {
+	switch (p_instruction_set) {
+		case ISA_SCALAR:
+			return true;
+		case ISA_SSE2:
+#ifdef AUDIO_MIX_SSE2_ENABLED
+			return true;
+#else
+			return false;
+#endif
+		case ISA_AVX2:
+#ifdef AUDIO_MIX_AVX2_ENABLED
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		case ISA_NEON:
+#ifdef AUDIO_MIX_NEON_ENABLED
+			return true;
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+AudioMixKernels::Functions AudioMixKernels::get_instruction_set_functions(InstructionSet p_instruction_set) {
+	Functions f;
+	f.mix_ramp = _mix_ramp_scalar;
+	f.apply_ramp = _apply_ramp_scalar;
+	f.accumulate = _accumulate_scalar;
+	f.scale_and_peak = _scale_and_peak_scalar;
+	f.resample_cubic = _resample_cubic_scalar;
+
+	switch (p_instruction_set) {
+		case ISA_SCALAR: {
+		} break;
+		case ISA_SSE2: {
+#ifdef AUDIO_MIX_SSE2_ENABLED
+			f.mix_ramp = _mix_ramp_sse2;
+			f.apply_ramp = _apply_ramp_sse2;
+			f.accumulate = _accumulate_sse2;
+			f.scale_and_peak = _scale_and_peak_sse2;
+			f.resample_cubic = _resample_cubic_sse2;
+#endif
+		} break;
+		case ISA_AVX2: {
+#ifdef AUDIO_MIX_AVX2_ENABLED
+			f.mix_ramp = _mix_ramp_avx2;
+			f.apply_ramp = _apply_ramp_avx2;
+			f.accumulate = _accumulate_avx2;
+			f.scale_and_peak = _scale_and_peak_avx2;
+			// Gathering frames for the resampler doesn't benefit from wider registers.
+			f.resample_cubic = _resample_cubic_sse2;
+#endif
+		} break;
+		case ISA_NEON: {
+#ifdef AUDIO_MIX_NEON_ENABLED
+			f.mix_ramp = _mix_ramp_neon;
+			f.apply_ramp = _apply_ramp_neon;
+			f.accumulate = _accumulate_neon;
+			f.scale_and_peak = _scale_and_peak_neon;
+			f.resample_cubic = _resample_cubic_neon;
+#endif
+		} break;
+		default: {
+		} break;
+	}
+
+	return f;
+}
+
+const char *AudioMixKernels::get_instruction_set_name(InstructionSet p_instruction_set) {
+	static const char *names[ISA_MAX] = {
+		"Scalar",
+		"SSE2",
+		"AVX2",
+		"NEON",
+	};
+	ERR_FAIL_INDEX_V(p_instruction_set, ISA_MAX, "");
+	return names[p_instruction_set];
+}
+
+void AudioMixKernels::set_instruction_set(InstructionSet p_instruction_set) {
+	ERR_FAIL_COND_MSG(!is_instruction_set_supported(p_instruction_set), vformat("Audio mix kernels for %s are not supported on this CPU.", get_instruction_set_name(p_instruction_set)));
+	functions = get_instruction_set_functions(p_instruction_set);
+	instruction_set = p_instruction_set;
+}
+
+void AudioMixKernels::init() {
+	static const InstructionSet preferred[] = { ISA_AVX2, ISA_SSE2, ISA_NEON };
+	InstructionSet best = ISA_SCALAR;
+	for (InstructionSet p : preferred) {
+		if (is_instruction_set_supported(p)) {
+			best = p;
+			break;
+		}
+	}
+	set_instruction_set(best);
+	print_verbose(vformat("AudioServer: Using %s audio mix kernels.", get_instruction_set_name(best)));
+}
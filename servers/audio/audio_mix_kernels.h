@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  audio_mix_kernels.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/audio_frame.h"
+#include "core/typedefs.h"
+
+// Inner loops of the audio mix. Each kernel has a scalar reference implementation and vectorized
+// ones; init() picks the widest set supported by the running CPU, which is why AVX2 can be used
+// even though the engine itself is not compiled for it.
+class AudioMixKernels {
+public:
+	enum InstructionSet {
+		ISA_SCALAR,
+		ISA_SSE2,
+		ISA_AVX2,
+		ISA_NEON,
+		ISA_MAX
+	};
+
+	enum {
+		// Resampling positions are 16.16 fixed point, see AudioStreamPlaybackResampled.
+		RESAMPLE_FP_BITS = 16,
+		RESAMPLE_FP_LEN = (1 << RESAMPLE_FP_BITS),
+		RESAMPLE_FP_MASK = RESAMPLE_FP_LEN - 1,
+	};
+
+	struct Functions {
+		// p_dst[i] += p_src[i] * lerp(p_vol_start, p_vol_end, i / p_frames).
+		void (*mix_ramp)(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) = nullptr;
+		// p_dst[i] = p_src[i] * lerp(p_vol_start, p_vol_end, i / p_frames).
+		void (*apply_ramp)(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) = nullptr;
+		// p_dst[i] += p_src[i].
+		void (*accumulate)(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) = nullptr;
+		// p_buffer[i] *= p_volume, returns the absolute peak of each channel after scaling.
+		AudioFrame (*scale_and_peak)(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) = nullptr;
+		// Cubic interpolation of p_src at p_offset + i * p_increment. Frame i reads p_src[n] to p_src[n + 3], n being the integer part of its position.
+		void (*resample_cubic)(AudioFrame *p_dst, const AudioFrame *p_src, uint64_t p_offset, uint64_t p_increment, uint32_t p_frames) = nullptr;
+	};
+
+private:
+	static Functions functions;
+	static InstructionSet instruction_set;
+
+public:
+	static bool is_instruction_set_supported(InstructionSet p_instruction_set);
+	static Functions get_instruction_set_functions(InstructionSet p_instruction_set);
+	static const char *get_instruction_set_name(InstructionSet p_instruction_set);
+
+	static void set_instruction_set(InstructionSet p_instruction_set);
+	_FORCE_INLINE_ static InstructionSet get_instruction_set() { return instruction_set; }
+
+	// Selects the widest instruction set supported by the CPU.
+	static void init();
+
+	_FORCE_INLINE_ static void mix_ramp(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+		functions.mix_ramp(p_dst, p_src, p_vol_start, p_vol_end, p_frames);
+	}
+	_FORCE_INLINE_ static void apply_ramp(AudioFrame *p_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_end, uint32_t p_frames) {
+		functions.apply_ramp(p_dst, p_src, p_vol_start, p_vol_end, p_frames);
+	}
+	_FORCE_INLINE_ static void accumulate(AudioFrame *p_dst, const AudioFrame *p_src, uint32_t p_frames) {
+		functions.accumulate(p_dst, p_src, p_frames);
+	}
+	_FORCE_INLINE_ static AudioFrame scale_and_peak(AudioFrame *p_buffer, float p_volume, uint32_t p_frames) {
+		return functions.scale_and_peak(p_buffer, p_volume, p_frames);
+	}
+	_FORCE_INLINE_ static void resample_cubic(AudioFrame *p_dst, const AudioFrame *p_src, uint64_t p_offset, uint64_t p_increment, uint32_t p_frames) {
+		functions.resample_cubic(p_dst, p_src, p_offset, p_increment, p_frames);
+	}
+};
@@ -0,0 +1,137 @@
+/**************************************************************************/
+/*  audio_mix_thread_pool.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "audio_mix_thread_pool.h"
+
+void AudioMixThreadPool::_thread_function(void *p_worker) {
+	Worker *worker = (Worker *)p_worker;
+	AudioMixThreadPool *pool = worker->pool;
+
+	while (true) {
+		worker->start.wait();
+		if (pool->exit_threads.load(std::memory_order_acquire)) {
+			break;
+		}
+		pool->_process_elements(worker->index);
+	}
+}
+
+void AudioMixThreadPool::_process_elements(uint32_t p_thread) {
+	uint64_t current = cursor.load(std::memory_order_acquire);
+	while (true) {
+		const Job &job = jobs[(current >> 32) & 1];
+		const uint32_t element = uint32_t(current);
+		if (element >= job.elements.load(std::memory_order_relaxed)) {
+			break;
+		}
+		WorkFunc func = job.func.load(std::memory_order_relaxed);
+		void *userdata = job.userdata.load(std::memory_order_relaxed);
+		// Fails if another thread claimed the element first, or if this is a stale job (then the loaded values are discarded).
+		if (!cursor.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			continue;
+		}
+		func(userdata, element, p_thread);
+		completed_elements.fetch_add(1, std::memory_order_release);
+		current = cursor.load(std::memory_order_acquire);
+	}
+}
+
+void AudioMixThreadPool::run(WorkFunc p_func, void *p_userdata, uint32_t p_elements) {
+	if (workers.is_empty() || p_elements <= 1) {
+		// Not worth waking anyone up.
+		for (uint32_t i = 0; i < p_elements; i++) {
+			p_func(p_userdata, i, 0);
+		}
+		return;
+	}
+
+	// The previous job is complete, so no thread can claim from the slot that is overwritten here.
+	const uint64_t job_number = (cursor.load(std::memory_order_relaxed) >> 32) + 1;
+	Job &job = jobs[job_number & 1];
+	job.func.store(p_func, std::memory_order_relaxed);
+	job.userdata.store(p_userdata, std::memory_order_relaxed);
+	job.elements.store(p_elements, std::memory_order_relaxed);
+	completed_elements.store(0, std::memory_order_relaxed);
+	cursor.store(job_number << 32, std::memory_order_release);
+
+	// Don't wake more workers than there are elements left for them after the caller takes its share.
+	// post() locks the semaphore mutex, but only for as long as a waking worker takes to decrement the count.
+	uint32_t to_wake = MIN(workers.size(), p_elements - 1);
+	for (uint32_t i = 0; i < to_wake; i++) {
+		workers[i]->start.post();
+	}
+
+	_process_elements(0);
+
+	// Every element is claimed at this point, so this only waits for the ones still running on awake workers.
+	while (completed_elements.load(std::memory_order_acquire) != p_elements) {
+		Thread::yield();
+	}
+}
+
+void AudioMixThreadPool::init(uint32_t p_worker_count) {
+	finish();
+
+#ifdef THREADS_ENABLED
+	exit_threads.store(false, std::memory_order_relaxed);
+
+	Thread::Settings settings;
+	settings.priority = Thread::PRIORITY_HIGH;
+
+	workers.resize(p_worker_count);
+	for (uint32_t i = 0; i < p_worker_count; i++) {
+		Worker *worker = memnew(Worker);
+		worker->pool = this;
+		worker->index = i + 1; // Thread 0 is the caller of run().
+		workers[i] = worker;
+		worker->thread.start(&AudioMixThreadPool::_thread_function, worker, settings);
+	}
+#endif
+}
+
+void AudioMixThreadPool::finish() {
+	if (workers.is_empty()) {
+		return;
+	}
+
+	exit_threads.store(true, std::memory_order_release);
+	for (Worker *worker : workers) {
+		worker->start.post();
+	}
+	for (Worker *worker : workers) {
+		worker->thread.wait_to_finish();
+		memdelete(worker);
+	}
+	workers.clear();
+}
+
+AudioMixThreadPool::~AudioMixThreadPool() {
+	finish();
+}
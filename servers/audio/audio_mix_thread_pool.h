@@ -0,0 +1,90 @@
+/**************************************************************************/
+/*  audio_mix_thread_pool.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include <atomic>
+
+// Small, fixed-size pool of threads dedicated to the audio mix.
+// Unlike WorkerThreadPool, running a job does not allocate: elements are claimed through an atomic counter
+// and the calling (audio) thread takes part in the work.
+// The caller never waits for a worker to wake up, it keeps claiming elements itself and only waits for
+// the elements already being processed by other threads, so a late or descheduled worker costs nothing.
+// The one lock taken by the caller is the semaphore mutex when waking workers. A worker only holds it to
+// check its count in Semaphore::wait(), never while sleeping or running a job.
+class AudioMixThreadPool {
+public:
+	typedef void (*WorkFunc)(void *p_userdata, uint32_t p_element, uint32_t p_thread);
+
+private:
+	struct Worker {
+		Thread thread;
+		Semaphore start;
+		AudioMixThreadPool *pool = nullptr;
+		uint32_t index = 0;
+	};
+
+	// Jobs are double buffered: a worker waking up late may still read the previous job while run() writes
+	// the next one. Its claim then fails, since claims only succeed for the current job.
+	struct Job {
+		std::atomic<WorkFunc> func = nullptr;
+		std::atomic<void *> userdata = nullptr;
+		std::atomic<uint32_t> elements = 0;
+	};
+
+	LocalVector<Worker *> workers;
+
+	Job jobs[2];
+	// Current job number in the upper 32 bits, next element to claim in the lower ones.
+	std::atomic<uint64_t> cursor = 0;
+	std::atomic<uint32_t> completed_elements = 0;
+	std::atomic<bool> exit_threads = false;
+
+	static void _thread_function(void *p_worker);
+	void _process_elements(uint32_t p_thread);
+
+public:
+	// Number of threads taking part in a job, including the caller of run(). Thread indices passed to WorkFunc are in [0, get_thread_count()).
+	_FORCE_INLINE_ uint32_t get_thread_count() const { return workers.size() + 1; }
+	_FORCE_INLINE_ uint32_t get_worker_count() const { return workers.size(); }
+
+	// Calls p_func for every element in [0, p_elements) and returns once all of them are done.
+	// Must only be called from one thread at a time (the audio thread).
+	void run(WorkFunc p_func, void *p_userdata, uint32_t p_elements);
+
+	void init(uint32_t p_worker_count);
+	void finish();
+
+	~AudioMixThreadPool();
+};
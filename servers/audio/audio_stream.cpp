@@ -31,6 +31,7 @@
 #include "audio_stream.h"
 
 #include "core/config/project_settings.h"
+#include "servers/audio/audio_mix_kernels.h"
 
 void AudioStreamPlayback::start(double p_from_pos) {
 	if (GDVIRTUAL_CALL(_start, p_from_pos)) {
@@ -198,31 +199,35 @@ int AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 
 	int mixed_frames_total = -1;
 
-	int i;
-	for (i = 0; i < p_frames; i++) {
-		uint32_t idx = CUBIC_INTERP_HISTORY + uint32_t(mix_offset >> FP_BITS);
-		//standard cubic interpolation (great quality/performance ratio)
-		//this used to be moved to a LUT for greater performance, but nowadays CPU speed is generally faster than memory.
-		float mu = (mix_offset & FP_MASK) / float(FP_LEN);
-		AudioFrame y0 = internal_buffer[idx - 3];
-		AudioFrame y1 = internal_buffer[idx - 2];
-		AudioFrame y2 = internal_buffer[idx - 1];
-		AudioFrame y3 = internal_buffer[idx - 0];
-
-		if (idx >= internal_buffer_end && mixed_frames_total == -1) {
-			// The internal buffer ends somewhere in this range, and we haven't yet recorded the number of good frames we have.
-			mixed_frames_total = i;
+	static_assert(FP_BITS == AudioMixKernels::RESAMPLE_FP_BITS, "Resampling fixed point format must match the mix kernels.");
+
+	int i = 0;
+	while (i < p_frames) {
+		// Interpolate as many frames as possible before the internal buffer has to be refilled.
+		uint64_t to_buffer_end = (uint64_t(INTERNAL_BUFFER_LEN) << FP_BITS) - mix_offset;
+		int to_mix = p_frames - i;
+		if (mix_increment > 0) {
+			to_mix = MIN((uint64_t)to_mix, (to_buffer_end + mix_increment - 1) / mix_increment);
 		}
 
-		float mu2 = mu * mu;
-		float h11 = mu2 * (mu - 1);
-		float z = mu2 - h11;
-		float h01 = z - h11;
-		float h10 = mu - z;
+		if (internal_buffer_end != (unsigned int)-1 && mixed_frames_total == -1) {
+			// The internal buffer ends somewhere, find the first frame reading past its last good frame.
+			uint64_t end_offset = internal_buffer_end > CUBIC_INTERP_HISTORY ? (uint64_t(internal_buffer_end - CUBIC_INTERP_HISTORY) << FP_BITS) : 0;
+			if (mix_offset >= end_offset) {
+				mixed_frames_total = i;
+			} else if (mix_increment > 0) {
+				uint64_t frames_to_end = (end_offset - mix_offset + mix_increment - 1) / mix_increment;
+				if (frames_to_end < (uint64_t)to_mix) {
+					mixed_frames_total = i + frames_to_end;
+				}
+			}
+		}
 
-		p_buffer[i] = y1 + (y2 - y1) * h01 + ((y2 - y0) * h10 + (y3 - y1) * h11) * 0.5;
+		// Frame n reads internal_buffer[idx - 3] to internal_buffer[idx], with idx = CUBIC_INTERP_HISTORY + n.
+		AudioMixKernels::resample_cubic(&p_buffer[i], &internal_buffer[CUBIC_INTERP_HISTORY - 3], mix_offset, mix_increment, to_mix);
 
-		mix_offset += mix_increment;
+		mix_offset += mix_increment * to_mix;
+		i += to_mix;
 
 		while ((mix_offset >> FP_BITS) >= INTERNAL_BUFFER_LEN) {
 			internal_buffer[0] = internal_buffer[INTERNAL_BUFFER_LEN + 0];
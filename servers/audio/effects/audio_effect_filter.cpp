@@ -31,41 +31,6 @@
 #include "audio_effect_filter.h"
 #include "servers/audio_server.h"
 
-template <int S>
-void AudioEffectFilterInstance::_process_filter(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) {
-	for (int i = 0; i < p_frame_count; i++) {
-		float f = p_src_frames[i].left;
-		filter_process[0][0].process_one(f);
-		if constexpr (S > 1) {
-			filter_process[0][1].process_one(f);
-		}
-		if constexpr (S > 2) {
-			filter_process[0][2].process_one(f);
-		}
-		if constexpr (S > 3) {
-			filter_process[0][3].process_one(f);
-		}
-
-		p_dst_frames[i].left = f;
-	}
-
-	for (int i = 0; i < p_frame_count; i++) {
-		float f = p_src_frames[i].right;
-		filter_process[1][0].process_one(f);
-		if constexpr (S > 1) {
-			filter_process[1][1].process_one(f);
-		}
-		if constexpr (S > 2) {
-			filter_process[1][2].process_one(f);
-		}
-		if constexpr (S > 3) {
-			filter_process[1][3].process_one(f);
-		}
-
-		p_dst_frames[i].right = f;
-	}
-}
-
 void AudioEffectFilterInstance::process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) {
 	filter.set_cutoff(base->cutoff);
 	filter.set_gain(base->gain);
@@ -81,14 +46,13 @@ void AudioEffectFilterInstance::process(const AudioFrame *p_src_frames, AudioFra
 		}
 	}
 
-	if (stages == 1) {
-		_process_filter<1>(p_src_frames, p_dst_frames, p_frame_count);
-	} else if (stages == 2) {
-		_process_filter<2>(p_src_frames, p_dst_frames, p_frame_count);
-	} else if (stages == 3) {
-		_process_filter<3>(p_src_frames, p_dst_frames, p_frame_count);
-	} else if (stages == 4) {
-		_process_filter<4>(p_src_frames, p_dst_frames, p_frame_count);
+	if (p_dst_frames != p_src_frames) {
+		memcpy(p_dst_frames, p_src_frames, sizeof(AudioFrame) * p_frame_count);
+	}
+
+	// Stages run one after the other over the whole block, both channels of each stage are filtered together.
+	for (int j = 0; j < stages; j++) {
+		AudioFilterSW::Processor::process_stereo(&filter_process[0][j], &filter_process[1][j], p_dst_frames, p_frame_count);
 	}
 }
 
@@ -44,9 +44,6 @@ class AudioEffectFilterInstance : public AudioEffectInstance {
 	AudioFilterSW filter;
 	AudioFilterSW::Processor filter_process[2][4];
 
-	template <int S>
-	void _process_filter(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count);
-
 public:
 	virtual void process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) override;
 
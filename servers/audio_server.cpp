@@ -39,7 +39,10 @@
 #include "core/string/string_name.h"
 #include "core/templates/pair.h"
 #include "scene/scene_string_names.h"
+#include "servers/audio/audio_decode_ahead.h"
+#include "servers/audio/audio_decode_cache.h"
 #include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/audio_mix_kernels.h"
 #include "servers/audio/audio_stream.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 
@@ -336,7 +339,7 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 }
 
 void AudioServer::_mix_step() {
-	bool solo_mode = false;
+	mix_solo_mode = false;
 
 	for (int i = 0; i < buses.size(); i++) {
 		Bus *bus = buses[i];
@@ -347,7 +350,7 @@ void AudioServer::_mix_step() {
 
 		if (bus->solo) {
 			//solo chain
-			solo_mode = true;
+			mix_solo_mode = true;
 			bus->soloed = true;
 			do {
 				if (bus != buses[0]) {
@@ -377,288 +380,571 @@ void AudioServer::_mix_step() {
 		ci->callback(ci->userdata);
 	}
 
-	// Main mixing loop for audio streams.
-	// The basic idea here is to copy the samples returned by the AudioStreamPlayback's mix function into the audio buffers,
-	//  while always maintaining a lookahead buffer of size LOOKAHEAD_BUFFER_SIZE to allow fade-outs for sudden stoppages.
-	for (AudioStreamPlaybackListNode *playback : playback_list) {
-		// Paused streams are no-ops. Don't even mix audio from the stream playback.
-		if (playback->state.load() == AudioStreamPlaybackListNode::PAUSED) {
-			continue;
+	_update_virtual_voices();
+
+	if (mix_thread_pool.get_worker_count() > 0) {
+		_mix_step_threaded();
+	} else {
+		// Main mixing loop for audio streams.
+		for (AudioStreamPlaybackListNode *playback : playback_list) {
+			if (_mix_playback(playback, mix_buffer.ptrw(), nullptr)) {
+				_mix_playback_update_state(playback);
+			}
 		}
 
-		if (playback->stream_playback->get_is_sample()) {
-			continue;
+		// Now that all of the buses have their audio sources mixed into them, we can process the effects and bus sends.
+		for (int i = buses.size() - 1; i >= 0; i--) {
+			_mix_step_bus(i, temp_buffer);
+			_mix_step_bus_send(i);
 		}
+	}
 
-		// If `fading_out` is true, we're in the process of fading out the stream playback.
-		// TODO: Currently this sets the volume of the stream to 0 which creates a linear interpolation between its previous volume and silence.
-		//  A more punchy option for fading out could be to just use the lookahead buffer.
-		bool fading_out = playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION || playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
+	mix_frames += buffer_size;
+	to_mix = buffer_size;
+}
 
-		AudioFrame *buf = mix_buffer.ptrw();
+void AudioServer::_update_mix_thread_data() {
+	uint32_t thread_count = mix_thread_pool.get_thread_count();
+	uint32_t bus_channel_count = buses.size() * channel_count;
 
-		// Copy the old contents of the lookahead buffer into the beginning of the mix buffer.
-		for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
-			buf[i] = playback->lookahead[i];
+	mix_thread_data.resize(thread_count);
+	for (MixThreadData &thread_data : mix_thread_data) {
+		thread_data.mix_buffer.resize(buffer_size + LOOKAHEAD_BUFFER_SIZE);
+		thread_data.bus_buffers.resize(bus_channel_count * buffer_size);
+		thread_data.bus_channels_used.resize(bus_channel_count);
+		thread_data.temp_buffer.resize(channel_count);
+		for (int i = 0; i < channel_count; i++) {
+			thread_data.temp_buffer.write[i].resize(buffer_size);
 		}
+	}
+}
 
-		// Mix the audio stream.
-		unsigned int mixed_frames = playback->stream_playback->mix(&buf[LOOKAHEAD_BUFFER_SIZE], playback->pitch_scale.get(), buffer_size);
+void AudioServer::_mix_playback_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread) {
+	AudioServer *self = (AudioServer *)p_userdata;
+	MixThreadData *thread_data = &self->mix_thread_data[p_thread];
+	self->mix_playbacks_mixed[p_element] = self->_mix_playback(self->mix_playbacks[p_element], thread_data->mix_buffer.ptrw(), thread_data);
+}
 
-		if (tag_used_audio_streams && playback->stream_playback->is_playing()) {
-			playback->stream_playback->tag_used_streams();
+void AudioServer::_mix_reduce_bus_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread) {
+	AudioServer *self = (AudioServer *)p_userdata;
+
+	for (int k = 0; k < self->channel_count; k++) {
+		uint32_t bus_channel = p_element * self->channel_count + k;
+		for (const MixThreadData &thread_data : self->mix_thread_data) {
+			if (!thread_data.bus_channels_used[bus_channel]) {
+				continue;
+			}
+			AudioFrame *buf = self->thread_get_channel_mix_buffer(p_element, k);
+			AudioMixKernels::accumulate(buf, &thread_data.bus_buffers[bus_channel * self->buffer_size], self->buffer_size);
 		}
+	}
+}
+
+void AudioServer::_mix_bus_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread) {
+	AudioServer *self = (AudioServer *)p_userdata;
+	self->_mix_step_bus(self->mix_bus_order[self->mix_level_from + p_element], self->mix_thread_data[p_thread].temp_buffer);
+}
 
-		// Check to see if the stream has run out of samples.
-		if (mixed_frames != buffer_size) {
-			// We know we have at least the size of our lookahead buffer for fade-out purposes.
+void AudioServer::_mix_step_threaded() {
+	uint32_t bus_count = buses.size();
 
-			float fadeout_base = 0.94;
-			float fadeout_coefficient = 1;
-			static_assert(LOOKAHEAD_BUFFER_SIZE == 64, "Update fadeout_base and comment here if you change LOOKAHEAD_BUFFER_SIZE.");
-			// 0.94 ^ 64 = 0.01906. There might still be a pop but it'll be way better than if we didn't do this.
-			for (unsigned int idx = mixed_frames; idx < buffer_size; idx++) {
-				fadeout_coefficient *= fadeout_base;
-				buf[idx] *= fadeout_coefficient;
-			}
-			AudioStreamPlaybackListNode::PlaybackState new_state;
-			new_state = AudioStreamPlaybackListNode::AWAITING_DELETION;
-			playback->state.store(new_state);
+	if (mix_thread_data.size() != mix_thread_pool.get_thread_count() || mix_thread_data[0].bus_channels_used.size() != bus_count * channel_count) {
+		// Only happens when the bus layout or the speaker mode changes, like `init_channels_and_buffers()`.
+		_update_mix_thread_data();
+	}
+
+	// Voices are independent from each other, so each thread mixes its share into its own copy of the bus buffers.
+	mix_playbacks.clear();
+	for (AudioStreamPlaybackListNode *playback : playback_list) {
+		mix_playbacks.push_back(playback);
+	}
+	mix_playbacks_mixed.resize(mix_playbacks.size());
+	for (MixThreadData &thread_data : mix_thread_data) {
+		memset(thread_data.bus_channels_used.ptr(), 0, thread_data.bus_channels_used.size());
+	}
+
+	mix_thread_pool.run(&AudioServer::_mix_playback_thread_func, this, mix_playbacks.size());
+
+	// State changes can deallocate, and SafeList does not support concurrent removal, so they stay on this thread.
+	for (uint32_t i = 0; i < mix_playbacks.size(); i++) {
+		if (mix_playbacks_mixed[i]) {
+			_mix_playback_update_state(mix_playbacks[i]);
+		}
+	}
+
+	mix_thread_pool.run(&AudioServer::_mix_reduce_bus_thread_func, this, bus_count);
+
+	// A bus can only be processed once every bus sending to it is done. Sends always point to a lower index,
+	// so levels can be computed in a single pass: leaf buses end up in level 0 and master in the last one.
+	mix_bus_levels.resize(bus_count);
+	memset(mix_bus_levels.ptr(), 0, bus_count * sizeof(uint32_t));
+	uint32_t level_count = 1;
+	for (int i = bus_count - 1; i > 0; i--) {
+		uint32_t send = _get_bus_send_index(i);
+		mix_bus_levels[send] = MAX(mix_bus_levels[send], mix_bus_levels[i] + 1);
+		level_count = MAX(level_count, mix_bus_levels[send] + 1);
+	}
+
+	// Counting sort, keeping buses of the same level in descending index order like the serial path.
+	mix_level_offsets.resize(level_count + 1);
+	memset(mix_level_offsets.ptr(), 0, (level_count + 1) * sizeof(uint32_t));
+	for (uint32_t i = 0; i < bus_count; i++) {
+		mix_level_offsets[mix_bus_levels[i] + 1]++;
+	}
+	for (uint32_t i = 1; i <= level_count; i++) {
+		mix_level_offsets[i] += mix_level_offsets[i - 1];
+	}
+	mix_bus_order.resize(bus_count);
+	for (int i = bus_count - 1; i >= 0; i--) {
+		mix_bus_order[mix_level_offsets[mix_bus_levels[i]]++] = i;
+	}
+	for (uint32_t i = level_count; i > 0; i--) {
+		mix_level_offsets[i] = mix_level_offsets[i - 1];
+	}
+	mix_level_offsets[0] = 0;
+
+	for (uint32_t level = 0; level < level_count; level++) {
+		uint32_t from = mix_level_offsets[level];
+		uint32_t to = mix_level_offsets[level + 1];
+
+		if (to - from == 1) {
+			_mix_step_bus(mix_bus_order[from], temp_buffer);
 		} else {
-			// Move the last little bit of what we just mixed into our lookahead buffer for the next call to _mix_step.
-			for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
-				playback->lookahead[i] = buf[buffer_size + i];
-			}
+			mix_level_from = from;
+			mix_thread_pool.run(&AudioServer::_mix_bus_thread_func, this, to - from);
 		}
 
-		// Get the bus details for this playback. This contains information about which buses the playback is assigned to and the volume of the playback on each bus.
-		AudioStreamPlaybackBusDetails *bus_details_ptr = playback->bus_details.load();
-		ERR_FAIL_NULL(bus_details_ptr);
-		// Make a copy of the bus details so we can modify it without worrying about other threads.
-		AudioStreamPlaybackBusDetails bus_details = *bus_details_ptr;
+		// Several buses of a level may send to the same bus, so sends are summed serially.
+		for (uint32_t i = from; i < to; i++) {
+			_mix_step_bus_send(mix_bus_order[i]);
+		}
+	}
+}
 
-		// Mix to any active buses.
-		for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
-			if (!bus_details.bus_active[idx]) {
-				continue;
-			}
-			// This is the AudioServer-internal index of the bus we're mixing to in this step of the loop. Not to be confused with `idx` which is an index into `AudioStreamPlaybackBusDetails` member var arrays.
-			int bus_idx = thread_find_bus_index(bus_details.bus[idx]);
+bool AudioServer::_mix_playback(AudioStreamPlaybackListNode *p_playback, AudioFrame *p_mix_buffer, MixThreadData *p_thread_data) {
+	// The basic idea here is to copy the samples returned by the AudioStreamPlayback's mix function into the audio buffers,
+	//  while always maintaining a lookahead buffer of size LOOKAHEAD_BUFFER_SIZE to allow fade-outs for sudden stoppages.
+	AudioStreamPlaybackListNode *playback = p_playback;
 
-			// It's important to know whether or not this bus was active in the previous mix step of this stream. If it was, we need to perform volume interpolation to avoid pops.
-			int prev_bus_idx = -1;
-			for (int search_idx = 0; search_idx < MAX_BUSES_PER_PLAYBACK; search_idx++) {
-				if (!playback->prev_bus_details->bus_active[search_idx]) {
-					continue;
-				}
-				// If the StringNames of the buses match, we've found the previous bus index. This indicates that this playback mixed to `prev_bus_details->bus[prev_bus_index]` in the previous mix step, which gives us a way to look up the playback's previous volume.
-				if (playback->prev_bus_details->bus[search_idx].hash() == bus_details.bus[idx].hash()) {
-					prev_bus_idx = search_idx;
-					break;
-				}
-			}
+	// Paused streams are no-ops. Don't even mix audio from the stream playback.
+	if (playback->state.load() == AudioStreamPlaybackListNode::PAUSED) {
+		return false;
+	}
 
-			// It's now time to mix to the bus. We do this by going through each channel of the bus and mixing to it.
-			//  The channels correspond to output channels of the audio device, e.g. stereo or 5.1. To reduce needless nesting, this is done with a helper method named `_mix_step_for_channel`.
-			for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
-				AudioFrame *channel_buf = thread_get_channel_mix_buffer(bus_idx, channel_idx);
-				// TODO: This `fading_out` check could be replaced with with an exponential fadeout of the samples from the lookahead buffer for more punchy results.
-				if (fading_out) {
-					bus_details.volume[idx][channel_idx] = AudioFrame(0, 0);
-				}
-				AudioFrame channel_vol = bus_details.volume[idx][channel_idx];
+	if (playback->stream_playback->get_is_sample()) {
+		return false;
+	}
 
-				// If this bus was not active in the previous mix step, we want to start playback at the full volume to avoid crushing transients.
-				AudioFrame prev_channel_vol = channel_vol;
-				// If this bus was active in the previous mix step, we need to interpolate between the previous volume and the current volume to avoid pops. Set `prev_channel_volume` accordingly.
-				if (prev_bus_idx != -1) {
-					prev_channel_vol = playback->prev_bus_details->volume[prev_bus_idx][channel_idx];
-				}
-				_mix_step_for_channel(channel_buf, buf, prev_channel_vol, channel_vol, playback->attenuation_filter_cutoff_hz.get(), playback->highshelf_gain.get(), &playback->filter_process[channel_idx * 2], &playback->filter_process[channel_idx * 2 + 1]);
-			}
+	AudioStreamPlaybackListNode::VoiceState voice_state = playback->voice_state.load();
+	if (_is_voice_virtual(voice_state)) {
+		// Virtual voices don't decode nor mix anything, pausing or stopping them doesn't need a fade-out either.
+		if (playback->state.load() != AudioStreamPlaybackListNode::PLAYING) {
+			return true;
 		}
+		double position = playback->virtual_position.get() + _get_playback_time(playback, buffer_size);
+		playback->virtual_position.set(position);
+		if (!playback->voice_stream_loops.is_set() && position >= playback->voice_stream_length.get()) {
+			playback->state.store(AudioStreamPlaybackListNode::AWAITING_DELETION);
+			return true;
+		}
+		return false;
+	}
+
+	// If `fading_out` is true, we're in the process of fading out the stream playback.
+	// TODO: Currently this sets the volume of the stream to 0 which creates a linear interpolation between its previous volume and silence.
+	//  A more punchy option for fading out could be to just use the lookahead buffer.
+	bool fading_out = playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION || playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE || voice_state == AudioStreamPlaybackListNode::VOICE_FADE_OUT_TO_VIRTUAL;
 
-		// Now go through and fade-out any buses that were being played to previously that we missed by going through current data.
-		for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
-			if (!playback->prev_bus_details->bus_active[idx]) {
+	AudioFrame *buf = p_mix_buffer;
+
+	// Copy the old contents of the lookahead buffer into the beginning of the mix buffer.
+	for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
+		buf[i] = playback->lookahead[i];
+	}
+
+	// Only the frames before the lookahead are heard in this step, a voice going virtual continues right after them.
+	double fade_out_position = 0.0;
+	if (voice_state == AudioStreamPlaybackListNode::VOICE_FADE_OUT_TO_VIRTUAL) {
+		fade_out_position = playback->stream_playback->get_playback_position() + _get_playback_time(playback, buffer_size - LOOKAHEAD_BUFFER_SIZE);
+	}
+
+	// Mix the audio stream.
+	unsigned int mixed_frames = playback->stream_playback->mix(&buf[LOOKAHEAD_BUFFER_SIZE], playback->pitch_scale.get(), buffer_size);
+
+	if (tag_used_audio_streams && playback->stream_playback->is_playing()) {
+		playback->stream_playback->tag_used_streams();
+	}
+
+	// Check to see if the stream has run out of samples.
+	if (mixed_frames != buffer_size) {
+		// We know we have at least the size of our lookahead buffer for fade-out purposes.
+
+		float fadeout_base = 0.94;
+		float fadeout_coefficient = 1;
+		static_assert(LOOKAHEAD_BUFFER_SIZE == 64, "Update fadeout_base and comment here if you change LOOKAHEAD_BUFFER_SIZE.");
+		// 0.94 ^ 64 = 0.01906. There might still be a pop but it'll be way better than if we didn't do this.
+		for (unsigned int idx = mixed_frames; idx < buffer_size; idx++) {
+			fadeout_coefficient *= fadeout_base;
+			buf[idx] *= fadeout_coefficient;
+		}
+		AudioStreamPlaybackListNode::PlaybackState new_state;
+		new_state = AudioStreamPlaybackListNode::AWAITING_DELETION;
+		playback->state.store(new_state);
+	} else {
+		// Move the last little bit of what we just mixed into our lookahead buffer for the next call to _mix_step.
+		for (int i = 0; i < LOOKAHEAD_BUFFER_SIZE; i++) {
+			playback->lookahead[i] = buf[buffer_size + i];
+		}
+	}
+
+	// Get the bus details for this playback. This contains information about which buses the playback is assigned to and the volume of the playback on each bus.
+	AudioStreamPlaybackBusDetails *bus_details_ptr = playback->bus_details.load();
+	ERR_FAIL_NULL_V(bus_details_ptr, false);
+	// Make a copy of the bus details so we can modify it without worrying about other threads.
+	AudioStreamPlaybackBusDetails bus_details = *bus_details_ptr;
+
+	// Mix to any active buses.
+	for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
+		if (!bus_details.bus_active[idx]) {
+			continue;
+		}
+		// This is the AudioServer-internal index of the bus we're mixing to in this step of the loop. Not to be confused with `idx` which is an index into `AudioStreamPlaybackBusDetails` member var arrays.
+		int bus_idx = thread_find_bus_index(bus_details.bus[idx]);
+
+		// It's important to know whether or not this bus was active in the previous mix step of this stream. If it was, we need to perform volume interpolation to avoid pops.
+		int prev_bus_idx = -1;
+		for (int search_idx = 0; search_idx < MAX_BUSES_PER_PLAYBACK; search_idx++) {
+			if (!playback->prev_bus_details->bus_active[search_idx]) {
 				continue;
 			}
-			int bus_idx = thread_find_bus_index(playback->prev_bus_details->bus[idx]);
+			// If the StringNames of the buses match, we've found the previous bus index. This indicates that this playback mixed to `prev_bus_details->bus[prev_bus_index]` in the previous mix step, which gives us a way to look up the playback's previous volume.
+			if (playback->prev_bus_details->bus[search_idx].hash() == bus_details.bus[idx].hash()) {
+				prev_bus_idx = search_idx;
+				break;
+			}
+		}
 
-			int current_bus_idx = -1;
-			for (int search_idx = 0; search_idx < MAX_BUSES_PER_PLAYBACK; search_idx++) {
-				if (bus_details.bus[search_idx] == playback->prev_bus_details->bus[idx]) {
-					current_bus_idx = search_idx;
-				}
+		// It's now time to mix to the bus. We do this by going through each channel of the bus and mixing to it.
+		//  The channels correspond to output channels of the audio device, e.g. stereo or 5.1. To reduce needless nesting, this is done with a helper method named `_mix_step_for_channel`.
+		for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
+			AudioFrame *channel_buf = _get_playback_bus_buffer(p_thread_data, bus_idx, channel_idx);
+			// TODO: This `fading_out` check could be replaced with with an exponential fadeout of the samples from the lookahead buffer for more punchy results.
+			if (fading_out) {
+				bus_details.volume[idx][channel_idx] = AudioFrame(0, 0);
 			}
-			if (current_bus_idx != -1) {
-				// If we found a corresponding bus in the current bus assignments, we've already mixed to this bus.
-				continue;
+			AudioFrame channel_vol = bus_details.volume[idx][channel_idx];
+
+			// If this bus was not active in the previous mix step, we want to start playback at the full volume to avoid crushing transients.
+			AudioFrame prev_channel_vol = channel_vol;
+			// If this bus was active in the previous mix step, we need to interpolate between the previous volume and the current volume to avoid pops. Set `prev_channel_volume` accordingly.
+			if (prev_bus_idx != -1) {
+				prev_channel_vol = playback->prev_bus_details->volume[prev_bus_idx][channel_idx];
 			}
+			_mix_step_for_channel(channel_buf, buf, prev_channel_vol, channel_vol, playback->attenuation_filter_cutoff_hz.get(), playback->highshelf_gain.get(), &playback->filter_process[channel_idx * 2], &playback->filter_process[channel_idx * 2 + 1]);
+		}
+	}
 
-			for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
-				AudioFrame *channel_buf = thread_get_channel_mix_buffer(bus_idx, channel_idx);
-				AudioFrame prev_channel_vol = playback->prev_bus_details->volume[idx][channel_idx];
-				// Fade out to silence. This could be replaced with an exponential fadeout of the samples from the lookahead buffer for more punchy results.
-				_mix_step_for_channel(channel_buf, buf, prev_channel_vol, AudioFrame(0, 0), playback->attenuation_filter_cutoff_hz.get(), playback->highshelf_gain.get(), &playback->filter_process[channel_idx * 2], &playback->filter_process[channel_idx * 2 + 1]);
+	// Now go through and fade-out any buses that were being played to previously that we missed by going through current data.
+	for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
+		if (!playback->prev_bus_details->bus_active[idx]) {
+			continue;
+		}
+		int bus_idx = thread_find_bus_index(playback->prev_bus_details->bus[idx]);
+
+		int current_bus_idx = -1;
+		for (int search_idx = 0; search_idx < MAX_BUSES_PER_PLAYBACK; search_idx++) {
+			if (bus_details.bus[search_idx] == playback->prev_bus_details->bus[idx]) {
+				current_bus_idx = search_idx;
 			}
 		}
+		if (current_bus_idx != -1) {
+			// If we found a corresponding bus in the current bus assignments, we've already mixed to this bus.
+			continue;
+		}
 
-		// Copy the bus details we mixed with to the previous bus details to maintain volume ramps.
-		for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
-			playback->prev_bus_details->bus_active[i] = bus_details.bus_active[i];
+		for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
+			AudioFrame *channel_buf = _get_playback_bus_buffer(p_thread_data, bus_idx, channel_idx);
+			AudioFrame prev_channel_vol = playback->prev_bus_details->volume[idx][channel_idx];
+			// Fade out to silence. This could be replaced with an exponential fadeout of the samples from the lookahead buffer for more punchy results.
+			_mix_step_for_channel(channel_buf, buf, prev_channel_vol, AudioFrame(0, 0), playback->attenuation_filter_cutoff_hz.get(), playback->highshelf_gain.get(), &playback->filter_process[channel_idx * 2], &playback->filter_process[channel_idx * 2 + 1]);
 		}
-		for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
-			playback->prev_bus_details->bus[i] = bus_details.bus[i];
+	}
+
+	// Copy the bus details we mixed with to the previous bus details to maintain volume ramps.
+	for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
+		playback->prev_bus_details->bus_active[i] = bus_details.bus_active[i];
+	}
+	for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
+		playback->prev_bus_details->bus[i] = bus_details.bus[i];
+	}
+	for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
+		for (int j = 0; j < MAX_CHANNELS_PER_BUS; j++) {
+			playback->prev_bus_details->volume[i][j] = bus_details.volume[i][j];
 		}
-		for (int i = 0; i < MAX_BUSES_PER_PLAYBACK; i++) {
-			for (int j = 0; j < MAX_CHANNELS_PER_BUS; j++) {
-				playback->prev_bus_details->volume[i][j] = bus_details.volume[i][j];
-			}
+	}
+
+	if (voice_state == AudioStreamPlaybackListNode::VOICE_FADE_OUT_TO_VIRTUAL) {
+		playback->virtual_position.set(fade_out_position);
+		playback->voice_state.store(AudioStreamPlaybackListNode::VOICE_VIRTUAL);
+	}
+
+	return true;
+}
+
+void AudioServer::_mix_playback_update_state(AudioStreamPlaybackListNode *p_playback) {
+	switch (p_playback->state.load()) {
+		case AudioStreamPlaybackListNode::AWAITING_DELETION:
+		case AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION:
+			// Remove the playback from the list.
+			_delete_stream_playback_list_node(p_playback);
+			break;
+		case AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE: {
+			// Pause the stream.
+			p_playback->state.store(AudioStreamPlaybackListNode::PAUSED);
+		} break;
+		case AudioStreamPlaybackListNode::PLAYING:
+		case AudioStreamPlaybackListNode::PAUSED:
+			// No-op!
+			break;
+	}
+}
+
+void AudioServer::_update_virtual_voices() {
+	voice_candidates.clear();
+	uint32_t fixed_voices = 0;
+	uint32_t virtual_voices = 0;
+
+	for (AudioStreamPlaybackListNode *playback : playback_list) {
+		if (playback->state.load() != AudioStreamPlaybackListNode::PLAYING) {
+			virtual_voices += _is_voice_virtual(playback->voice_state.load()) ? 1 : 0;
+			continue;
+		}
+		if (playback->voice_stream_length.get() <= 0.0 || playback->stream_playback->get_is_sample()) {
+			_set_voice_virtual(playback, false);
+			fixed_voices++;
+			continue;
 		}
 
-		switch (playback->state.load()) {
-			case AudioStreamPlaybackListNode::AWAITING_DELETION:
-			case AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION:
-				// Remove the playback from the list.
-				_delete_stream_playback_list_node(playback);
-				break;
-			case AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE: {
-				// Pause the stream.
-				playback->state.store(AudioStreamPlaybackListNode::PAUSED);
-			} break;
-			case AudioStreamPlaybackListNode::PLAYING:
-			case AudioStreamPlaybackListNode::PAUSED:
-				// No-op!
-				break;
+		bool is_real = playback->voice_state.load() == AudioStreamPlaybackListNode::VOICE_REAL;
+		float audibility = _get_playback_audibility(playback);
+		// Voices need to get 3 dB louder than the threshold to be restored, so they don't flip every mix step.
+		if (audibility < (is_real ? virtual_voice_threshold : virtual_voice_threshold * Math::SQRT2)) {
+			_set_voice_virtual(playback, true);
+			virtual_voices++;
+			continue;
 		}
+
+		VoiceCandidate candidate;
+		candidate.playback = playback;
+		candidate.priority = playback->voice_priority.get();
+		// Same for voices fighting over the voice budget, real ones keep a 3 dB advantage.
+		candidate.audibility = is_real ? audibility * Math::SQRT2 : audibility;
+		voice_candidates.push_back(candidate);
 	}
 
-	// Now that all of the buses have their audio sources mixed into them, we can process the effects and bus sends.
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		Bus *bus = buses[i];
+	uint32_t allowed = voice_candidates.size();
+	if (max_voices > 0 && fixed_voices + voice_candidates.size() > (uint32_t)max_voices) {
+		allowed = (uint32_t)max_voices > fixed_voices ? max_voices - fixed_voices : 0;
+		voice_candidates.sort();
+	}
+	for (uint32_t i = 0; i < voice_candidates.size(); i++) {
+		_set_voice_virtual(voice_candidates[i].playback, i >= allowed);
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				// Buffer was not used, but it's still active, so it must be cleaned.
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+	virtual_voice_count.set(virtual_voices + voice_candidates.size() - allowed);
+}
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					buf[j] = AudioFrame(0, 0);
-				}
-			}
+void AudioServer::_set_voice_virtual(AudioStreamPlaybackListNode *p_playback, bool p_virtual) {
+	AudioStreamPlaybackListNode::VoiceState voice_state = p_playback->voice_state.load();
+
+	if (p_virtual) {
+		if (voice_state == AudioStreamPlaybackListNode::VOICE_REAL) {
+			p_playback->voice_state.store(AudioStreamPlaybackListNode::VOICE_FADE_OUT_TO_VIRTUAL);
+		} else if (voice_state == AudioStreamPlaybackListNode::VOICE_VIRTUAL_SEEKING) {
+			// Seeks again when it's restored.
+			p_playback->voice_state.store(AudioStreamPlaybackListNode::VOICE_VIRTUAL);
 		}
+		return;
+	}
 
-		// Process effects.
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
-				if (!bus->effects[j].enabled) {
-					continue;
-				}
+	if (voice_state == AudioStreamPlaybackListNode::VOICE_VIRTUAL) {
+		// Seek to where the voice will be when it's mixed again: after the coming virtual step, plus the lookahead, which
+		// starts out silent. Streams decoded ahead only post the seek to the decode thread, which has this step to handle it.
+		p_playback->stream_playback->seek(_get_virtual_position(p_playback, _get_playback_time(p_playback, buffer_size + LOOKAHEAD_BUFFER_SIZE)));
+		p_playback->voice_state.store(AudioStreamPlaybackListNode::VOICE_VIRTUAL_SEEKING);
+		return;
+	}
 
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
+	if (voice_state == AudioStreamPlaybackListNode::VOICE_VIRTUAL_SEEKING) {
+		// It fades back in, since its previous volumes were faded out to zero.
+		for (AudioFrame &frame : p_playback->lookahead) {
+			frame = AudioFrame(0, 0);
+		}
+	}
+	p_playback->voice_state.store(AudioStreamPlaybackListNode::VOICE_REAL);
+}
 
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
+float AudioServer::_get_playback_audibility(const AudioStreamPlaybackListNode *p_playback) const {
+	const AudioStreamPlaybackBusDetails *bus_details = p_playback->bus_details.load();
+	if (!bus_details) {
+		return 0.0f;
+	}
 
-				// Swap buffers, so internal buffer always has the right data.
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
+	float audibility = 0.0f;
+	for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
+		if (!bus_details->bus_active[idx]) {
+			continue;
+		}
+		for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
+			const AudioFrame &volume = bus_details->volume[idx][channel_idx];
+			audibility = MAX(audibility, MAX(Math::abs(volume.left), Math::abs(volume.right)));
+		}
+	}
+	return audibility;
+}
 
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
-			}
+double AudioServer::_get_playback_time(const AudioStreamPlaybackListNode *p_playback, int p_frames) const {
+	return p_frames * p_playback->pitch_scale.get() * playback_speed_scale / get_mix_rate();
+}
+
+double AudioServer::_get_virtual_position(const AudioStreamPlaybackListNode *p_playback, double p_ahead) const {
+	double position = p_playback->virtual_position.get() + p_ahead;
+	double length = p_playback->voice_stream_length.get();
+	if (p_playback->voice_stream_loops.is_set() && length > 0.0 && position >= length) {
+		// Loop points aren't known at this level, assume the whole stream loops.
+		position = Math::fmod(position, length);
+	}
+	return position;
+}
+
+AudioFrame *AudioServer::_get_playback_bus_buffer(MixThreadData *p_thread_data, int p_bus, int p_channel) {
+	if (!p_thread_data) {
+		return thread_get_channel_mix_buffer(p_bus, p_channel);
+	}
+
+	ERR_FAIL_INDEX_V(p_bus, buses.size(), nullptr);
+	ERR_FAIL_INDEX_V(p_channel, channel_count, nullptr);
+
+	uint32_t bus_channel = p_bus * channel_count + p_channel;
+	AudioFrame *data = &p_thread_data->bus_buffers.ptrw()[bus_channel * buffer_size];
+	if (!p_thread_data->bus_channels_used[bus_channel]) {
+		p_thread_data->bus_channels_used[bus_channel] = 1;
+		for (uint32_t i = 0; i < buffer_size; i++) {
+			data[i] = AudioFrame(0, 0);
 		}
+	}
+	return data;
+}
+
+int AudioServer::_get_bus_send_index(int p_bus) const {
+	if (p_bus == 0) {
+		return -1;
+	}
 
-		// Process send.
+	// Everything has a send except for the master bus.
+	const Bus *bus = buses[p_bus];
+	Bus *const *send = bus_map.getptr(bus->send);
+	if (!send || (*send)->index_cache >= bus->index_cache) { // Invalid, send to master.
+		return 0;
+	}
+	return (*send)->index_cache;
+}
 
-		Bus *send = nullptr;
+void AudioServer::_mix_step_bus(int p_bus, Vector<Vector<AudioFrame>> &r_temp_buffer) {
+	Bus *bus = buses[p_bus];
 
-		if (i > 0) {
-			// Everything has a send except for the master bus.
-			if (!bus_map.has(bus->send)) {
-				send = buses[0];
-			} else {
-				send = bus_map[bus->send];
-				if (send->index_cache >= bus->index_cache) { // Invalid, send to master.
-					send = buses[0];
-				}
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			// Buffer was not used, but it's still active, so it must be cleaned.
+			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+
+			for (uint32_t j = 0; j < buffer_size; j++) {
+				buf[j] = AudioFrame(0, 0);
 			}
 		}
+	}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (!bus->channels[k].active) {
-				bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+	// Process effects.
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
+			if (!bus->effects[j].enabled) {
 				continue;
 			}
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
-
-			AudioFrame peak = AudioFrame(0, 0);
-
-			float volume = Math::db_to_linear(bus->volume_db);
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), r_temp_buffer.write[k].ptrw(), buffer_size);
 			}
 
-			// Apply volume and compute peak.
-			for (uint32_t j = 0; j < buffer_size; j++) {
-				buf[j] *= volume;
-
-				float l = Math::abs(buf[j].left);
-				if (l > peak.left) {
-					peak.left = l;
-				}
-				float r = Math::abs(buf[j].right);
-				if (r > peak.right) {
-					peak.right = r;
+			// Swap buffers, so internal buffer always has the right data.
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
+				SWAP(bus->channels.write[k].buffer, r_temp_buffer.write[k]);
 			}
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear_to_db(peak.left + AUDIO_PEAK_OFFSET), Math::linear_to_db(peak.right + AUDIO_PEAK_OFFSET));
+#ifdef DEBUG_ENABLED
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
+		}
+	}
 
-			if (!bus->channels[k].used) {
-				// See if any audio is contained, because channel was not used.
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (!bus->channels[k].active) {
+			bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+			continue;
+		}
 
-				if (MAX(peak.right, peak.left) > Math::db_to_linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
+		float volume = Math::db_to_linear(bus->volume_db);
+
+		if (mix_solo_mode) {
+			if (!bus->soloed) {
+				volume = 0.0;
+			}
+		} else {
+			if (bus->mute) {
+				volume = 0.0;
 			}
+		}
 
-			if (send) {
-				// If not master bus, send.
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+		// Apply volume and compute peak.
+		AudioFrame peak = AudioMixKernels::scale_and_peak(bus->channels.write[k].buffer.ptrw(), volume, buffer_size);
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear_to_db(peak.left + AUDIO_PEAK_OFFSET), Math::linear_to_db(peak.right + AUDIO_PEAK_OFFSET));
+
+		if (!bus->channels[k].used) {
+			// See if any audio is contained, because channel was not used.
+
+			if (MAX(peak.right, peak.left) > Math::db_to_linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false; // Went inactive, don't send.
 			}
 		}
 	}
+}
 
-	mix_frames += buffer_size;
-	to_mix = buffer_size;
+void AudioServer::_mix_step_bus_send(int p_bus) {
+	int send = _get_bus_send_index(p_bus);
+	if (send == -1) {
+		return;
+	}
+
+	Bus *bus = buses[p_bus];
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (!bus->channels[k].active) {
+			continue;
+		}
+
+		AudioMixKernels::accumulate(thread_get_channel_mix_buffer(send, k), bus->channels[k].buffer.ptr(), buffer_size);
+	}
 }
 
 void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r) {
@@ -681,22 +967,24 @@ void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_sou
 		p_processor_r->set_filter(&filter, /* clear_history= */ is_just_started);
 		p_processor_r->update_coeffs(buffer_size);
 
-		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
+		// Apply the volume ramp and the filter on small blocks, so the ramp and the accumulation stay vectorized and the block stays in cache.
+		AudioFrame block[FILTER_BLOCK_SIZE];
+		for (uint32_t from = 0; from < buffer_size; from += FILTER_BLOCK_SIZE) {
+			uint32_t frames = MIN((uint32_t)FILTER_BLOCK_SIZE, buffer_size - from);
 			// TODO: Make lerp speed buffer-size-invariant if buffer_size ever becomes a project setting to avoid very small buffer sizes causing pops due to too-fast lerps.
-			float lerp_param = (float)frame_idx / buffer_size;
-			AudioFrame vol = p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start;
-			AudioFrame mixed = vol * p_source_buf[frame_idx];
-			p_processor_l->process_one_interp(mixed.left);
-			p_processor_r->process_one_interp(mixed.right);
-			p_out_buf[frame_idx] += mixed;
+			float lerp_from = (float)from / buffer_size;
+			float lerp_to = (float)(from + frames) / buffer_size;
+			AudioFrame vol_from = p_vol_final * lerp_from + (1 - lerp_from) * p_vol_start;
+			AudioFrame vol_to = p_vol_final * lerp_to + (1 - lerp_to) * p_vol_start;
+
+			AudioMixKernels::apply_ramp(block, &p_source_buf[from], vol_from, vol_to, frames);
+			AudioFilterSW::Processor::process_stereo(p_processor_l, p_processor_r, block, frames, true);
+			AudioMixKernels::accumulate(&p_out_buf[from], block, frames);
 		}
 
 	} else {
-		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
-			// TODO: Make lerp speed buffer-size-invariant if buffer_size ever becomes a project setting to avoid very small buffer sizes causing pops due to too-fast lerps.
-			float lerp_param = (float)frame_idx / buffer_size;
-			p_out_buf[frame_idx] += (p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start) * p_source_buf[frame_idx];
-		}
+		// TODO: Make lerp speed buffer-size-invariant if buffer_size ever becomes a project setting to avoid very small buffer sizes causing pops due to too-fast lerps.
+		AudioMixKernels::mix_ramp(p_out_buf, p_source_buf, p_vol_start, p_vol_final, buffer_size);
 	}
 }
 
@@ -1426,6 +1714,19 @@ void AudioServer::set_playback_highshelf_params(Ref<AudioStreamPlayback> p_playb
 	playback_node->highshelf_gain.set(p_gain);
 }
 
+void AudioServer::set_playback_voice_priority(Ref<AudioStreamPlayback> p_playback, int p_priority, double p_stream_length, bool p_stream_loops) {
+	ERR_FAIL_COND(p_playback.is_null());
+
+	AudioStreamPlaybackListNode *playback_node = _find_playback_list_node(p_playback);
+	if (!playback_node) {
+		return;
+	}
+
+	playback_node->voice_priority.set(p_priority);
+	playback_node->voice_stream_loops.set_to(p_stream_loops);
+	playback_node->voice_stream_length.set(MAX(p_stream_length, 0.0));
+}
+
 bool AudioServer::is_playback_active(Ref<AudioStreamPlayback> p_playback) {
 	ERR_FAIL_COND_V(p_playback.is_null(), false);
 
@@ -1459,6 +1760,10 @@ float AudioServer::get_playback_position(Ref<AudioStreamPlayback> p_playback) {
 		return 0;
 	}
 
+	if (_is_voice_virtual(playback_node->voice_state.load())) {
+		return _get_virtual_position(playback_node);
+	}
+
 	return playback_node->stream_playback->get_playback_position();
 }
 
@@ -1473,6 +1778,21 @@ bool AudioServer::is_playback_paused(Ref<AudioStreamPlayback> p_playback) {
 	return playback_node->state.load() == AudioStreamPlaybackListNode::PAUSED || playback_node->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
 }
 
+bool AudioServer::is_playback_virtual(Ref<AudioStreamPlayback> p_playback) {
+	ERR_FAIL_COND_V(p_playback.is_null(), false);
+
+	AudioStreamPlaybackListNode *playback_node = _find_playback_list_node(p_playback);
+	if (!playback_node) {
+		return false;
+	}
+
+	return _is_voice_virtual(playback_node->voice_state.load());
+}
+
+uint32_t AudioServer::get_virtual_voice_count() const {
+	return virtual_voice_count.get();
+}
+
 uint64_t AudioServer::get_mix_count() const {
 	return mix_count;
 }
@@ -1516,8 +1836,22 @@ void AudioServer::init() {
 	// When this becomes a project setting, it should be specified in milliseconds rather than raw sample count, because 512 samples at 192khz is shorter than it is at 48khz, for example.
 	buffer_size = 512;
 
+	AudioMixKernels::init();
 	init_channels_and_buffers();
 
+	// Extra threads helping the audio thread mix voices and process independent buses. Zero keeps everything on the audio thread.
+	mix_thread_pool.init(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "audio/general/mix_threads", PROPERTY_HINT_RANGE, "0,16,1"), 0));
+
+	// Voices over the budget or quieter than the threshold stop mixing until they are audible again. Zero voices means no budget.
+	max_voices = GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "audio/general/max_voices", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), 0);
+	virtual_voice_threshold = Math::db_to_linear(float(GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "audio/general/virtual_voice_threshold_db", PROPERTY_HINT_RANGE, "-120,0,0.1,suffix:dB"), -80.0)));
+
+	// Short compressed streams are decoded once and shared, long ones are decoded ahead of the mixer on a background thread.
+	double decoded_cache_max_length = GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "audio/general/decoded_cache_max_length", PROPERTY_HINT_RANGE, "0,60,0.1,or_greater,suffix:s"), 5.0);
+	uint64_t decoded_cache_size = uint64_t(int(GLOBAL_DEF_RST(PropertyInfo(Variant::INT, "audio/general/decoded_cache_size_mb", PROPERTY_HINT_RANGE, "0,1024,1,or_greater,suffix:MiB"), 32))) * 1024 * 1024;
+	AudioDecodeCache::set_limits(decoded_cache_max_length, decoded_cache_size);
+	AudioDecodeAheadThread::init(GLOBAL_DEF_RST(PropertyInfo(Variant::FLOAT, "audio/general/decode_ahead_time", PROPERTY_HINT_RANGE, "0,5,0.01,suffix:s"), 0.5));
+
 	mix_count = 0;
 	set_bus_count(1);
 	set_bus_name(0, "Master");
@@ -1636,6 +1970,10 @@ void AudioServer::finish() {
 		AudioDriverManager::get_driver(i)->finish();
 	}
 
+	mix_thread_pool.finish();
+	AudioDecodeAheadThread::finish();
+	AudioDecodeCache::clear();
+
 	for (int i = 0; i < buses.size(); i++) {
 		memdelete(buses[i]);
 	}
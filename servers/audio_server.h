@@ -37,6 +37,7 @@
 #include "core/variant/variant.h"
 #include "servers/audio/audio_effect.h"
 #include "servers/audio/audio_filter_sw.h"
+#include "servers/audio/audio_mix_thread_pool.h"
 
 #include <atomic>
 
@@ -203,6 +204,7 @@ public:
 		MAX_CHANNELS_PER_BUS = 4,
 		MAX_BUSES_PER_PLAYBACK = 6,
 		LOOKAHEAD_BUFFER_SIZE = 64,
+		FILTER_BLOCK_SIZE = 128,
 	};
 
 	typedef void (*AudioCallback)(void *p_userdata);
@@ -305,6 +307,39 @@ private:
 		AudioStreamPlaybackBusDetails *prev_bus_details = nullptr;
 		// The next few samples are stored here so we have some time to fade audio out if it ends abruptly at the beginning of the next mix.
 		AudioFrame lookahead[LOOKAHEAD_BUFFER_SIZE];
+
+		// Voice virtualization: inaudible or culled voices stop mixing and only keep track of their position.
+		// 1. The voice is real and mixed normally.
+		// 2. The audio thread decides to virtualize the voice, the state is set to FADE_OUT_TO_VIRTUAL.
+		// 2.1. The voice is mixed one last time while fading out, then the position of the last frame heard is saved and the state is set to VIRTUAL.
+		// 3. Virtual voices advance their position every mix step.
+		// 4. When the voice becomes real again, the playback is seeked to where the voice will be one mix step later and the state is set to VIRTUAL_SEEKING.
+		// 4.1. The voice stays virtual for that step, so streams decoded ahead have time to get there. Then the state is set back to REAL.
+		enum VoiceState {
+			VOICE_REAL = 0,
+			VOICE_FADE_OUT_TO_VIRTUAL = 1,
+			VOICE_VIRTUAL = 2,
+			VOICE_VIRTUAL_SEEKING = 3,
+		};
+		SafeNumeric<int> voice_priority;
+		// Length of the stream in seconds. Zero if it's unknown, in which case the voice can't be virtualized.
+		SafeNumeric<double> voice_stream_length;
+		SafeFlag voice_stream_loops;
+		std::atomic<VoiceState> voice_state = VOICE_REAL;
+		SafeNumeric<double> virtual_position;
+	};
+
+	struct VoiceCandidate {
+		AudioStreamPlaybackListNode *playback = nullptr;
+		int priority = 0;
+		float audibility = 0.0f;
+
+		bool operator<(const VoiceCandidate &p_other) const {
+			if (priority != p_other.priority) {
+				return priority > p_other.priority;
+			}
+			return audibility > p_other.audibility;
+		}
 	};
 
 	SafeList<AudioStreamPlaybackListNode *> playback_list;
@@ -326,7 +361,52 @@ private:
 
 	void init_channels_and_buffers();
 
+	// Scratch space owned by each thread of the mix thread pool, so voices and bus effects can be mixed without sharing any buffer.
+	struct MixThreadData {
+		Vector<AudioFrame> mix_buffer;
+		// Voices mixed by this thread are accumulated here as [bus][channel][frame], then summed into the bus buffers.
+		Vector<AudioFrame> bus_buffers;
+		LocalVector<uint8_t> bus_channels_used;
+		Vector<Vector<AudioFrame>> temp_buffer;
+	};
+
+	AudioMixThreadPool mix_thread_pool;
+	LocalVector<MixThreadData> mix_thread_data;
+	LocalVector<AudioStreamPlaybackListNode *> mix_playbacks;
+	LocalVector<bool> mix_playbacks_mixed;
+	// Buses grouped by their depth in the send graph: every bus only depends on buses of lower levels.
+	LocalVector<uint32_t> mix_bus_levels;
+	LocalVector<uint32_t> mix_bus_order;
+	LocalVector<uint32_t> mix_level_offsets;
+	uint32_t mix_level_from = 0;
+	bool mix_solo_mode = false;
+
+	// Voices that aren't allowed to mix because of the voice budget or because they are inaudible.
+	int max_voices = 0;
+	float virtual_voice_threshold = 0.0f;
+	LocalVector<VoiceCandidate> voice_candidates;
+	SafeNumeric<uint32_t> virtual_voice_count;
+
+	static void _mix_playback_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread);
+	static void _mix_reduce_bus_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread);
+	static void _mix_bus_thread_func(void *p_userdata, uint32_t p_element, uint32_t p_thread);
+
+	void _update_mix_thread_data();
 	void _mix_step();
+	void _mix_step_threaded();
+	bool _mix_playback(AudioStreamPlaybackListNode *p_playback, AudioFrame *p_mix_buffer, MixThreadData *p_thread_data);
+	void _mix_playback_update_state(AudioStreamPlaybackListNode *p_playback);
+	void _update_virtual_voices();
+	void _set_voice_virtual(AudioStreamPlaybackListNode *p_playback, bool p_virtual);
+	float _get_playback_audibility(const AudioStreamPlaybackListNode *p_playback) const;
+	_FORCE_INLINE_ static bool _is_voice_virtual(AudioStreamPlaybackListNode::VoiceState p_state) { return p_state == AudioStreamPlaybackListNode::VOICE_VIRTUAL || p_state == AudioStreamPlaybackListNode::VOICE_VIRTUAL_SEEKING; }
+	// Stream time covered by p_frames mixed frames.
+	double _get_playback_time(const AudioStreamPlaybackListNode *p_playback, int p_frames) const;
+	double _get_virtual_position(const AudioStreamPlaybackListNode *p_playback, double p_ahead = 0.0) const;
+	AudioFrame *_get_playback_bus_buffer(MixThreadData *p_thread_data, int p_bus, int p_channel);
+	int _get_bus_send_index(int p_bus) const;
+	void _mix_step_bus(int p_bus, Vector<Vector<AudioFrame>> &r_temp_buffer);
+	void _mix_step_bus_send(int p_bus);
 	void _mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r);
 
 	// Should only be called on the main thread.
@@ -439,10 +519,14 @@ public:
 	void set_playback_pitch_scale(Ref<AudioStreamPlayback> p_playback, float p_pitch_scale);
 	void set_playback_paused(Ref<AudioStreamPlayback> p_playback, bool p_paused);
 	void set_playback_highshelf_params(Ref<AudioStreamPlayback> p_playback, float p_gain, float p_attenuation_cutoff_hz);
+	// Allows the playback to be virtualized when it's inaudible or when the voice budget is exceeded. Voices with a lower priority are virtualized first.
+	void set_playback_voice_priority(Ref<AudioStreamPlayback> p_playback, int p_priority, double p_stream_length, bool p_stream_loops);
 
 	bool is_playback_active(Ref<AudioStreamPlayback> p_playback);
 	float get_playback_position(Ref<AudioStreamPlayback> p_playback);
 	bool is_playback_paused(Ref<AudioStreamPlayback> p_playback);
+	bool is_playback_virtual(Ref<AudioStreamPlayback> p_playback);
+	uint32_t get_virtual_voice_count() const;
 
 	uint64_t get_mix_count() const;
 	uint64_t get_mixed_frames() const;
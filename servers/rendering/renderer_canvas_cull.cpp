@@ -33,6 +33,8 @@
 #include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -46,6 +48,8 @@ const static float FEATHER_SIZE = 1.25f;
 
 static RendererCanvasCull *_canvas_cull_singleton = nullptr;
 
+thread_local RendererCanvasCull::CullChunk *RendererCanvasCull::current_cull_chunk = nullptr;
+
 void RendererCanvasCull::_dependency_changed(Dependency::DependencyChangedNotification p_notification, DependencyTracker *p_tracker) {
 	Item *item = (Item *)p_tracker->userdata;
 
@@ -78,9 +82,11 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
+	uint64_t cull_begin = OS::get_singleton()->get_ticks_usec();
 	for (int i = 0; i < p_child_item_count; i++) {
 		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, false, p_canvas_cull_mask, Point2(), 1, nullptr);
 	}
+	cull_time_usec += OS::get_singleton()->get_ticks_usec() - cull_begin;
 
 	RendererCanvasRender::Item *list = nullptr;
 	RendererCanvasRender::Item *list_end = nullptr;
@@ -156,6 +162,37 @@ void RendererCanvasCull::_collect_ysort_children(RendererCanvasCull::Item *p_can
 	}
 }
 
+void RendererCanvasCull::_sort_ysort_items(RendererCanvasCull::Item **r_items, int p_count) {
+	uint64_t sort_begin = OS::get_singleton()->get_ticks_usec();
+
+	if (p_count < YSORT_RADIX_MIN_ITEMS) {
+		SortArray<Item *, ItemYSort> sorter;
+		sorter.sort(r_items, p_count);
+	} else {
+		// Radix sort on Y, quantized so that nearly equal positions keep the collection order like ItemYSort does.
+		// Items are collected in `ysort_index` order and the sort is stable.
+		static thread_local RadixSort radix_sort;
+		static thread_local LocalVector<uint32_t> keys;
+		static thread_local LocalVector<uint32_t> indices;
+		static thread_local LocalVector<Item *> items;
+		keys.resize(p_count);
+		indices.resize(p_count);
+		items.resize(p_count);
+		for (int i = 0; i < p_count; i++) {
+			// Adding zero turns -0.0 into 0.0, so both get the same key.
+			keys[i] = RadixSort::float_to_key(float(r_items[i]->ysort_xform.columns[2].y) + 0.0f) & ~uint32_t(0x7F);
+			indices[i] = i;
+			items[i] = r_items[i];
+		}
+		radix_sort.sort(keys.ptr(), indices.ptr(), p_count, current_cull_chunk == nullptr);
+		for (int i = 0; i < p_count; i++) {
+			r_items[i] = items[indices[i]];
+		}
+	}
+
+	ysort_time_usec.add(OS::get_singleton()->get_ticks_usec() - sort_begin);
+}
+
 int RendererCanvasCull::_count_ysort_children(RendererCanvasCull::Item *p_canvas_item) {
 	int ysort_children_count = 0;
 	int child_item_count = p_canvas_item->child_items.size();
@@ -178,6 +215,15 @@ void RendererCanvasCull::_mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+void RendererCanvasCull::_mark_visibility_notifier_visible(Item::VisibilityNotifierData *p_notifier) {
+	if (!p_notifier->visible_element.in_list()) {
+		visibility_notifier_list.add(&p_notifier->visible_element);
+		p_notifier->just_visible = true;
+	}
+
+	p_notifier->visible_in_frame = RSG::rasterizer->get_frame_number();
+}
+
 void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from) {
 	if (ci->copy_back_buffer) {
 		ci->copy_back_buffer->screen_rect = p_transform.xform(ci->copy_back_buffer->rect).intersection(p_clip_rect);
@@ -250,7 +296,11 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		// Something to draw?
 
 		if (ci->update_when_visible) {
-			RenderingServerDefault::redraw_request();
+			if (current_cull_chunk) {
+				current_cull_chunk->redraw_requested = true;
+			} else {
+				RenderingServerDefault::redraw_request();
+			}
 		}
 
 		if (ci->commands != nullptr || ci->copy_back_buffer) {
@@ -269,6 +319,10 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 			} else {
 				r_z_list[zidx] = ci;
 				r_z_last_list[zidx] = ci;
+				if (current_cull_chunk) {
+					current_cull_chunk->z_min = MIN(current_cull_chunk->z_min, zidx);
+					current_cull_chunk->z_max = MAX(current_cull_chunk->z_max, zidx);
+				}
 			}
 
 			ci->z_final = p_z;
@@ -277,12 +331,11 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		}
 
 		if (ci->visibility_notifier) {
-			if (!ci->visibility_notifier->visible_element.in_list()) {
-				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
-				ci->visibility_notifier->just_visible = true;
+			if (current_cull_chunk) {
+				current_cull_chunk->visible_notifiers.push_back(ci->visibility_notifier);
+			} else {
+				_mark_visibility_notifier_visible(ci->visibility_notifier);
 			}
-
-			ci->visibility_notifier->visible_in_frame = RSG::rasterizer->get_frame_number();
 		}
 	} else if (ci->repeat_source) {
 		// If repeat source does not draw itself it still needs transform updated as its child items' repeat offsets are relative to it.
@@ -441,11 +494,29 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			int i = 1;
 			_collect_ysort_children(ci, p_material_owner, Color(1, 1, 1, 1), child_items, i, p_z);
 
-			SortArray<Item *, ItemYSort> sorter;
-			sorter.sort(child_items, child_item_count);
+			_sort_ysort_items(child_items, child_item_count);
 
-			for (i = 0; i < child_item_count; i++) {
-				_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, true, p_canvas_cull_mask, child_items[i]->repeat_size, child_items[i]->repeat_times, child_items[i]->repeat_source_item);
+			// Repeated items read the transform of their repeat source, which may be attached by another chunk.
+			bool threaded = _can_cull_threaded(child_item_count);
+			for (i = 0; threaded && i < child_item_count; i++) {
+				threaded = child_items[i]->repeat_source_item == nullptr;
+			}
+
+			if (threaded) {
+				CullTask task;
+				task.items = child_items;
+				task.item_count = child_item_count;
+				task.y_sorted = true;
+				task.parent_xform = final_xform;
+				task.clip_rect = p_clip_rect;
+				task.modulate = modulate;
+				task.canvas_clip = (Item *)ci->final_clip_owner;
+				task.canvas_cull_mask = p_canvas_cull_mask;
+				_cull_canvas_items_threaded(task, r_z_list, r_z_last_list);
+			} else {
+				for (i = 0; i < child_item_count; i++) {
+					_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, true, p_canvas_cull_mask, child_items[i]->repeat_size, child_items[i]->repeat_times, child_items[i]->repeat_source_item);
+				}
 			}
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
@@ -465,6 +536,31 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			canvas_group_from = r_z_last_list[zidx];
 		}
 
+		if (_can_cull_threaded(child_item_count)) {
+			CullTask task;
+			task.items = child_items;
+			task.item_count = child_item_count;
+			task.parent_xform = final_xform;
+			task.clip_rect = p_clip_rect;
+			task.modulate = modulate;
+			task.z = p_z;
+			task.canvas_clip = (Item *)ci->final_clip_owner;
+			task.material_owner = p_material_owner;
+			task.canvas_cull_mask = p_canvas_cull_mask;
+			task.repeat_size = repeat_size;
+			task.repeat_times = repeat_times;
+			task.repeat_source_item = repeat_source_item;
+
+			task.behind = use_canvas_group ? -1 : 1;
+			_cull_canvas_items_threaded(task, r_z_list, r_z_last_list);
+			_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from);
+			if (!use_canvas_group) {
+				task.behind = 0;
+				_cull_canvas_items_threaded(task, r_z_list, r_z_last_list);
+			}
+			return;
+		}
+
 		for (int i = 0; i < child_item_count; i++) {
 			if (!child_items[i]->behind && !use_canvas_group) {
 				continue;
@@ -481,6 +577,88 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	}
 }
 
+bool RendererCanvasCull::_can_cull_threaded(uint32_t p_item_count) const {
+	// Chunks never split further, nested lists are culled serially by the chunk that reaches them.
+	return current_cull_chunk == nullptr && p_item_count >= CULL_CHUNK_MIN_ITEMS * 2;
+}
+
+void RendererCanvasCull::_cull_canvas_items_threaded(CullTask &p_task, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list) {
+	uint32_t chunk_count = MIN(p_task.item_count / CULL_CHUNK_MIN_ITEMS, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count() * 2);
+	chunk_count = MAX(chunk_count, 1u);
+	p_task.chunk_size = (p_task.item_count + chunk_count - 1) / chunk_count;
+	chunk_count = (p_task.item_count + p_task.chunk_size - 1) / p_task.chunk_size;
+
+	for (uint32_t i = cull_chunks.size(); i < chunk_count; i++) {
+		cull_chunks.push_back(CullChunk());
+		CullChunk &chunk = cull_chunks[i];
+		chunk.z_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		chunk.z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
+		memset(chunk.z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+		memset(chunk.z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererCanvasCull::_cull_canvas_items_chunk, &p_task, chunk_count, -1, true, SNAME("CanvasCullChunk"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Append the chunk lists in order, then leave the chunks cleared for the next use.
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		CullChunk &chunk = cull_chunks[i];
+		for (int zidx = chunk.z_min; zidx <= chunk.z_max; zidx++) {
+			if (!chunk.z_list[zidx]) {
+				continue;
+			}
+			if (r_z_last_list[zidx]) {
+				r_z_last_list[zidx]->next = chunk.z_list[zidx];
+			} else {
+				r_z_list[zidx] = chunk.z_list[zidx];
+			}
+			r_z_last_list[zidx] = chunk.z_last_list[zidx];
+			chunk.z_list[zidx] = nullptr;
+			chunk.z_last_list[zidx] = nullptr;
+		}
+		chunk.z_min = z_range;
+		chunk.z_max = -1;
+
+		for (Item::VisibilityNotifierData *notifier : chunk.visible_notifiers) {
+			_mark_visibility_notifier_visible(notifier);
+		}
+		chunk.visible_notifiers.clear();
+
+		if (chunk.redraw_requested) {
+			RenderingServerDefault::redraw_request();
+			chunk.redraw_requested = false;
+		}
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_items_chunk(uint32_t p_chunk, CullTask *p_task) {
+	CullChunk &chunk = cull_chunks[p_chunk];
+	current_cull_chunk = &chunk;
+
+	uint32_t from = p_chunk * p_task->chunk_size;
+	uint32_t to = MIN(from + p_task->chunk_size, p_task->item_count);
+	for (uint32_t i = from; i < to; i++) {
+		Item *item = p_task->items[i];
+		if (p_task->y_sorted) {
+			_cull_canvas_item(item, p_task->parent_xform * item->ysort_xform, p_task->clip_rect, p_task->modulate * item->ysort_modulate, item->ysort_parent_abs_z_index, chunk.z_list, chunk.z_last_list, p_task->canvas_clip, (Item *)item->material_owner, true, p_task->canvas_cull_mask, item->repeat_size, item->repeat_times, item->repeat_source_item);
+		} else {
+			if (p_task->behind != -1 && item->behind != (p_task->behind == 1)) {
+				continue;
+			}
+			_cull_canvas_item(item, p_task->parent_xform, p_task->clip_rect, p_task->modulate, p_task->z, chunk.z_list, chunk.z_last_list, p_task->canvas_clip, p_task->material_owner, false, p_task->canvas_cull_mask, p_task->repeat_size, p_task->repeat_times, p_task->repeat_source_item);
+		}
+	}
+
+	current_cull_chunk = nullptr;
+}
+
+void RendererCanvasCull::commit_cull_info() {
+	last_cull_time_usec = cull_time_usec;
+	last_ysort_time_usec = ysort_time_usec.get();
+	cull_time_usec = 0;
+	ysort_time_usec.set(0);
+}
+
 void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel, uint32_t canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info) {
 	RENDER_TIMESTAMP("> Render Canvas");
 
@@ -2781,5 +2959,9 @@ RendererCanvasCull::RendererCanvasCull() {
 RendererCanvasCull::~RendererCanvasCull() {
 	memfree(z_list);
 	memfree(z_last_list);
+	for (CullChunk &chunk : cull_chunks) {
+		memfree(chunk.z_list);
+		memfree(chunk.z_last_list);
+	}
 	_canvas_cull_singleton = nullptr;
 }
@@ -31,11 +31,15 @@
 #pragma once
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/safe_refcount.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 #include "servers/rendering/instance_uniforms.h"
 
 class RendererCanvasCull {
+	friend class TestRendererCanvasCullInternalsAccessor;
+
 	static void _dependency_changed(Dependency::DependencyChangedNotification p_notification, DependencyTracker *p_tracker);
 	static void _dependency_deleted(const RID &p_dependency, DependencyTracker *p_tracker);
 
@@ -201,6 +205,7 @@ public:
 	PagedAllocator<Item::VisibilityNotifierData> visibility_notifier_allocator;
 	SelfList<Item::VisibilityNotifierData>::List visibility_notifier_list;
 
+	void _mark_visibility_notifier_visible(Item::VisibilityNotifierData *p_notifier);
 	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from);
 
 private:
@@ -208,6 +213,7 @@ private:
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_is_already_y_sorted, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item);
 
 	void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, RendererCanvasCull::Item *p_material_owner, const Color &p_modulate, RendererCanvasCull::Item **r_items, int &r_index, int p_z);
+	void _sort_ysort_items(RendererCanvasCull::Item **r_items, int p_count);
 	int _count_ysort_children(RendererCanvasCull::Item *p_canvas_item);
 	void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner);
 
@@ -216,6 +222,53 @@ private:
 	RendererCanvasRender::Item **z_list;
 	RendererCanvasRender::Item **z_last_list;
 
+	// Large sibling lists and y-sorted lists are culled in chunks on the WorkerThreadPool.
+	// Each chunk fills its own z lists, which are appended in chunk order afterwards, so the draw order is unchanged.
+	enum {
+		CULL_CHUNK_MIN_ITEMS = 256,
+		YSORT_RADIX_MIN_ITEMS = 128,
+	};
+
+	struct CullChunk {
+		RendererCanvasRender::Item **z_list = nullptr; // Kept cleared between uses.
+		RendererCanvasRender::Item **z_last_list = nullptr;
+		int z_min = z_range; // Range of used z indices.
+		int z_max = -1;
+		LocalVector<Item::VisibilityNotifierData *> visible_notifiers; // Registered on the calling thread.
+		bool redraw_requested = false;
+	};
+
+	struct CullTask {
+		Item **items = nullptr;
+		uint32_t item_count = 0;
+		uint32_t chunk_size = 0;
+		bool y_sorted = false; // Items were collected by _collect_ysort_children(), and carry their own parameters.
+		int behind = -1; // For siblings, only cull items with this `behind` value, or all of them if -1.
+		Transform2D parent_xform;
+		Rect2 clip_rect;
+		Color modulate;
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+		uint32_t canvas_cull_mask = 0;
+		Point2 repeat_size;
+		int repeat_times = 1;
+		RendererCanvasRender::Item *repeat_source_item = nullptr;
+	};
+
+	LocalVector<CullChunk> cull_chunks;
+	static thread_local CullChunk *current_cull_chunk;
+
+	bool _can_cull_threaded(uint32_t p_item_count) const;
+	void _cull_canvas_items_threaded(CullTask &p_task, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list);
+	void _cull_canvas_items_chunk(uint32_t p_chunk, CullTask *p_task);
+
+	// Cull statistics, accumulated over the frame being drawn and published by commit_cull_info().
+	uint64_t cull_time_usec = 0;
+	SafeNumeric<uint64_t> ysort_time_usec;
+	uint64_t last_cull_time_usec = 0;
+	uint64_t last_ysort_time_usec = 0;
+
 	Transform2D _current_camera_transform;
 
 public:
@@ -223,6 +276,10 @@ public:
 
 	bool was_sdf_used();
 
+	void commit_cull_info();
+	uint64_t get_cull_time_usec() const { return last_cull_time_usec; }
+	uint64_t get_ysort_time_usec() const { return last_ysort_time_usec; }
+
 	RID canvas_allocate();
 	void canvas_initialize(RID p_rid);
 
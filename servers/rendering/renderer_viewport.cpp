@@ -922,6 +922,7 @@ void RendererViewport::draw_viewports(bool p_swap_buffers) {
 	total_objects_drawn = objects_drawn;
 	total_vertices_drawn = vertices_drawn;
 	total_draw_calls_used = draw_calls_used;
+	RSG::canvas->commit_cull_info();
 
 	RENDER_TIMESTAMP("< Render Viewports");
 
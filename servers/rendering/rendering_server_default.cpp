@@ -59,6 +59,63 @@ void RenderingServerDefault::_free(RID p_rid) {
 	}
 }
 
+/* INSTANCE TRANSFORM BATCH */
+
+void RenderingServerDefault::_flush_instance_transform_batch() const {
+	// Only the main thread batches, other threads must not touch the arrays.
+	if (!Thread::is_main_thread() || likely(instance_transform_batch_instances.is_empty())) {
+		return;
+	}
+
+	// The command queue keeps a reference to the arrays, start new ones.
+	Vector<RID> instances = instance_transform_batch_instances;
+	Vector<Transform3D> transforms = instance_transform_batch_transforms;
+	instance_transform_batch_instances = Vector<RID>();
+	instance_transform_batch_transforms = Vector<Transform3D>();
+
+	if (Thread::get_caller_id() != server_thread) {
+		command_queue.push(RSG::scene, &RenderingMethod::instance_set_transforms, instances, transforms);
+	} else {
+		command_queue.flush_if_pending();
+		RSG::scene->instance_set_transforms(instances, transforms);
+	}
+}
+
+void RenderingServerDefault::instance_set_transform(RID p_instance, const Transform3D &p_transform) {
+	redraw_request();
+	if (instance_transform_batch_depth > 0 && Thread::is_main_thread()) {
+		// Transforms of the same instance stay in order, so the latest one still wins.
+		instance_transform_batch_instances.push_back(p_instance);
+		instance_transform_batch_transforms.push_back(p_transform);
+		return;
+	}
+
+	_flush_instance_transform_batch();
+	if (Thread::get_caller_id() != server_thread) {
+		command_queue.push(RSG::scene, &RenderingMethod::instance_set_transform, p_instance, p_transform);
+	} else {
+		command_queue.flush_if_pending();
+		RSG::scene->instance_set_transform(p_instance, p_transform);
+	}
+}
+
+void RenderingServerDefault::begin_instance_transform_batch() {
+	if (Thread::is_main_thread()) {
+		instance_transform_batch_depth++;
+	}
+}
+
+void RenderingServerDefault::end_instance_transform_batch() {
+	if (!Thread::is_main_thread()) {
+		return;
+	}
+	ERR_FAIL_COND(instance_transform_batch_depth == 0);
+	instance_transform_batch_depth--;
+	if (instance_transform_batch_depth == 0) {
+		_flush_instance_transform_batch();
+	}
+}
+
 /* EVENT QUEUING */
 
 void RenderingServerDefault::request_frame_drawn_callback(const Callable &p_callable) {
@@ -297,6 +354,16 @@ uint64_t RenderingServerDefault::get_rendering_info(RenderingInfo p_info) {
 		return RSG::canvas_render->get_pipeline_compilations(PIPELINE_SOURCE_DRAW) + RSG::scene->get_pipeline_compilations(PIPELINE_SOURCE_DRAW);
 	} else if (p_info == RENDERING_INFO_PIPELINE_COMPILATIONS_SPECIALIZATION) {
 		return RSG::canvas_render->get_pipeline_compilations(PIPELINE_SOURCE_SPECIALIZATION) + RSG::scene->get_pipeline_compilations(PIPELINE_SOURCE_SPECIALIZATION);
+	} else if (p_info == RENDERING_INFO_CANVAS_CULL_TIME) {
+		return RSG::canvas->get_cull_time_usec();
+	} else if (p_info == RENDERING_INFO_CANVAS_YSORT_TIME) {
+		return RSG::canvas->get_ysort_time_usec();
+	} else if (p_info == RENDERING_INFO_COMMAND_QUEUE_PENDING_COMMANDS) {
+		return command_queue.get_pending_command_count();
+	} else if (p_info == RENDERING_INFO_COMMAND_QUEUE_FLUSH_COMMANDS) {
+		return command_queue.get_last_flush_command_count();
+	} else if (p_info == RENDERING_INFO_COMMAND_QUEUE_FLUSH_MEM) {
+		return command_queue.get_last_flush_bytes();
 	}
 	return RSG::utilities->get_rendering_info(p_info);
 }
@@ -42,6 +42,8 @@
 #include "servers/server_wrap_mt_common.h"
 
 class RenderingServerDefault : public RenderingServer {
+	friend class TestRenderingServerDefaultInternalsAccessor;
+
 	enum {
 		MAX_INSTANCE_CULL = 8192,
 		MAX_INSTANCE_LIGHTS = 4,
@@ -92,6 +94,12 @@ class RenderingServerDefault : public RenderingServer {
 
 	void _call_on_render_thread(const Callable &p_callable);
 
+	int instance_transform_batch_depth = 0;
+	mutable Vector<RID> instance_transform_batch_instances;
+	mutable Vector<Transform3D> instance_transform_batch_transforms;
+
+	void _flush_instance_transform_batch() const;
+
 public:
 	//if editor is redrawing when it shouldn't, enable this and put a breakpoint in _changes_changed()
 	//#define DEBUG_CHANGES
@@ -885,11 +893,18 @@ public:
 	/* INSTANCING API */
 	FUNCRIDSPLIT(instance)
 
+	// Instance calls submit the pending batched transforms first.
+#undef WRITE_ACTION
+#define WRITE_ACTION redraw_request(); _flush_instance_transform_batch();
+
 	FUNC2(instance_set_base, RID, RID)
 	FUNC2(instance_set_scenario, RID, RID)
 	FUNC2(instance_set_layer_mask, RID, uint32_t)
 	FUNC3(instance_set_pivot_data, RID, float, bool)
-	FUNC2(instance_set_transform, RID, const Transform3D &)
+	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform) override;
+	FUNC2(instance_set_transforms, const Vector<RID> &, const Vector<Transform3D> &)
+	virtual void begin_instance_transform_batch() override;
+	virtual void end_instance_transform_batch() override;
 	FUNC2(instance_attach_object_instance_id, RID, ObjectID)
 	FUNC3(instance_set_blend_shape_weight, RID, int, float)
 	FUNC3(instance_set_surface_override_material, RID, int, RID)
@@ -907,9 +922,48 @@ public:
 	FUNC2(instance_set_ignore_culling, RID, bool)
 
 	// don't use these in a game!
-	FUNC2RC(Vector<ObjectID>, instances_cull_aabb, const AABB &, RID)
-	FUNC3RC(Vector<ObjectID>, instances_cull_ray, const Vector3 &, const Vector3 &, RID)
-	FUNC2RC(Vector<ObjectID>, instances_cull_convex, const Vector<Plane> &, RID)
+	// Culling reads the instance transforms, so it submits the pending ones too.
+	virtual Vector<ObjectID> instances_cull_aabb(const AABB &p_aabb, RID p_scenario) const override {
+		_flush_instance_transform_batch();
+		if (Thread::get_caller_id() != server_thread) {
+			Vector<ObjectID> ret;
+			command_queue.push_and_ret(server_name, &ServerName::instances_cull_aabb, &ret, p_aabb, p_scenario);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return server_name->instances_cull_aabb(p_aabb, p_scenario);
+		}
+	}
+
+	virtual Vector<ObjectID> instances_cull_ray(const Vector3 &p_from, const Vector3 &p_to, RID p_scenario) const override {
+		_flush_instance_transform_batch();
+		if (Thread::get_caller_id() != server_thread) {
+			Vector<ObjectID> ret;
+			command_queue.push_and_ret(server_name, &ServerName::instances_cull_ray, &ret, p_from, p_to, p_scenario);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return server_name->instances_cull_ray(p_from, p_to, p_scenario);
+		}
+	}
+
+	virtual Vector<ObjectID> instances_cull_convex(const Vector<Plane> &p_convex, RID p_scenario) const override {
+		_flush_instance_transform_batch();
+		if (Thread::get_caller_id() != server_thread) {
+			Vector<ObjectID> ret;
+			command_queue.push_and_ret(server_name, &ServerName::instances_cull_convex, &ret, p_convex, p_scenario);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return server_name->instances_cull_convex(p_convex, p_scenario);
+		}
+	}
 
 	FUNC3(instance_geometry_set_flag, RID, InstanceFlags, bool)
 	FUNC2(instance_geometry_set_cast_shadows_setting, RID, ShadowCastingSetting)
@@ -929,6 +983,9 @@ public:
 
 	FUNC1(gi_set_use_half_resolution, bool)
 
+#undef WRITE_ACTION
+#define WRITE_ACTION redraw_request();
+
 #undef server_name
 #undef ServerName
 //from now on, calls forwarded to this singleton
@@ -1134,6 +1191,9 @@ public:
 	/* FREE */
 
 	virtual void free(RID p_rid) override {
+		if (Thread::is_main_thread()) {
+			_flush_instance_transform_batch();
+		}
 		if (Thread::get_caller_id() == server_thread) {
 			command_queue.flush_if_pending();
 			_free(p_rid);
@@ -1445,6 +1445,11 @@ public:
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask) = 0;
 	virtual void instance_set_pivot_data(RID p_instance, float p_sorting_offset, bool p_use_aabb_center) = 0;
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform) = 0;
+	virtual void instance_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) = 0;
+	// While a batch is open, instance transforms set from the main thread are submitted together when the outermost
+	// batch ends. Any other instance call submits the pending ones first, so calls are still applied in order.
+	virtual void begin_instance_transform_batch() = 0;
+	virtual void end_instance_transform_batch() = 0;
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id) = 0;
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight) = 0;
 	virtual void instance_set_surface_override_material(RID p_instance, int p_surface, RID p_material) = 0;
@@ -1469,6 +1474,7 @@ public:
 	PackedInt64Array _instances_cull_aabb_bind(const AABB &p_aabb, RID p_scenario = RID()) const;
 	PackedInt64Array _instances_cull_ray_bind(const Vector3 &p_from, const Vector3 &p_to, RID p_scenario = RID()) const;
 	PackedInt64Array _instances_cull_convex_bind(const TypedArray<Plane> &p_convex, RID p_scenario = RID()) const;
+	void _instance_set_transforms_bind(const TypedArray<RID> &p_instances, const TypedArray<Transform3D> &p_transforms);
 
 	enum InstanceFlags {
 		INSTANCE_FLAG_USE_BAKED_LIGHT,
@@ -1795,6 +1801,11 @@ public:
 		RENDERING_INFO_PIPELINE_COMPILATIONS_SURFACE,
 		RENDERING_INFO_PIPELINE_COMPILATIONS_DRAW,
 		RENDERING_INFO_PIPELINE_COMPILATIONS_SPECIALIZATION,
+		RENDERING_INFO_CANVAS_CULL_TIME,
+		RENDERING_INFO_CANVAS_YSORT_TIME,
+		RENDERING_INFO_COMMAND_QUEUE_PENDING_COMMANDS,
+		RENDERING_INFO_COMMAND_QUEUE_FLUSH_COMMANDS,
+		RENDERING_INFO_COMMAND_QUEUE_FLUSH_MEM,
 		RENDERING_INFO_MAX
 	};
 
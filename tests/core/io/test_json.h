@@ -393,4 +393,126 @@ TEST_CASE("[JSON] Serialization") {
 		}
 	}
 }
+
+TEST_CASE("[JSON] Parsing UTF-8 buffers") {
+	const String text = String::utf8(R"({"name": "Gödot ✓ 🎮", "escaped": "tab\there é 🎮 \"quoted\"", "numbers": [0, -0.5, 12345678901234567890, 1.5e300, 2.5E-3, 0.1, 123.456e2, 9007199254740993], "nested": {"empty": [], "flags": [true, false, null]}})");
+	const Vector<uint8_t> buffer = text.to_utf8_buffer();
+
+	JSON from_string;
+	REQUIRE(from_string.parse(text) == OK);
+	JSON from_buffer;
+	REQUIRE(from_buffer.parse_utf8_buffer(buffer) == OK);
+	CHECK(from_buffer.get_data() == from_string.get_data());
+
+	const Dictionary dictionary = from_buffer.get_data();
+	CHECK(dictionary["name"] == String::utf8("Gödot ✓ 🎮"));
+	CHECK(dictionary["escaped"] == String::utf8("tab\there é 🎮 \"quoted\""));
+
+	// Numbers taking the fast path must round exactly like String::to_float().
+	const Array numbers = dictionary["numbers"];
+	const char *number_texts[] = { "0", "-0.5", "12345678901234567890", "1.5e300", "2.5E-3", "0.1", "123.456e2", "9007199254740993" };
+	for (int i = 0; i < numbers.size(); i++) {
+		CHECK_MESSAGE(double(numbers[i]) == String::to_float(number_texts[i]), number_texts[i]);
+	}
+
+	// A leading BOM is skipped.
+	Vector<uint8_t> with_bom = { 0xEF, 0xBB, 0xBF };
+	with_bom.append_array(String("[1]").to_utf8_buffer());
+	REQUIRE(from_buffer.parse_utf8_buffer(with_bom) == OK);
+	CHECK(from_buffer.get_data() == Variant(Array({ 1.0 })));
+
+	ERR_PRINT_OFF
+	CHECK(from_buffer.parse_utf8_buffer(String("{\"a\": [1, 2}\n").to_utf8_buffer()) == ERR_PARSE_ERROR);
+	CHECK(from_buffer.get_error_message() == "Expected ','");
+	CHECK(from_buffer.parse_utf8_buffer(String("[\n\"unterminated").to_utf8_buffer()) == ERR_PARSE_ERROR);
+	CHECK(from_buffer.get_error_message() == "Unterminated string");
+	CHECK(from_buffer.get_error_line() == 1);
+	ERR_PRINT_ON
+}
+
+TEST_CASE("[JSON] Parsing with a handler") {
+	class CountingHandler : public JSON::Handler {
+	public:
+		int values = 0;
+		int containers = 0;
+		int max_depth = 0;
+		int depth = 0;
+		PackedStringArray keys;
+
+		virtual Error null_value() override {
+			values++;
+			return OK;
+		}
+		virtual Error bool_value(bool p_value) override {
+			values++;
+			return OK;
+		}
+		virtual Error number_value(double p_value) override {
+			values++;
+			return OK;
+		}
+		virtual Error string_value(const String &p_value) override {
+			values++;
+			return OK;
+		}
+		virtual Error begin_array() override {
+			containers++;
+			max_depth = MAX(max_depth, ++depth);
+			return OK;
+		}
+		virtual Error end_array() override {
+			depth--;
+			return OK;
+		}
+		virtual Error begin_object() override {
+			containers++;
+			max_depth = MAX(max_depth, ++depth);
+			return OK;
+		}
+		virtual Error object_key(const String &p_key) override {
+			keys.push_back(p_key);
+			return keys.size() > 2 ? ERR_SKIP : OK;
+		}
+		virtual Error end_object() override {
+			depth--;
+			return OK;
+		}
+	};
+
+	const CharString text = R"([1, "two", {"three": [null, true]}, false])";
+	CountingHandler handler;
+	String err_str;
+	int err_line = 0;
+	CHECK(JSON::parse_utf8((const uint8_t *)text.get_data(), text.length(), handler, err_str, err_line) == OK);
+	CHECK(handler.values == 5);
+	CHECK(handler.containers == 3);
+	CHECK(handler.max_depth == 3);
+	CHECK(handler.depth == 0);
+	CHECK(handler.keys == PackedStringArray({ "three" }));
+
+	// Errors returned by the handler stop parsing.
+	const CharString keys = R"({"a": 1, "b": 2, "c": 3, "d": 4})";
+	CountingHandler stopping;
+	CHECK(JSON::parse_utf8((const uint8_t *)keys.get_data(), keys.length(), stopping, err_str, err_line) == ERR_SKIP);
+	CHECK(stopping.keys.size() == 3);
+}
+
+TEST_CASE("[JSON] Stringify to UTF-8") {
+	Dictionary dictionary;
+	dictionary["text"] = String::utf8("Gödot \"✓\"\n🎮");
+	dictionary["numbers"] = Array({ 1, -42, 0.5, INT64_MIN });
+	dictionary["nested"] = Dictionary();
+
+	for (const String &indent : { String(), String("\t") }) {
+		const String text = JSON::stringify(dictionary, indent);
+		CHECK(JSON::stringify_to_utf8_buffer(dictionary, indent) == text.to_utf8_buffer());
+
+		LocalVector<uint8_t> buffer;
+		buffer.push_back('x');
+		JSON::stringify_utf8(dictionary, buffer, indent);
+		CHECK(buffer.size() == uint32_t(text.to_utf8_buffer().size() + 1));
+		CHECK(buffer[0] == 'x');
+	}
+}
+
 } // namespace TestJSON
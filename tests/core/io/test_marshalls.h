@@ -489,4 +489,51 @@ TEST_CASE("[Marshalls] Typed dictionary decoding") {
 	CHECK(dictionary[Variant(uint64_t(0x0f123456789abcdef))] == Variant(uint64_t(0x0f123456789abcdef)));
 }
 
+TEST_CASE("[Marshalls] Single-pass encoding matches the sized encoding") {
+	Array array;
+	array.push_back(42);
+	array.push_back(String("hello"));
+	array.push_back(StringName("name"));
+	array.push_back(NodePath("a/b:c"));
+	array.push_back(PackedInt32Array({ 1, -2, 3 }));
+	array.push_back(PackedFloat64Array({ 0.5, -1.25 }));
+	array.push_back(PackedVector3Array({ Vector3(1, 2, 3), Vector3(-4, 5, -6) }));
+	array.push_back(PackedColorArray({ Color(0.1, 0.2, 0.3, 0.4) }));
+	array.push_back(PackedStringArray({ "a", "bcd", "" }));
+	array.push_back(PackedByteArray({ 1, 2, 3, 4, 5 }));
+	Dictionary dictionary;
+	dictionary["key"] = Vector2(1.5, 2.5);
+	array.push_back(dictionary);
+
+	int len = 0;
+	CHECK(encode_variant(array, nullptr, len) == OK);
+	Vector<uint8_t> sized;
+	sized.resize(len);
+	CHECK(encode_variant(array, sized.ptrw(), len) == OK);
+
+	// Appends after existing content.
+	Vector<uint8_t> streamed = { 0xAA };
+	CHECK(encode_variant(array, streamed) == OK);
+	REQUIRE(streamed.size() == sized.size() + 1);
+	CHECK(streamed[0] == 0xAA);
+	CHECK(memcmp(streamed.ptr() + 1, sized.ptr(), sized.size()) == 0);
+
+	Variant decoded;
+	int r_len = 0;
+	CHECK(decode_variant(decoded, streamed.ptr() + 1, sized.size(), &r_len) == OK);
+	CHECK(r_len == sized.size());
+	CHECK(decoded == Variant(array));
+}
+
+TEST_CASE("[Marshalls] Array decoding rejects impossible element counts") {
+	uint8_t buffer[] = {
+		0x1c, 0x00, 0x00, 0x00, // Variant::ARRAY
+		0xff, 0xff, 0xff, 0x0f, // Array size.
+	};
+	Variant variant;
+	ERR_PRINT_OFF;
+	CHECK(decode_variant(variant, buffer, 8) == ERR_INVALID_DATA);
+	ERR_PRINT_ON;
+}
+
 } // namespace TestMarshalls
@@ -121,6 +121,41 @@ TEST_CASE("[String] UTF16") {
 	CHECK(String::utf16(cs) == parsed);
 }
 
+TEST_CASE("[String] UTF8 after a long ASCII prefix") {
+	const String ascii = String("0123456789abcdef").repeat(3) + "xyz";
+	static const char32_t u32str[] = { 0x00B5, 0x304A, 0x1F3A4, 0x41, 0 };
+	const String s = ascii + String(u32str);
+
+	Vector<uint8_t> ch_length_map;
+	const CharString utf8 = s.utf8(&ch_length_map);
+	CHECK_EQ(utf8.length(), ascii.length() + 2 + 3 + 4 + 1);
+	CHECK_EQ(ch_length_map.size(), s.length());
+	CHECK_EQ(ch_length_map[0], 1);
+	CHECK_EQ(ch_length_map[ascii.length() - 1], 1);
+	CHECK_EQ(ch_length_map[ascii.length()], 2);
+	CHECK_EQ(ch_length_map[ascii.length() + 2], 4);
+	CHECK_EQ(String::utf8(utf8.get_data()), s);
+	CHECK_EQ(ascii.utf8(), CharString(ascii.ascii().get_data()));
+}
+
+TEST_CASE("[String] Concatenation replaces invalid characters after a long valid prefix") {
+	const String valid = String("0123456789").repeat(2);
+	String invalid = valid;
+	invalid += "abc";
+	invalid.set(12, 0xd812); // Unpaired UTF-16 surrogate.
+	invalid.set(21, 0x20d812); // Outside UTF-32 range.
+
+	ERR_PRINT_OFF
+	const String result = String("prefix") + invalid;
+	ERR_PRINT_ON
+
+	REQUIRE_EQ(result.length(), 6 + invalid.length());
+	CHECK_EQ(result.substr(0, 6 + 12), "prefix" + valid.substr(0, 12));
+	CHECK_EQ(result[6 + 12], 0xfffd);
+	CHECK_EQ(result[6 + 21], 0xfffd);
+	CHECK_EQ(result.substr(6 + 22), "c");
+}
+
 TEST_CASE("[String] UTF8 with BOM") {
 	/* how can i embed UTF in here? */
 	static const char32_t u32str[] = { 0x0045, 0x0020, 0x304A, 0x360F, 0x3088, 0x3046, 0x1F3A4, 0 };
@@ -436,6 +471,26 @@ TEST_CASE("[String] Find character") {
 	CHECK_EQ(s.rfind_char('e', 2), -1);
 }
 
+TEST_CASE("[String] Find in long strings") {
+	// Long enough for the vectorized scans, with matches in and after full blocks.
+	String s = String("abcdefgh").repeat(8) + "needle" + String("xyz").repeat(5) + "needlE";
+	CHECK_EQ(s.find_char('n'), 64);
+	CHECK_EQ(s.find_char('E'), s.length() - 1);
+	CHECK_EQ(s.find_char('q'), -1);
+	CHECK_EQ(s.find_char('a', 1), 8);
+	CHECK_EQ(s.find("needle"), 64);
+	CHECK_EQ(s.find(String("needle")), 64);
+	CHECK_EQ(s.find("needle", 65), -1);
+	CHECK_EQ(s.find(String("needlE")), s.length() - 6);
+	CHECK_EQ(s.find("hab", 10), 15);
+	CHECK_EQ(s.find(String("zne")), 84);
+
+	Vector<String> parts = s.split("needle");
+	REQUIRE_EQ(parts.size(), 2);
+	CHECK_EQ(parts[0], String("abcdefgh").repeat(8));
+	CHECK_EQ(parts[1], String("xyz").repeat(5) + "needlE");
+}
+
 TEST_CASE("[String] Find case insensitive") {
 	String s = "Pretty Whale Whale";
 	MULTICHECK_STRING_EQ(s, findn, "WHA", 7);
@@ -2217,4 +2272,5 @@ TEST_CASE("[Stress][String] Empty via `is_empty()`") {
 		}
 	}
 }
+
 } // namespace TestString
@@ -560,4 +560,109 @@ TEST_CASE("[CommandQueue] Test Parameter Passing Semantics") {
 
 	sts.destroy_threads();
 }
+
+class MultiProducerState {
+public:
+	static const int PRODUCER_COUNT = 4;
+	static const int COMMANDS_PER_PRODUCER = 1000;
+
+	CommandQueueMT command_queue;
+	Thread producers[PRODUCER_COUNT];
+	int last_value[PRODUCER_COUNT];
+	LocalVector<int> execution_order;
+	int order_errors = 0;
+
+	void record(int p_producer, int p_value) {
+		if (p_value != last_value[p_producer] + 1) {
+			order_errors++;
+		}
+		last_value[p_producer] = p_value;
+		execution_order.push_back(p_producer);
+	}
+
+	struct ProducerData {
+		MultiProducerState *state = nullptr;
+		int index = 0;
+	} producer_data[PRODUCER_COUNT];
+
+	static void producer_loop(void *p_userdata) {
+		ProducerData *data = static_cast<ProducerData *>(p_userdata);
+		for (int i = 0; i < COMMANDS_PER_PRODUCER; i++) {
+			data->state->command_queue.push(data->state, &MultiProducerState::record, data->index, i);
+		}
+	}
+
+	MultiProducerState() {
+		for (int i = 0; i < PRODUCER_COUNT; i++) {
+			last_value[i] = -1;
+			producer_data[i].state = this;
+			producer_data[i].index = i;
+		}
+	}
+};
+
+TEST_CASE("[CommandQueue] Multiple producers keep per-producer order") {
+	MultiProducerState state;
+	for (int i = 0; i < MultiProducerState::PRODUCER_COUNT; i++) {
+		state.producers[i].start(&MultiProducerState::producer_loop, &state.producer_data[i]);
+	}
+	// Flush while the producers are still pushing.
+	for (int i = 0; i < 100; i++) {
+		state.command_queue.flush_if_pending();
+	}
+	for (int i = 0; i < MultiProducerState::PRODUCER_COUNT; i++) {
+		state.producers[i].wait_to_finish();
+	}
+
+	CHECK(state.command_queue.get_pending_command_count() == MultiProducerState::PRODUCER_COUNT * MultiProducerState::COMMANDS_PER_PRODUCER - state.execution_order.size());
+	state.command_queue.flush_all();
+
+	CHECK_MESSAGE(state.order_errors == 0, "Commands from the same producer must run in the order they were pushed.");
+	CHECK(state.execution_order.size() == MultiProducerState::PRODUCER_COUNT * MultiProducerState::COMMANDS_PER_PRODUCER);
+	CHECK(state.command_queue.get_pending_command_count() == 0);
+}
+
+TEST_CASE("[CommandQueue] Commands pushed in sequence from different threads run in that order") {
+	MultiProducerState state;
+	// Each producer runs to completion before the next one starts, so all of its commands
+	// happen-before the ones of the next producer and must be executed first.
+	for (int i = 0; i < MultiProducerState::PRODUCER_COUNT; i++) {
+		state.producers[i].start(&MultiProducerState::producer_loop, &state.producer_data[i]);
+		state.producers[i].wait_to_finish();
+	}
+	state.command_queue.flush_all();
+
+	REQUIRE(state.execution_order.size() == MultiProducerState::PRODUCER_COUNT * MultiProducerState::COMMANDS_PER_PRODUCER);
+	bool sorted = true;
+	for (uint32_t i = 1; i < state.execution_order.size(); i++) {
+		if (state.execution_order[i] < state.execution_order[i - 1]) {
+			sorted = false;
+			break;
+		}
+	}
+	CHECK(sorted);
+	CHECK(state.order_errors == 0);
+}
+
+TEST_CASE("[CommandQueue] Flush counters") {
+	MultiProducerState state;
+	CHECK(state.command_queue.get_pending_command_count() == 0);
+	CHECK(state.command_queue.get_last_flush_command_count() == 0);
+
+	for (int i = 0; i < 3; i++) {
+		state.command_queue.push(&state, &MultiProducerState::record, 0, i);
+	}
+	CHECK(state.command_queue.get_pending_command_count() == 3);
+
+	state.command_queue.flush_all();
+	CHECK(state.command_queue.get_pending_command_count() == 0);
+	CHECK(state.command_queue.get_last_flush_command_count() == 3);
+	CHECK(state.command_queue.get_last_flush_bytes() > 0);
+
+	// An empty flush keeps the figures of the last one that did work.
+	uint64_t bytes = state.command_queue.get_last_flush_bytes();
+	state.command_queue.flush_all();
+	CHECK(state.command_queue.get_last_flush_command_count() == 3);
+	CHECK(state.command_queue.get_last_flush_bytes() == bytes);
+}
 } // namespace TestCommandQueue
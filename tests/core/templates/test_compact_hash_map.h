@@ -0,0 +1,244 @@
+/**************************************************************************/
+/*  test_compact_hash_map.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/compact_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCompactHashMap {
+
+TEST_CASE("[CompactHashMap] List initialization") {
+	CompactHashMap<int, String> map{ { 0, "A" }, { 1, "B" }, { 2, "C" }, { 3, "D" }, { 4, "E" } };
+
+	CHECK(map.size() == 5);
+	CHECK(map[0] == "A");
+	CHECK(map[1] == "B");
+	CHECK(map[2] == "C");
+	CHECK(map[3] == "D");
+	CHECK(map[4] == "E");
+}
+
+TEST_CASE("[CompactHashMap] Insert and overwrite element") {
+	CompactHashMap<int, int> map;
+	CompactHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+	CHECK_FALSE(map.find(43));
+
+	map.insert(42, 1234);
+	CHECK(map.size() == 1);
+	CHECK(map[42] == 1234);
+}
+
+TEST_CASE("[CompactHashMap] Erase keeps insertion order") {
+	CompactHashMap<int, int> map;
+	for (int i = 0; i < 6; i++) {
+		map.insert(i, i * 10);
+	}
+	CHECK(map.erase(0));
+	CHECK(map.erase(3));
+	CHECK_FALSE(map.erase(3));
+	map.insert(3, 30);
+
+	Vector<int> expected = { 1, 2, 4, 5, 3 };
+	int index = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(E.key == expected[index]);
+		CHECK(map.get_by_index(index).key == expected[index]);
+		index++;
+	}
+	CHECK(index == 5);
+
+	CHECK(map.erase(1));
+	CHECK(map.erase(2));
+	CHECK(map.erase(4));
+	CHECK(map.erase(5));
+	CHECK(map.erase(3));
+	CHECK(map.is_empty());
+	CHECK(map.begin() == map.end());
+}
+
+TEST_CASE("[CompactHashMap] Growing past linear scan") {
+	CompactHashMap<int, int> map;
+	const int count = CompactHashMap<int, int>::LINEAR_SCAN_MAX * 8;
+	for (int i = 0; i < count; i++) {
+		map[i * 7] = i;
+	}
+	CHECK(map.size() == uint32_t(count));
+
+	// Erase every other element, then insert enough to reuse the freed slots and grow again.
+	for (int i = 0; i < count; i += 2) {
+		CHECK(map.erase(i * 7));
+	}
+	for (int i = 0; i < count; i++) {
+		map[-i - 1] = i;
+	}
+
+	int index = 0;
+	for (const KeyValue<int, int> &E : map) {
+		if (index < count / 2) {
+			CHECK(E.key == (index * 2 + 1) * 7);
+		} else {
+			CHECK(E.key == -(index - count / 2) - 1);
+		}
+		index++;
+	}
+	CHECK(index == count / 2 + count);
+	for (int i = 1; i < count; i += 2) {
+		CHECK(map.has(i * 7));
+		CHECK(map[i * 7] == i);
+	}
+	CHECK_FALSE(map.has(0));
+}
+
+TEST_CASE("[CompactHashMap] Insert while iterating") {
+	CompactHashMap<int, int> map;
+	map[0] = 0;
+
+	int visited = 0;
+	for (const KeyValue<int, int> &E : map) {
+		if (E.key < 20) {
+			// May reallocate, but the iterator refers to the map and its slot.
+			map[E.key + 1] = 0;
+		}
+		visited++;
+	}
+	CHECK(visited == 21);
+}
+
+TEST_CASE("[CompactHashMap] Erase, then insert while iterating") {
+	CompactHashMap<int, int> map;
+	for (int i = 0; i < 4; i++) {
+		map[i] = i;
+	}
+	map.erase(0);
+
+	// Inserting reuses the slot of 0, then grows the map, none of it may skip the remaining pairs.
+	Vector<int> visited;
+	for (const KeyValue<int, int> &E : map) {
+		visited.push_back(E.key);
+		if (E.key < 100) {
+			map[E.key + 100] = 0;
+		}
+	}
+	Vector<int> expected = { 1, 2, 3, 101, 102, 103 };
+	CHECK(visited == expected);
+}
+
+TEST_CASE("[CompactHashMap] References stay valid when inserting") {
+	CompactHashMap<int, String> map;
+	map[0] = "first";
+	String *first = &map[0];
+
+	// Growing past the linear scan, and reusing erased slots, never moves pairs.
+	for (int i = 1; i < 100; i++) {
+		map[i] = map[0];
+	}
+	for (int i = 1; i < 100; i += 2) {
+		map.erase(i);
+	}
+	for (int i = 100; i < 200; i++) {
+		map[i] = itos(i);
+	}
+	CHECK(first == map.getptr(0));
+	CHECK(*first == "first");
+	CHECK(map[98] == "first");
+}
+
+TEST_CASE("[CompactHashMap] Copy") {
+	CompactHashMap<int, String> map;
+	for (int i = 0; i < 20; i++) {
+		map[i] = itos(i);
+	}
+	map.erase(5);
+
+	CompactHashMap<int, String> copy = map;
+	CHECK(copy.size() == 19);
+	CHECK_FALSE(copy.has(5));
+
+	CompactHashMap<int, String> assigned;
+	assigned[100] = "overwritten";
+	assigned = map;
+	CHECK(assigned.size() == 19);
+	CHECK_FALSE(assigned.has(100));
+
+	CompactHashMap<int, String>::ConstIterator it_copy = copy.begin();
+	CompactHashMap<int, String>::ConstIterator it_assigned = assigned.begin();
+	for (const KeyValue<int, String> &E : map) {
+		CHECK(it_copy->key == E.key);
+		CHECK(it_copy->value == E.value);
+		CHECK(it_assigned->key == E.key);
+		++it_copy;
+		++it_assigned;
+	}
+}
+
+TEST_CASE("[CompactHashMap] Move") {
+	CompactHashMap<int, String> map;
+	for (int i = 0; i < 20; i++) {
+		map[i] = itos(i);
+	}
+	const String *element = map.getptr(3);
+
+	CompactHashMap<int, String> moved = std::move(map);
+	CHECK(moved.size() == 20);
+	CHECK(map.is_empty());
+	CHECK_MESSAGE(moved.getptr(3) == element, "Moving should take the storage, not copy the pairs.");
+
+	CompactHashMap<int, String> assigned;
+	for (int i = 100; i < 120; i++) {
+		assigned[i] = itos(i);
+	}
+	assigned = std::move(moved);
+	CHECK(assigned.size() == 20);
+	CHECK(moved.is_empty());
+	CHECK_FALSE(assigned.has(100));
+	CHECK(assigned.getptr(3) == element);
+	int expected = 0;
+	for (const KeyValue<int, String> &E : assigned) {
+		CHECK(E.key == expected);
+		CHECK(E.value == itos(expected));
+		expected++;
+	}
+
+	// Moved-from maps can be used again.
+	moved[1] = "one";
+	CHECK(moved.size() == 1);
+	map = std::move(moved);
+	CHECK(map[1] == "one");
+}
+
+} // namespace TestCompactHashMap
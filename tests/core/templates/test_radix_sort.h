@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_radix_sort.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/random_pcg.h"
+#include "core/templates/radix_sort.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRadixSort {
+
+static bool _is_sorted_stable(const LocalVector<uint32_t> &p_keys, const LocalVector<uint32_t> &p_values) {
+	for (uint32_t i = 1; i < p_keys.size(); i++) {
+		if (p_keys[i - 1] > p_keys[i]) {
+			return false;
+		}
+		// Values start as their original index, equal keys must keep that order.
+		if (p_keys[i - 1] == p_keys[i] && p_values[i - 1] > p_values[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[RadixSort] Float keys") {
+	const float values[] = { 3.5, -1.0, 0.0, -0.0, 1e-30, -1e30, 1e30, 2.0, -2.5 };
+	for (uint32_t i = 0; i < std::size(values); i++) {
+		for (uint32_t j = 0; j < std::size(values); j++) {
+			if (values[i] < values[j]) {
+				CHECK(RadixSort::float_to_key(values[i]) < RadixSort::float_to_key(values[j]));
+			}
+		}
+	}
+}
+
+TEST_CASE("[RadixSort] Sort") {
+	RandomPCG rng(42);
+	RadixSort sort;
+
+	SUBCASE("Small arrays") {
+		for (uint32_t count = 0; count < 100; count++) {
+			LocalVector<uint32_t> keys;
+			LocalVector<uint32_t> values;
+			for (uint32_t i = 0; i < count; i++) {
+				keys.push_back(rng.rand() % 16);
+				values.push_back(i);
+			}
+			sort.sort(keys.ptr(), values.ptr(), count);
+			CHECK(_is_sorted_stable(keys, values));
+		}
+	}
+
+	SUBCASE("Large array sorted in blocks") {
+		const uint32_t count = 200000;
+		LocalVector<uint32_t> keys;
+		LocalVector<uint32_t> values;
+		LocalVector<uint32_t> original_keys;
+		for (uint32_t i = 0; i < count; i++) {
+			keys.push_back(rng.rand());
+			values.push_back(i);
+		}
+		original_keys = keys;
+		sort.sort(keys.ptr(), values.ptr(), count);
+		CHECK(_is_sorted_stable(keys, values));
+
+		bool values_follow_keys = true;
+		for (uint32_t i = 0; i < count; i++) {
+			values_follow_keys = values_follow_keys && original_keys[values[i]] == keys[i];
+		}
+		CHECK(values_follow_keys);
+	}
+
+	SUBCASE("Keys sharing digits") {
+		LocalVector<uint32_t> keys;
+		LocalVector<uint32_t> values;
+		for (uint32_t i = 0; i < 1000; i++) {
+			keys.push_back(0xABCD0000 | ((i * 7) & 0xFF));
+			values.push_back(i);
+		}
+		sort.sort(keys.ptr(), values.ptr(), keys.size());
+		CHECK(_is_sorted_stable(keys, values));
+	}
+}
+
+} // namespace TestRadixSort
@@ -539,6 +539,68 @@ TEST_CASE("[Dictionary] Order and find") {
 	CHECK_EQ(d.find_key("does not exist"), Variant());
 }
 
+TEST_CASE("[Dictionary] Order after erase, growth and sort") {
+	Dictionary d;
+	for (int i = 0; i < 5; i++) {
+		d[i] = i;
+	}
+	d.erase(1);
+	d.erase(3);
+	d[1] = 1;
+
+	Array keys = { 0, 2, 4, 1 };
+	CHECK_EQ(d.keys(), keys);
+	CHECK_EQ(d.get_key_at_index(3), Variant(1));
+	CHECK_EQ(d.get_value_at_index(1), Variant(2));
+	CHECK_EQ(d.get_key_at_index(4), Variant());
+
+	// Grow well past the size where lookups stop scanning linearly.
+	for (int i = 100; i > 5; i--) {
+		d[i] = i;
+	}
+	CHECK_EQ(d.size(), 99);
+	CHECK_EQ(d.get_key_at_index(4), Variant(100));
+	CHECK_EQ(d.get_key_at_index(98), Variant(6));
+
+	const Variant *key = nullptr;
+	int visited = 0;
+	while ((key = d.next(key))) {
+		CHECK_EQ(d[*key], *key);
+		visited++;
+	}
+	CHECK_EQ(visited, 99);
+
+	d.sort();
+	CHECK_EQ(d.get_key_at_index(0), Variant(0));
+	CHECK_EQ(d.get_key_at_index(3), Variant(4));
+	CHECK_EQ(d.get_key_at_index(98), Variant(100));
+	CHECK_EQ(d[50], Variant(50));
+	CHECK_FALSE(d.has(3));
+}
+
+TEST_CASE("[Dictionary] References to values survive insertions") {
+	Dictionary d;
+	d["source"] = "value";
+
+	// The right side is evaluated first, its reference must stay valid while the left side inserts (and grows the storage).
+	for (int i = 0; i < 100; i++) {
+		d[i] = d["source"];
+	}
+	CHECK_EQ(d[0], Variant("value"));
+	CHECK_EQ(d[99], Variant("value"));
+
+	Variant &source = d["source"];
+	for (int i = 0; i < 100; i += 2) {
+		d.erase(i);
+	}
+	for (int i = 100; i < 300; i++) {
+		d[i] = i;
+	}
+	CHECK_EQ(source, Variant("value"));
+	source = "changed";
+	CHECK_EQ(d["source"], Variant("changed"));
+}
+
 TEST_CASE("[Dictionary] Typed copying") {
 	TypedDictionary<int, int> d1;
 	d1[0] = 1;
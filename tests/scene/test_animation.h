@@ -308,4 +308,57 @@ TEST_CASE("[Animation] Create Bezier track") {
 	ERR_PRINT_ON;
 }
 
+TEST_CASE("[Animation] Batch sampling of compressed 3D transform tracks") {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(2.0);
+	const int value_track = animation->add_track(Animation::TYPE_VALUE);
+	animation->track_set_path(value_track, NodePath("Enemy:modulate"));
+	animation->track_insert_key(value_track, 0.0, Color(1, 1, 1));
+
+	for (int i = 0; i < 7; i++) {
+		// More tracks than a single vector holds, so both the vectorized and the remaining tracks are tested.
+		const int position_track = animation->add_track(Animation::TYPE_POSITION_3D);
+		animation->track_set_path(position_track, NodePath(vformat("Skeleton3D:bone_%d", i)));
+		const int rotation_track = animation->add_track(Animation::TYPE_ROTATION_3D);
+		animation->track_set_path(rotation_track, NodePath(vformat("Skeleton3D:bone_%d", i)));
+		const int scale_track = animation->add_track(Animation::TYPE_SCALE_3D);
+		animation->track_set_path(scale_track, NodePath(vformat("Skeleton3D:bone_%d", i)));
+		for (int k = 0; k <= 8; k++) {
+			const double time = k * 0.25;
+			animation->position_track_insert_key(position_track, time, Vector3(Math::sin(time + i), k * 0.5 - i, Math::cos(time * 3.0)));
+			animation->rotation_track_insert_key(rotation_track, time, Quaternion::from_euler(Vector3(time * 2.0, i * 0.3 - time, Math::sin(time * 5.0))));
+			animation->scale_track_insert_key(scale_track, time, Vector3(1.0 + time * 0.1, 1.0, 2.0 - i * 0.1));
+		}
+	}
+
+	Animation::TransformTrackSamples samples;
+	CHECK_MESSAGE(!animation->sample_compressed_transform_tracks(0.0, samples), "Uncompressed animations are not sampled in batch.");
+
+	animation->compress();
+	REQUIRE(animation->track_is_compressed(1));
+
+	for (double time : { 0.0, 0.1, 0.25, 0.6, 1.33, 2.0 }) {
+		REQUIRE(animation->sample_compressed_transform_tracks(time, samples));
+		CHECK_FALSE(samples.is_sampled(value_track));
+		for (int i = 1; i < animation->get_track_count(); i++) {
+			REQUIRE(samples.is_sampled(i));
+			if (animation->track_get_type(i) == Animation::TYPE_ROTATION_3D) {
+				Quaternion expected;
+				REQUIRE(animation->try_rotation_track_interpolate(i, time, &expected) == OK);
+				const Quaternion sampled = samples.get_quaternion(i);
+				CHECK_MESSAGE(Math::abs(sampled.dot(expected)) == doctest::Approx(1.0).epsilon(0.0001), vformat("Rotation track %d at %f: %s, expected %s.", i, time, sampled, expected));
+			} else {
+				Vector3 expected;
+				if (animation->track_get_type(i) == Animation::TYPE_POSITION_3D) {
+					REQUIRE(animation->try_position_track_interpolate(i, time, &expected) == OK);
+				} else {
+					REQUIRE(animation->try_scale_track_interpolate(i, time, &expected) == OK);
+				}
+				const Vector3 sampled = samples.get_vector3(i);
+				CHECK_MESSAGE(sampled.distance_to(expected) < 0.0001, vformat("Track %d at %f: %s, expected %s.", i, time, sampled, expected));
+			}
+		}
+	}
+}
+
 } // namespace TestAnimation
@@ -0,0 +1,173 @@
+/**************************************************************************/
+/*  test_animation_lod_policy.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "scene/3d/visible_on_screen_notifier_3d.h"
+#include "scene/animation/animation_lod_policy.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimationLODPolicy {
+
+TEST_CASE("[AnimationLODPolicy] LOD levels and update intervals") {
+	Ref<AnimationLODPolicy> policy;
+	policy.instantiate();
+	policy->set_lod_distances({ 50.0, 10.0 });
+	policy->set_update_intervals({ 1, 3 });
+
+	CHECK_MESSAGE(policy->get_lod_distances()[0] == doctest::Approx(10.0), "LOD distances should be sorted.");
+	CHECK(policy->get_lod_level(0.0) == 0);
+	CHECK(policy->get_lod_level(10.0) == 1);
+	CHECK(policy->get_lod_level(49.0) == 1);
+	CHECK(policy->get_lod_level(1000.0) == 2);
+
+	CHECK(policy->get_update_interval(0) == 1);
+	CHECK(policy->get_update_interval(1) == 3);
+	CHECK_MESSAGE(policy->get_update_interval(2) == 3, "Levels without an interval should use the last one.");
+}
+
+TEST_CASE("[AnimationLODPolicy] Low priority tracks") {
+	Ref<AnimationLODPolicy> policy;
+	policy.instantiate();
+	CHECK_FALSE(policy->is_low_priority_track(NodePath("Skeleton3D:LeftIndex1")));
+
+	policy->set_low_priority_tracks({ "*:*Index*", "*:blend_shapes/*" });
+	CHECK(policy->is_low_priority_track(NodePath("Skeleton3D:LeftIndex1")));
+	CHECK(policy->is_low_priority_track(NodePath("Face:blend_shapes/Smile")));
+	CHECK_FALSE(policy->is_low_priority_track(NodePath("Skeleton3D:Spine")));
+}
+
+TEST_CASE("[AnimationLODPolicy][SceneTree] Off-screen update throttling") {
+	Node3D *character = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(character);
+
+	VisibleOnScreenNotifier3D *notifier = memnew(VisibleOnScreenNotifier3D);
+	notifier->set_name("Notifier");
+	character->add_child(notifier);
+	notifier->set_owner(character);
+
+	Node *animated = memnew(Node);
+	character->add_child(animated);
+	animated->set_owner(character);
+
+	Ref<AnimationLODPolicy> policy;
+	policy.instantiate();
+	policy->set_offscreen_update_interval(3);
+
+	AnimationLODState state;
+	double delta = 0.0;
+
+	SUBCASE("Without visibility notifier") {
+		for (int i = 0; i < 4; i++) {
+			CHECK(state.advance(policy, animated, 0.1, delta));
+			CHECK(delta == doctest::Approx(0.1));
+		}
+	}
+
+	SUBCASE("Off-screen") {
+		// The notifier is never drawn, so it is off-screen.
+		policy->set_visibility_notifier(NodePath("Notifier"));
+		CHECK_MESSAGE(state.advance(policy, animated, 0.1, delta), "The first frame should always update.");
+
+		// Skip the frames of the first interval, which depend on the instance ID.
+		int skipped = 0;
+		while (!state.advance(policy, animated, 0.1, delta)) {
+			skipped++;
+			REQUIRE(skipped < 5);
+		}
+
+		CHECK_FALSE(state.advance(policy, animated, 0.1, delta));
+		CHECK_FALSE(state.advance(policy, animated, 0.1, delta));
+		CHECK(state.advance(policy, animated, 0.1, delta));
+		CHECK_MESSAGE(delta == doctest::Approx(0.3), "The time of the skipped frames should be accumulated.");
+		CHECK(state.skip_low_priority);
+
+		policy->set_offscreen_update_interval(0);
+		for (int i = 0; i < 10; i++) {
+			CHECK_FALSE(state.advance(policy, animated, 0.1, delta));
+		}
+
+		policy->set_offscreen_update_interval(3);
+		skipped = 0;
+		while (!state.advance(policy, animated, 0.1, delta)) {
+			skipped++;
+			REQUIRE(skipped < 3);
+		}
+		CHECK_MESSAGE(delta <= 0.3 + CMP_EPSILON, "The time spent paused should be dropped.");
+	}
+
+	memdelete(character);
+}
+
+TEST_CASE("[AnimationLODPolicy][SceneTree] Nodes created together update in different frames") {
+	Ref<AnimationLODPolicy> policy;
+	policy.instantiate();
+	policy->set_offscreen_update_interval(4);
+	policy->set_visibility_notifier(NodePath("Notifier"));
+
+	Node3D *character = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(character);
+	VisibleOnScreenNotifier3D *notifier = memnew(VisibleOnScreenNotifier3D);
+	notifier->set_name("Notifier");
+	character->add_child(notifier);
+	notifier->set_owner(character);
+
+	const int node_count = 32;
+	LocalVector<AnimationLODState> states;
+	states.resize(node_count);
+	LocalVector<Node *> nodes;
+	for (int i = 0; i < node_count; i++) {
+		Node *animated = memnew(Node);
+		character->add_child(animated);
+		animated->set_owner(character);
+		nodes.push_back(animated);
+	}
+
+	double delta = 0.0;
+	int updates_per_frame[4] = {};
+	for (int frame = 0; frame < 5; frame++) {
+		for (int i = 0; i < node_count; i++) {
+			if (states[i].advance(policy, nodes[i], 0.1, delta) && frame > 0) {
+				updates_per_frame[frame - 1]++;
+			}
+		}
+	}
+
+	for (int i = 0; i < 4; i++) {
+		CHECK_MESSAGE(updates_per_frame[i] < node_count, "Updates should be spread over the interval.");
+	}
+	CHECK(updates_per_frame[0] + updates_per_frame[1] + updates_per_frame[2] + updates_per_frame[3] == node_count);
+
+	memdelete(character);
+}
+
+} // namespace TestAnimationLODPolicy
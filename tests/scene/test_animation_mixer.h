@@ -0,0 +1,191 @@
+/**************************************************************************/
+/*  test_animation_mixer.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/message_queue.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/node_3d.h"
+#include "scene/animation/animation_player.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+class TestAnimationMixerInternalsAccessor {
+public:
+	static bool is_queued(const AnimationMixer *p_mixer) {
+		return p_mixer->parallel_blend_queued;
+	}
+
+	static uint32_t get_queue_size() {
+		return AnimationMixer::parallel_blend_queue.size();
+	}
+};
+
+namespace TestAnimationMixer {
+
+constexpr int MIXER_COUNT = 4;
+
+static Ref<Animation> _create_animation(int p_mixer, float p_scale) {
+	Ref<Animation> anim;
+	anim.instantiate();
+	anim->set_length(1.0);
+	anim->set_loop_mode(Animation::LOOP_LINEAR);
+
+	// Every mixer writes to the shared nodes, so the order they're applied in matters.
+	int track = anim->add_track(Animation::TYPE_VALUE);
+	anim->track_set_path(track, NodePath("Shared:position"));
+	anim->track_insert_key(track, 0.0, Vector2(p_mixer, 0.0));
+	anim->track_insert_key(track, 1.0, Vector2(10.0 * p_scale, 5.0 * p_mixer));
+
+	track = anim->add_track(Animation::TYPE_VALUE);
+	anim->track_set_path(track, NodePath("Target" + itos(p_mixer) + ":rotation"));
+	anim->track_insert_key(track, 0.0, 0.0);
+	anim->track_insert_key(track, 1.0, p_scale * (p_mixer + 1));
+
+	track = anim->add_track(Animation::TYPE_POSITION_3D);
+	anim->track_set_path(track, NodePath("Shared3D"));
+	anim->position_track_insert_key(track, 0.0, Vector3(0.0, p_mixer, 0.0));
+	anim->position_track_insert_key(track, 1.0, Vector3(p_scale, 0.0, p_mixer));
+	return anim;
+}
+
+static Node *_create_scene(bool p_parallel, LocalVector<AnimationPlayer *> &r_players) {
+	Node *scene = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(scene);
+
+	Node2D *shared = memnew(Node2D);
+	shared->set_name("Shared");
+	scene->add_child(shared);
+	Node3D *shared_3d = memnew(Node3D);
+	shared_3d->set_name("Shared3D");
+	scene->add_child(shared_3d);
+
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		Node2D *target = memnew(Node2D);
+		target->set_name("Target" + itos(i));
+		scene->add_child(target);
+
+		Ref<AnimationLibrary> library;
+		library.instantiate();
+		library->add_animation("a", _create_animation(i, 1.0));
+		library->add_animation("b", _create_animation(i, -2.0));
+
+		AnimationPlayer *player = memnew(AnimationPlayer);
+		player->set_parallel_blending(p_parallel);
+		scene->add_child(player);
+		player->add_animation_library("", library);
+		r_players.push_back(player);
+	}
+	return scene;
+}
+
+TEST_CASE("[AnimationMixer][SceneTree] Parallel blending matches serial blending") {
+	LocalVector<AnimationPlayer *> serial_players;
+	LocalVector<AnimationPlayer *> parallel_players;
+	Node *serial = _create_scene(false, serial_players);
+	Node *parallel = _create_scene(true, parallel_players);
+
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		serial_players[i]->play("a");
+		parallel_players[i]->play("a");
+	}
+
+	for (int frame = 0; frame < 10; frame++) {
+		if (frame == 3) {
+			// Cross-fade, so two animations are blended into the same tracks.
+			for (int i = 0; i < MIXER_COUNT; i++) {
+				serial_players[i]->play("b", 0.5);
+				parallel_players[i]->play("b", 0.5);
+			}
+		}
+		SceneTree::get_singleton()->process(0.1);
+
+		Node2D *serial_shared = Object::cast_to<Node2D>(serial->get_node(NodePath("Shared")));
+		Node2D *parallel_shared = Object::cast_to<Node2D>(parallel->get_node(NodePath("Shared")));
+		CHECK_MESSAGE(parallel_shared->get_position().is_equal_approx(serial_shared->get_position()), vformat("Frame %d: shared 2D position should match.", frame));
+
+		Node3D *serial_shared_3d = Object::cast_to<Node3D>(serial->get_node(NodePath("Shared3D")));
+		Node3D *parallel_shared_3d = Object::cast_to<Node3D>(parallel->get_node(NodePath("Shared3D")));
+		CHECK_MESSAGE(parallel_shared_3d->get_position().is_equal_approx(serial_shared_3d->get_position()), vformat("Frame %d: shared 3D position should match.", frame));
+
+		for (int i = 0; i < MIXER_COUNT; i++) {
+			const NodePath path = NodePath("Target" + itos(i));
+			Node2D *serial_target = Object::cast_to<Node2D>(serial->get_node(path));
+			Node2D *parallel_target = Object::cast_to<Node2D>(parallel->get_node(path));
+			CHECK_MESSAGE(parallel_target->get_rotation() == doctest::Approx(serial_target->get_rotation()), vformat("Frame %d: rotation of target %d should match.", frame, i));
+		}
+	}
+
+	// Sanity check that the animations actually ran.
+	Node2D *serial_target = Object::cast_to<Node2D>(serial->get_node(NodePath("Target1")));
+	CHECK(serial_target->get_rotation() != doctest::Approx(0.0));
+
+	memdelete(serial);
+	memdelete(parallel);
+}
+
+TEST_CASE("[AnimationMixer][SceneTree] Parallel blending queues mixers until the end of the frame") {
+	LocalVector<AnimationPlayer *> serial_players;
+	LocalVector<AnimationPlayer *> parallel_players;
+	Node *serial = _create_scene(false, serial_players);
+	Node *parallel = _create_scene(true, parallel_players);
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		serial_players[i]->play("a");
+		parallel_players[i]->play("a");
+	}
+	SceneTree::get_singleton()->process(0.1);
+
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		serial_players[i]->notification(Node::NOTIFICATION_INTERNAL_PROCESS);
+		parallel_players[i]->notification(Node::NOTIFICATION_INTERNAL_PROCESS);
+	}
+	CHECK(TestAnimationMixerInternalsAccessor::get_queue_size() == MIXER_COUNT);
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		CHECK_FALSE(TestAnimationMixerInternalsAccessor::is_queued(serial_players[i]));
+		CHECK(TestAnimationMixerInternalsAccessor::is_queued(parallel_players[i]));
+	}
+
+	// Nothing is applied until the queue is flushed.
+	Node2D *parallel_target = Object::cast_to<Node2D>(parallel->get_node(NodePath("Target1")));
+	const real_t rotation = parallel_target->get_rotation();
+	MessageQueue::get_singleton()->flush();
+
+	CHECK(TestAnimationMixerInternalsAccessor::get_queue_size() == 0);
+	for (int i = 0; i < MIXER_COUNT; i++) {
+		CHECK_FALSE(TestAnimationMixerInternalsAccessor::is_queued(parallel_players[i]));
+	}
+	CHECK(parallel_target->get_rotation() != doctest::Approx(rotation));
+
+	memdelete(serial);
+	memdelete(parallel);
+}
+
+} // namespace TestAnimationMixer
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*  test_node_3d.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "scene/3d/node_3d.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode3D {
+
+class TransformListener3D : public Node3D {
+	GDCLASS(TransformListener3D, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			transform_changed_count++;
+			last_global_transform = get_global_transform();
+		}
+	}
+
+public:
+	int transform_changed_count = 0;
+	Transform3D last_global_transform;
+};
+
+TEST_CASE("[SceneTree][Node3D] Transform changes of dirty branches") {
+	GDREGISTER_CLASS(TransformListener3D);
+
+	Node3D *root = memnew(Node3D);
+	Node3D *middle = memnew(Node3D);
+	TransformListener3D *listener = memnew(TransformListener3D);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	root->add_child(middle);
+	middle->add_child(listener);
+	listener->set_notify_transform(true);
+	listener->set_position(Vector3(0, 0, 1));
+	SceneTree::get_singleton()->flush_transform_notifications();
+	listener->transform_changed_count = 0;
+
+	SUBCASE("Moving an ancestor several times notifies once, with the final transform") {
+		root->set_position(Vector3(1, 0, 0));
+		middle->set_position(Vector3(0, 1, 0));
+		root->set_position(Vector3(2, 0, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		CHECK(listener->transform_changed_count == 1);
+		CHECK(listener->last_global_transform.origin.is_equal_approx(Vector3(2, 1, 1)));
+		CHECK(listener->get_global_position().is_equal_approx(Vector3(2, 1, 1)));
+	}
+
+	SUBCASE("Moves after a flush are notified again") {
+		root->set_position(Vector3(1, 0, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+		root->set_position(Vector3(3, 0, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		CHECK(listener->transform_changed_count == 2);
+		CHECK(listener->last_global_transform.origin.is_equal_approx(Vector3(3, 0, 1)));
+	}
+
+	SUBCASE("A node that starts listening inside a dirty branch is notified") {
+		TransformListener3D *late_listener = memnew(TransformListener3D);
+		middle->add_child(late_listener);
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		root->set_position(Vector3(1, 0, 0));
+		late_listener->set_notify_transform(true);
+		root->set_position(Vector3(4, 0, 0));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		CHECK(late_listener->transform_changed_count == 1);
+		CHECK(late_listener->last_global_transform.origin.is_equal_approx(Vector3(4, 0, 0)));
+
+		memdelete(late_listener);
+	}
+
+	memdelete(listener);
+	memdelete(middle);
+	memdelete(root);
+}
+
+TEST_CASE("[SceneTree][Node3D] Batched global transform resolve of a large hierarchy") {
+	GDREGISTER_CLASS(TransformListener3D);
+
+	// Wide enough for the levels to be resolved on the thread pool.
+	const int branch_count = 64;
+	const int branch_length = 32;
+
+	Node3D *root = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	LocalVector<TransformListener3D *> leaves;
+	for (int i = 0; i < branch_count; i++) {
+		Node3D *parent = root;
+		for (int j = 0; j < branch_length; j++) {
+			TransformListener3D *node = memnew(TransformListener3D);
+			node->set_position(Vector3(0, 1, 0));
+			node->set_notify_transform(true);
+			parent->add_child(node);
+			parent = node;
+		}
+		leaves.push_back(Object::cast_to<TransformListener3D>(parent));
+	}
+	SceneTree::get_singleton()->flush_transform_notifications();
+
+	root->set_position(Vector3(5, 0, 0));
+	SceneTree::get_singleton()->flush_transform_notifications();
+
+	for (TransformListener3D *leaf : leaves) {
+		CHECK(leaf->transform_changed_count == 2);
+		CHECK(leaf->last_global_transform.origin.is_equal_approx(Vector3(5, branch_length, 0)));
+	}
+
+	memdelete(root);
+}
+
+} // namespace TestNode3D
@@ -72,4 +72,40 @@ TEST_CASE("[Skeleton3D] Test per-bone meta") {
 	skeleton->set_bone_meta(0, "non-existing-key", Variant());
 	memdelete(skeleton);
 }
+
+TEST_CASE("[Skeleton3D] Global poses follow the bone hierarchy") {
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	// Children are added before their parents, so bone indices differ from the nested set order.
+	skeleton->add_bone("hand");
+	skeleton->add_bone("arm");
+	skeleton->add_bone("root");
+	skeleton->add_bone("head");
+	skeleton->set_bone_parent(0, 1);
+	skeleton->set_bone_parent(1, 2);
+	skeleton->set_bone_parent(3, 2);
+	for (int i = 0; i < skeleton->get_bone_count(); i++) {
+		skeleton->set_bone_rest(i, Transform3D(Basis(), Vector3(0, 1, 0)));
+		skeleton->set_bone_pose_position(i, Vector3(0, 1, 0));
+		skeleton->set_bone_pose_rotation(i, Quaternion(Vector3(0, 0, 1), Math::PI / 4 * (i + 1)));
+	}
+
+	const Transform3D root = skeleton->get_bone_pose(2);
+	const Transform3D arm = root * skeleton->get_bone_pose(1);
+	CHECK(skeleton->get_bone_global_pose(2).is_equal_approx(root));
+	CHECK(skeleton->get_bone_global_pose(1).is_equal_approx(arm));
+	CHECK(skeleton->get_bone_global_pose(0).is_equal_approx(arm * skeleton->get_bone_pose(0)));
+	CHECK(skeleton->get_bone_global_pose(3).is_equal_approx(root * skeleton->get_bone_pose(3)));
+
+	// Only the subtree of a changed bone is recalculated.
+	skeleton->set_bone_pose_position(1, Vector3(2, 0, 0));
+	skeleton->force_update_all_dirty_bones();
+	CHECK(skeleton->get_bone_global_pose(0).is_equal_approx(root * skeleton->get_bone_pose(1) * skeleton->get_bone_pose(0)));
+	CHECK(skeleton->get_bone_global_pose(3).is_equal_approx(root * skeleton->get_bone_pose(3)));
+
+	// Disabled bones use their rest.
+	skeleton->set_bone_enabled(2, false);
+	CHECK(skeleton->get_bone_global_pose(3).is_equal_approx(skeleton->get_bone_rest(2) * skeleton->get_bone_pose(3)));
+	memdelete(skeleton);
+}
+
 } // namespace TestSkeleton3D
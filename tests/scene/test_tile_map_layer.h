@@ -0,0 +1,381 @@
+/**************************************************************************/
+/*  test_tile_map_layer.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "scene/2d/tile_map_layer.h"
+#include "scene/main/window.h"
+#include "scene/resources/image_texture.h"
+
+#include "tests/test_macros.h"
+
+class TestTileMapLayerInternalsAccessor {
+public:
+	static int get_dirty_rendering_quadrant_count(const TileMapLayer *p_layer) {
+		int count = 0;
+		for (const SelfList<RenderingQuadrant> *E = p_layer->dirty_rendering_quadrant_list.first(); E; E = E->next()) {
+			count++;
+		}
+		return count;
+	}
+
+#ifndef PHYSICS_2D_DISABLED
+	static int get_dirty_physics_quadrant_count(const TileMapLayer *p_layer) {
+		int count = 0;
+		for (const SelfList<PhysicsQuadrant> *E = p_layer->dirty_physics_quadrant_list.first(); E; E = E->next()) {
+			count++;
+		}
+		return count;
+	}
+
+	static int get_building_physics_quadrant_count(const TileMapLayer *p_layer) {
+		int count = 0;
+		for (const SelfList<PhysicsQuadrant> *E = p_layer->building_physics_quadrant_list.first(); E; E = E->next()) {
+			count++;
+		}
+		return count;
+	}
+
+	static int get_abandoned_physics_build_count(const TileMapLayer *p_layer) {
+		return p_layer->abandoned_physics_builds.size();
+	}
+
+	static int get_physics_shape_count(const TileMapLayer *p_layer) {
+		int count = 0;
+		for (const KeyValue<Vector2i, Ref<PhysicsQuadrant>> &E : p_layer->physics_quadrant_map) {
+			count += E.value->shapes.size();
+		}
+		return count;
+	}
+
+	// Total area of the collision shapes, in the layer's space.
+	static real_t get_physics_shape_area(const TileMapLayer *p_layer) {
+		real_t area = 0.0;
+		for (const KeyValue<Vector2i, Ref<PhysicsQuadrant>> &E : p_layer->physics_quadrant_map) {
+			for (const Ref<ConvexPolygonShape2D> &shape : E.value->shapes) {
+				const Vector<Vector2> points = shape->get_points();
+				real_t shape_area = 0.0;
+				for (int i = 0; i < points.size(); i++) {
+					shape_area += points[i].cross(points[(i + 1) % points.size()]);
+				}
+				area += Math::abs(shape_area) / 2.0;
+			}
+		}
+		return area;
+	}
+
+	static int get_physics_rectangle_count(const TileMapLayer *p_layer, const Size2 &p_size) {
+		int count = 0;
+		for (const KeyValue<Vector2i, Ref<PhysicsQuadrant>> &E : p_layer->physics_quadrant_map) {
+			for (const Ref<ConvexPolygonShape2D> &shape : E.value->shapes) {
+				const Vector<Vector2> points = shape->get_points();
+				if (points.size() == 4 && (points[2] - points[0]).abs().is_equal_approx(p_size) && Math::is_equal_approx(points[0].x, points[3].x)) {
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	static bool is_full_cell_polygon(const Vector<Vector2> &p_polygon, const Vector2 &p_half_cell_size) {
+		return TileMapLayer::_is_full_cell_polygon(p_polygon, p_half_cell_size);
+	}
+#endif // PHYSICS_2D_DISABLED
+};
+
+namespace TestTileMapLayer {
+
+// A 16x16 tile set with three tiles: a full square collision polygon, a triangle covering half the cell, and a notched polygon.
+static Ref<TileSet> _create_tile_set() {
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->set_tile_size(Size2i(16, 16));
+#ifndef PHYSICS_2D_DISABLED
+	tile_set->add_physics_layer();
+#endif // PHYSICS_2D_DISABLED
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instantiate();
+	atlas_source->set_texture(ImageTexture::create_from_image(Image::create_empty(48, 16, false, Image::FORMAT_RGBA8)));
+	tile_set->add_source(atlas_source, 0);
+
+	const Vector<Vector2> polygons[3] = {
+		{ Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(-8, 8) },
+		{ Vector2(-8, -8), Vector2(8, -8), Vector2(-8, 8) },
+		{ Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(0, 0), Vector2(-8, 8) },
+	};
+	for (int i = 0; i < 3; i++) {
+		atlas_source->create_tile(Vector2i(i, 0));
+#ifndef PHYSICS_2D_DISABLED
+		TileData *tile_data = atlas_source->get_tile_data(Vector2i(i, 0), 0);
+		tile_data->add_collision_polygon(0);
+		tile_data->set_collision_polygon_points(0, 0, polygons[i]);
+#endif // PHYSICS_2D_DISABLED
+	}
+	return tile_set;
+}
+
+static TileMapLayer *_create_layer(const Ref<TileSet> &p_tile_set) {
+	TileMapLayer *layer = memnew(TileMapLayer);
+	layer->set_tile_set(p_tile_set);
+	SceneTree::get_singleton()->get_root()->add_child(layer);
+	return layer;
+}
+
+// Runs the update of the next frame, like the scene tree would.
+static void _process_layer(TileMapLayer *p_layer) {
+	if (p_layer->is_processing_internal()) {
+		p_layer->notification(Node::NOTIFICATION_INTERNAL_PROCESS);
+	}
+	MessageQueue::get_singleton()->flush();
+}
+
+TEST_CASE("[TileMapLayer][SceneTree] Quadrant update budget") {
+	TileMapLayer *layer = _create_layer(_create_tile_set());
+	layer->set_rendering_quadrant_size(1);
+#ifndef PHYSICS_2D_DISABLED
+	layer->set_physics_quadrant_size(1);
+#endif // PHYSICS_2D_DISABLED
+	layer->set_quadrant_update_budget(3);
+	for (int i = 0; i < 10; i++) {
+		layer->set_cell(Vector2i(i, 0), 0, Vector2i(0, 0));
+	}
+
+	SUBCASE("Leftover quadrants are updated on the next frames") {
+		const int expected_remaining[4] = { 7, 4, 1, 0 };
+		for (int frame = 0; frame < 4; frame++) {
+			_process_layer(layer);
+			CHECK(TestTileMapLayerInternalsAccessor::get_dirty_rendering_quadrant_count(layer) == expected_remaining[frame]);
+#ifndef PHYSICS_2D_DISABLED
+			CHECK(TestTileMapLayerInternalsAccessor::get_dirty_physics_quadrant_count(layer) == expected_remaining[frame]);
+			CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_count(layer) == 10 - expected_remaining[frame]);
+#endif // PHYSICS_2D_DISABLED
+		}
+		CHECK_MESSAGE(!layer->is_processing_internal(), "The layer should stop processing once all quadrants are updated.");
+	}
+
+	SUBCASE("update_internals() ignores the budget") {
+		layer->update_internals();
+		CHECK(TestTileMapLayerInternalsAccessor::get_dirty_rendering_quadrant_count(layer) == 0);
+#ifndef PHYSICS_2D_DISABLED
+		CHECK(TestTileMapLayerInternalsAccessor::get_dirty_physics_quadrant_count(layer) == 0);
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_count(layer) == 10);
+#endif // PHYSICS_2D_DISABLED
+		CHECK_FALSE(layer->is_processing_internal());
+	}
+
+	SUBCASE("Without budget") {
+		layer->set_quadrant_update_budget(0);
+		_process_layer(layer);
+		CHECK(TestTileMapLayerInternalsAccessor::get_dirty_rendering_quadrant_count(layer) == 0);
+#ifndef PHYSICS_2D_DISABLED
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_count(layer) == 10);
+#endif // PHYSICS_2D_DISABLED
+	}
+
+	memdelete(layer);
+}
+
+#ifndef PHYSICS_2D_DISABLED
+TEST_CASE("[TileMapLayer][SceneTree] Threaded collision build") {
+	Ref<TileSet> tile_set = _create_tile_set();
+
+	// Built synchronously, as reference.
+	TileMapLayer *reference = _create_layer(tile_set);
+	TileMapLayer *layer = _create_layer(tile_set);
+	layer->set_use_threaded_collision_build(true);
+	for (TileMapLayer *l : { reference, layer }) {
+		for (int i = 0; i < 20; i++) {
+			l->set_cell(Vector2i(i, i % 3), 0, Vector2i(i % 3, 0));
+		}
+	}
+	reference->update_internals();
+
+	// Waits for the threaded builds of the layer to be swapped in.
+	auto wait_for_builds = [&]() {
+		for (int frame = 0; frame < 1000 && layer->is_processing_internal(); frame++) {
+			OS::get_singleton()->delay_usec(1000);
+			_process_layer(layer);
+		}
+		REQUIRE_FALSE(layer->is_processing_internal());
+	};
+
+	SUBCASE("Matches the synchronous build") {
+		_process_layer(layer);
+		wait_for_builds();
+		CHECK(TestTileMapLayerInternalsAccessor::get_building_physics_quadrant_count(layer) == 0);
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_count(layer) == TestTileMapLayerInternalsAccessor::get_physics_shape_count(reference));
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+	}
+
+	SUBCASE("Old shapes stay active until the new ones are ready") {
+		_process_layer(layer);
+		wait_for_builds();
+		const real_t area = TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer);
+
+		layer->set_cell(Vector2i(0, 0));
+		_process_layer(layer);
+		if (TestTileMapLayerInternalsAccessor::get_building_physics_quadrant_count(layer) > 0) {
+			CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(area));
+		}
+		wait_for_builds();
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) < area);
+	}
+
+	SUBCASE("Outdated builds are dropped") {
+		// Each change restarts the builds of the quadrant, the previous ones are abandoned.
+		for (int i = 0; i < 5; i++) {
+			layer->set_cell(Vector2i(0, 0), 0, Vector2i(i % 3, 0));
+			reference->set_cell(Vector2i(0, 0), 0, Vector2i(i % 3, 0));
+			_process_layer(layer);
+		}
+		reference->update_internals();
+		wait_for_builds();
+		CHECK(TestTileMapLayerInternalsAccessor::get_abandoned_physics_build_count(layer) == 0);
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+	}
+
+	SUBCASE("update_internals() waits for running builds") {
+		_process_layer(layer);
+		layer->set_cell(Vector2i(1, 1), 0, Vector2i(0, 0));
+		reference->set_cell(Vector2i(1, 1), 0, Vector2i(0, 0));
+		layer->update_internals();
+		reference->update_internals();
+		CHECK(TestTileMapLayerInternalsAccessor::get_building_physics_quadrant_count(layer) == 0);
+		CHECK(TestTileMapLayerInternalsAccessor::get_abandoned_physics_build_count(layer) == 0);
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+	}
+
+	memdelete(layer);
+	memdelete(reference);
+}
+
+TEST_CASE("[TileMapLayer] Full cell polygons") {
+	const Vector2 half_cell_size(8, 8);
+	CHECK(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(-8, 8) }, half_cell_size));
+	CHECK_MESSAGE(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(8, 8), Vector2(-8, 8), Vector2(-8, -8), Vector2(8, -8) }, half_cell_size), "The winding and starting point should not matter.");
+	CHECK(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-4, -8), Vector2(4, -8), Vector2(4, 8), Vector2(-4, 8) }, Vector2(4, 8)));
+
+	CHECK_FALSE_MESSAGE(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-8, -8), Vector2(8, -8), Vector2(-8, 8) }, half_cell_size), "Triangles should not be full cells.");
+	CHECK_FALSE_MESSAGE(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(0, 0), Vector2(-8, 8) }, half_cell_size), "Polygons with more points should not be full cells.");
+	CHECK_FALSE_MESSAGE(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-6, -6), Vector2(6, -6), Vector2(6, 6), Vector2(-6, 6) }, half_cell_size), "Smaller squares should not be full cells.");
+	CHECK_FALSE_MESSAGE(TestTileMapLayerInternalsAccessor::is_full_cell_polygon({ Vector2(-8, -8), Vector2(8, -8), Vector2(8, 8), Vector2(8, -8) }, half_cell_size), "Every corner should be used once.");
+}
+
+TEST_CASE("[TileMapLayer] Merge full cells into rectangles") {
+	PhysicsQuadrant::Build::Body body;
+	// A 3x2 block, and an L shape next to it:
+	// ###.#
+	// ###.#
+	// ....##
+	for (int y = 0; y < 2; y++) {
+		for (int x = 0; x < 3; x++) {
+			body.full_cells.push_back(Vector2i(x, y));
+		}
+	}
+	body.full_cells.push_back(Vector2i(4, 0));
+	body.full_cells.push_back(Vector2i(4, 1));
+	body.full_cells.push_back(Vector2i(4, 2));
+	body.full_cells.push_back(Vector2i(5, 2));
+
+	const Vector2 cell_origin(-8, -8);
+	const Vector2 cell_size(16, 16);
+	PhysicsQuadrant::Build::merge_full_cells(body, cell_origin, cell_size);
+
+	CHECK(body.full_cells.is_empty());
+	CHECK_MESSAGE(body.convex_polygons.size() == 3, "The cells should be merged into three rectangles.");
+
+	real_t area = 0.0;
+	for (const Vector<Vector2> &rectangle : body.convex_polygons) {
+		REQUIRE(rectangle.size() == 4);
+		const Rect2 rect = Rect2(rectangle[0], Size2()).expand(rectangle[2]);
+		area += rect.get_area();
+		// Every rectangle is aligned on the cell grid.
+		const Vector2 from = (rect.position - cell_origin) / cell_size;
+		const Vector2 to = (rect.get_end() - cell_origin) / cell_size;
+		CHECK(from.is_equal_approx(from.round()));
+		CHECK(to.is_equal_approx(to.round()));
+	}
+	CHECK(area == doctest::Approx(10 * 16 * 16));
+	CHECK(body.convex_polygons[0] == Vector<Vector2>({ Vector2(-8, -8), Vector2(40, -8), Vector2(40, 24), Vector2(-8, 24) }));
+}
+
+TEST_CASE("[TileMapLayer][SceneTree] Rectangle collision merging") {
+	Ref<TileSet> tile_set = _create_tile_set();
+	TileMapLayer *reference = _create_layer(tile_set);
+	TileMapLayer *layer = _create_layer(tile_set);
+	layer->set_use_rectangle_collision_merging(true);
+
+	// A block of full cells with partial and custom polygon cells around it.
+	for (TileMapLayer *l : { reference, layer }) {
+		for (int y = 0; y < 4; y++) {
+			for (int x = 0; x < 6; x++) {
+				l->set_cell(Vector2i(x, y), 0, Vector2i(0, 0));
+			}
+		}
+		for (int x = 0; x < 6; x++) {
+			l->set_cell(Vector2i(x, 4), 0, Vector2i(1 + x % 2, 0));
+		}
+		l->set_cell(Vector2i(8, 8), 0, Vector2i(2, 0));
+	}
+
+	SUBCASE("Same collision area with fewer shapes") {
+		reference->update_internals();
+		layer->update_internals();
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(24 * 16 * 16 + 3 * 8 * 16 + 3 * 12 * 16 + 12 * 16));
+		CHECK_MESSAGE(TestTileMapLayerInternalsAccessor::get_physics_rectangle_count(layer, Size2(6 * 16, 4 * 16)) == 1, "The full cells should be merged into a single rectangle.");
+	}
+
+	SUBCASE("Only on square tiles") {
+		tile_set->set_tile_shape(TileSet::TILE_SHAPE_HEXAGON);
+		reference->update_internals();
+		layer->update_internals();
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_count(layer) == TestTileMapLayerInternalsAccessor::get_physics_shape_count(reference));
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+	}
+
+	SUBCASE("Flipped full cells are still merged") {
+		layer->set_cell(Vector2i(2, 2), 0, Vector2i(0, 0), TileSetAtlasSource::TRANSFORM_FLIP_H | TileSetAtlasSource::TRANSFORM_TRANSPOSE);
+		reference->set_cell(Vector2i(2, 2), 0, Vector2i(0, 0), TileSetAtlasSource::TRANSFORM_FLIP_H | TileSetAtlasSource::TRANSFORM_TRANSPOSE);
+		reference->update_internals();
+		layer->update_internals();
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_shape_area(layer) == doctest::Approx(TestTileMapLayerInternalsAccessor::get_physics_shape_area(reference)));
+		CHECK(TestTileMapLayerInternalsAccessor::get_physics_rectangle_count(layer, Size2(6 * 16, 4 * 16)) == 1);
+	}
+
+	memdelete(layer);
+	memdelete(reference);
+}
+#endif // PHYSICS_2D_DISABLED
+
+} // namespace TestTileMapLayer
@@ -0,0 +1,177 @@
+/**************************************************************************/
+/*  test_renderer_canvas_cull.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/random_number_generator.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+class TestRendererCanvasCullInternalsAccessor {
+public:
+	static void sort_ysort_items(RendererCanvasCull::Item **r_items, int p_count) {
+		RSG::canvas->_sort_ysort_items(r_items, p_count);
+	}
+
+	// Culls the item as the root of a canvas, and returns the render items in draw order.
+	static LocalVector<RendererCanvasRender::Item *> cull(RID p_item, bool p_threaded) {
+		RendererCanvasCull *canvas = RSG::canvas;
+		RendererCanvasCull::Item *item = canvas->canvas_item_owner.get_or_null(p_item);
+
+		LocalVector<RendererCanvasRender::Item *> z_list;
+		LocalVector<RendererCanvasRender::Item *> z_last_list;
+		z_list.resize_initialized(RendererCanvasCull::z_range);
+		z_last_list.resize_initialized(RendererCanvasCull::z_range);
+
+		// Lists are never split from inside a chunk, so pretending to be in one keeps the culling serial.
+		RendererCanvasCull::CullChunk serial_chunk;
+		if (!p_threaded) {
+			RendererCanvasCull::current_cull_chunk = &serial_chunk;
+		}
+		canvas->_cull_canvas_item(item, Transform2D(), Rect2(-10000, -10000, 20000, 20000), Color(1, 1, 1, 1), 0, z_list.ptr(), z_last_list.ptr(), nullptr, nullptr, false, 0xFFFFFFFF, Point2(), 1, nullptr);
+		RendererCanvasCull::current_cull_chunk = nullptr;
+
+		LocalVector<RendererCanvasRender::Item *> draw_list;
+		for (RendererCanvasRender::Item *first : z_list) {
+			for (RendererCanvasRender::Item *ci = first; ci; ci = ci->next) {
+				draw_list.push_back(ci);
+			}
+		}
+		return draw_list;
+	}
+};
+
+namespace TestRendererCanvasCull {
+
+static void _check_ysort(int p_count) {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(42);
+
+	LocalVector<RendererCanvasCull::Item *> items;
+	for (int i = 0; i < p_count; i++) {
+		RendererCanvasCull::Item *item = memnew(RendererCanvasCull::Item);
+		// Many equal positions, negative ones, and both zeros.
+		real_t y = rng->randi_range(-50, 50) * 0.5;
+		if (i % 17 == 0) {
+			y = (i % 2) ? -0.0 : 0.0;
+		}
+		item->ysort_xform.columns[2].y = y;
+		item->ysort_index = i;
+		items.push_back(item);
+	}
+
+	LocalVector<RendererCanvasCull::Item *> expected = items;
+	SortArray<RendererCanvasCull::Item *, RendererCanvasCull::ItemYSort> sorter;
+	sorter.sort(expected.ptr(), expected.size());
+
+	TestRendererCanvasCullInternalsAccessor::sort_ysort_items(items.ptr(), items.size());
+	bool same_order = true;
+	for (int i = 0; i < p_count; i++) {
+		same_order = same_order && items[i] == expected[i];
+	}
+	CHECK_MESSAGE(same_order, "Items should be sorted by Y, and keep their collection order when Y is equal.");
+
+	for (RendererCanvasCull::Item *item : items) {
+		memdelete(item);
+	}
+}
+
+static void _check_threaded_cull(bool p_y_sorted) {
+	RendererCanvasCull *canvas = RSG::canvas;
+	RID canvas_rid = canvas->canvas_allocate();
+	canvas->canvas_initialize(canvas_rid);
+
+	RID root = canvas->canvas_item_allocate();
+	canvas->canvas_item_initialize(root);
+	canvas->canvas_item_set_parent(root, canvas_rid);
+	canvas->canvas_item_add_rect(root, Rect2(0, 0, 100, 100), Color(1, 1, 1), false);
+
+	canvas->canvas_item_set_sort_children_by_y(root, p_y_sorted);
+
+	// Enough items to be culled in several chunks, with different z indices, items drawn behind their parent, and nested items.
+	LocalVector<RID> items;
+	for (int i = 0; i < 1200; i++) {
+		RID item = canvas->canvas_item_allocate();
+		canvas->canvas_item_initialize(item);
+		canvas->canvas_item_set_parent(item, root);
+		canvas->canvas_item_set_transform(item, Transform2D(0.0, Vector2((i % 40) * 10, (i * 37) % 100)));
+		canvas->canvas_item_set_z_index(item, i % 5 - 2);
+		canvas->canvas_item_set_draw_behind_parent(item, i % 7 == 0);
+		canvas->canvas_item_add_rect(item, Rect2(0, 0, 8, 8), Color(1, 1, 1), false);
+		items.push_back(item);
+
+		if (i % 13 == 0) {
+			RID child = canvas->canvas_item_allocate();
+			canvas->canvas_item_initialize(child);
+			canvas->canvas_item_set_parent(child, item);
+			canvas->canvas_item_set_transform(child, Transform2D(0.0, Vector2(2, -(i % 3))));
+			canvas->canvas_item_add_rect(child, Rect2(0, 0, 4, 4), Color(1, 1, 1), false);
+			items.push_back(child);
+		}
+	}
+
+	const LocalVector<RendererCanvasRender::Item *> serial = TestRendererCanvasCullInternalsAccessor::cull(root, false);
+	const LocalVector<RendererCanvasRender::Item *> threaded = TestRendererCanvasCullInternalsAccessor::cull(root, true);
+	CHECK(serial.size() == items.size() + 1);
+	REQUIRE(threaded.size() == serial.size());
+	bool same_order = true;
+	for (uint32_t i = 0; i < serial.size(); i++) {
+		same_order = same_order && serial[i] == threaded[i];
+	}
+	CHECK_MESSAGE(same_order, "Items should be drawn in the same order when culled in chunks.");
+
+	for (int i = items.size() - 1; i >= 0; i--) {
+		canvas->free(items[i]);
+	}
+	canvas->free(root);
+	canvas->free(canvas_rid);
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Y-sort matches the comparison sort") {
+	SUBCASE("Comparison sort") {
+		_check_ysort(16);
+	}
+	SUBCASE("Radix sort") {
+		_check_ysort(1000);
+	}
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Threaded culling keeps the draw order") {
+	SUBCASE("Siblings") {
+		_check_threaded_cull(false);
+	}
+	SUBCASE("Y-sorted") {
+		_check_threaded_cull(true);
+	}
+}
+
+} // namespace TestRendererCanvasCull
@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*  test_rendering_server_default.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#pragma once
+
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_server_default.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+class TestRenderingServerDefaultInternalsAccessor {
+public:
+	static int get_pending_transform_count() {
+		return static_cast<RenderingServerDefault *>(RS::get_singleton())->instance_transform_batch_instances.size();
+	}
+};
+
+namespace TestRenderingServerDefault {
+
+static Transform3D _get_server_transform(RID p_instance) {
+	RendererSceneCull *scene = static_cast<RendererSceneCull *>(RSG::scene);
+	return scene->instance_owner.get_or_null(p_instance)->transform;
+}
+
+static bool _is_server_visible(RID p_instance) {
+	RendererSceneCull *scene = static_cast<RendererSceneCull *>(RSG::scene);
+	return scene->instance_owner.get_or_null(p_instance)->visible;
+}
+
+TEST_CASE("[SceneTree][RenderingServer] Batched instance transforms stay in order with other instance calls") {
+	RenderingServer *rs = RS::get_singleton();
+	const RID a = rs->instance_create();
+	const RID b = rs->instance_create();
+	const Transform3D first(Basis(), Vector3(1, 2, 3));
+	const Transform3D second(Basis(), Vector3(4, 5, 6));
+	const Transform3D third(Basis(), Vector3(7, 8, 9));
+
+	rs->begin_instance_transform_batch();
+	rs->instance_set_transform(a, first);
+	CHECK(TestRenderingServerDefaultInternalsAccessor::get_pending_transform_count() == 1);
+	CHECK(_get_server_transform(a) == Transform3D());
+
+	// Other instance calls submit the pending transforms before they are applied.
+	rs->instance_set_visible(a, false);
+	CHECK(TestRenderingServerDefaultInternalsAccessor::get_pending_transform_count() == 0);
+	CHECK(_get_server_transform(a) == first);
+	CHECK_FALSE(_is_server_visible(a));
+
+	rs->instance_set_transform(a, second);
+	rs->instance_set_transform(b, third);
+	rs->instance_set_visible(b, false);
+	rs->instance_set_transform(a, third);
+	CHECK(TestRenderingServerDefaultInternalsAccessor::get_pending_transform_count() == 1);
+	CHECK(_get_server_transform(a) == second);
+	CHECK(_get_server_transform(b) == third);
+
+	// Nested batches are submitted when the outermost one ends.
+	rs->begin_instance_transform_batch();
+	rs->instance_set_transform(b, first);
+	rs->end_instance_transform_batch();
+	CHECK(TestRenderingServerDefaultInternalsAccessor::get_pending_transform_count() == 2);
+	CHECK(_get_server_transform(b) == third);
+
+	rs->end_instance_transform_batch();
+	CHECK(TestRenderingServerDefaultInternalsAccessor::get_pending_transform_count() == 0);
+	CHECK(_get_server_transform(a) == third);
+	CHECK(_get_server_transform(b) == first);
+	CHECK_FALSE(_is_server_visible(a));
+	CHECK_FALSE(_is_server_visible(b));
+
+	// Outside of a batch, transforms are sent right away.
+	rs->instance_set_transform(a, first);
+	CHECK(_get_server_transform(a) == first);
+
+	// Transforms of instances freed before the batch is submitted are dropped.
+	rs->begin_instance_transform_batch();
+	rs->instance_set_transform(b, second);
+	rs->free(b);
+	rs->instance_set_transform(a, second);
+	rs->end_instance_transform_batch();
+	CHECK(_get_server_transform(a) == second);
+
+	rs->free(a);
+}
+
+} // namespace TestRenderingServerDefault
@@ -0,0 +1,233 @@
+/**************************************************************************/
+/*  test_audio_decode_cache.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/os.h"
+#include "servers/audio/audio_decode_ahead.h"
+#include "servers/audio/audio_decode_cache.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioDecodeCache {
+
+static Vector<AudioFrame> _make_frames(int p_count) {
+	Vector<AudioFrame> frames;
+	frames.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		frames.write[i] = AudioFrame(i, -i);
+	}
+	return frames;
+}
+
+TEST_CASE("[AudioDecodeCache] Least recently used streams are evicted first") {
+	const int frame_count = 1000;
+	AudioDecodeCache::clear();
+	AudioDecodeCache::set_limits(10.0, frame_count * 2 * sizeof(AudioFrame));
+
+	CHECK(AudioDecodeCache::is_cacheable(5.0));
+	CHECK_FALSE(AudioDecodeCache::is_cacheable(20.0));
+	CHECK_FALSE(AudioDecodeCache::is_cacheable(0.0));
+
+	AudioDecodeCache::insert(ObjectID(uint64_t(1)), _make_frames(frame_count));
+	AudioDecodeCache::insert(ObjectID(uint64_t(2)), _make_frames(frame_count));
+
+	Vector<AudioFrame> frames;
+	CHECK(AudioDecodeCache::get(ObjectID(uint64_t(1)), frames));
+	CHECK(frames.size() == frame_count);
+
+	// Stream 1 was used last, so stream 2 is evicted to make room for stream 3.
+	AudioDecodeCache::insert(ObjectID(uint64_t(3)), _make_frames(frame_count));
+	CHECK(AudioDecodeCache::get(ObjectID(uint64_t(1)), frames));
+	CHECK_FALSE(AudioDecodeCache::get(ObjectID(uint64_t(2)), frames));
+	CHECK(AudioDecodeCache::get(ObjectID(uint64_t(3)), frames));
+	CHECK(AudioDecodeCache::get_memory_used() == frame_count * 2 * sizeof(AudioFrame));
+
+	AudioDecodeCache::erase(ObjectID(uint64_t(1)));
+	CHECK_FALSE(AudioDecodeCache::get(ObjectID(uint64_t(1)), frames));
+	CHECK(AudioDecodeCache::get_memory_used() == frame_count * sizeof(AudioFrame));
+
+	// Eviction is by size, a large stream evicts as many entries as needed.
+	AudioDecodeCache::insert(ObjectID(uint64_t(4)), _make_frames(frame_count));
+	AudioDecodeCache::insert(ObjectID(uint64_t(5)), _make_frames(frame_count * 2));
+	CHECK_FALSE(AudioDecodeCache::get(ObjectID(uint64_t(3)), frames));
+	CHECK_FALSE(AudioDecodeCache::get(ObjectID(uint64_t(4)), frames));
+	CHECK(AudioDecodeCache::get(ObjectID(uint64_t(5)), frames));
+	CHECK(AudioDecodeCache::get_memory_used() == frame_count * 2 * sizeof(AudioFrame));
+
+	// Lowering the budget evicts right away.
+	AudioDecodeCache::insert(ObjectID(uint64_t(6)), _make_frames(frame_count / 2));
+	AudioDecodeCache::set_limits(10.0, frame_count * sizeof(AudioFrame));
+	CHECK_FALSE(AudioDecodeCache::get(ObjectID(uint64_t(5)), frames));
+	CHECK(AudioDecodeCache::get_memory_used() == frame_count / 2 * sizeof(AudioFrame));
+	CHECK(AudioDecodeCache::get(ObjectID(uint64_t(6)), frames));
+
+	// Frames handed out stay valid after eviction.
+	AudioDecodeCache::clear();
+	CHECK(frames.size() == frame_count);
+	CHECK(frames[frame_count - 1].left == doctest::Approx(frame_count - 1));
+	CHECK(AudioDecodeCache::get_memory_used() == 0);
+
+	AudioDecodeCache::set_limits(0.0, 0);
+}
+
+TEST_CASE("[AudioDecodeCache] Background decodes are cancelled when the stream changes") {
+	AudioDecodeCache::clear();
+	AudioDecodeCache::set_limits(10.0, 1024 * 1024);
+	const ObjectID stream = ObjectID(uint64_t(1));
+
+	CHECK(AudioDecodeCache::begin_decode(stream));
+	// Already being decoded.
+	CHECK_FALSE(AudioDecodeCache::begin_decode(stream));
+
+	// The data changed while decoding, the frames are outdated.
+	AudioDecodeCache::erase(stream);
+	AudioDecodeCache::finish_decode(stream, _make_frames(100));
+	Vector<AudioFrame> frames;
+	CHECK_FALSE(AudioDecodeCache::get(stream, frames));
+
+	CHECK(AudioDecodeCache::begin_decode(stream));
+	AudioDecodeCache::finish_decode(stream, _make_frames(100));
+	CHECK(AudioDecodeCache::get(stream, frames));
+	CHECK(frames.size() == 100);
+	// Already cached.
+	CHECK_FALSE(AudioDecodeCache::begin_decode(stream));
+
+	AudioDecodeCache::clear();
+	AudioDecodeCache::set_limits(0.0, 0);
+}
+
+struct TestDecoder {
+	uint32_t position = 0;
+	uint32_t length = 0;
+};
+
+static int _test_decode(void *p_userdata, AudioFrame *p_buffer, int p_frames, uint32_t &r_position, int &r_loops) {
+	TestDecoder *decoder = (TestDecoder *)p_userdata;
+	int frames = MIN(p_frames, int(decoder->length - decoder->position));
+	for (int i = 0; i < frames; i++) {
+		p_buffer[i] = AudioFrame(decoder->position + i, 0);
+	}
+	decoder->position += frames;
+	r_position = decoder->position;
+	r_loops = 0;
+	return frames;
+}
+
+static void _test_seek(void *p_userdata, uint32_t p_position, bool p_restart) {
+	TestDecoder *decoder = (TestDecoder *)p_userdata;
+	decoder->position = MIN(p_position, decoder->length);
+}
+
+static bool _wait_for_decoder(AudioDecodeAheadBuffer &p_buffer, TestDecoder &p_decoder) {
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (OS::get_singleton()->get_ticks_msec() < timeout) {
+		{
+			MutexLock lock(p_buffer.get_mutex());
+			if (p_decoder.position == p_decoder.length) {
+				return true;
+			}
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+	return false;
+}
+
+TEST_CASE("[AudioDecodeCache] Decode-ahead buffer returns frames in order until the end of the stream") {
+	bool was_running = AudioDecodeAheadThread::is_running();
+	if (!was_running) {
+		AudioDecodeAheadThread::init(0.1);
+	}
+	if (!AudioDecodeAheadThread::is_running()) {
+		// No thread support.
+		return;
+	}
+
+	TestDecoder decoder;
+	decoder.length = 3000;
+	decoder.position = 100;
+
+	AudioDecodeAheadBuffer buffer;
+	buffer.setup(&_test_decode, &_test_seek, &decoder, 4096);
+	CHECK(buffer.is_enabled());
+	buffer.request_restart(100, true);
+
+	// The ring is large enough for the whole stream, wait for the decode thread to get to its end.
+	REQUIRE(_wait_for_decoder(buffer, decoder));
+
+	AudioFrame frames[300];
+	int mixed_total = 0;
+	bool in_order = true;
+	while (!buffer.is_finished() && mixed_total < 10000) {
+		int mixed = buffer.mix(frames, 300);
+		for (int i = 0; i < mixed; i++) {
+			in_order = in_order && frames[i].left == float(100 + mixed_total + i);
+		}
+		mixed_total += mixed;
+	}
+
+	CHECK(in_order);
+	CHECK(mixed_total == 2900);
+	CHECK(buffer.is_finished());
+	CHECK(buffer.get_underruns() == 0);
+	CHECK(buffer.get_position() == 3000);
+
+	// Restart, then seek while the ring is still full of frames that were never read.
+	buffer.request_restart(0, true);
+	REQUIRE(_wait_for_decoder(buffer, decoder));
+	CHECK(buffer.mix(frames, 10) == 10);
+	CHECK_FALSE(buffer.is_finished());
+	CHECK(frames[0].left == doctest::Approx(0));
+
+	buffer.request_restart(2000, false);
+	CHECK(buffer.get_position() == 10);
+
+	// Until the decode thread handles the seek, the reader outputs silence instead of the frames decoded before it.
+	bool seeked = false;
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 5000;
+	while (!seeked && OS::get_singleton()->get_ticks_msec() < timeout) {
+		CHECK(buffer.mix(frames, 10) == 10);
+		seeked = frames[0].left != 0.0f;
+		if (!seeked) {
+			CHECK(buffer.get_position() == 2000);
+			OS::get_singleton()->delay_usec(1000);
+		}
+	}
+	REQUIRE(seeked);
+	CHECK(frames[0].left == doctest::Approx(2000));
+	CHECK(frames[9].left == doctest::Approx(2009));
+	CHECK(buffer.get_position() == 2010);
+
+	if (!was_running) {
+		AudioDecodeAheadThread::finish();
+	}
+}
+
+} // namespace TestAudioDecodeCache
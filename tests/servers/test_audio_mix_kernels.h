@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*  test_audio_mix_kernels.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "servers/audio/audio_filter_sw.h"
+#include "servers/audio/audio_mix_kernels.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioMixKernels {
+
+static LocalVector<AudioFrame> _make_signal(uint32_t p_frames, uint32_t p_seed) {
+	LocalVector<AudioFrame> signal;
+	signal.resize(p_frames);
+	for (uint32_t i = 0; i < p_frames; i++) {
+		signal[i] = AudioFrame(Math::sin((i + p_seed) * 0.037f), Math::cos((i * 3 + p_seed) * 0.011f) * 0.5f);
+	}
+	return signal;
+}
+
+static bool _frames_equal(const LocalVector<AudioFrame> &p_a, const LocalVector<AudioFrame> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (!Math::is_equal_approx(p_a[i].left, p_b[i].left) || !Math::is_equal_approx(p_a[i].right, p_b[i].right)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[AudioMixKernels] Vectorized kernels match the scalar reference") {
+	const AudioMixKernels::Functions reference = AudioMixKernels::get_instruction_set_functions(AudioMixKernels::ISA_SCALAR);
+	// Odd frame count, so the remainder loops of the vectorized kernels are covered too.
+	const uint32_t frames = 509;
+	const LocalVector<AudioFrame> src = _make_signal(frames + 4, 7);
+	const AudioFrame vol_start(0.25, 1.0);
+	const AudioFrame vol_end(0.75, 0.5);
+
+	for (int i = AudioMixKernels::ISA_SCALAR + 1; i < AudioMixKernels::ISA_MAX; i++) {
+		AudioMixKernels::InstructionSet instruction_set = AudioMixKernels::InstructionSet(i);
+		if (!AudioMixKernels::is_instruction_set_supported(instruction_set)) {
+			continue;
+		}
+		const AudioMixKernels::Functions functions = AudioMixKernels::get_instruction_set_functions(instruction_set);
+		INFO("Instruction set: ", AudioMixKernels::get_instruction_set_name(instruction_set));
+
+		LocalVector<AudioFrame> expected = _make_signal(frames, 3);
+		LocalVector<AudioFrame> result = expected;
+		reference.mix_ramp(expected.ptr(), src.ptr(), vol_start, vol_end, frames);
+		functions.mix_ramp(result.ptr(), src.ptr(), vol_start, vol_end, frames);
+		CHECK_MESSAGE(_frames_equal(expected, result), "mix_ramp should match the scalar kernel.");
+
+		reference.apply_ramp(expected.ptr(), src.ptr(), vol_start, vol_end, frames);
+		functions.apply_ramp(result.ptr(), src.ptr(), vol_start, vol_end, frames);
+		CHECK_MESSAGE(_frames_equal(expected, result), "apply_ramp should match the scalar kernel.");
+
+		reference.accumulate(expected.ptr(), src.ptr(), frames);
+		functions.accumulate(result.ptr(), src.ptr(), frames);
+		CHECK_MESSAGE(_frames_equal(expected, result), "accumulate should match the scalar kernel.");
+
+		AudioFrame expected_peak = reference.scale_and_peak(expected.ptr(), -1.5, frames);
+		AudioFrame result_peak = functions.scale_and_peak(result.ptr(), -1.5, frames);
+		CHECK_MESSAGE(_frames_equal(expected, result), "scale_and_peak should match the scalar kernel.");
+		CHECK(expected_peak.left == doctest::Approx(result_peak.left));
+		CHECK(expected_peak.right == doctest::Approx(result_peak.right));
+
+		// Fractional and integer increments, including a fast-forward one skipping source frames.
+		const uint64_t increments[] = { 0, 27000, 1 << AudioMixKernels::RESAMPLE_FP_BITS, 95000 };
+		for (uint64_t increment : increments) {
+			INFO("Increment: ", increment);
+			const uint32_t resample_frames = MIN(frames, uint32_t((uint64_t(frames - 1) << AudioMixKernels::RESAMPLE_FP_BITS) / MAX(increment, uint64_t(1))));
+			reference.resample_cubic(expected.ptr(), src.ptr(), 1234, increment, resample_frames);
+			functions.resample_cubic(result.ptr(), src.ptr(), 1234, increment, resample_frames);
+			CHECK_MESSAGE(_frames_equal(expected, result), "resample_cubic should match the scalar kernel.");
+		}
+	}
+}
+
+TEST_CASE("[AudioMixKernels] Stereo biquad processing matches per-channel processing") {
+	AudioFilterSW filter;
+	filter.set_mode(AudioFilterSW::LOWPASS);
+	filter.set_cutoff(2000);
+	filter.set_resonance(1.5);
+	filter.set_sampling_rate(44100);
+
+	AudioFilterSW::Processor left;
+	AudioFilterSW::Processor right;
+	left.set_filter(&filter);
+	right.set_filter(&filter);
+	AudioFilterSW::Processor stereo_left;
+	AudioFilterSW::Processor stereo_right;
+	stereo_left.set_filter(&filter);
+	stereo_right.set_filter(&filter);
+
+	LocalVector<AudioFrame> expected = _make_signal(301, 11);
+	LocalVector<AudioFrame> result = expected;
+	for (AudioFrame &frame : expected) {
+		left.process_one(frame.left);
+		right.process_one(frame.right);
+	}
+	AudioFilterSW::Processor::process_stereo(&stereo_left, &stereo_right, result.ptr(), result.size());
+	CHECK_MESSAGE(_frames_equal(expected, result), "Filtering both channels together should give the same output as filtering them one by one.");
+}
+
+TEST_CASE("[AudioMixKernels] Interpolated stereo biquad processing matches per-channel processing") {
+	AudioFilterSW filter;
+	filter.set_mode(AudioFilterSW::PEAK);
+	filter.set_cutoff(800);
+	filter.set_resonance(0.8);
+	filter.set_gain(2.0);
+	filter.set_sampling_rate(44100);
+
+	AudioFilterSW::Processor left;
+	AudioFilterSW::Processor right;
+	AudioFilterSW::Processor stereo_left;
+	AudioFilterSW::Processor stereo_right;
+	AudioFilterSW::Processor *processors[] = { &left, &right, &stereo_left, &stereo_right };
+	for (AudioFilterSW::Processor *processor : processors) {
+		processor->set_filter(&filter);
+		processor->update_coeffs();
+	}
+
+	// Ramp the coefficients to the new cutoff over the block, like AudioServer does when a bus filter changes.
+	const int frames = 257;
+	filter.set_cutoff(5000);
+	for (AudioFilterSW::Processor *processor : processors) {
+		processor->update_coeffs(frames);
+	}
+
+	LocalVector<AudioFrame> expected = _make_signal(frames, 13);
+	LocalVector<AudioFrame> result = expected;
+	for (AudioFrame &frame : expected) {
+		left.process_one_interp(frame.left);
+		right.process_one_interp(frame.right);
+	}
+	AudioFilterSW::Processor::process_stereo(&stereo_left, &stereo_right, result.ptr(), frames, true);
+	CHECK_MESSAGE(_frames_equal(expected, result), "Interpolated filtering of both channels together should give the same output as filtering them one by one.");
+
+	// The interpolated coefficients and the history must be written back for the next block.
+	expected = _make_signal(frames, 17);
+	result = expected;
+	for (AudioFrame &frame : expected) {
+		left.process_one(frame.left);
+		right.process_one(frame.right);
+	}
+	AudioFilterSW::Processor::process_stereo(&stereo_left, &stereo_right, result.ptr(), frames);
+	CHECK_MESSAGE(_frames_equal(expected, result), "Filtering after an interpolated block should continue from the same state.");
+}
+
+} // namespace TestAudioMixKernels
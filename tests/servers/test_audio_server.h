@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*  test_audio_server.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/config/project_settings.h"
+#include "core/io/marshalls.h"
+#include "scene/resources/audio_stream_wav.h"
+#include "servers/audio/audio_driver_dummy.h"
+#include "servers/audio/effects/audio_effect_amplify.h"
+#include "servers/audio/effects/audio_effect_filter.h"
+#include "servers/audio_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioServer {
+
+// Runs an AudioServer on the dummy driver without its thread, so the test decides when mixing happens.
+// Tests using it must not be tagged [Audio], which already sets up a threaded AudioServer.
+class ManualAudioServer {
+	AudioServer *server = nullptr;
+
+public:
+	AudioServer *operator->() const { return server; }
+
+	void mix(LocalVector<int32_t> &r_output, int p_frames) {
+		r_output.resize(p_frames * AudioDriverDummy::get_dummy_singleton()->get_channels());
+		AudioDriverDummy::get_dummy_singleton()->mix_audio(p_frames, r_output.ptr());
+	}
+
+	ManualAudioServer(int p_mix_threads) {
+		ProjectSettings::get_singleton()->set_setting("audio/general/mix_threads", p_mix_threads);
+		AudioDriverDummy::get_dummy_singleton()->set_use_threads(false);
+		AudioDriverManager::initialize(AudioDriverManager::get_driver_count() - 1);
+		server = memnew(AudioServer);
+		server->init();
+	}
+
+	~ManualAudioServer() {
+		server->finish();
+		memdelete(server);
+		AudioDriverDummy::get_dummy_singleton()->set_use_threads(true);
+		ProjectSettings::get_singleton()->set_setting("audio/general/mix_threads", 0);
+	}
+};
+
+// A looping 16-bit mono sine wave.
+static Ref<AudioStreamWAV> _make_sine_stream(float p_frequency, float p_seconds = 1.0) {
+	const int mix_rate = 44100;
+	const int frames = mix_rate * p_seconds;
+	Vector<uint8_t> data;
+	data.resize(frames * 2);
+	for (int i = 0; i < frames; i++) {
+		encode_uint16(int16_t(Math::sin(i * p_frequency * Math::TAU / mix_rate) * 3000), data.ptrw() + i * 2);
+	}
+
+	Ref<AudioStreamWAV> stream;
+	stream.instantiate();
+	stream->set_format(AudioStreamWAV::FORMAT_16_BITS);
+	stream->set_mix_rate(mix_rate);
+	stream->set_data(data);
+	stream->set_loop_mode(AudioStreamWAV::LOOP_FORWARD);
+	stream->set_loop_end(frames);
+	return stream;
+}
+
+static Vector<AudioFrame> _make_volume_vector(float p_volume) {
+	Vector<AudioFrame> volume_vector;
+	volume_vector.resize(AudioServer::MAX_CHANNELS_PER_BUS);
+	for (AudioFrame &volume : volume_vector) {
+		volume = AudioFrame(p_volume, p_volume);
+	}
+	return volume_vector;
+}
+
+// Mixes the same voices and bus layout (with effects and sends on several levels) with the given number of mix threads.
+static void _mix_scene(int p_mix_threads, int p_blocks, LocalVector<int32_t> &r_output) {
+	ManualAudioServer server(p_mix_threads);
+
+	server->set_bus_count(4);
+	server->set_bus_name(1, "Music");
+	server->set_bus_name(2, "Effects");
+	server->set_bus_name(3, "Footsteps");
+	server->set_bus_send(1, "Master");
+	server->set_bus_send(2, "Master");
+	server->set_bus_send(3, "Effects");
+
+	Ref<AudioEffectAmplify> amplify;
+	amplify.instantiate();
+	amplify->set_volume_db(-3);
+	server->add_bus_effect(1, amplify);
+	Ref<AudioEffectLowPassFilter> low_pass;
+	low_pass.instantiate();
+	low_pass->set_cutoff(3000);
+	server->add_bus_effect(2, low_pass);
+	Ref<AudioEffectHighPassFilter> high_pass;
+	high_pass.instantiate();
+	high_pass->set_cutoff(200);
+	server->add_bus_effect(3, high_pass);
+
+	const StringName bus_names[] = { "Master", "Music", "Effects", "Footsteps" };
+	for (int i = 0; i < 16; i++) {
+		Ref<AudioStreamWAV> stream = _make_sine_stream(110 + i * 37);
+		server->start_playback_stream(stream->instantiate_playback(), bus_names[i % 4], _make_volume_vector(0.1), 0, 1.0 + i * 0.01);
+	}
+
+	LocalVector<int32_t> block;
+	r_output.clear();
+	for (int i = 0; i < p_blocks; i++) {
+		server.mix(block, 512);
+		for (int32_t sample : block) {
+			r_output.push_back(sample);
+		}
+	}
+}
+
+TEST_CASE("[AudioServer] Threaded mix matches the serial mix") {
+	LocalVector<int32_t> serial;
+	_mix_scene(0, 8, serial);
+	LocalVector<int32_t> threaded;
+	_mix_scene(3, 8, threaded);
+
+	REQUIRE(serial.size() == threaded.size());
+	bool silent = true;
+	bool equal = true;
+	for (uint32_t i = 0; i < serial.size(); i++) {
+		silent = silent && serial[i] == 0;
+		// Voices are summed per thread first, so rounding can differ slightly.
+		equal = equal && Math::abs(int64_t(serial[i]) - int64_t(threaded[i])) <= (1 << 14);
+	}
+	CHECK_FALSE_MESSAGE(silent, "The scene should produce sound.");
+	CHECK_MESSAGE(equal, "Mixing on several threads should give the same output as mixing on the audio thread.");
+}
+
+static bool _is_silent(const LocalVector<int32_t> &p_block) {
+	for (int32_t sample : p_block) {
+		if (sample != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[AudioServer] Inaudible voices go virtual and resume where they would have been") {
+	ManualAudioServer server(0);
+	const double block_time = 512 / server->get_mix_rate();
+	const double lookahead_time = AudioServer::LOOKAHEAD_BUFFER_SIZE / server->get_mix_rate();
+	// Seeking rounds to whole frames.
+	const double frame_time = 1.0 / server->get_mix_rate();
+
+	Ref<AudioStreamWAV> stream = _make_sine_stream(440, 10.0);
+	Ref<AudioStreamPlayback> playback = stream->instantiate_playback();
+	server->start_playback_stream(playback, "Master", _make_volume_vector(0.1));
+	server->set_playback_voice_priority(playback, 0, stream->get_length(), true);
+
+	LocalVector<int32_t> block;
+	for (int i = 0; i < 4; i++) {
+		server.mix(block, 512);
+	}
+	CHECK_FALSE(_is_silent(block));
+	CHECK_FALSE(server->is_playback_virtual(playback));
+	// The stream is mixed ahead of what was heard by the lookahead.
+	const double real_position = server->get_playback_position(playback);
+
+	// Muted, the voice fades out for one step, then resumes right after the last frame that was heard.
+	server->set_playback_all_bus_volumes_linear(playback, _make_volume_vector(0.0));
+	server.mix(block, 512);
+	CHECK(server->is_playback_virtual(playback));
+	CHECK(server->get_virtual_voice_count() == 1);
+	CHECK(Math::abs(server->get_playback_position(playback) - (real_position + block_time - lookahead_time)) < frame_time);
+
+	// Virtual voices keep advancing without mixing.
+	for (int i = 0; i < 3; i++) {
+		server.mix(block, 512);
+	}
+	CHECK(_is_silent(block));
+	const double virtual_position = server->get_playback_position(playback);
+	CHECK(Math::abs(virtual_position - (real_position + 4 * block_time - lookahead_time)) < frame_time);
+
+	// Audible again, the playback is seeked and the voice stays virtual for one more step.
+	server->set_playback_all_bus_volumes_linear(playback, _make_volume_vector(0.1));
+	server.mix(block, 512);
+	CHECK(server->is_playback_virtual(playback));
+	CHECK(_is_silent(block));
+	CHECK(Math::abs(server->get_playback_position(playback) - (virtual_position + block_time)) < frame_time);
+
+	// Then it's mixed again, as far ahead of the output as a voice that never went virtual.
+	server.mix(block, 512);
+	CHECK_FALSE(server->is_playback_virtual(playback));
+	CHECK(server->get_virtual_voice_count() == 0);
+	CHECK_FALSE(_is_silent(block));
+	CHECK(Math::abs(server->get_playback_position(playback) - (virtual_position + 2 * block_time + lookahead_time)) < frame_time);
+
+	server->stop_playback_stream(playback);
+	server.mix(block, 512);
+}
+
+} // namespace TestAudioServer